@@ -73,8 +73,7 @@ struct Dart
 	 * Creates a new Dart from an another one.
 	 * \param[in] d a dart
 	 */
-	inline Dart(const Dart& d) : index(d.index)
-	{}
+	Dart(const Dart& d) = default;
 
 	/**
 	 * \brief Tests the nullity of the dart.
@@ -89,7 +88,7 @@ struct Dart
 	 * \param[in] rhs the dart to assign
 	 * \return The dart with the assigned value
 	 */
-	inline Dart& operator=(Dart rhs) { index = rhs.index; return *this; }
+	Dart& operator=(const Dart& rhs) = default;
 
 	/**
 	 * \brief Tests whether the left hand side dart is equal
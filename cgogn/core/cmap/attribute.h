@@ -186,6 +186,37 @@ public:
 		chunk_array_->set_all_values(val);
 	}
 
+	/**
+	 * \brief report the modification of the element i to the consumers of the data (see ChunkArrayGen::set_dirty)
+	 * @param i
+	 */
+	inline void set_dirty(uint32 i)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
+		chunk_array_->set_dirty(i);
+	}
+
+	/**
+	 * \brief report the modification of the elements [first, last)
+	 */
+	inline void set_dirty(uint32 first, uint32 last)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
+		chunk_array_->set_dirty(first, last);
+	}
+
+	inline void set_dirty(Dart d)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
+		chunk_array_->set_dirty(this->map_->embedding(d, orbit_));
+	}
+
+	inline void set_all_dirty()
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
+		chunk_array_->set_all_dirty();
+	}
+
 	/**
 	 * \brief operator[]
 	 * @param i
@@ -382,6 +413,7 @@ public:
 
 	using TChunkArray = typename Inherit::TChunkArray;
 	using Inherit::operator[];
+	using Inherit::set_dirty;
 
 	static const Orbit orb_ = ORBIT;
 
@@ -443,6 +475,16 @@ public:
 		return this->chunk_array_->operator[](this->map_->embedding(c));
 	}
 
+	/**
+	 * \brief report the modification of the value of c to the consumers of the data
+	 * @param c
+	 */
+	inline void set_dirty(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
+		this->chunk_array_->set_dirty(this->map_->embedding(c));
+	}
+
 	inline Orbit orbit() const
 	{
 		return ORBIT;
@@ -0,0 +1,206 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_CMAP_ATTRIBUTE_SNAPSHOT_H_
+#define CGOGN_CORE_CMAP_ATTRIBUTE_SNAPSHOT_H_
+
+#include <memory>
+#include <vector>
+
+#include <cgogn/core/cmap/attribute.h>
+#include <cgogn/core/container/chunk_allocator.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The AttributeSnapshot class publishes consistent copies of an attribute, so that readers
+ * (e.g. the rendering thread) never see a partially updated attribute while a writer (e.g. a simulation
+ * thread) keeps modifying it.
+ * A published View is immutable: it stays valid and unchanged as long as a reader holds it.
+ * The chunks of the attribute are copied on publication only if they have been reported as modified
+ * (see ChunkArrayGen::set_dirty) since the previous one; the other chunks are shared with the previous view.
+ * The snapshot keeps its own versions of the chunks (see ChunkArrayGen::modified_chunks), so that the
+ * other consumers of the modification state of the attribute (e.g. the VBOs) are not disturbed.
+ * The topology (i.e. the embedding of the cells) is supposed not to change while views are read.
+ */
+template <typename T>
+class AttributeSnapshot
+{
+	static_assert(!std::is_same<T, bool>::value, "AttributeSnapshot does not handle attributes of bool");
+
+public:
+
+	using Self = AttributeSnapshot<T>;
+	using value_type = T;
+
+	static const uint32 CHUNK_SIZE = AttributeGen::CHUNK_SIZE;
+
+	class View
+	{
+		friend class AttributeSnapshot<T>;
+
+	public:
+
+		using value_type = T;
+		static const uint32 CHUNK_SIZE = AttributeSnapshot<T>::CHUNK_SIZE;
+
+		inline View() : epoch_(0u)
+		{}
+
+		CGOGN_NOT_COPYABLE_NOR_MOVABLE(View);
+
+		/**
+		 * @return the number of the publication of this view (from 1)
+		 */
+		inline uint64 epoch() const { return epoch_; }
+
+		inline uint32 nb_chunks() const { return uint32(chunks_.size()); }
+
+		inline const T* chunk(uint32 c) const
+		{
+			cgogn_message_assert(c < chunks_.size(), "View::chunk: chunk out of the view");
+			return chunks_[c].get();
+		}
+
+		/**
+		 * @return the value of the element (embedding) i at the publication of this view
+		 */
+		inline const T& operator[](uint32 i) const
+		{
+			cgogn_message_assert(i / CHUNK_SIZE < chunks_.size(), "View: index out of the view");
+			return chunks_[i / CHUNK_SIZE].get()[i % CHUNK_SIZE];
+		}
+
+		/**
+		 * @brief return a vector with pointers to all chunks (as ChunkArray::chunks_pointers)
+		 */
+		std::vector<const void*> chunks_pointers() const
+		{
+			std::vector<const void*> addr;
+			addr.reserve(chunks_.size());
+			for (const std::shared_ptr<const T>& chunk : chunks_)
+				addr.push_back(chunk.get());
+			return addr;
+		}
+
+		/**
+		 * @return the indices of the chunks of this view that have been copied after the publication of older
+		 */
+		std::vector<uint32> changed_chunks(const View& older) const
+		{
+			std::vector<uint32> changed;
+			for (uint32 c = 0u; c < nb_chunks(); ++c)
+			{
+				if (c >= older.nb_chunks() || chunks_[c] != older.chunks_[c])
+					changed.push_back(c);
+			}
+			return changed;
+		}
+
+	private:
+
+		std::vector<std::shared_ptr<const T>> chunks_;
+		uint64 epoch_;
+	};
+
+	inline AttributeSnapshot(const Attribute_T<T>& attribute) :
+		attribute_(attribute),
+		epoch_(0u)
+	{
+		cgogn_message_assert(attribute_.is_valid(), "AttributeSnapshot: invalid attribute");
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(AttributeSnapshot);
+
+	/**
+	 * @brief publish the current values of the attribute as a new view.
+	 * Must be called by the writer while it does not modify the attribute (e.g. between two steps).
+	 * The modified chunks are copied in parallel.
+	 */
+	void publish()
+	{
+		cgogn_message_assert(attribute_.is_valid(), "AttributeSnapshot: the attribute has been removed");
+
+		const typename Attribute_T<T>::TChunkArray* ca = attribute_.data();
+		uint32 byte_chunk_size;
+		const std::vector<const void*> chunk_addr = ca->chunks_pointers(byte_chunk_size);
+		const uint32 nb_chunks = uint32(chunk_addr.size());
+
+		// only the writer replaces the current view: it can be read without synchronization here
+		const std::shared_ptr<const View> previous = current_;
+
+		std::shared_ptr<View> view = std::make_shared<View>();
+		view->epoch_ = ++epoch_;
+		view->chunks_.resize(nb_chunks);
+
+		std::vector<bool> modified(nb_chunks, false);
+		for (uint32 c : ca->modified_chunks(published_versions_))
+			modified[c] = true;
+
+		std::vector<uint32> copied;
+		for (uint32 c = 0u; c < nb_chunks; ++c)
+		{
+			if (previous != nullptr && c < previous->nb_chunks() && !modified[c])
+				view->chunks_[c] = previous->chunks_[c];
+			else
+				copied.push_back(c);
+		}
+
+		parallel_for(0u, uint32(copied.size()), 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 k = first; k < last; ++k)
+			{
+				const T* src = static_cast<const T*>(chunk_addr[copied[k]]);
+				T* chunk = static_cast<T*>(chunk_allocator()->allocate(std::size_t(CHUNK_SIZE) * sizeof(T)));
+				std::uninitialized_copy(src, src + CHUNK_SIZE, chunk);
+				view->chunks_[copied[k]] = std::shared_ptr<const T>(chunk, [] (const T* p)
+				{
+					internal::delete_chunk(const_cast<T*>(p), CHUNK_SIZE);
+				});
+			}
+		});
+
+		std::atomic_store(&current_, std::shared_ptr<const View>(std::move(view)));
+	}
+
+	/**
+	 * @brief get the last published view, or nullptr if nothing has been published (thread safe)
+	 */
+	inline std::shared_ptr<const View> view() const
+	{
+		return std::atomic_load(&current_);
+	}
+
+private:
+
+	Attribute_T<T> attribute_;
+	std::shared_ptr<const View> current_;
+	uint64 epoch_;
+	ChunkVersions published_versions_;
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_CMAP_ATTRIBUTE_SNAPSHOT_H_
@@ -179,6 +179,7 @@ protected:
 	 */
 	void phi1_sew(Dart d, Dart e)
 	{
+		this->topology_changed();
 		Dart f = phi1(d);
 		Dart g = phi1(e);
 		(*phi1_)[d.index] = g;
@@ -195,6 +196,7 @@ protected:
 	 */
 	void phi1_unsew(Dart d)
 	{
+		this->topology_changed();
 		Dart e = phi1(d);
 		Dart f = phi1(e);
 		(*phi1_)[d.index] = f;
@@ -26,6 +26,7 @@
 
 #include <cgogn/core/cmap/cmap1.h>
 #include <cgogn/core/cmap/cmap2_builder.h>
+#include <cgogn/core/cmap/csr_incidence.h>
 
 namespace cgogn
 {
@@ -189,6 +190,7 @@ protected:
 	 */
 	inline void phi2_sew(Dart d, Dart e)
 	{
+		this->topology_changed();
 		cgogn_assert(phi2(d) == d);
 		cgogn_assert(phi2(e) == e);
 		(*phi2_)[d.index] = e;
@@ -203,6 +205,7 @@ protected:
 	 */
 	inline void phi2_unsew(Dart d)
 	{
+		this->topology_changed();
 		Dart e = phi2(d);
 		(*phi2_)[d.index] = d;
 		(*phi2_)[e.index] = e;
@@ -804,7 +807,10 @@ public:
 		{
 			auto vn1it = std::find(vn1->begin(), vn1->end(), this->embedding(Vertex(this->phi1(it))));
 			if (vn1it != vn1->end())
+			{
+				uint_buffers()->release_buffer(vn1);
 				return false;
+			}
 			it = next_edge(it);
 		} while(it != end);
 		uint_buffers()->release_buffer(vn1);
@@ -2059,6 +2065,7 @@ extern template class CGOGN_CORE_API CellMarkerStore<CMap2, CMap2::Edge::ORBIT>;
 extern template class CGOGN_CORE_API CellMarkerStore<CMap2, CMap2::Face::ORBIT>;
 extern template class CGOGN_CORE_API CellMarkerStore<CMap2, CMap2::Volume::ORBIT>;
 extern template class CGOGN_CORE_API CellCache<CMap2>;
+extern template class CGOGN_CORE_API CSRIncidence<CMap2>;
 extern template class CGOGN_CORE_API BoundaryCache<CMap2>;
 extern template class CGOGN_CORE_API QuickTraversor<CMap2>;
 #endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_CORE_EXTERNAL_TEMPLATES_CPP_))
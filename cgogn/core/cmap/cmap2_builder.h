@@ -143,6 +143,17 @@ public:
 		return map_.add_topology_element();
 	}
 
+	inline Dart add_topology_elements(uint32 nb)
+	{
+		return map_.add_topology_elements(nb);
+	}
+
+	template <Orbit ORBIT>
+	inline uint32 add_attribute_elements(uint32 nb)
+	{
+		return map_.template add_attribute_elements<ORBIT>(nb);
+	}
+
 
 	template <bool B=true>
 	inline auto ca_phi1() -> typename std::enable_if<B && MAP2::PRIM_SIZE==1,ChunkArray<Dart>&>::type
@@ -161,6 +172,12 @@ public:
 		return *(map_.phi2_);
 	}
 
+	template <Orbit ORBIT>
+	inline ChunkArray<uint32>& ca_embedding()
+	{
+		return *(map_.embeddings_[ORBIT]);
+	}
+
 	inline ChunkArrayContainer<uint8>& cac_topology()
 	{
 		return map_.topology_;
@@ -177,6 +177,7 @@ protected:
 	 */
 	inline void phi2_sew(Dart d, Dart e)
 	{
+		this->topology_changed();
 		cgogn_assert(phi2(d) == d);
 		cgogn_assert(phi2(e) == e);
 		(*phi2_)[d.index] = e;
@@ -191,6 +192,7 @@ protected:
 	 */
 	inline void phi2_unsew(Dart d)
 	{
+		this->topology_changed();
 		Dart e = phi2(d);
 		(*phi2_)[d.index] = d;
 		(*phi2_)[e.index] = e;
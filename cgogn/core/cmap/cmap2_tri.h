@@ -178,6 +178,7 @@ protected:
 	 */
 	inline void phi2_sew(Dart d, Dart e)
 	{
+		this->topology_changed();
 		cgogn_assert(phi2(d) == d);
 		cgogn_assert(phi2(e) == e);
 		(*phi2_)[d.index] = e;
@@ -192,6 +193,7 @@ protected:
 	 */
 	inline void phi2_unsew(Dart d)
 	{
+		this->topology_changed();
 		Dart e = phi2(d);
 		(*phi2_)[d.index] = d;
 		(*phi2_)[e.index] = e;
@@ -202,6 +202,7 @@ protected:
 	 */
 	inline void phi3_sew(Dart d, Dart e)
 	{
+		this->topology_changed();
 		cgogn_assert(phi3(d) == d);
 		cgogn_assert(phi3(e) == e);
 		(*phi3_)[d.index] = e;
@@ -216,6 +217,7 @@ protected:
 	 */
 	inline void phi3_unsew(Dart d)
 	{
+		this->topology_changed();
 		Dart e = phi3(d);
 		(*phi3_)[d.index] = d;
 		(*phi3_)[e.index] = e;
@@ -2645,6 +2647,7 @@ extern template class CGOGN_CORE_API CellMarkerStore<CMap3, CMap3::Edge::ORBIT>;
 extern template class CGOGN_CORE_API CellMarkerStore<CMap3, CMap3::Face::ORBIT>;
 extern template class CGOGN_CORE_API CellMarkerStore<CMap3, CMap3::Volume::ORBIT>;
 extern template class CGOGN_CORE_API CellCache<CMap3>;
+extern template class CGOGN_CORE_API CSRIncidence<CMap3>;
 extern template class CGOGN_CORE_API BoundaryCache<CMap3>;
 extern template class CGOGN_CORE_API QuickTraversor<CMap3>;
 #endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_CORE_EXTERNAL_TEMPLATES_CPP_))
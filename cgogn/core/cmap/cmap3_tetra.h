@@ -195,6 +195,7 @@ protected:
 	 */
 	inline void phi3_sew(Dart d, Dart e)
 	{
+		this->topology_changed();
 		cgogn_assert(phi3(d) == d);
 		cgogn_assert(phi3(e) == e);
 		(*phi3_)[d.index] = e;
@@ -209,6 +210,7 @@ protected:
 	 */
 	inline void phi3_unsew(Dart d)
 	{
+		this->topology_changed();
 		Dart e = phi3(d);
 		(*phi3_)[d.index] = d;
 		(*phi3_)[e.index] = e;
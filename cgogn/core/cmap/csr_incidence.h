@@ -0,0 +1,276 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_CMAP_CSR_INCIDENCE_H_
+#define CGOGN_CORE_CMAP_CSR_INCIDENCE_H_
+
+#include <vector>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/masks.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The CSRIncidence class is a read-only snapshot of the vertex -> vertex (through edges),
+ * vertex -> face and face -> vertex relations of a map, stored in compressed sparse row arrays.
+ * The vertices and faces are numbered from 0 in the order of map.foreach_cell, and each relation
+ * stores, for each cell, the darts given by the corresponding traversal of the map in the same order
+ * (e.g. foreach_adjacent_vertex_through_edge gives the same Vertex darts as the map).
+ * The snapshot is built in parallel and becomes invalid as soon as the topology of the map changes
+ * (see MapBaseData::topology_revision); it must then be built again.
+ */
+template <typename MAP>
+class CSRIncidence
+{
+public:
+
+	using Self = CSRIncidence<MAP>;
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+
+	/**
+	 * @brief The Range class gives the darts of the incident or adjacent cells of a cell
+	 */
+	class Range
+	{
+	public:
+
+		inline Range(const Dart* begin, const Dart* end) : begin_(begin), end_(end) {}
+		inline const Dart* begin() const { return begin_; }
+		inline const Dart* end() const { return end_; }
+		inline uint32 size() const { return uint32(end_ - begin_); }
+
+	private:
+
+		const Dart* begin_;
+		const Dart* end_;
+	};
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(CSRIncidence);
+
+	inline CSRIncidence(const MAP& map) :
+		map_(map),
+		built_(false),
+		revision_(0u)
+	{}
+
+	/**
+	 * @brief build the snapshot of the current topology of the map
+	 */
+	void build()
+	{
+		const uint32 nb_darts = map_.topology_container().end();
+
+		CellCache<MAP> cache(map_);
+		cache.template parallel_build<Vertex>();
+		cache.template parallel_build<Face>();
+		vertices_ = cache.template cells<Vertex>();
+		faces_ = cache.template cells<Face>();
+
+		vertex_of_dart_.assign(nb_darts, INVALID_INDEX);
+		face_of_dart_.assign(nb_darts, INVALID_INDEX);
+		parallel_for(0u, nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				map_.foreach_dart_of_orbit(Vertex(vertices_[i]), [&] (Dart d) { vertex_of_dart_[d.index] = i; });
+		});
+		parallel_for(0u, nb_faces(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				map_.foreach_dart_of_orbit(Face(faces_[i]), [&] (Dart d) { face_of_dart_[d.index] = i; });
+		});
+
+		build_relation<Vertex, Vertex>(vertices_, vv_offsets_, vv_darts_);
+		build_relation<Vertex, Face>(vertices_, vf_offsets_, vf_darts_);
+		build_relation<Face, Vertex>(faces_, fv_offsets_, fv_darts_);
+
+		revision_ = map_.topology_revision();
+		built_ = true;
+	}
+
+	/**
+	 * @brief release the memory of the snapshot
+	 */
+	void clear()
+	{
+		built_ = false;
+		std::vector<Dart>().swap(vertices_);
+		std::vector<Dart>().swap(faces_);
+		std::vector<uint32>().swap(vertex_of_dart_);
+		std::vector<uint32>().swap(face_of_dart_);
+		std::vector<uint32>().swap(vv_offsets_);
+		std::vector<Dart>().swap(vv_darts_);
+		std::vector<uint32>().swap(vf_offsets_);
+		std::vector<Dart>().swap(vf_darts_);
+		std::vector<uint32>().swap(fv_offsets_);
+		std::vector<Dart>().swap(fv_darts_);
+	}
+
+	/**
+	 * @return true if the snapshot has been built and the topology of the map has not changed since
+	 */
+	inline bool is_valid() const
+	{
+		return built_ && revision_ == map_.topology_revision();
+	}
+
+	inline const MAP& map() const { return map_; }
+
+	inline uint32 nb_vertices() const { return uint32(vertices_.size()); }
+	inline uint32 nb_faces() const { return uint32(faces_.size()); }
+
+	/// the vertices (resp. faces) of the snapshot, in the order of their numbering
+	inline const std::vector<Dart>& vertices() const { return vertices_; }
+	inline const std::vector<Dart>& faces() const { return faces_; }
+
+	/// the number of the vertex (resp. face) of a dart (INVALID_INDEX for the darts of boundary faces)
+	inline uint32 vertex_index(Dart d) const { return vertex_of_dart_[d.index]; }
+	inline uint32 face_index(Dart d) const { return face_of_dart_[d.index]; }
+
+	/// the darts of the vertices adjacent to the i-th vertex through an edge
+	inline Range adjacent_vertices(uint32 i) const
+	{
+		cgogn_message_assert(is_valid(), "CSRIncidence: the topology of the map has changed");
+		return Range(vv_darts_.data() + vv_offsets_[i], vv_darts_.data() + vv_offsets_[i + 1u]);
+	}
+
+	/// the darts of the faces incident to the i-th vertex
+	inline Range incident_faces(uint32 i) const
+	{
+		cgogn_message_assert(is_valid(), "CSRIncidence: the topology of the map has changed");
+		return Range(vf_darts_.data() + vf_offsets_[i], vf_darts_.data() + vf_offsets_[i + 1u]);
+	}
+
+	/// the darts of the vertices incident to the i-th face
+	inline Range incident_vertices(uint32 i) const
+	{
+		cgogn_message_assert(is_valid(), "CSRIncidence: the topology of the map has changed");
+		return Range(fv_darts_.data() + fv_offsets_[i], fv_darts_.data() + fv_offsets_[i + 1u]);
+	}
+
+	/*******************************************************************************
+	 * Incidence traversals (same interface as the map)
+	 *******************************************************************************/
+
+	template <typename FUNC>
+	inline void foreach_adjacent_vertex_through_edge(Vertex v, const FUNC& func) const
+	{
+		static_assert(is_func_parameter_same<FUNC, Vertex>::value, "Wrong function cell parameter type");
+		for (Dart d : adjacent_vertices(vertex_index(v.dart)))
+			if (!internal::void_to_true_binder(func, Vertex(d)))
+				break;
+	}
+
+	template <typename FUNC>
+	inline void foreach_incident_face(Vertex v, const FUNC& func) const
+	{
+		static_assert(is_func_parameter_same<FUNC, Face>::value, "Wrong function cell parameter type");
+		for (Dart d : incident_faces(vertex_index(v.dart)))
+			if (!internal::void_to_true_binder(func, Face(d)))
+				break;
+	}
+
+	template <typename FUNC>
+	inline void foreach_incident_vertex(Face f, const FUNC& func) const
+	{
+		static_assert(is_func_parameter_same<FUNC, Vertex>::value, "Wrong function cell parameter type");
+		for (Dart d : incident_vertices(face_index(f.dart)))
+			if (!internal::void_to_true_binder(func, Vertex(d)))
+				break;
+	}
+
+private:
+
+	template <typename FUNC>
+	inline void foreach_related(Vertex v, Vertex, const FUNC& f) const
+	{
+		map_.foreach_adjacent_vertex_through_edge(v, [&f] (Vertex u) { f(u.dart); });
+	}
+
+	template <typename FUNC>
+	inline void foreach_related(Vertex v, Face, const FUNC& f) const
+	{
+		map_.foreach_incident_face(v, [&f] (Face g) { f(g.dart); });
+	}
+
+	template <typename FUNC>
+	inline void foreach_related(Face g, Vertex, const FUNC& f) const
+	{
+		map_.foreach_incident_vertex(g, [&f] (Vertex u) { f(u.dart); });
+	}
+
+	/**
+	 * @brief fill the offsets and darts of the relation between the given cells and their related cells
+	 * The related cells are counted, then stored, in parallel.
+	 */
+	template <typename CellType, typename RelatedType>
+	void build_relation(const std::vector<Dart>& cells, std::vector<uint32>& offsets, std::vector<Dart>& darts) const
+	{
+		const uint32 nb_cells = uint32(cells.size());
+		offsets.assign(nb_cells + 1u, 0u);
+		parallel_for(0u, nb_cells, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				uint32 count = 0u;
+				foreach_related(CellType(cells[i]), RelatedType(), [&count] (Dart) { ++count; });
+				offsets[i + 1u] = count;
+			}
+		});
+		for (uint32 i = 0u; i < nb_cells; ++i)
+			offsets[i + 1u] += offsets[i];
+
+		darts.resize(offsets[nb_cells]);
+		parallel_for(0u, nb_cells, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				uint32 k = offsets[i];
+				foreach_related(CellType(cells[i]), RelatedType(), [&] (Dart d) { darts[k++] = d; });
+			}
+		});
+	}
+
+	const MAP& map_;
+	bool built_;
+	uint64 revision_;
+
+	std::vector<Dart> vertices_;
+	std::vector<Dart> faces_;
+	std::vector<uint32> vertex_of_dart_;
+	std::vector<uint32> face_of_dart_;
+
+	std::vector<uint32> vv_offsets_;
+	std::vector<Dart> vv_darts_;
+	std::vector<uint32> vf_offsets_;
+	std::vector<Dart> vf_darts_;
+	std::vector<uint32> fv_offsets_;
+	std::vector<Dart> fv_darts_;
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_CMAP_CSR_INCIDENCE_H_
@@ -26,6 +26,9 @@
 
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <fstream>
+#include <cstring>
 
 #include <cgogn/core/utils/masks.h>
 #include <cgogn/core/utils/logger.h>
@@ -93,6 +96,7 @@ public:
 	 */
 	inline void clear()
 	{
+		this->topology_changed();
 		this->topology_.clear_chunk_arrays();
 
 		for (uint32 i = 0u; i < NB_ORBITS; ++i)
@@ -105,6 +109,7 @@ public:
 	inline void clear_and_remove_attributes()
 	{
 		// 1st step : some cleaning
+		this->topology_changed();
 		this->topology_.clear_chunk_arrays();
 
 		for (auto& att : this->attributes_)
@@ -132,6 +137,121 @@ public:
 		}
 	}
 
+	/*******************************************************************************
+	 * Mapped file format
+	 *******************************************************************************/
+
+	/**
+	 * @brief save the whole map (topology, boundary and all the attributes) in a binary file
+	 * whose chunks can be used directly in memory by load_mapped
+	 * @param filename name of the file
+	 * @return ok
+	 */
+	bool save_mapped(const std::string& filename) const
+	{
+		std::ofstream fs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!fs.good())
+		{
+			cgogn_log_error("save_mapped") << "Unable to open the file \"" << filename << "\".";
+			return false;
+		}
+
+		fs.write(MAPPED_FILE_MAGIC, 8);
+		const uint32 info[4] = { MAPPED_FILE_VERSION, MAPPED_FILE_ENDIANNESS, CHUNK_SIZE, uint32(MappedFile::alignment()) };
+		serialization::save(fs, info, 4);
+		const std::string map_type = name_of_type(*to_concrete());
+		serialization::save(fs, &map_type, 1);
+
+		this->topology_.save_mapped(fs);
+		this->boundary_marker_->save_mapped(fs, this->topology_.end());
+
+		for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		{
+			const uint32 embedded = this->is_embedded(Orbit(orbit)) ? 1u : 0u;
+			serialization::save(fs, &embedded, 1);
+			if (embedded)
+				this->attributes_[orbit].save_mapped(fs);
+		}
+
+		return fs.good();
+	}
+
+	/**
+	 * @brief load a map saved by save_mapped, replacing the content of this map.
+	 * The file is mapped in memory and the chunks of raw data (topology, indices, positions...)
+	 * are used as is without being read or copied: the pages are loaded on first access
+	 * and copied on first write (the file is never modified).
+	 * If the file cannot be loaded completely, the map is left empty.
+	 * @param filename name of the file
+	 * @return ok
+	 */
+	bool load_mapped(const std::string& filename)
+	{
+		std::shared_ptr<MappedFile> file = MappedFile::open(filename);
+		if (!file)
+			return false;
+
+		MemoryStreambuf buffer(file->data(), file->size());
+		std::istream fs(&buffer);
+
+		char magic[8];
+		uint32 info[4];
+		fs.read(magic, 8);
+		serialization::load(fs, info, 4);
+		if (!fs.good() || std::memcmp(magic, MAPPED_FILE_MAGIC, 8) != 0 || info[0] != MAPPED_FILE_VERSION)
+		{
+			cgogn_log_error("load_mapped") << "The file \"" << filename << "\" is not a map file of version " << MAPPED_FILE_VERSION << ".";
+			return false;
+		}
+		if (info[1] != MAPPED_FILE_ENDIANNESS || info[2] != CHUNK_SIZE || info[3] != MappedFile::alignment())
+		{
+			cgogn_log_error("load_mapped") << "The file \"" << filename << "\" has been saved with another endianness, chunk size or alignment.";
+			return false;
+		}
+		std::string map_type;
+		serialization::load(fs, &map_type, 1);
+		if (map_type != name_of_type(*to_concrete()))
+		{
+			cgogn_log_error("load_mapped") << "The file \"" << filename << "\" contains a map of type " << map_type << ".";
+			return false;
+		}
+
+		clear_and_remove_attributes();
+
+		bool ok = this->topology_.load_mapped(fs, file);
+		ok = ok && this->boundary_marker_->load_mapped(fs, file);
+
+		for (uint32 orbit = 0u; ok && orbit < NB_ORBITS; ++orbit)
+		{
+			uint32 embedded;
+			serialization::load(fs, &embedded, 1);
+			if (!embedded)
+				continue;
+
+			std::ostringstream oss;
+			oss << "EMB_" << orbit_name(Orbit(orbit));
+			ChunkArray<uint32>* emb = this->topology_.template get_chunk_array<uint32>(oss.str());
+			if (emb == nullptr)
+			{
+				cgogn_log_error("load_mapped") << "Missing embedding of orbit " << orbit_name(Orbit(orbit)) << ".";
+				clear_and_remove_attributes();
+				return false;
+			}
+			this->embeddings_[orbit] = emb;
+			ok = this->attributes_[orbit].load_mapped(fs, file);
+		}
+
+		// never leave a partially loaded map
+		if (!ok || !fs.good())
+		{
+			cgogn_log_error("load_mapped") << "The file \"" << filename << "\" is truncated or corrupted.";
+			clear_and_remove_attributes();
+			return false;
+		}
+
+		return true;
+	}
+
 protected:
 
 	inline ConcreteMap* to_concrete()
@@ -156,6 +276,7 @@ protected:
 	 */
 	inline Dart add_topology_element()
 	{
+		this->topology_changed();
 		const uint32 idx = this->topology_.template insert_lines<ConcreteMap::PRIM_SIZE>();
 		for (uint32 jdx = idx; jdx < idx + ConcreteMap::PRIM_SIZE; ++jdx)
 		{
@@ -170,6 +291,36 @@ protected:
 		return Dart(idx);
 	}
 
+	/**
+	 * \brief Adds nb topological elements at the end of the topology container (only for PRIM_SIZE==1)
+	 * \return the first added dart (the added darts have consecutive indices)
+	 * The added darts are initialized in parallel as in add_topology_element.
+	 * The ranges processed by the workers are aligned on the chunks, so that the bits of the markers are not shared.
+	 */
+	inline Dart add_topology_elements(uint32 nb)
+	{
+		static_assert(ConcreteMap::PRIM_SIZE == 1u, "add_topology_elements only with PRIM_SIZE == 1");
+
+		this->topology_changed();
+		const uint32 first = this->topology_.append_lines(nb);
+		const uint32 last = first + nb;
+		parallel_for(first / CHUNK_SIZE, (last + CHUNK_SIZE - 1u) / CHUNK_SIZE, 1u, [&] (uint32 first_chunk, uint32 last_chunk)
+		{
+			const uint32 end = std::min(last, last_chunk * CHUNK_SIZE);
+			for (uint32 jdx = std::max(first, first_chunk * CHUNK_SIZE); jdx < end; ++jdx)
+			{
+				this->topology_.init_markers_of_line(jdx);
+				for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+				{
+					if (this->embeddings_[orbit])
+						(*this->embeddings_[orbit])[jdx] = INVALID_INDEX;
+				}
+				to_concrete()->init_dart(Dart(jdx));
+			}
+		});
+		return Dart(first);
+	}
+
 	/**
 	 * \brief Removes a topological element of PRIM_SIZE from the topology container
 	 * \param d the element to remove ( or one them if PRIM_SIZE >1)
@@ -178,6 +329,7 @@ protected:
 	 */
 	inline void remove_topology_element(Dart d)
 	{
+		this->topology_changed();
 		uint32 index = d.index;
 		this->topology_.template remove_lines<ConcreteMap::PRIM_SIZE>(index);
 
@@ -205,6 +357,26 @@ protected:
 		return idx;
 	}
 
+	/**
+	 * \brief Adds nb consecutive elements at the end of the attribute container of ORBIT
+	 * \return the index of the first added element
+	 */
+	template <Orbit ORBIT>
+	inline uint32 add_attribute_elements(uint32 nb)
+	{
+		static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+
+		const uint32 first = this->attributes_[ORBIT].append_lines(nb);
+		const uint32 last = first + nb;
+		parallel_for(first / CHUNK_SIZE, (last + CHUNK_SIZE - 1u) / CHUNK_SIZE, 1u, [&] (uint32 first_chunk, uint32 last_chunk)
+		{
+			const uint32 end = std::min(last, last_chunk * CHUNK_SIZE);
+			for (uint32 idx = std::max(first, first_chunk * CHUNK_SIZE); idx < end; ++idx)
+				this->attributes_[ORBIT].init_markers_of_line(idx);
+		});
+		return first;
+	}
+
 	template <Orbit ORBIT>
 	inline void remove_attribute_element(uint32 index)
 	{
@@ -869,6 +1041,7 @@ public:
 
 	/**
 	 * \brief apply a function in parallel on each dart of the map (including boundary darts)
+	 * each worker scans its own contiguous range of indices of the topology container
 	 * @tparam FUNC type of the callable
 	 * @param f a callable
 	 */
@@ -877,70 +1050,14 @@ public:
 	{
 		static_assert(is_func_parameter_same<FUNC, Dart>::value, "parallel_foreach_dart: given function should take a Dart as parameter");
 
-		using Future = std::future<typename std::result_of<FUNC(Dart)>::type>;
-		using VecDarts = std::vector<Dart>;
-
 		ThreadPool* thread_pool = cgogn::thread_pool();
-		uint32 nb_workers = thread_pool->nb_workers();
-		if (nb_workers == 0)
+		if (thread_pool->nb_workers() == 0)
 			return foreach_dart(f);
 
-		std::array<std::vector<VecDarts*>, 2> dart_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		dart_buffers[0].reserve(nb_workers);
-		dart_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
-
-		Buffers<Dart>* dbuffs = cgogn::dart_buffers();
-		const ConcreteMap* cmap = to_concrete();
-
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
-		Dart it = cmap->all_begin();
-		Dart last = cmap->all_end();
-
-		while (it != last)
+		thread_pool->parallel_for(0u, this->topology_.end(), PARALLEL_BUFFER_SIZE, [this, &f] (uint32 first, uint32 last)
 		{
-			dart_buffers[i].push_back(dbuffs->buffer());
-			cgogn_assert(dart_buffers[i].size() <= nb_workers);
-			std::vector<Dart>& darts = *dart_buffers[i].back();
-			darts.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it.index < last.index; ++k)
-			{
-				darts.push_back(it);
-				cmap->all_next(it);
-			}
-
-			futures[i].push_back(thread_pool->enqueue([&darts, &f] ()
-			{
-				for (auto d : darts)
-					f(d);
-			}));
-
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i+1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : dart_buffers[i])
-					dbuffs->release_buffer(b);
-				futures[i].clear();
-				dart_buffers[i].clear();
-			}
-		}
-
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto& b : dart_buffers[0u])
-			dbuffs->release_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto& b : dart_buffers[1u])
-			dbuffs->release_buffer(b);
+			this->topology_.foreach_index_in_range(first, last, [&f] (uint32 i) { f(Dart(i)); });
+		});
 	}
 
 	/**
@@ -1201,8 +1318,75 @@ public:
 			dbuffs->release_cell_buffer(b);
 	}
 
+	/**
+	 * \brief apply a function on each cell of the map that is stored in the given CellCache
+	 * the dimension of the traversed cells is determined based on the first parameter of the given callable
+	 * the callable may take the embedding index of the cell as second parameter if the cache is embedded
+	 * if the function returns a boolean, the traversal stops when it first returns false
+	 * @tparam FUNC type of the callable (CellType) or (CellType, uint32)
+	 * @param f a callable
+	 * @param cache a CellCache object
+	 */
+	template <typename FUNC, typename MAP>
+	inline void foreach_cell(const FUNC& f, const CellCache<MAP>& cache) const
+	{
+		using CellType = func_parameter_type<FUNC>;
+		static_assert(func_arity<FUNC>::value == 1u || func_arity<FUNC>::value == 2u, "Badly formed FUNC");
+		cgogn_message_assert(func_arity<FUNC>::value == 1u || cache.template is_embedded<CellType>(), "foreach_cell: the CellCache does not store the embeddings");
+
+		if (!cache.template is_traversed<CellType>())
+			cgogn_log_warning("foreach_cell") << "Using a CellTraversor for a non-traversed CellType";
+
+		const std::vector<Dart>& cells = cache.template cells<CellType>();
+		const std::vector<uint32>& embeddings = cache.template embeddings<CellType>();
+		for (std::size_t i = 0u, end = cells.size(); i < end; ++i)
+			if (!apply_cached_cell(f, CellType(cells[i]), embeddings, i))
+				break;
+	}
+
+	/**
+	 * \brief apply a function in parallel on each cell of the map that is stored in the given CellCache
+	 * the cached cells are split in equal ranges handled by the workers
+	 * the callable may take the embedding index of the cell as second parameter if the cache is embedded
+	 * @tparam FUNC type of the callable (CellType) or (CellType, uint32)
+	 * @param f a callable
+	 * @param cache a CellCache object
+	 */
+	template <typename FUNC, typename MAP>
+	inline void parallel_foreach_cell(const FUNC& f, const CellCache<MAP>& cache) const
+	{
+		using CellType = func_parameter_type<FUNC>;
+		static_assert(func_arity<FUNC>::value == 1u || func_arity<FUNC>::value == 2u, "Badly formed FUNC");
+		cgogn_message_assert(func_arity<FUNC>::value == 1u || cache.template is_embedded<CellType>(), "parallel_foreach_cell: the CellCache does not store the embeddings");
+
+		if (!cache.template is_traversed<CellType>())
+			cgogn_log_warning("foreach_cell") << "Using a CellTraversor for a non-traversed CellType";
+
+		const std::vector<Dart>& cells = cache.template cells<CellType>();
+		const std::vector<uint32>& embeddings = cache.template embeddings<CellType>();
+		cgogn::thread_pool()->parallel_for(0u, uint32(cells.size()), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				apply_cached_cell(f, CellType(cells[i]), embeddings, i);
+		});
+	}
+
 protected:
 
+	template <typename FUNC, typename CellType>
+	inline auto apply_cached_cell(const FUNC& f, CellType c, const std::vector<uint32>&, std::size_t) const
+		-> typename std::enable_if<func_arity<FUNC>::value == 1u, bool>::type
+	{
+		return internal::void_to_true_binder(f, c);
+	}
+
+	template <typename FUNC, typename CellType>
+	inline auto apply_cached_cell(const FUNC& f, CellType c, const std::vector<uint32>& embeddings, std::size_t i) const
+		-> typename std::enable_if<func_arity<FUNC>::value == 2u, bool>::type
+	{
+		return internal::void_to_true_binder(f, c, embeddings[i]);
+	}
+
 	/**
 	 * \brief apply a function on each cell of the map (boundary cells excluded) using a DartMarker
 	 * the dimension of the traversed cells is determined based on the parameter of the given callable
@@ -1351,9 +1535,11 @@ protected:
 	}
 
 	/**
-	 * \brief apply a function in parallel on each cell of the map (boundary cells excluded) using a CellMarker
+	 * \brief apply a function in parallel on each cell of the map (boundary cells excluded) using the cells indices
 	 * the dimension of the traversed cells is determined based on the parameter of the given callable
 	 * only cells selected by the given FilterFunction (CellType -> bool) are processed
+	 * each worker scans its own contiguous range of darts, a cell is processed by the first worker
+	 * that atomically marks its index (the filter is also evaluated by the workers)
 	 * @tparam FUNC type of the callable
 	 * @tparam FilterFunction type of the cell filtering function (CellType -> bool)
 	 * @param f a callable
@@ -1365,79 +1551,30 @@ protected:
 		using CellType = func_parameter_type<FUNC>;
 		static const Orbit ORBIT = CellType::ORBIT;
 
-		using VecCell = std::vector<CellType>;
-		using Future = std::future<typename std::result_of<FUNC(CellType)>::type>;
-
 		ThreadPool* thread_pool = cgogn::thread_pool();
-		uint32 nb_workers = thread_pool->nb_workers();
-		if (nb_workers == 0)
+		if (thread_pool->nb_workers() == 0)
 			return foreach_cell_cell_marking(f, filter);
 
-		std::array<std::vector<VecCell*>, 2> cells_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		cells_buffers[0].reserve(nb_workers);
-		cells_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
-
-		Buffers<Dart>* dbuffs = cgogn::dart_buffers();
-
-		const ConcreteMap* cmap = to_concrete();
-		CellMarker<ORBIT> cm(*cmap);
-		Dart it = cmap->begin();
-		Dart last = cmap->end();
+		const ChunkArray<uint32>& embedding = *this->embeddings_[ORBIT];
+		std::vector<std::atomic<uint32>> visited((this->attributes_[ORBIT].end() + 31u) / 32u);
 
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
-		while (it.index < last.index)
+		thread_pool->parallel_for(0u, this->topology_.end(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
 		{
-			// fill buffer
-			cells_buffers[i].push_back(dbuffs->template cell_buffer<CellType>());
-			VecCell& cells = *cells_buffers[i].back();
-			cells.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it.index < last.index; )
+			this->topology_.foreach_index_in_range(first, last, [&] (uint32 i)
 			{
-				CellType c(it);
-				if (!cm.is_marked(c))
+				const Dart d(i);
+				if (this->is_boundary(d))
+					return;
+				const uint32 emb = embedding[i];
+				const uint32 bit = 1u << (emb % 32u);
+				if ((visited[emb / 32u].fetch_or(bit) & bit) == 0u)
 				{
-					cm.mark(c);
+					const CellType c(d);
 					if (filter(c))
-					{
-						cells.push_back(c);
-						++k;
-					}
+						f(c);
 				}
-				cmap->next(it);
-			}
-			// launch thread
-			futures[i].push_back(thread_pool->enqueue([&cells, &f] ()
-			{
-				for (auto c : cells)
-					f(c);
-			}));
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i+1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : cells_buffers[i])
-					dbuffs->release_cell_buffer(b);
-				futures[i].clear();
-				cells_buffers[i].clear();
-			}
-		}
-
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto& b : cells_buffers[0u])
-			dbuffs->release_cell_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto& b : cells_buffers[1u])
-			dbuffs->release_cell_buffer(b);
+			});
+		});
 	}
 
 public:
@@ -1451,56 +1588,133 @@ public:
 	 */
 	void compact_embedding(uint32 orbit)
 	{
-		ChunkArray<uint32>* embedding = this->embeddings_[orbit];
-		if (embedding != nullptr)
+		if (this->embeddings_[orbit] != nullptr)
+			remap_embeddings(orbit, this->attributes_[orbit].template compact<1>());
+	}
+
+	/**
+	 * @brief compact an embedding orbit, renumbering its cells in the given order
+	 * @param orbit to compact
+	 * @param order embedding indices in their new order (the cells that are not given are placed after)
+	 */
+	void compact_embedding(uint32 orbit, const std::vector<uint32>& order)
+	{
+		if (this->embeddings_[orbit] != nullptr)
+			remap_embeddings(orbit, this->attributes_[orbit].template compact<1>(order));
+	}
+
+	void compact_topo()
+	{
+		remap_topo_relations(this->topology_.template compact<ConcreteMap::PRIM_SIZE>());
+	}
+
+	/**
+	 * @brief compact the topology container, renumbering the darts in the given order
+	 * @param order darts in their new order (the darts that are not given are placed after)
+	 */
+	void compact_topo(const std::vector<Dart>& order)
+	{
+		std::vector<uint32> indices;
+		indices.reserve(order.size());
+		for (Dart d : order)
+			indices.push_back(d.index);
+		remap_topo_relations(this->topology_.template compact<ConcreteMap::PRIM_SIZE>(indices));
+	}
+
+	/**
+	 * @brief compact this map
+	 */
+	void compact()
+	{
+		compact_topo();
+		for (uint32 orbit = 0; orbit < NB_ORBITS; ++orbit)
+			compact_embedding(orbit); // checking if embedding used done inside
+	}
+
+	/**
+	 * @brief compact this map, renumbering the darts in the given order to improve memory locality
+	 * (see geometry/algos/reordering.h for ordering strategies).
+	 * The cells of each embedded orbit are renumbered in the order of their first dart.
+	 * @param order darts in their new order (the darts that are not given are placed after)
+	 */
+	void compact(const std::vector<Dart>& order)
+	{
+		compact_topo(order);
+		for (uint32 orbit = 0; orbit < NB_ORBITS; ++orbit)
 		{
-			std::vector<uint32> old_new = this->attributes_[orbit].template compact<1>();
-			if (!old_new.empty())
+			const ChunkArray<uint32>* embedding = this->embeddings_[orbit];
+			if (embedding != nullptr)
 			{
-				for (uint32 i=this->topology_.begin(); i!= this->topology_.end(); this->topology_.next(i))
+				std::vector<uint32> emb_order;
+				emb_order.reserve(this->attributes_[orbit].size());
+				std::vector<bool> seen(this->attributes_[orbit].end(), false);
+				for (uint32 i = this->topology_.begin(); i != this->topology_.end(); this->topology_.next(i))
 				{
-					uint32& emb = (*embedding)[i];
-					if ((emb != std::numeric_limits<uint32>::max())
-						&& (old_new[emb] != std::numeric_limits<uint32>::max()))
-						emb = old_new[emb];
+					const uint32 emb = (*embedding)[i];
+					if (emb < seen.size() && !seen[emb])
+					{
+						seen[emb] = true;
+						emb_order.push_back(emb);
+					}
 				}
+				compact_embedding(orbit, emb_order);
 			}
 		}
 	}
 
-	void compact_topo()
-	{
-		std::vector<uint32> old_new = this->topology_.template compact<ConcreteMap::PRIM_SIZE>();
+protected:
 
+	/**
+	 * @brief update (in parallel) the Dart relations of the topology container after a renumbering of its lines
+	 * @param old_new map from old indices to new indices (unchanged -> 0xffffffff)
+	 */
+	void remap_topo_relations(const std::vector<uint32>& old_new)
+	{
 		if (old_new.empty())
 			return;			// already compact nothing to do with relationss
 
+		this->topology_changed();
+
 		for (ChunkArrayGen* ptr: this->topology_.chunk_arrays())
 		{
 			ChunkArray<Dart>* ca = dynamic_cast<ChunkArray<Dart>*>(ptr);
 			if (ca)
 			{
-				for (uint32 i=this->topology_.begin(); i!= this->topology_.end(); this->topology_.next(i))
+				this->topology_.parallel_foreach_index([&] (uint32 i)
 				{
 					Dart& d = (*ca)[i];
 					uint32 idx = d.index;
 					if (old_new[idx] != std::numeric_limits<uint32>::max())
 						d = Dart(old_new[idx]);
-				}
+				});
 			}
 		}
 	}
 
 	/**
-	 * @brief compact this map
+	 * @brief update (in parallel) the embedding indices of an orbit after a renumbering of its container
+	 * @param orbit the orbit
+	 * @param old_new map from old indices to new indices (unchanged -> 0xffffffff)
 	 */
-	void compact()
+	void remap_embeddings(uint32 orbit, const std::vector<uint32>& old_new)
 	{
-		compact_topo();
-		for (uint32 orbit = 0; orbit < NB_ORBITS; ++orbit)
-			compact_embedding(orbit); // checking if embedding used done inside
+		if (old_new.empty())
+			return;
+
+		this->topology_changed();
+
+		ChunkArray<uint32>* embedding = this->embeddings_[orbit];
+		this->topology_.parallel_foreach_index([&] (uint32 i)
+		{
+			uint32& emb = (*embedding)[i];
+			if ((emb != std::numeric_limits<uint32>::max())
+				&& (old_new[emb] != std::numeric_limits<uint32>::max()))
+				emb = old_new[emb];
+		});
 	}
 
+public:
+
 	/**
 	 * @brief merge map in this map
 	 * @param map must be of same type than map
@@ -1528,6 +1742,7 @@ public:
 		concrete->merge_check_embedding(map);
 
 		// store index of copied darts
+		this->topology_changed();
 		std::vector<uint32> old_new_topo = this->topology_.template merge<ConcreteMap::PRIM_SIZE>(map.topology_);
 
 		// mark new darts with the given dartmarker
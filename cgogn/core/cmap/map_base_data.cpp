@@ -29,12 +29,14 @@ namespace cgogn
 {
 
 std::vector<const MapBaseData*>* MapBaseData::instances_ = nullptr;
+const char MapBaseData::MAPPED_FILE_MAGIC[8] = {'C','G','o','G','N','M','A','P'};
 // tetra_phi2 = {3,5,7,-3,7,2,-5,-2,2,-7,-2,-7}
 const std::array<uint32, 12> MapBaseData::tetra_phi2 = {3,5,7,uint32(-3),7,2,uint32(-5),uint32(-2),2,uint32(-7),uint32(-2),uint32(-7)};
 // hexa_phi2 = {4,7,10,13, -4,14,17,2, -7,-2,12,2, -10,-2,7,2, -13,-2,2,-14, -2,-7,-12,-17}
 const std::array<uint32, 24> MapBaseData::hexa_phi2 = {4,7,10,13, uint32(-4),14,17,2, uint32(-7),uint32(-2),12,2, uint32(-10),uint32(-2),7,2, uint32(-13),uint32(-2),2,uint32(-14), uint32(-2),uint32(-7),uint32(-12),uint32(-17)};
 
-MapBaseData::MapBaseData()
+MapBaseData::MapBaseData() :
+	topology_revision_(0u)
 {
 	if (instances_ == nullptr)
 	{
@@ -26,6 +26,7 @@
 
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <algorithm>
 #include <type_traits>
 #include <sstream>
@@ -67,6 +68,11 @@ public:
 
 	static const uint32 CHUNK_SIZE = CGOGN_CHUNK_SIZE;
 
+	// identification of the files written by save_mapped
+	static const char MAPPED_FILE_MAGIC[8];
+	static const uint32 MAPPED_FILE_VERSION = 1u;
+	static const uint32 MAPPED_FILE_ENDIANNESS = 0x01020304u;
+
 	template <typename T> friend class Attribute_T;
 	template <typename T, Orbit ORBIT> friend class Attribute;
 
@@ -92,6 +98,9 @@ protected:
 	// boundary marker shortcut
 	ChunkArrayBool* boundary_marker_;
 
+	// changed by each modification of the darts or of their relations (see topology_revision)
+	std::atomic<uint64> topology_revision_;
+
 	// vector of available mark attributes per thread on the topology container
 	std::vector<std::vector<ChunkArrayBool*>> mark_attributes_topology_;
 	std::mutex mark_attributes_topology_mutex_;
@@ -142,8 +151,26 @@ public:
 		return topology_;
 	}
 
+	/**
+	 * @brief the topology revision changes each time darts are added, removed, sewn, unsewn or renumbered,
+	 * so that the data computed from the topology (e.g. a CSRIncidence) can check that they are up to date
+	 */
+	inline uint64 topology_revision() const
+	{
+		return topology_revision_.load(std::memory_order_relaxed);
+	}
+
 protected:
 
+	/**
+	 * @brief change the topology revision (thread safe: concurrent modifications, e.g. sewing in parallel,
+	 * all increment it, so that the revision always differs from the ones read before the modifications)
+	 */
+	inline void topology_changed()
+	{
+		topology_revision_.fetch_add(1u, std::memory_order_relaxed);
+	}
+
 	template <Orbit ORBIT>
 	inline ChunkArrayContainer<uint32>& non_const_attribute_container()
 	{
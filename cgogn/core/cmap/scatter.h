@@ -0,0 +1,189 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_CMAP_SCATTER_H_
+#define CGOGN_CORE_CMAP_SCATTER_H_
+
+#include <memory>
+#include <vector>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/unique_ptr.h>
+#include <cgogn/core/container/chunk_allocator.h>
+#include <cgogn/core/utils/masks.h>
+#include <cgogn/core/cmap/attribute.h>
+
+namespace cgogn
+{
+
+namespace internal
+{
+
+/**
+ * @brief values accumulated by a thread during a parallel_scatter
+ * (the values are stored in chunks of the attributes size, so that they are aligned and that
+ * the chunk allocator recycles them for and from the chunk arrays)
+ */
+template <typename T>
+struct ScatterPartial
+{
+	static const uint32 CHUNK_SIZE = MapBaseData::CHUNK_SIZE;
+
+	std::vector<T*> chunks_;
+	std::vector<uint8> touched_;
+
+	inline ScatterPartial(uint32 size) : touched_(size, 0u)
+	{
+		new_chunks(chunks_, (size + CHUNK_SIZE - 1u) / CHUNK_SIZE, CHUNK_SIZE);
+	}
+
+	inline ~ScatterPartial()
+	{
+		for (T* chunk : chunks_)
+			delete_chunk(chunk, CHUNK_SIZE);
+	}
+
+	inline T& value(uint32 i) { return chunks_[i / CHUNK_SIZE][i % CHUNK_SIZE]; }
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ScatterPartial);
+};
+
+} // namespace internal
+
+/**
+ * @brief The ScatterAccumulator class is given to the functions called by parallel_scatter:
+ * acc(c, value) adds value to the target attribute of the cell c.
+ * In parallel, the values are accumulated in the partial buffer of the calling thread.
+ */
+template <typename T, Orbit ORBIT>
+class ScatterAccumulator
+{
+public:
+
+	inline ScatterAccumulator(const MapBaseData& map, Attribute<T, ORBIT>& target, internal::ScatterPartial<T>* partial) :
+		map_(map),
+		target_(target),
+		partial_(partial)
+	{}
+
+	inline void operator()(Cell<ORBIT> c, const T& value)
+	{
+		const uint32 emb = map_.embedding(c);
+		if (partial_ == nullptr)
+			target_[emb] += value;
+		else if (partial_->touched_[emb] != 0u)
+			partial_->value(emb) += value;
+		else
+		{
+			partial_->value(emb) = value;
+			partial_->touched_[emb] = 1u;
+		}
+	}
+
+private:
+
+	const MapBaseData& map_;
+	Attribute<T, ORBIT>& target_;
+	internal::ScatterPartial<T>* partial_;
+};
+
+/**
+ * @brief accumulate in parallel values computed on source cells into an attribute of (incident) target cells
+ * f(SourceCell c, ScatterAccumulator<T, ORBIT>& acc) is called on each source cell selected by the mask
+ * and calls acc(target_cell, value) to add value to target[target_cell] (target is not reset).
+ * Each thread accumulates in its own partial buffer (allocated on its first contribution)
+ * and the buffers are then summed into the target in a parallel reduction pass,
+ * so the source cells never write concurrently to the same target cell.
+ * Without workers, the values are directly added to the target.
+ * @param map the map
+ * @param mask the source cells filter
+ * @param target the attribute in which the values are accumulated
+ * @param f the function called on each source cell
+ */
+template <typename MAP, typename MASK, typename T, Orbit ORBIT, typename FUNC>
+inline void parallel_scatter(
+	const MAP& map,
+	const MASK& mask,
+	Attribute<T, ORBIT>& target,
+	const FUNC& f
+)
+{
+	using SourceCell = func_parameter_type<FUNC>;
+	using Accumulator = ScatterAccumulator<T, ORBIT>;
+	using Partial = internal::ScatterPartial<T>;
+
+	ThreadPool* pool = thread_pool();
+	if (pool->nb_workers() == 0u)
+	{
+		Accumulator acc(map, target, nullptr);
+		map.foreach_cell([&] (SourceCell c) { f(c, acc); }, mask);
+		return;
+	}
+
+	const uint32 size = map.template attribute_container<ORBIT>().end();
+	const uint32 caller = current_thread_marker_index();
+	std::vector<std::unique_ptr<Partial>> partials(pool->max_nb_workers() + 1u);
+
+	map.parallel_foreach_cell([&] (SourceCell c)
+	{
+		// the caller uses the first buffer, the workers of the pool use their own
+		const uint32 t = current_thread_marker_index();
+		const uint32 slot = t == caller ? 0u : t;
+		cgogn_message_assert(slot < partials.size(), "parallel_scatter: called from an unknown thread");
+		if (!partials[slot])
+			partials[slot] = make_unique<Partial>(size);
+		Accumulator acc(map, target, partials[slot].get());
+		f(c, acc);
+	},
+	mask);
+
+	pool->parallel_for(0u, size, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+	{
+		for (const auto& p : partials)
+		{
+			if (!p)
+				continue;
+			for (uint32 i = first; i < last; ++i)
+			{
+				if (p->touched_[i] != 0u)
+					target[i] += p->value(i);
+			}
+		}
+	});
+}
+
+template <typename MAP, typename T, Orbit ORBIT, typename FUNC>
+inline void parallel_scatter(
+	const MAP& map,
+	Attribute<T, ORBIT>& target,
+	const FUNC& f
+)
+{
+	parallel_scatter(map, AllCellsFilter(), target, f);
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_CMAP_SCATTER_H_
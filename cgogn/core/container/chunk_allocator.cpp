@@ -0,0 +1,181 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cstdlib>
+
+#include <cgogn/core/container/chunk_allocator.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace cgogn
+{
+
+const std::size_t ChunkAllocator::CACHE_LINE_SIZE;
+const std::size_t ChunkAllocator::PAGE_SIZE;
+const std::size_t ChunkAllocator::HUGE_PAGE_SIZE;
+
+ChunkAllocator::ChunkAllocator() :
+	cached_bytes_(0ul),
+	max_cached_bytes_(256ul << 20),
+	huge_pages_(false)
+{}
+
+ChunkAllocator::~ChunkAllocator()
+{
+	release_cached();
+}
+
+void* ChunkAllocator::allocate(std::size_t bytes)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = free_lists_.find(bytes);
+		if (it != free_lists_.end() && !it->second.empty())
+		{
+			void* chunk = it->second.back();
+			it->second.pop_back();
+			cached_bytes_ -= bytes;
+			return chunk;
+		}
+	}
+	void* chunk = allocate_aligned(bytes);
+	if (chunk == nullptr)
+		throw std::bad_alloc();
+	return chunk;
+}
+
+void ChunkAllocator::deallocate(void* chunk, std::size_t bytes)
+{
+	if (chunk == nullptr)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (cached_bytes_ + bytes <= max_cached_bytes_)
+		{
+			free_lists_[bytes].push_back(chunk);
+			cached_bytes_ += bytes;
+			return;
+		}
+	}
+	free_aligned(chunk);
+}
+
+void ChunkAllocator::release_cached()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	release_cached_locked();
+}
+
+void ChunkAllocator::release_cached_locked()
+{
+	for (auto& fl : free_lists_)
+	{
+		for (void* chunk : fl.second)
+			free_aligned(chunk);
+	}
+	free_lists_.clear();
+	cached_bytes_ = 0ul;
+}
+
+std::size_t ChunkAllocator::cached_bytes() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return cached_bytes_;
+}
+
+void ChunkAllocator::set_max_cached_bytes(std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	max_cached_bytes_ = bytes;
+	if (cached_bytes_ > bytes)
+		release_cached_locked();
+}
+
+std::size_t ChunkAllocator::max_cached_bytes() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return max_cached_bytes_;
+}
+
+std::size_t ChunkAllocator::alignment(std::size_t bytes) const
+{
+	if (huge_pages() && bytes >= HUGE_PAGE_SIZE)
+		return HUGE_PAGE_SIZE;
+	return bytes >= PAGE_SIZE ? PAGE_SIZE : CACHE_LINE_SIZE;
+}
+
+void* ChunkAllocator::allocate_aligned(std::size_t bytes) const
+{
+	const std::size_t align = alignment(bytes);
+#ifdef _WIN32
+	return _aligned_malloc(bytes, align);
+#else
+	void* chunk = nullptr;
+	if (posix_memalign(&chunk, align, bytes) != 0)
+		return nullptr;
+#ifdef MADV_HUGEPAGE
+	if (align == HUGE_PAGE_SIZE)
+		madvise(chunk, bytes, MADV_HUGEPAGE);
+#endif
+	return chunk;
+#endif
+}
+
+void ChunkAllocator::free_aligned(void* chunk)
+{
+#ifdef _WIN32
+	_aligned_free(chunk);
+#else
+	std::free(chunk);
+#endif
+}
+
+namespace
+{
+
+ChunkAllocator*& current_chunk_allocator()
+{
+	// never destroyed: chunk arrays of static maps may be released after the end of main
+	static ChunkAllocator* default_allocator = new ChunkAllocator();
+	static ChunkAllocator* allocator = default_allocator;
+	return allocator;
+}
+
+} // namespace
+
+ChunkAllocator* chunk_allocator()
+{
+	return current_chunk_allocator();
+}
+
+void set_chunk_allocator(ChunkAllocator* allocator)
+{
+	static ChunkAllocator* default_allocator = current_chunk_allocator();
+	current_chunk_allocator() = allocator != nullptr ? allocator : default_allocator;
+}
+
+} // namespace cgogn
@@ -0,0 +1,194 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_CONTAINER_CHUNK_ALLOCATOR_H_
+#define CGOGN_CORE_CONTAINER_CHUNK_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <cgogn/core/dll.h>
+#include <cgogn/core/utils/definitions.h>
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The ChunkAllocator class provides the memory of the chunks of the chunk arrays.
+ * The chunks are aligned on cache lines, or on pages for the chunks of at least one page.
+ * The released chunks are kept in per-size free lists (up to max_cached_bytes) and recycled
+ * when attributes are added and removed. The chunks of at least 2MB can be backed by (transparent) huge pages.
+ * Another allocator can be installed with set_chunk_allocator (see allocate and deallocate).
+ */
+class CGOGN_CORE_API ChunkAllocator
+{
+public:
+
+	static const std::size_t CACHE_LINE_SIZE = 64ul;
+	static const std::size_t PAGE_SIZE = 4096ul;
+	static const std::size_t HUGE_PAGE_SIZE = 2ul << 20;
+
+	ChunkAllocator();
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ChunkAllocator);
+	virtual ~ChunkAllocator();
+
+	/**
+	 * @brief allocate a chunk of the given size (the memory is not initialized)
+	 * @throw std::bad_alloc if the memory can not be allocated
+	 */
+	virtual void* allocate(std::size_t bytes);
+
+	/**
+	 * @brief release a chunk allocated by allocate with the same size
+	 */
+	virtual void deallocate(void* chunk, std::size_t bytes);
+
+	/**
+	 * @brief release the memory of the cached chunks
+	 */
+	void release_cached();
+
+	std::size_t cached_bytes() const;
+
+	void set_max_cached_bytes(std::size_t bytes);
+
+	std::size_t max_cached_bytes() const;
+
+	/**
+	 * @brief use huge pages for the chunks of at least HUGE_PAGE_SIZE bytes (Linux only)
+	 */
+	inline void set_huge_pages(bool b) { huge_pages_.store(b, std::memory_order_relaxed); }
+
+	inline bool huge_pages() const { return huge_pages_.load(std::memory_order_relaxed); }
+
+	/**
+	 * @return the alignment of a chunk of the given size
+	 */
+	std::size_t alignment(std::size_t bytes) const;
+
+protected:
+
+	void* allocate_aligned(std::size_t bytes) const;
+	static void free_aligned(void* chunk);
+
+private:
+
+	// release the cached chunks, mutex_ must be locked
+	void release_cached_locked();
+
+	mutable std::mutex mutex_;
+#pragma warning(push)
+#pragma warning(disable:4251)
+	std::unordered_map<std::size_t, std::vector<void*>> free_lists_;
+#pragma warning(pop)
+	std::size_t cached_bytes_;
+	std::size_t max_cached_bytes_;
+	std::atomic<bool> huge_pages_;
+};
+
+/**
+ * @return the allocator used by the chunk arrays
+ */
+CGOGN_CORE_API ChunkAllocator* chunk_allocator();
+
+/**
+ * @brief install the allocator used by the chunk arrays (nullptr restores the default one)
+ * It must be installed before the creation of the maps and outlive them.
+ */
+CGOGN_CORE_API void set_chunk_allocator(ChunkAllocator* allocator);
+
+namespace internal
+{
+
+/**
+ * @brief allocate a chunk of size value-initialized elements with the chunk allocator
+ */
+template <typename T>
+inline T* new_chunk(uint32 size)
+{
+	T* chunk = static_cast<T*>(chunk_allocator()->allocate(std::size_t(size) * sizeof(T)));
+	if (std::is_trivially_default_constructible<T>::value)
+		std::memset(static_cast<void*>(chunk), 0, std::size_t(size) * sizeof(T));
+	else
+	{
+		for (uint32 i = 0u; i < size; ++i)
+			new (chunk + i) T();
+	}
+	return chunk;
+}
+
+/**
+ * @brief destroy the elements of a chunk allocated by new_chunk and release it
+ */
+template <typename T>
+inline void delete_chunk(T* chunk, uint32 size)
+{
+	if (!std::is_trivially_destructible<T>::value)
+	{
+		for (uint32 i = 0u; i < size; ++i)
+			chunk[i].~T();
+	}
+	chunk_allocator()->deallocate(chunk, std::size_t(size) * sizeof(T));
+}
+
+/**
+ * @brief append chunks allocated by new_chunk to the table until it contains nb_chunks chunks
+ * The chunks are initialized, i.e. first-touched, by the workers of the thread pool, so that
+ * their pages are placed on the (NUMA) memory nodes of the threads that will process them.
+ * When called from a worker, the chunks are initialized by the calling thread.
+ */
+template <typename T>
+inline void new_chunks(std::vector<T*>& table, uint32 nb_chunks, uint32 size)
+{
+	const uint32 first = uint32(table.size());
+	if (nb_chunks <= first)
+		return;
+	table.resize(nb_chunks, nullptr);
+	if (nb_chunks - first > 1u && !thread_pool()->is_worker_thread())
+	{
+		thread_pool()->parallel_for(first, nb_chunks, 1u, [&] (uint32 b, uint32 e)
+		{
+			for (uint32 i = b; i < e; ++i)
+				table[i] = new_chunk<T>(size);
+		});
+	}
+	else
+	{
+		for (uint32 i = first; i < nb_chunks; ++i)
+			table[i] = new_chunk<T>(size);
+	}
+}
+
+} // namespace internal
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_CONTAINER_CHUNK_ALLOCATOR_H_
@@ -32,6 +32,7 @@
 
 #include <cgogn/core/dll.h>
 #include <cgogn/core/container/chunk_array_gen.h>
+#include <cgogn/core/container/chunk_allocator.h>
 #include <cgogn/core/utils/name_types.h>
 #include <cgogn/core/utils/serialization.h>
 #include <cgogn/core/utils/assert.h>
@@ -60,6 +61,9 @@ public:
 
 protected:
 
+	// number of elements of a chunk
+	static const uint32 CHUNK_ELEMENTS = CHUNK_SIZE;
+
 	// vector of block pointers
 	std::vector<T*> table_data_;
 
@@ -84,7 +88,10 @@ public:
 	~ChunkArray() override
 	{
 		for(auto chunk : table_data_)
-			delete[] chunk;
+		{
+			if (this->owns_chunk(chunk))
+				internal::delete_chunk(chunk, CHUNK_ELEMENTS);
+		}
 	}
 
 	std::string nested_type_name() const override
@@ -159,15 +166,36 @@ public:
 			return false;
 		}
 		table_data_.swap(ca->table_data_);
+		this->mapped_file_.swap(ca->mapped_file_);
+		this->resize_dirty(nb_chunks());
+		ca->resize_dirty(ca->nb_chunks());
+		this->set_all_dirty();
+		ca->set_all_dirty();
 		return true;
 	}
 
+	bool raw_data() const override
+	{
+		return serialization::raw_data(static_cast<const T*>(nullptr));
+	}
+
+	void adopt_chunks(const std::vector<void*>& chunks, const std::shared_ptr<MappedFile>& file) override
+	{
+		cgogn_message_assert(raw_data(), "adopt_chunks: data of the array is not raw");
+		clear();
+		this->mapped_file_ = file;
+		for (void* chunk : chunks)
+			table_data_.push_back(static_cast<T*>(chunk));
+		this->resize_dirty(nb_chunks());
+	}
+
 	/**
 	 * @brief add a chunk (T[CHUNK_SIZE])
 	 */
 	void add_chunk() override
 	{
-		table_data_.push_back(new T[CHUNK_SIZE]());
+		table_data_.push_back(internal::new_chunk<T>(CHUNK_ELEMENTS));
+		this->resize_dirty(nb_chunks());
 	}
 
 	/**
@@ -178,15 +206,18 @@ public:
 	{
 		if (nbc >= table_data_.size())
 		{
-			for (std::size_t i = table_data_.size(); i < nbc; ++i)
-				add_chunk();
+			internal::new_chunks(table_data_, nbc, CHUNK_ELEMENTS);
 		}
 		else
 		{
 			for (std::size_t i = static_cast<std::size_t>(nbc); i < table_data_.size(); ++i)
-				delete[] table_data_[i];
+			{
+				if (this->owns_chunk(table_data_[i]))
+					internal::delete_chunk(table_data_[i], CHUNK_ELEMENTS);
+			}
 			table_data_.resize(nbc);
 		}
+		this->resize_dirty(nbc);
 	}
 
 	/**
@@ -195,10 +226,15 @@ public:
 	void clear() override
 	{
 		for(auto chunk : table_data_)
-			delete[] chunk;
+		{
+			if (this->owns_chunk(chunk))
+				internal::delete_chunk(chunk, CHUNK_ELEMENTS);
+		}
 		table_data_.clear();
+		this->mapped_file_.reset();
 		table_data_.shrink_to_fit();
 		table_data_.reserve(1024u);
+		this->resize_dirty(0u);
 	}
 
 
@@ -211,6 +247,7 @@ public:
 	void copy_element(uint32 dst, uint32 src) override
 	{
 		table_data_[dst / CHUNK_SIZE][dst % CHUNK_SIZE] = table_data_[src / CHUNK_SIZE][src % CHUNK_SIZE];
+		this->set_dirty(dst);
 	}
 
 	/**
@@ -223,6 +260,7 @@ public:
 	{
 		Self* ca = static_cast<Self*>(cag_src);
 		table_data_[dst / CHUNK_SIZE][dst % CHUNK_SIZE] = ca->table_data_[src / CHUNK_SIZE][src % CHUNK_SIZE];
+		this->set_dirty(dst);
 	}
 
 	/**
@@ -233,6 +271,8 @@ public:
 	void move_element(uint32 dst, uint32 src) override
 	{
 		table_data_[dst / CHUNK_SIZE][dst % CHUNK_SIZE] = std::move(table_data_[src / CHUNK_SIZE][src % CHUNK_SIZE]);
+		this->set_dirty(dst);
+		this->set_dirty(src);
 	}
 
 	/**
@@ -252,6 +292,8 @@ public:
 		a = std::move(b);
 		b = std::move(tmp);
 #endif // _GLIBCXX_DEBUG
+		this->set_dirty(idx1);
+		this->set_dirty(idx2);
 	}
 
 	void save(std::ostream& fs, uint32 nb_lines) const override
@@ -332,6 +374,7 @@ public:
 		const uint32 nb = nb_lines - nbc*CHUNK_SIZE;
 		serialization::load(fs, table_data_[nbc], nb);
 		cgogn_assert(fs.good());
+		this->set_all_dirty();
 
 		return true;
 	}
@@ -350,6 +393,7 @@ public:
 	void import_element(uint32 idx, std::istream& in) override
 	{
 		serialization::parse(in, this->operator [](idx));
+		this->set_dirty(idx);
 	}
 
 	const void* element_ptr(uint32 idx) const override
@@ -397,6 +441,7 @@ public:
 			for(uint32 i = 0; i < CHUNK_SIZE; ++i)
 				*chunk++ = v;
 		}
+		this->set_all_dirty();
 	}
 
 	void copy(const Inherit& cag_src) override
@@ -435,6 +480,7 @@ public:
 			for(uint32 i=0; i< CHUNK_SIZE; ++i)
 				*ptr++ = *chunk++;
 		}
+		this->set_all_dirty();
 	}
 };
 
@@ -455,6 +501,9 @@ protected:
 	// ensure we can use CHUNK_SIZE value < 32
 	static const uint32 BOOLS_PER_INT = (CHUNK_SIZE<32u) ? CHUNK_SIZE : 32u;
 
+	// number of uint32 of a chunk
+	static const uint32 CHUNK_ELEMENTS = CHUNK_SIZE / BOOLS_PER_INT;
+
 	// vector of block pointers
 	std::vector<uint32*> table_data_;
 
@@ -476,7 +525,10 @@ public:
 	~ChunkArrayBool() override
 	{
 		for(auto chunk : table_data_)
-			delete[] chunk;
+		{
+			if (this->owns_chunk(chunk))
+				internal::delete_chunk(chunk, CHUNK_ELEMENTS);
+		}
 	}
 
 	std::string nested_type_name() const override
@@ -550,16 +602,35 @@ public:
 			return false;
 		}
 		table_data_.swap(ca->table_data_);
+		this->mapped_file_.swap(ca->mapped_file_);
+		this->resize_dirty(nb_chunks());
+		ca->resize_dirty(ca->nb_chunks());
+		this->set_all_dirty();
+		ca->set_all_dirty();
 		return true;
 	}
 
+	bool raw_data() const override
+	{
+		return true;
+	}
+
+	void adopt_chunks(const std::vector<void*>& chunks, const std::shared_ptr<MappedFile>& file) override
+	{
+		clear();
+		this->mapped_file_ = file;
+		for (void* chunk : chunks)
+			table_data_.push_back(static_cast<uint32*>(chunk));
+		this->resize_dirty(nb_chunks());
+	}
+
 	/**
 	 * @brief add a chunk (T[CHUNK_SIZE/32])
 	 */
 	void add_chunk() override
 	{
-		// adding the empty parentheses for default-initialization
-		table_data_.push_back(new uint32[CHUNK_SIZE/BOOLS_PER_INT]());
+		table_data_.push_back(internal::new_chunk<uint32>(CHUNK_ELEMENTS));
+		this->resize_dirty(nb_chunks());
 	}
 
 	/**
@@ -570,15 +641,18 @@ public:
 	{
 		if (nbc >= table_data_.size())
 		{
-			for (std::size_t i = table_data_.size(); i < nbc; ++i)
-				add_chunk();
+			internal::new_chunks(table_data_, nbc, CHUNK_ELEMENTS);
 		}
 		else
 		{
 			for (std::size_t i = nbc; i < table_data_.size(); ++i)
-				delete[] table_data_[i];
+			{
+				if (this->owns_chunk(table_data_[i]))
+					internal::delete_chunk(table_data_[i], CHUNK_ELEMENTS);
+			}
 			table_data_.resize(nbc);
 		}
+		this->resize_dirty(nbc);
 	}
 
 	/**
@@ -587,10 +661,15 @@ public:
 	void clear() override
 	{
 		for(auto chunk : table_data_)
-			delete[] chunk;
+		{
+			if (this->owns_chunk(chunk))
+				internal::delete_chunk(chunk, CHUNK_ELEMENTS);
+		}
 		table_data_.clear();
+		this->mapped_file_.reset();
 		table_data_.shrink_to_fit();
 		table_data_.reserve(1024u);
+		this->resize_dirty(0u);
 	}
 
 
@@ -602,6 +681,7 @@ public:
 	inline void copy_element(uint32 dst, uint32 src) override
 	{
 		set_value(dst, this->operator[](src));
+		this->set_dirty(dst);
 	}
 
 	/**
@@ -614,6 +694,7 @@ public:
 	{
 		Self* ca = static_cast<Self*>(cag_src);
 		set_value(dst, ca->operator[](src));
+		this->set_dirty(dst);
 	}
 
 	/**
@@ -626,6 +707,8 @@ public:
 		const bool data = this->operator[](idx1);
 		set_value(idx1, this->operator[](idx2));
 		set_value(idx2, data);
+		this->set_dirty(idx1);
+		this->set_dirty(idx2);
 	}
 
 	void save(std::ostream& fs, uint32 nb_lines) const override
@@ -692,6 +775,7 @@ public:
 		// load last chunk
 		const uint32 nb = nb_lines - nbc*CHUNK_SIZE;
 		fs.read(reinterpret_cast<char*>(table_data_[nbc]), nb / 8u);
+		this->set_all_dirty();
 
 		return true;
 	}
@@ -708,6 +792,7 @@ public:
 		val = to_lower(val);
 		const bool b = (val == "true") || (std::stoi(val) != 0);
 		set_value(idx,b);
+		this->set_dirty(idx);
 	}
 
 	const void* element_ptr(uint32) const override
@@ -766,6 +851,7 @@ public:
 			for (int32 j = 0; j < int32(CHUNK_SIZE / BOOLS_PER_INT); ++j)
 				ptr[j] = 0u;
 		}
+		this->set_all_dirty();
 	}
 
 	void copy(const Inherit& cag_src) override
@@ -803,6 +889,7 @@ public:
 			for(uint32 i=0; i< CHUNK_SIZE; ++i)
 				*ptr++ = *chunk++;
 		}
+		this->set_all_dirty();
 	}
 
 	inline uint32 count_true()
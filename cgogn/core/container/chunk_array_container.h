@@ -31,6 +31,7 @@
 #include <string>
 #include <memory>
 #include <climits>
+#include <algorithm>
 
 #include <cgogn/core/utils/logger.h>
 #include <cgogn/core/dll.h>
@@ -97,9 +98,19 @@ protected:
 	ChunkArray<T_REF> refs_;
 
 	/**
-	 * stack of holes
+	 * bitset of the used lines (one bit per line, cleared beyond nb_max_lines_)
 	 */
-	ChunkStack<uint32> holes_stack_;
+	std::vector<uint64> used_lines_;
+
+	/**
+	 * number of used lines of each chunk
+	 */
+	std::vector<uint32> chunk_nb_used_lines_;
+
+	/**
+	 * lower bound of the index of the first hole (all the lines before it are used)
+	 */
+	uint32 first_hole_;
 
 	/**
 	* size (number of elts) of the container
@@ -166,12 +177,136 @@ protected:
 		delete ptr_to_del;
 	}
 
+	/**
+	 * @brief resize the bitset of used lines and the occupancy counters to the number of chunks of refs_
+	 */
+	inline void resize_used_lines()
+	{
+		const uint32 nbc = refs_.nb_chunks();
+		used_lines_.resize((nbc * CHUNK_SIZE + 63u) / 64u, 0u);
+		chunk_nb_used_lines_.resize(nbc, 0u);
+	}
+
+	/**
+	 * @brief flag a line as used in the bitset and in the occupancy counter of its chunk
+	 * @param index index of the line
+	 */
+	inline void set_used_line(uint32 index)
+	{
+		uint64& word = used_lines_[index / 64u];
+		const uint64 bit = uint64(1u) << (index % 64u);
+		if ((word & bit) == 0u)
+		{
+			word |= bit;
+			++chunk_nb_used_lines_[index / CHUNK_SIZE];
+		}
+	}
+
+	/**
+	 * @brief flag a line as unused in the bitset and in the occupancy counter of its chunk
+	 * @param index index of the line
+	 */
+	inline void set_unused_line(uint32 index)
+	{
+		uint64& word = used_lines_[index / 64u];
+		const uint64 bit = uint64(1u) << (index % 64u);
+		if ((word & bit) != 0u)
+		{
+			word &= ~bit;
+			--chunk_nb_used_lines_[index / CHUNK_SIZE];
+		}
+		first_hole_ = std::min(first_hole_, index);
+	}
+
+	/**
+	 * @brief recompute the bitset of used lines and the occupancy counters from refs_ (after bulk operations)
+	 */
+	void rebuild_used_lines()
+	{
+		const uint32 nbc = refs_.nb_chunks();
+		used_lines_.assign((nbc * CHUNK_SIZE + 63u) / 64u, 0u);
+		chunk_nb_used_lines_.assign(nbc, 0u);
+		for (uint32 i = 0u; i < nb_max_lines_; ++i)
+		{
+			if (refs_[i] != 0)
+				set_used_line(i);
+		}
+		first_hole_ = 0u;
+	}
+
+	/**
+	 * @brief first used line of index >= it, skipping empty chunks and 64 lines words at once
+	 * @return the index of the line or nb_max_lines_ if there is none
+	 */
+	inline uint32 next_used_line(uint32 it) const
+	{
+		while (it < nb_max_lines_)
+		{
+			const uint32 chunk = it / CHUNK_SIZE;
+			if (chunk_nb_used_lines_[chunk] == 0u)
+			{
+				it = (chunk + 1u) * CHUNK_SIZE;
+				continue;
+			}
+			const uint64 word = used_lines_[it / 64u] & (~uint64(0u) << (it % 64u));
+			if (word != 0u)
+				return (it / 64u) * 64u + trailing_zeros(word);
+			it = (it / 64u + 1u) * 64u;
+		}
+		return nb_max_lines_;
+	}
+
+	/**
+	 * @brief last used line of index <= it, skipping empty chunks and 64 lines words at once
+	 * @return the index of the line or 0xffffffff if there is none
+	 */
+	inline uint32 previous_used_line(uint32 it) const
+	{
+		while (it != 0xffffffff)
+		{
+			const uint32 chunk = it / CHUNK_SIZE;
+			if (chunk_nb_used_lines_[chunk] == 0u)
+			{
+				it = chunk * CHUNK_SIZE - 1u;
+				continue;
+			}
+			const uint64 word = used_lines_[it / 64u] & (~uint64(0u) >> (63u - it % 64u));
+			if (word != 0u)
+				return (it / 64u) * 64u + 63u - leading_zeros(word);
+			it = (it / 64u) * 64u - 1u;
+		}
+		return it;
+	}
+
+	/**
+	 * @brief first unused line of index >= it, skipping full chunks and 64 lines words at once
+	 * @return the index of the line or nb_max_lines_ if there is no hole after it
+	 */
+	inline uint32 next_hole(uint32 it) const
+	{
+		while (it < nb_max_lines_)
+		{
+			const uint32 chunk = it / CHUNK_SIZE;
+			if (chunk_nb_used_lines_[chunk] == CHUNK_SIZE)
+			{
+				it = (chunk + 1u) * CHUNK_SIZE;
+				continue;
+			}
+			const uint64 word = ~used_lines_[it / 64u] & (~uint64(0u) << (it % 64u));
+			if (word != 0u)
+				return std::min((it / 64u) * 64u + trailing_zeros(word), nb_max_lines_);
+			it = (it / 64u + 1u) * 64u;
+		}
+		return nb_max_lines_;
+	}
+
 public:
 
 	/**
 	 * @brief ChunkArrayContainer constructor
 	 */
 	ChunkArrayContainer() :
+		first_hole_(0u),
 		nb_used_lines_(0u),
 		nb_max_lines_(0u)
 	{
@@ -474,10 +609,7 @@ public:
 	 */
 	inline uint32 begin() const
 	{
-		uint32 it = 0u;
-		while ((it < nb_max_lines_) && (!used(it)))
-			++it;
-		return it;
+		return next_used_line(0u);
 	}
 
 	/**
@@ -495,10 +627,7 @@ public:
 	 */
 	inline void next(uint32& it) const
 	{
-		do
-		{
-			++it;
-		} while ((it < nb_max_lines_) && (!used(it)));
+		it = next_used_line(it + 1u);
 	}
 
 	/**
@@ -507,10 +636,7 @@ public:
 	 */
 	inline void next_primitive(uint32 &it, uint32 prim_size) const
 	{
-		do
-		{
-			it += prim_size;
-		} while ((it < nb_max_lines_) && (!used(it)));
+		it = next_used_line(it + prim_size);
 	}
 
 	/**
@@ -519,10 +645,7 @@ public:
 	 */
 	inline unsigned int rbegin() const
 	{
-		uint32 it = nb_max_lines_- 1u;
-		while ((it != 0xffffffff) && (!used(it)))
-			--it;
-		return it;
+		return previous_used_line(nb_max_lines_- 1u);
 	}
 
 	/**
@@ -540,10 +663,7 @@ public:
 	 */
 	void rnext(uint32 &it) const
 	{
-		do
-		{
-			--it;
-		} while ((it != 0xffffffff) && (!used(it)));
+		it = previous_used_line(it - 1u);
 	}
 
 	/**
@@ -558,7 +678,9 @@ public:
 		refs_.clear();
 
 		// clear holes
-		holes_stack_.clear();
+		used_lines_.clear();
+		chunk_nb_used_lines_.clear();
+		first_hole_ = 0u;
 
 		// clear data
 		for (auto cagen : table_arrays_)
@@ -572,7 +694,9 @@ public:
 		nb_used_lines_ = 0u;
 		nb_max_lines_ = 0u;
 		refs_.clear();
-		holes_stack_.clear();
+		used_lines_.clear();
+		chunk_nb_used_lines_.clear();
+		first_hole_ = 0u;
 
 		for (auto cagen : table_arrays_)
 		{
@@ -597,7 +721,9 @@ public:
 		type_names_.swap(container.type_names_);
 		table_marker_arrays_.swap(container.table_marker_arrays_);
 		refs_.swap_data(&(container.refs_));
-		holes_stack_.swap_data(&(container.holes_stack_));
+		used_lines_.swap(container.used_lines_);
+		chunk_nb_used_lines_.swap(container.chunk_nb_used_lines_);
+		std::swap(first_hole_, container.first_hole_);
 		std::swap(nb_used_lines_, container.nb_used_lines_);
 		std::swap(nb_max_lines_, container.nb_max_lines_);
 		// invalidate existing external refs
@@ -622,46 +748,120 @@ public:
 
 	/**
 	 * @brief container compacting
+	 * the holes are filled in increasing order with the last used lines
 	 * @return map_old_new vector that contains a map from old indices to new indices (holes & unchanged -> 0xffffffff)
 	 */
 	template <uint32 PRIM_SIZE>
 	std::vector<uint32> compact()
 	{
-		if (this->holes_stack_.empty())
+		if (nb_used_lines_ == nb_max_lines_)
 			return std::vector<uint32>();
 
 		uint32 up = rbegin();
-		uint32 down = std::numeric_limits<uint32>::max();
 		std::vector<uint32> map_old_new(up+1, std::numeric_limits<uint32>::max());
-		do
+		for (uint32 down = next_hole(first_hole_); down < nb_used_lines_; down = next_hole(down + PRIM_SIZE))
 		{
-			down = holes_stack_.head();
-			if (down < nb_used_lines_)
-				for(uint32 i = 0u; i < PRIM_SIZE; ++i)
-				{
-					const uint32 rdown = down + PRIM_SIZE - 1u - i;
-					map_old_new[up] = rdown;
-					move_line(rdown, up,true,true);
-					rnext(up);
-				}
-			holes_stack_.pop();
-		} while (!holes_stack_.empty());
+			for(uint32 i = 0u; i < PRIM_SIZE; ++i)
+			{
+				const uint32 rdown = down + PRIM_SIZE - 1u - i;
+				map_old_new[up] = rdown;
+				move_line(rdown, up,true,true);
+				rnext(up);
+			}
+		}
 
 		// free unused memory blocks
 		const uint32 old_nb_blocks = this->nb_max_lines_/CHUNK_SIZE + 1u;
 		nb_max_lines_ = nb_used_lines_;
 		const uint32 new_nb_blocks = nb_max_lines_/CHUNK_SIZE + 1u;
 
-		if (old_nb_blocks == new_nb_blocks)
-			return map_old_new;
+		if (old_nb_blocks != new_nb_blocks)
+		{
+			for (auto arr : table_arrays_)
+				arr->set_nb_chunks(new_nb_blocks);
 
-		for (auto arr : table_arrays_)
-			arr->set_nb_chunks(new_nb_blocks);
+			for (auto arr : table_marker_arrays_)
+				arr->set_nb_chunks(new_nb_blocks);
 
-		for (auto arr : table_marker_arrays_)
-			arr->set_nb_chunks(new_nb_blocks);
+			refs_.set_nb_chunks(new_nb_blocks);
+		}
 
-		refs_.set_nb_chunks(new_nb_blocks);
+		// the moved lines are still flagged as used beyond the new end
+		rebuild_used_lines();
+
+		return map_old_new;
+	}
+
+	/**
+	 * @brief container compacting with reordering
+	 * the used primitives are renumbered contiguously in the given order,
+	 * the used primitives that are not given are placed after, by increasing index.
+	 * The data of all the chunk arrays (attributes, markers & refs) are relabelled in parallel.
+	 * @param new_order indices of the primitives in their new order (any line of a primitive designates it)
+	 * @return map_old_new vector that contains a map from old indices to new indices (holes -> 0xffffffff)
+	 */
+	template <uint32 PRIM_SIZE>
+	std::vector<uint32> compact(const std::vector<uint32>& new_order)
+	{
+		if (nb_used_lines_ == 0u)
+			return std::vector<uint32>();
+
+		// new_old[k]: old index of the line that goes at index k
+		std::vector<uint32> map_old_new(rbegin() + 1u, std::numeric_limits<uint32>::max());
+		std::vector<uint32> new_old;
+		new_old.reserve(nb_used_lines_);
+
+		auto place = [&] (uint32 prim)
+		{
+			if (prim < map_old_new.size() && used(prim) && map_old_new[prim] == std::numeric_limits<uint32>::max())
+			{
+				for (uint32 i = 0u; i < PRIM_SIZE; ++i)
+				{
+					map_old_new[prim + i] = uint32(new_old.size());
+					new_old.push_back(prim + i);
+				}
+			}
+		};
+
+		for (uint32 index : new_order)
+			place((index / PRIM_SIZE) * PRIM_SIZE);
+		for (uint32 it = begin(); it != end(); next_primitive(it, PRIM_SIZE))
+			place(it);
+
+		cgogn_assert(new_old.size() == nb_used_lines_);
+
+		// all the arrays are moved in temporary arrays and copied back in the new order
+		std::vector<ChunkArrayGen*> arrays(table_arrays_.begin(), table_arrays_.end());
+		arrays.insert(arrays.end(), table_marker_arrays_.begin(), table_marker_arrays_.end());
+		arrays.push_back(&refs_);
+
+		const uint32 new_nb_chunks = nb_used_lines_ / CHUNK_SIZE + 1u;
+		std::vector<std::unique_ptr<ChunkArrayGen>> sources(arrays.size());
+		for (uint32 a = 0u; a < uint32(arrays.size()); ++a)
+		{
+			sources[a] = arrays[a]->clone("__compact_source__");
+			sources[a]->swap_data(arrays[a]);
+			arrays[a]->set_nb_chunks(new_nb_chunks);
+		}
+
+		// blocks of 32 lines so that the words of the boolean arrays are written by a single worker
+		const uint32 nb_blocks = (nb_used_lines_ + 31u) / 32u;
+		const uint32 nb_lines = nb_used_lines_;
+		thread_pool()->parallel_for(0u, uint32(arrays.size()) * nb_blocks, PARALLEL_BUFFER_SIZE / 32u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 t = first; t < last; ++t)
+			{
+				ChunkArrayGen* dst = arrays[t / nb_blocks];
+				ChunkArrayGen* src = sources[t / nb_blocks].get();
+				const uint32 block = t % nb_blocks;
+				const uint32 block_end = std::min(32u * (block + 1u), nb_lines);
+				for (uint32 k = 32u * block; k < block_end; ++k)
+					dst->copy_external_element(k, src, new_old[k]);
+			}
+		});
+
+		nb_max_lines_ = nb_used_lines_;
+		rebuild_used_lines();
 
 		return map_old_new;
 	}
@@ -755,6 +955,7 @@ public:
 
 	/**
 	* @brief insert a group of PRIM_SIZE consecutive lines in the container
+	* the lowest hole is reused first, lines are added at the end only when there is no hole
 	* @return index of the first line of group
 	*/
 	template <uint32 PRIM_SIZE>
@@ -764,7 +965,7 @@ public:
 
 		uint32 index;
 
-		if (holes_stack_.empty()) // no holes -> insert at the end
+		if (nb_used_lines_ == nb_max_lines_) // no holes -> insert at the end
 		{
 			if (nb_max_lines_ == 0) // add first chunk
 			{
@@ -785,25 +986,65 @@ public:
 					arr->add_chunk();
 				refs_.add_chunk();
 			}
+			resize_used_lines();
 
 			index = nb_max_lines_;
 			nb_max_lines_ += PRIM_SIZE;
 		}
 		else
 		{
-			index = holes_stack_.head();
-			holes_stack_.pop();
+			index = next_hole(first_hole_);
+			cgogn_message_assert(index % PRIM_SIZE == 0u, "insert_lines: hole not aligned on PRIM_SIZE");
 		}
+		first_hole_ = index + PRIM_SIZE;
 
 		// mark lines as used
 		for(uint32 i = 0u; i < PRIM_SIZE; ++i)
+		{
 			refs_.set_value(index + i, 1u); // do not use [] in case of refs_ is bool
+			set_used_line(index + i);
+		}
 
 		nb_used_lines_ += PRIM_SIZE;
 
 		return index;
 	}
 
+	/**
+	 * @brief insert nb consecutive lines at the end of the container (only for PRIM_SIZE==1)
+	 * The holes of the container are not reused. The markers of the inserted lines are not initialized.
+	 * @param nb number of lines to insert
+	 * @return index of the first inserted line
+	 */
+	uint32 append_lines(uint32 nb)
+	{
+		const uint32 index = nb_max_lines_;
+		if (nb == 0u)
+			return index;
+
+		// the chunk of the next line to insert always exists (see insert_lines)
+		const uint32 nbc = (index + nb) / CHUNK_SIZE + 1u;
+		while (refs_.nb_chunks() < nbc)
+		{
+			for (auto arr : table_arrays_)
+				arr->add_chunk();
+			for (auto arr : table_marker_arrays_)
+				arr->add_chunk();
+			refs_.add_chunk();
+		}
+		resize_used_lines();
+
+		nb_max_lines_ += nb;
+		for (uint32 i = index; i < nb_max_lines_; ++i)
+		{
+			refs_.set_value(i, 1u);
+			set_used_line(i);
+		}
+		nb_used_lines_ += nb;
+
+		return index;
+	}
+
 	/**
 	* @brief remove a group of PRIM_SIZE lines in the container
 	* @param index index of one line of group to remove
@@ -815,11 +1056,12 @@ public:
 
 		cgogn_message_assert(used(begin_prim_idx), "Error removing non existing index");
 
-		holes_stack_.push(begin_prim_idx);
-
 		// mark lines as unused
 		for(uint32 i = 0u; i < PRIM_SIZE; ++i)
+		{
+			set_unused_line(begin_prim_idx);
 			refs_.set_value(begin_prim_idx++, 0u); // do not use [] in case of refs_ is bool
+		}
 
 		nb_used_lines_ -= PRIM_SIZE;
 	}
@@ -855,7 +1097,13 @@ public:
 				ptr->copy_element(dst, src);
 		}
 		if (copy_refs)
+		{
 			refs_[dst] = refs_[src];
+			if (refs_[dst] != 0)
+				set_used_line(dst);
+			else
+				set_unused_line(dst);
+		}
 	}
 
 	/**
@@ -878,7 +1126,13 @@ public:
 				ptr->copy_element(dst, src);
 		}
 		if (copy_refs)
+		{
 			refs_[dst] = refs_[src];
+			if (refs_[dst] != 0)
+				set_used_line(dst);
+			else
+				set_unused_line(dst);
+		}
 	}
 
 	/**
@@ -904,7 +1158,7 @@ public:
 		refs_[index]--;
 		if (refs_[index] == 1u)
 		{
-			holes_stack_.push(index);
+			set_unused_line(index);
 			refs_[index] = 0u;
 			--nb_used_lines_;
 			return true;
@@ -930,7 +1184,9 @@ public:
 	void copy_all_but_data(const Self* from)
 	{
 		refs_.copy(from->refs_);
-		holes_stack_.copy(from->holes_stack_);
+		used_lines_ = from->used_lines_;
+		chunk_nb_used_lines_ = from->chunk_nb_used_lines_;
+		first_hole_ = from->first_hole_;
 		nb_used_lines_ = from->nb_used_lines_;
 		nb_max_lines_ = from->nb_max_lines_;
 
@@ -979,8 +1235,14 @@ public:
 		// save uses/refs
 		refs_.save(fs, nb_max_lines_);
 
-		// save stack
-		holes_stack_.save(fs, holes_stack_.size());
+		// save holes as a stack (lowest hole on top)
+		ChunkStack<uint32> holes_stack;
+		for (uint32 i = nb_max_lines_; i-- > 0u;)
+		{
+			if (!used(i))
+				holes_stack.push(i);
+		}
+		holes_stack.save(fs, holes_stack.size());
 	}
 
 	bool load(std::istream& fs)
@@ -1037,6 +1299,113 @@ public:
 		}
 		ok &= refs_.load(fs);
 
+		// the holes are recomputed from the refs
+		ChunkArrayGen::skip(fs);
+		rebuild_used_lines();
+
+		return ok;
+	}
+
+	/**
+	 * @brief save the container in a format that can be mapped back in memory by load_mapped
+	 * (the raw chunks are aligned on pages from the beginning of the stream)
+	 * @param fs output file stream
+	 */
+	void save_mapped(std::ostream& fs) const
+	{
+		cgogn_assert(fs.good());
+
+		const uint32 info[3] = { uint32(table_arrays_.size()), nb_used_lines_, nb_max_lines_ };
+		serialization::save(fs, info, 3);
+
+		for (uint32 i = 0u; i < table_arrays_.size(); ++i)
+		{
+			serialization::save(fs, &names_[i], 1);
+			serialization::save(fs, &type_names_[i], 1);
+			table_arrays_[i]->save_mapped(fs, nb_max_lines_);
+		}
+
+		refs_.save_mapped(fs, nb_max_lines_);
+	}
+
+	/**
+	 * @brief load a container saved by save_mapped, the raw chunks are used directly from the mapped file
+	 * The arrays of the container with a saved name are reused (the pointers to them stay valid),
+	 * the other saved arrays are created, the markers are reset.
+	 * On failure the container is left empty.
+	 * @param fs stream reading the memory of the mapped file (from its beginning)
+	 * @param file the mapped file
+	 * @return ok
+	 */
+	bool load_mapped(std::istream& fs, const std::shared_ptr<MappedFile>& file)
+	{
+		cgogn_assert(fs.good());
+
+		chunk_array_factory<CHUNK_SIZE>().register_known_types();
+
+		uint32 info[3];
+		serialization::load(fs, info, 3);
+		if (!fs.good())
+			return false;
+		nb_used_lines_ = info[1];
+		nb_max_lines_ = info[2];
+
+		bool ok = true;
+		for (uint32 i = 0u; i < info[0]; ++i)
+		{
+			std::string name;
+			std::string type_name;
+			serialization::load(fs, &name, 1);
+			serialization::load(fs, &type_name, 1);
+
+			ChunkArrayGen* cag = nullptr;
+			const uint32 index = array_index(name);
+			if (index != UNKNOWN)
+			{
+				if (type_names_[index] == type_name)
+					cag = table_arrays_[index];
+			}
+			else
+			{
+				auto created = chunk_array_factory<CHUNK_SIZE>().create(type_name, name);
+				if (created)
+				{
+					cag = created.release();
+					table_arrays_.push_back(cag);
+					names_.push_back(name);
+					type_names_.push_back(type_name);
+				}
+			}
+
+			if (cag != nullptr)
+				ok &= cag->load_mapped(fs, file);
+			else
+			{
+				cgogn_log_warning("ChunkArrayContainer::load_mapped") << "Could not load attribute \"" << name << "\" of type \"" << type_name << "\".";
+				ChunkArrayGen::skip_mapped(fs);
+			}
+		}
+		ok &= refs_.load_mapped(fs, file);
+		if (!ok)
+		{
+			clear_chunk_arrays();
+			return false;
+		}
+
+		const uint32 nbc = refs_.nb_chunks();
+		for (ChunkArrayGen* cag : table_arrays_)
+		{
+			if (cag->nb_chunks() != nbc)
+				cag->set_nb_chunks(nbc);
+		}
+		for (ChunkArrayBool* cab : table_marker_arrays_)
+		{
+			cab->set_nb_chunks(nbc);
+			cab->all_false();
+		}
+
+		rebuild_used_lines();
+
 		return ok;
 	}
 
@@ -1055,73 +1424,38 @@ public:
 		}
 	}
 
+	/**
+	 * @brief apply f on each used index of [first, last)
+	 * @param first first index of the range
+	 * @param last index after the last index of the range
+	 */
+	template <typename FUNC>
+	inline void foreach_index_in_range(uint32 first, uint32 last, const FUNC& f) const
+	{
+		uint32 it = first;
+		if (it < last && !used(it))
+			next(it);
+		for (; it < last; next(it))
+			f(it);
+	}
+
+	/**
+	 * @brief apply f on each used index of the container in parallel
+	 * each worker scans its own contiguous ranges of indices
+	 */
 	template <typename FUNC>
 	void parallel_foreach_index(const FUNC& f) const
 	{
 		static_assert(is_ith_func_parameter_same<FUNC,0,uint32>::value, "Wrong function first parameter type");
 
-		using VecIndice = std::vector<uint32>;
-		using Future = std::future<typename std::result_of<FUNC(uint32)>::type>;
-
 		ThreadPool* thread_pool = cgogn::thread_pool();
-		uint32 nb_workers = thread_pool->nb_workers();
-		if (nb_workers==0)
+		if (thread_pool->nb_workers() == 0)
 			return foreach_index(f);
 
-		std::array<std::vector<VecIndice*>, 2> indices_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		indices_buffers[0].reserve(nb_workers);
-		indices_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
-
-		Buffers<uint32>* buffs = cgogn::uint_buffers();
-
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
-
-		uint32 it = begin();
-		uint32 it_end = end();
-		while(it != it_end)
+		thread_pool->parallel_for(0u, end(), PARALLEL_BUFFER_SIZE, [this, &f] (uint32 first, uint32 last)
 		{
-			// fill buffer
-			indices_buffers[i].push_back(buffs->buffer());
-			VecIndice& indices = *indices_buffers[i].back();
-			indices.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && (it != it_end); ++k)
-			{
-				indices.push_back(it);
-				next(it);
-			}
-			// launch thread
-			futures[i].push_back(thread_pool->enqueue([&indices, &f] ()
-			{
-				for (auto ind : indices)
-					f(ind);
-			}));
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i+1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : indices_buffers[i])
-					buffs->release_buffer(b);
-				futures[i].clear();
-				indices_buffers[i].clear();
-			}
-		}
-
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto& b : indices_buffers[0u])
-			buffs->release_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto& b : indices_buffers[1u])
-			buffs->release_buffer(b);
+			this->foreach_index_in_range(first, last, [&f] (uint32 i) { f(i); });
+		});
 	}
 };
 
@@ -25,20 +25,60 @@
 #define CGOGN_CORE_CONTAINER_CHUNK_ARRAY_GEN_H_
 
 #include <cgogn/core/utils/serialization.h>
+#include <cgogn/core/utils/mapped_file.h>
+#include <cgogn/core/utils/logger.h>
 #include <cgogn/core/dll.h>
 
 #include <cgogn/core/cmap/map_traits.h>
 
 #include <vector>
+#include <deque>
+#include <atomic>
 #include <iostream>
 #include <algorithm>
 #include <memory>
+#include <string>
 
 namespace cgogn
 {
 
 template <uint32 CHUNK_SIZE, typename T_REF> class ChunkArrayContainer;
 
+/**
+ * @brief versions of the chunks of an array already seen by a consumer of its data (see ChunkArrayGen::modified_chunks)
+ */
+struct ChunkVersions
+{
+	inline ChunkVersions() : array_id_(0u)
+	{}
+
+	/**
+	 * @brief forget the seen versions: all the chunks will be reported as modified
+	 */
+	inline void clear()
+	{
+		array_id_ = 0u;
+		versions_.clear();
+	}
+
+	uint64 array_id_;
+	std::vector<uint64> versions_;
+};
+
+namespace internal
+{
+
+/**
+ * @return a new identifier of array (from 1), so that a consumer never confuses two arrays
+ */
+inline uint64 new_chunk_array_id()
+{
+	static std::atomic<uint64> last_id(0u);
+	return last_id.fetch_add(1u, std::memory_order_relaxed) + 1u;
+}
+
+} // namespace internal
+
 /**
  * @brief Virtual version of ChunkArray
  */
@@ -53,10 +93,14 @@ public:
 
 	inline ChunkArrayGen(const std::string& name, const std::string& type_name) :
 		name_(name),
-		type_name_(type_name)
+		type_name_(type_name),
+		id_(internal::new_chunk_array_id()),
+		generation_(0u)
 	{}
 
-	inline ChunkArrayGen()
+	inline ChunkArrayGen() :
+		id_(internal::new_chunk_array_id()),
+		generation_(0u)
 	{}
 
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ChunkArrayGen);
@@ -69,6 +113,27 @@ protected:
 
 	std::string type_name_;
 
+	/**
+	 * file mapping the memory of the adopted chunks (these chunks are not deleted by the array)
+	 */
+	std::shared_ptr<MappedFile> mapped_file_;
+
+	/**
+	 * identifier of the array for the consumers of its modification state
+	 */
+	const uint64 id_;
+
+	/**
+	 * modification state of the chunks (one version counter per chunk), see set_dirty
+	 * (a deque, as the atomic counters cannot be moved by a vector)
+	 */
+	std::deque<std::atomic<uint64>> chunk_versions_;
+
+	/**
+	 * greatest version given to a chunk index, so that a reallocated chunk never gets a version already seen
+	 */
+	uint64 generation_;
+
 public:
 
 	/**
@@ -89,6 +154,29 @@ protected:
 		}
 	}
 
+	/**
+	 * @brief resize the modification state to nbc chunks: the versions of the kept chunks are unchanged
+	 * and the new chunks get a version that has never been given to their index
+	 */
+	void resize_dirty(uint32 nbc)
+	{
+		while (chunk_versions_.size() > nbc)
+		{
+			generation_ = std::max(generation_, chunk_versions_.back().load(std::memory_order_relaxed));
+			chunk_versions_.pop_back();
+		}
+		while (chunk_versions_.size() < nbc)
+			chunk_versions_.emplace_back(++generation_);
+	}
+
+	/**
+	 * @brief test if a chunk has been allocated by the array (and not adopted from a mapped file)
+	 */
+	inline bool owns_chunk(const void* chunk) const
+	{
+		return mapped_file_ == nullptr || !mapped_file_->contains(chunk);
+	}
+
 public:
 
 	void add_external_ref(ChunkArrayGen** ref)
@@ -106,6 +194,81 @@ public:
 		external_refs_.pop_back();
 	}
 
+	/**
+	 * @brief report the modification of the element i (thread safe)
+	 * The modification state of the array is kept at chunk granularity for the consumers of the data
+	 * (e.g. the VBOs, see update_vbo_incremental): each chunk has a version that is incremented at each
+	 * report, and each consumer keeps the versions it has already seen (see modified_chunks).
+	 * The chunk allocations and the functions that modify the elements through the array (copy, load,
+	 * set_all_values, copy_element, ...) report their chunks, but the writes done through operator[]
+	 * or set_value are not tracked and must be reported with set_dirty, after the write.
+	 */
+	inline void set_dirty(uint32 i)
+	{
+		const uint32 c = i / CHUNK_SIZE;
+		cgogn_message_assert(c < chunk_versions_.size(), "set_dirty: index out of the array");
+		chunk_versions_[c].fetch_add(1u, std::memory_order_release);
+	}
+
+	/**
+	 * @brief report the modification of the elements [first, last) (thread safe)
+	 */
+	inline void set_dirty(uint32 first, uint32 last)
+	{
+		if (first >= last)
+			return;
+		for (uint32 c = first / CHUNK_SIZE, end = (last - 1u) / CHUNK_SIZE; c <= end; ++c)
+			set_dirty(c * CHUNK_SIZE);
+	}
+
+	/**
+	 * @brief report the modification of all the elements (thread safe)
+	 */
+	inline void set_all_dirty()
+	{
+		for (std::atomic<uint64>& v : chunk_versions_)
+			v.fetch_add(1u, std::memory_order_release);
+	}
+
+	/**
+	 * @return the current version of the chunk c
+	 */
+	inline uint64 chunk_version(uint32 c) const
+	{
+		cgogn_message_assert(c < chunk_versions_.size(), "chunk_version: chunk out of the array");
+		return chunk_versions_[c].load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief get the chunks modified since the last call of a consumer (thread safe)
+	 * @param seen the versions of the chunks already seen by the consumer, updated to the current versions
+	 * (if they come from another array, they are forgotten)
+	 * @return the indices of the chunks whose version differs from the seen one (all the chunks that
+	 * were not seen yet), in increasing order
+	 */
+	std::vector<uint32> modified_chunks(ChunkVersions& seen) const
+	{
+		if (seen.array_id_ != id_)
+		{
+			seen.array_id_ = id_;
+			seen.versions_.clear();
+		}
+		const uint32 nbc = uint32(chunk_versions_.size());
+		// the versions start from 1: 0 is never seen
+		seen.versions_.resize(nbc, 0u);
+		std::vector<uint32> chunks;
+		for (uint32 c = 0u; c < nbc; ++c)
+		{
+			const uint64 v = chunk_versions_[c].load(std::memory_order_acquire);
+			if (v != seen.versions_[c])
+			{
+				seen.versions_[c] = v;
+				chunks.push_back(c);
+			}
+		}
+		return chunks;
+	}
+
 	inline const std::string& name() const { return name_; }
 
 	inline const std::string& type_name() const { return type_name_; }
@@ -148,6 +311,24 @@ public:
 
 	virtual bool swap_data(Self*) = 0;
 
+	/**
+	 * @brief test if the chunks can be saved and mapped back as raw memory
+	 */
+	virtual bool raw_data() const = 0;
+
+	/**
+	 * @brief replace the chunks of the array by memory of a mapped file (no copy)
+	 * Written elements are copied on write by the system, the file is never modified.
+	 * @param chunks pointers to the chunks in the mapped memory
+	 * @param file the mapped file, kept alive while the array uses it
+	 */
+	virtual void adopt_chunks(const std::vector<void*>& chunks, const std::shared_ptr<MappedFile>& file) = 0;
+
+	/**
+	 * @return true if (some of) the chunks of the array are mapped from a file
+	 */
+	inline bool is_mapped() const { return mapped_file_ != nullptr; }
+
 	/**
 	 * @brief add a chunk (T[CHUNK_SIZE])
 	 */
@@ -238,6 +419,121 @@ public:
 		fs.ignore(std::streamsize(chunk_bytes), EOF);
 	}
 
+	/**
+	 * @brief save the array in a format that can be mapped back in memory by load_mapped:
+	 * raw chunks are written as is, aligned on MappedFile::alignment() bytes from the beginning of the stream,
+	 * other arrays are written with save
+	 * @param fs file stream
+	 * @param nb_lines number of line to save
+	 */
+	void save_mapped(std::ostream& fs, uint32 nb_lines) const
+	{
+		cgogn_assert(fs.good());
+
+		const uint32 raw = this->raw_data() ? 1u : 0u;
+		serialization::save(fs, &raw, 1);
+		if (!raw)
+		{
+			this->save(fs, nb_lines);
+			return;
+		}
+
+		const uint32 nbc = (nb_lines + CHUNK_SIZE - 1u) / CHUNK_SIZE;
+		uint32 chunk_bytes;
+		const std::vector<const void*> chunks = this->chunks_pointers(chunk_bytes);
+		cgogn_assert(nbc <= chunks.size());
+		serialization::save(fs, &nbc, 1);
+		serialization::save(fs, &chunk_bytes, 1);
+
+		const std::string padding(mapped_padding(std::size_t(fs.tellp())), '\0');
+		fs.write(padding.data(), std::streamsize(padding.size()));
+		for (uint32 i = 0u; i < nbc; ++i)
+			fs.write(static_cast<const char*>(chunks[i]), std::streamsize(chunk_bytes));
+
+		cgogn_assert(fs.good());
+	}
+
+	/**
+	 * @brief load an array saved by save_mapped, the raw chunks are adopted from the mapped file (no copy)
+	 * @param fs stream reading the memory of the mapped file (from its beginning)
+	 * @param file the mapped file
+	 * @return ok
+	 */
+	bool load_mapped(std::istream& fs, const std::shared_ptr<MappedFile>& file)
+	{
+		uint32 raw;
+		serialization::load(fs, &raw, 1);
+		if (!raw)
+			return this->load(fs);
+
+		uint32 nbc;
+		serialization::load(fs, &nbc, 1);
+		uint32 chunk_bytes;
+		serialization::load(fs, &chunk_bytes, 1);
+		if (!fs.good())
+			return false;
+
+		uint32 array_chunk_bytes;
+		this->chunks_pointers(array_chunk_bytes);
+		if (!this->raw_data() || chunk_bytes != array_chunk_bytes)
+		{
+			cgogn_log_error("ChunkArrayGen::load_mapped") << "The chunks of \"" << name_ << "\" do not match the type " << type_name_ << ".";
+			skip_mapped_chunks(fs, nbc, chunk_bytes);
+			return false;
+		}
+
+		const std::size_t first = std::size_t(fs.tellg()) + mapped_padding(std::size_t(fs.tellg()));
+		if (first + std::size_t(nbc) * chunk_bytes > file->size())
+		{
+			cgogn_log_error("ChunkArrayGen::load_mapped") << "Truncated file.";
+			return false;
+		}
+
+		std::vector<void*> chunks;
+		chunks.reserve(nbc);
+		for (uint32 i = 0u; i < nbc; ++i)
+			chunks.push_back(file->data() + first + std::size_t(i) * chunk_bytes);
+		this->adopt_chunks(chunks, file);
+
+		fs.seekg(std::streamoff(first + std::size_t(nbc) * chunk_bytes));
+		return fs.good();
+	}
+
+	/**
+	 * @brief skip an array saved by save_mapped
+	 * @param fs input stream
+	 */
+	static void skip_mapped(std::istream& fs)
+	{
+		uint32 raw;
+		serialization::load(fs, &raw, 1);
+		if (!raw)
+		{
+			skip(fs);
+			return;
+		}
+		uint32 nbc;
+		serialization::load(fs, &nbc, 1);
+		uint32 chunk_bytes;
+		serialization::load(fs, &chunk_bytes, 1);
+		skip_mapped_chunks(fs, nbc, chunk_bytes);
+	}
+
+protected:
+
+	static inline std::size_t mapped_padding(std::size_t position)
+	{
+		return (MappedFile::alignment() - position % MappedFile::alignment()) % MappedFile::alignment();
+	}
+
+	static void skip_mapped_chunks(std::istream& fs, uint32 nbc, uint32 chunk_bytes)
+	{
+		const std::size_t pos = std::size_t(fs.tellg());
+		fs.seekg(std::streamoff(pos + mapped_padding(pos) + std::size_t(nbc) * chunk_bytes));
+	}
+
+public:
+
 	/**
 	 * @brief copy the chunk array source into this, allocation is done
 	 * @param cag_src
@@ -128,12 +128,10 @@ public:
 	 */
 	void compact()
 	{
-		const uint32 keep = (stack_size_+CHUNK_SIZE-1u) / CHUNK_SIZE;
-		while (this->table_data_.size() > keep)
-		{
-			delete[] this->table_data_.back();
-			this->table_data_.pop_back();
-		}
+		// the elements are stored from the index 1: the head is in the chunk stack_size_ / CHUNK_SIZE
+		const uint32 keep = stack_size_ / CHUNK_SIZE + 1u;
+		if (this->nb_chunks() > keep)
+			this->set_nb_chunks(keep); // the chunks are released with internal::delete_chunk
 	}
 
 	/**
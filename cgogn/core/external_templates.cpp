@@ -30,6 +30,7 @@
 #include <cgogn/core/cmap/cmap3.h>
 #include <cgogn/core/cmap/cmap3_hexa.h>
 #include <cgogn/core/cmap/cmap3_tetra.h>
+#include <cgogn/core/cmap/csr_incidence.h>
 
 #include <cgogn/core/graph/undirected_graph.h>
 
@@ -95,6 +96,7 @@ template class CGOGN_CORE_API CellMarkerStore<CMap2, CMap2::Edge::ORBIT>;
 template class CGOGN_CORE_API CellMarkerStore<CMap2, CMap2::Face::ORBIT>;
 template class CGOGN_CORE_API CellMarkerStore<CMap2, CMap2::Volume::ORBIT>;
 template class CGOGN_CORE_API CellCache<CMap2>;
+template class CGOGN_CORE_API CSRIncidence<CMap2>;
 template class CGOGN_CORE_API BoundaryCache<CMap2>;
 template class CGOGN_CORE_API QuickTraversor<CMap2>;
 
@@ -153,6 +155,7 @@ template class CGOGN_CORE_API CellMarkerStore<CMap3, CMap3::Edge::ORBIT>;
 template class CGOGN_CORE_API CellMarkerStore<CMap3, CMap3::Face::ORBIT>;
 template class CGOGN_CORE_API CellMarkerStore<CMap3, CMap3::Volume::ORBIT>;
 template class CGOGN_CORE_API CellCache<CMap3>;
+template class CGOGN_CORE_API CSRIncidence<CMap3>;
 template class CGOGN_CORE_API BoundaryCache<CMap3>;
 template class CGOGN_CORE_API QuickTraversor<CMap3>;
 
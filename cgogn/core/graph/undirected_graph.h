@@ -144,12 +144,14 @@ protected:
 	/* alpha0 is an involution */
 	inline void alpha0_sew(Dart d, Dart e)
 	{
+		this->topology_changed();
 		(*alpha0_)[d.index] = e;
 		(*alpha0_)[e.index] = d;
 	}
 
 	inline void alpha0_unsew(Dart d)
 	{
+		this->topology_changed();
 		Dart e = alpha0(d);
 		(*alpha0_)[d.index] = d;
 		(*alpha0_)[e.index] = e;
@@ -158,6 +160,7 @@ protected:
 	/* alpha1 is a permutation */
 	inline void alpha1_sew(Dart d, Dart e)
 	{
+		this->topology_changed();
 		Dart f = alpha1(d);
 		Dart g = alpha1(e);
 		(*alpha1_)[d.index] = g;
@@ -168,6 +171,7 @@ protected:
 
 	inline void alpha1_unsew(Dart d)
 	{
+		this->topology_changed();
 		Dart e = alpha1(d);
 		Dart f = alpha_1(d);
 		(*alpha1_)[f.index] = e;
@@ -0,0 +1,170 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <thread>
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/attribute_snapshot.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The AttributeSnapshotTest class builds a map of isolated triangles
+ * whose vertices span a few chunks of the vertex attributes.
+ */
+class AttributeSnapshotTest : public ::testing::Test
+{
+public:
+
+	using Vertex = CMap2::Vertex;
+	using VertexAttribute = CMap2::VertexAttribute<float64>;
+
+protected:
+
+	CMap2 cmap_;
+	VertexAttribute value_;
+	uint32 nb_lines_;
+
+	void SetUp() override
+	{
+		value_ = cmap_.add_attribute<float64, Vertex>("value");
+		for (uint32 i = 0u; i < 3000u; ++i)
+			cmap_.add_face(3u);
+		nb_lines_ = cmap_.attribute_container<Vertex::ORBIT>().end();
+		for (uint32 i = 0u; i < nb_lines_; ++i)
+			value_[i] = 1.0;
+	}
+};
+
+TEST_F(AttributeSnapshotTest, publish)
+{
+	AttributeSnapshot<float64> snapshot(value_);
+	EXPECT_EQ(snapshot.view(), nullptr);
+
+	// another consumer of the modifications of the attribute (e.g. a VBO)
+	ChunkVersions uploaded;
+	value_.data()->modified_chunks(uploaded);
+
+	snapshot.publish();
+	std::shared_ptr<const AttributeSnapshot<float64>::View> v1 = snapshot.view();
+	ASSERT_NE(v1, nullptr);
+	EXPECT_EQ(v1->epoch(), 1u);
+	EXPECT_EQ(v1->nb_chunks(), value_.data()->nb_chunks());
+
+	// the writer modifies the first chunk
+	value_[10u] = 2.0;
+	value_.set_dirty(10u);
+	EXPECT_EQ((*v1)[10u], 1.0);
+
+	snapshot.publish();
+	std::shared_ptr<const AttributeSnapshot<float64>::View> v2 = snapshot.view();
+	EXPECT_EQ(v2->epoch(), 2u);
+	EXPECT_EQ((*v2)[10u], 2.0);
+	EXPECT_EQ((*v1)[10u], 1.0);
+	EXPECT_EQ(v2->changed_chunks(*v1), std::vector<uint32>({0u}));
+
+	// the publication does not hide the modification to the other consumer
+	EXPECT_EQ(value_.data()->modified_chunks(uploaded), std::vector<uint32>({0u}));
+
+	// the clean chunks are shared
+	for (uint32 c = 1u; c < v2->nb_chunks(); ++c)
+		EXPECT_EQ(v2->chunk(c), v1->chunk(c));
+	EXPECT_NE(v2->chunk(0u), v1->chunk(0u));
+
+	// nothing modified: everything is shared
+	snapshot.publish();
+	EXPECT_TRUE(snapshot.view()->changed_chunks(*v2).empty());
+}
+
+TEST_F(AttributeSnapshotTest, several_snapshots)
+{
+	// two snapshots of the same attribute do not consume the modifications of each other
+	AttributeSnapshot<float64> snapshot1(value_);
+	AttributeSnapshot<float64> snapshot2(value_);
+	snapshot1.publish();
+	snapshot2.publish();
+
+	value_[10u] = 2.0;
+	value_.set_dirty(10u);
+	snapshot1.publish();
+	snapshot2.publish();
+	EXPECT_EQ((*snapshot1.view())[10u], 2.0);
+	EXPECT_EQ((*snapshot2.view())[10u], 2.0);
+
+	value_[20u] = 3.0;
+	value_.set_dirty(20u);
+	std::shared_ptr<const AttributeSnapshot<float64>::View> v1 = snapshot1.view();
+	snapshot1.publish();
+	EXPECT_EQ((*snapshot1.view())[20u], 3.0);
+	EXPECT_EQ(snapshot1.view()->changed_chunks(*v1), std::vector<uint32>({0u}));
+	value_[30u] = 4.0;
+	value_.set_dirty(30u);
+	snapshot2.publish();
+	EXPECT_EQ((*snapshot2.view())[20u], 3.0);
+	EXPECT_EQ((*snapshot2.view())[30u], 4.0);
+}
+
+TEST_F(AttributeSnapshotTest, concurrent_reads)
+{
+	AttributeSnapshot<float64> snapshot(value_);
+	snapshot.publish();
+
+	// each view must contain the values of a single step of the writer
+	std::atomic_bool stop(false);
+	std::atomic<uint32> nb_torn(0u);
+	std::thread reader([&] ()
+	{
+		while (!stop)
+		{
+			std::shared_ptr<const AttributeSnapshot<float64>::View> view = snapshot.view();
+			const float64 first = (*view)[0u];
+			for (uint32 i = 1u; i < nb_lines_; ++i)
+			{
+				if ((*view)[i] != first)
+				{
+					++nb_torn;
+					break;
+				}
+			}
+		}
+	});
+
+	for (uint32 step = 2u; step < 200u; ++step)
+	{
+		for (uint32 i = 0u; i < nb_lines_; ++i)
+			value_[i] = float64(step);
+		value_.set_dirty(0u, nb_lines_);
+		snapshot.publish();
+	}
+	stop = true;
+	reader.join();
+
+	EXPECT_EQ(nb_torn, 0u);
+	EXPECT_EQ((*snapshot.view())[nb_lines_ - 1u], 199.0);
+}
+
+} // namespace cgogn
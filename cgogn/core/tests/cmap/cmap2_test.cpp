@@ -21,9 +21,15 @@
 *                                                                              *
 *******************************************************************************/
 
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
 #include <gtest/gtest.h>
 
 #include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/scatter.h>
 
 namespace cgogn
 {
@@ -185,6 +191,153 @@ TEST_F(CMap2Test, add_face)
 	EXPECT_TRUE(cmap_.check_map_integrity());
 }
 
+/**
+ * \brief Parallel traversals visit each dart and each cell exactly once
+ */
+TEST_F(CMap2Test, parallel_foreach)
+{
+	add_closed_surfaces();
+
+	std::atomic<uint32> nb_darts(0u);
+	cmap_.parallel_foreach_dart([&] (Dart)
+	{
+		++nb_darts;
+	});
+	EXPECT_EQ(nb_darts.load(), cmap_.nb_darts());
+
+	CMap2::VertexAttribute<uint32> att_v = cmap_.add_attribute<uint32, Vertex>("visits");
+	att_v.set_all_values(0u);
+	std::atomic<uint32> nb_vertices(0u);
+	cmap_.parallel_foreach_cell([&] (Vertex v)
+	{
+		++nb_vertices;
+		++att_v[v];
+	});
+	EXPECT_EQ(nb_vertices.load(), cmap_.nb_cells<Vertex::ORBIT>());
+	for (uint32 n : att_v)
+		EXPECT_EQ(n, 1u);
+
+	std::atomic<uint32> nb_faces(0u);
+	cmap_.parallel_foreach_cell([&] (Face)
+	{
+		++nb_faces;
+	});
+	uint32 count_faces = 0u;
+	cmap_.foreach_cell([&] (Face) { ++count_faces; });
+	EXPECT_EQ(nb_faces.load(), count_faces);
+}
+
+/**
+ * \brief A CellCache built in parallel stores the cells in the traversal order, with their embeddings
+ */
+TEST_F(CMap2Test, cell_cache)
+{
+	add_closed_surfaces();
+
+	std::vector<Dart> vertices;
+	cmap_.foreach_cell([&] (Vertex v) { vertices.push_back(v.dart); });
+
+	CellCache<CMap2> cache(cmap_);
+	cache.set_embedded<Vertex>();
+	cache.parallel_build<Vertex>();
+	EXPECT_EQ(cache.cells<Vertex>(), vertices);
+	ASSERT_EQ(cache.embeddings<Vertex>().size(), vertices.size());
+	for (uint32 i = 0u; i < vertices.size(); ++i)
+		EXPECT_EQ(cache.embeddings<Vertex>()[i], cmap_.embedding(Vertex(vertices[i])));
+
+	CellCache<CMap2> serial_cache(cmap_);
+	serial_cache.set_embedded<Vertex>();
+	serial_cache.build<Vertex>();
+	EXPECT_EQ(serial_cache.cells<Vertex>(), vertices);
+	EXPECT_EQ(serial_cache.embeddings<Vertex>(), cache.embeddings<Vertex>());
+
+	CMap2::VertexAttribute<uint32> att_v = cmap_.add_attribute<uint32, Vertex>("visits");
+	att_v.set_all_values(0u);
+	cmap_.parallel_foreach_cell([&] (Vertex, uint32 emb) { ++att_v[emb]; }, cache);
+	for (uint32 n : att_v)
+		EXPECT_EQ(n, 1u);
+
+	const auto odd_degree = [&] (Face f) { return cmap_.codegree(f) % 2u == 1u; };
+	std::vector<Dart> faces;
+	cmap_.foreach_cell([&] (Face f) { faces.push_back(f.dart); }, odd_degree);
+	cache.parallel_build<Face>(odd_degree);
+	EXPECT_EQ(cache.cells<Face>(), faces);
+	EXPECT_TRUE(cache.embeddings<Face>().empty());
+
+	std::atomic<uint32> nb_faces(0u);
+	cmap_.parallel_foreach_cell([&] (Face f) { EXPECT_TRUE(odd_degree(f)); ++nb_faces; }, cache);
+	EXPECT_EQ(nb_faces.load(), uint32(faces.size()));
+}
+
+/**
+ * \brief A parallel scatter from the faces to their vertices gives the same values as a vertex gather
+ */
+TEST_F(CMap2Test, parallel_scatter)
+{
+	add_closed_surfaces();
+
+	CMap2::VertexAttribute<uint32> degrees = cmap_.add_attribute<uint32, Vertex>("degrees");
+	degrees.set_all_values(0u);
+	parallel_scatter(cmap_, degrees, [&] (Face f, ScatterAccumulator<uint32, Vertex::ORBIT>& acc)
+	{
+		const uint32 degree = cmap_.codegree(f);
+		cmap_.foreach_incident_vertex(f, [&] (Vertex v) { acc(v, degree); });
+	});
+
+	const auto odd_degree = [&] (Face f) { return cmap_.codegree(f) % 2u == 1u; };
+	CMap2::VertexAttribute<uint32> odd_degrees = cmap_.add_attribute<uint32, Vertex>("odd_degrees");
+	odd_degrees.set_all_values(0u);
+	parallel_scatter(cmap_, odd_degree, odd_degrees, [&] (Face f, ScatterAccumulator<uint32, Vertex::ORBIT>& acc)
+	{
+		cmap_.foreach_incident_vertex(f, [&] (Vertex v) { acc(v, 1u); });
+	});
+
+	cmap_.foreach_cell([&] (Vertex v)
+	{
+		uint32 sum = 0u;
+		uint32 nb_odd = 0u;
+		cmap_.foreach_incident_face(v, [&] (Face f)
+		{
+			sum += cmap_.codegree(f);
+			if (odd_degree(f))
+				++nb_odd;
+		});
+		EXPECT_EQ(degrees[v], sum);
+		EXPECT_EQ(odd_degrees[v], nb_odd);
+	});
+}
+
+/**
+ * \brief The partial buffers of a parallel scatter are made of chunks of the attributes size,
+ * that the chunk allocator recycles for the attributes
+ */
+TEST_F(CMap2Test, parallel_scatter_chunks)
+{
+	add_closed_surfaces();
+
+	CMap2::VertexAttribute<uint32> degrees = cmap_.add_attribute<uint32, Vertex>("degrees");
+	degrees.set_all_values(0u);
+
+	ChunkAllocator allocator;
+	set_chunk_allocator(&allocator);
+	parallel_scatter(cmap_, degrees, [&] (Face f, ScatterAccumulator<uint32, Vertex::ORBIT>& acc)
+	{
+		cmap_.foreach_incident_vertex(f, [&] (Vertex v) { acc(v, 1u); });
+	});
+
+	const std::size_t chunk_bytes = CMap2::CHUNK_SIZE * sizeof(uint32);
+	const std::size_t cached = allocator.cached_bytes();
+	EXPECT_EQ(cached % chunk_bytes, 0u);
+	if (thread_pool()->nb_workers() > 0u)
+	{
+		EXPECT_GT(cached, 0u);
+		CMap2::VertexAttribute<uint32> other = cmap_.add_attribute<uint32, Vertex>("other");
+		EXPECT_LT(allocator.cached_bytes(), cached);
+		cmap_.remove_attribute(other);
+	}
+	set_chunk_allocator(nullptr);
+}
+
 /**
  * \brief Cutting edges preserves the cell indexation
  */
@@ -374,6 +527,128 @@ TEST_F(CMap2Test, compact_map)
 //	});
 }
 
+/**
+ * \brief Compacting with a given dart order preserves the topology and the cell indexation
+ */
+TEST_F(CMap2Test, compact_map_order)
+{
+	add_closed_surfaces();
+
+	CMap2::VertexAttribute<int32> att_v = cmap_.get_attribute<int32, Vertex>("vertices");
+	int32 count = 0;
+	cmap_.foreach_cell([&] (Vertex v) { att_v[v] = count++; });
+
+	// cut some edges and remove a connected component to create holes in the containers
+	for (uint32 i = 0; i < NB_MAX; i += 2)
+		cmap_.cut_edge(Edge(darts_[i]));
+	cmap_.remove_volume(Volume(darts_[0]));
+
+	std::vector<std::pair<int32, int32>> edges_before;
+	cmap_.foreach_cell([&] (Edge e)
+	{
+		int32 a = att_v[Vertex(e.dart)];
+		int32 b = att_v[Vertex(cmap_.phi1(e.dart))];
+		edges_before.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+	});
+	std::sort(edges_before.begin(), edges_before.end());
+
+	std::vector<Dart> order;
+	cmap_.foreach_dart([&] (Dart d) { order.push_back(d); });
+	std::reverse(order.begin(), order.end());
+
+	cmap_.compact(order);
+	EXPECT_TRUE(cmap_.check_map_integrity());
+	EXPECT_EQ(cmap_.topology_container().size(), cmap_.topology_container().end());
+	EXPECT_EQ(cmap_.attribute_container<Vertex::ORBIT>().size(), cmap_.attribute_container<Vertex::ORBIT>().end());
+
+	std::vector<std::pair<int32, int32>> edges_after;
+	cmap_.foreach_cell([&] (Edge e)
+	{
+		int32 a = att_v[Vertex(e.dart)];
+		int32 b = att_v[Vertex(cmap_.phi1(e.dart))];
+		edges_after.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+	});
+	std::sort(edges_after.begin(), edges_after.end());
+	EXPECT_EQ(edges_before, edges_after);
+}
+
+TEST_F(CMap2Test, save_load_mapped)
+{
+	add_closed_surfaces();
+
+	CMap2::VertexAttribute<std::array<float64, 3>> att_v = cmap_.add_attribute<std::array<float64, 3>, Vertex>("position");
+	CMap2::FaceAttribute<std::string> att_f = cmap_.add_attribute<std::string, Face>("name");
+	cmap_.foreach_cell([&] (Vertex v) { const float64 x = float64(cmap_.embedding(v)); att_v[v] = {{ x, 2.0 * x, 3.0 * x }}; });
+	cmap_.foreach_cell([&] (Face f) { att_f[f] = std::to_string(cmap_.embedding(f)); });
+	cmap_.remove_volume(Volume(darts_[0]));
+
+	const std::string filename("cmap2_test_mapped.cgogn");
+	EXPECT_TRUE(cmap_.save_mapped(filename));
+
+	CMap2 map;
+	EXPECT_TRUE(map.save_mapped(filename + ".empty"));
+	EXPECT_TRUE(map.load_mapped(filename));
+	EXPECT_TRUE(map.check_map_integrity());
+	EXPECT_EQ(map.nb_darts(), cmap_.nb_darts());
+	EXPECT_EQ(map.nb_cells<Vertex::ORBIT>(), cmap_.nb_cells<Vertex::ORBIT>());
+	EXPECT_EQ(map.nb_cells<Face::ORBIT>(), cmap_.nb_cells<Face::ORBIT>());
+	EXPECT_TRUE(map.topology_container().get_chunk_array("phi1")->is_mapped());
+
+	// only the trivially copyable types are used as raw memory
+	EXPECT_TRUE(cgogn::serialization::raw_data(static_cast<const std::array<float64, 3>*>(nullptr)));
+	EXPECT_TRUE(cgogn::serialization::raw_data(static_cast<const cgogn::Dart*>(nullptr)));
+	EXPECT_FALSE(cgogn::serialization::raw_data(static_cast<const std::string*>(nullptr)));
+	EXPECT_FALSE(cgogn::serialization::raw_data(static_cast<const std::vector<uint32>*>(nullptr)));
+	EXPECT_FALSE(cgogn::serialization::raw_data(static_cast<const std::array<std::string, 2>*>(nullptr)));
+	EXPECT_FALSE(cgogn::serialization::raw_data(static_cast<const std::pair<uint32, std::string>*>(nullptr)));
+
+	CMap2::VertexAttribute<std::array<float64, 3>> map_v = map.get_attribute<std::array<float64, 3>, Vertex>("position");
+	CMap2::FaceAttribute<std::string> map_f = map.get_attribute<std::string, Face>("name");
+	EXPECT_TRUE(map_v.is_valid());
+	EXPECT_TRUE(map_f.is_valid());
+	cmap_.foreach_dart([&] (Dart d)
+	{
+		EXPECT_EQ(map.phi1(d), cmap_.phi1(d));
+		EXPECT_EQ(map.phi2(d), cmap_.phi2(d));
+		EXPECT_EQ(map.is_boundary(d), cmap_.is_boundary(d));
+		EXPECT_EQ(map_v[Vertex(d)], att_v[Vertex(d)]);
+		if (!cmap_.is_boundary(d))
+		{
+			EXPECT_EQ(map_f[Face(d)], att_f[Face(d)]);
+		}
+	});
+
+	// writing in the loaded map never modifies the file
+	map.foreach_cell([&] (Vertex v) { map_v[v] = {{ 0.0, 0.0, 0.0 }}; });
+	map.add_face(3u);
+	CMap2 map2;
+	EXPECT_TRUE(map2.load_mapped(filename));
+	EXPECT_EQ(map2.nb_darts(), cmap_.nb_darts());
+	CMap2::VertexAttribute<std::array<float64, 3>> map2_v = map2.get_attribute<std::array<float64, 3>, Vertex>("position");
+	cmap_.foreach_cell([&] (Vertex v) { EXPECT_EQ(map2_v[v], att_v[v]); });
+
+	// loading an empty map clears the previous content
+	EXPECT_TRUE(map2.load_mapped(filename + ".empty"));
+	EXPECT_EQ(map2.nb_darts(), 0u);
+	EXPECT_FALSE(map2.is_embedded<Vertex::ORBIT>());
+
+	// a truncated file is rejected and leaves the map empty
+	{
+		std::ifstream in(filename, std::ios::binary);
+		std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		std::ofstream out(filename + ".truncated", std::ios::binary | std::ios::trunc);
+		out.write(content.data(), std::streamsize(content.size() - content.size() / 4u));
+	}
+	CMap2 map3;
+	EXPECT_FALSE(map3.load_mapped(filename + ".truncated"));
+	EXPECT_EQ(map3.nb_darts(), 0u);
+	EXPECT_FALSE(map3.is_embedded<Vertex::ORBIT>());
+
+	std::remove(filename.c_str());
+	std::remove((filename + ".empty").c_str());
+	std::remove((filename + ".truncated").c_str());
+}
+
 TEST_F(CMap2Test, merge_map)
 {
 	using CDart = CMap2::CDart;
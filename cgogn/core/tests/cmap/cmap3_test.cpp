@@ -348,6 +348,60 @@ TEST_F(CMap3Test, merge_map2)
 	EXPECT_EQ(cmap_.nb_cells<Face::ORBIT>(), 30u);
 }
 
+/**
+ * @brief A CSRIncidence snapshot gives the same incidences as the map, until its topology changes
+ */
+TEST_F(CMap3Test, csr_incidence)
+{
+	MapBuilder mbuild(cmap_);
+
+	Dart p1 = mbuild.add_prism_topo_fp(3u);
+	Dart p2 = mbuild.add_prism_topo_fp(3u);
+	mbuild.sew_volumes_fp(p1, p2);
+	mbuild.add_pyramid_topo_fp(4u);
+	mbuild.close_map();
+
+	cmap_.add_attribute<int32, Vertex>("vertices");
+	cmap_.add_attribute<int32, Face>("faces");
+
+	CSRIncidence<CMap3> incidence(cmap_);
+	EXPECT_FALSE(incidence.is_valid());
+	incidence.build();
+	EXPECT_TRUE(incidence.is_valid());
+
+	uint32 i = 0u;
+	cmap_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_EQ(incidence.vertices()[i], v.dart);
+		EXPECT_EQ(incidence.vertex_index(v.dart), i);
+		std::vector<Dart> adjacent, incident;
+		cmap_.foreach_adjacent_vertex_through_edge(v, [&] (Vertex u) { adjacent.push_back(u.dart); });
+		cmap_.foreach_incident_face(v, [&] (Face f) { incident.push_back(f.dart); });
+		EXPECT_EQ(std::vector<Dart>(incidence.adjacent_vertices(i).begin(), incidence.adjacent_vertices(i).end()), adjacent);
+		EXPECT_EQ(std::vector<Dart>(incidence.incident_faces(i).begin(), incidence.incident_faces(i).end()), incident);
+		++i;
+	});
+	EXPECT_EQ(i, incidence.nb_vertices());
+
+	i = 0u;
+	cmap_.foreach_cell([&] (Face f)
+	{
+		EXPECT_EQ(incidence.face_index(f.dart), i);
+		std::vector<Dart> vertices, csr_vertices;
+		cmap_.foreach_incident_vertex(f, [&] (Vertex v) { vertices.push_back(v.dart); });
+		incidence.foreach_incident_vertex(f, [&] (Vertex v) { csr_vertices.push_back(v.dart); });
+		EXPECT_EQ(csr_vertices, vertices);
+		++i;
+	});
+	EXPECT_EQ(i, incidence.nb_faces());
+
+	cmap_.cut_edge(Edge(p1));
+	EXPECT_FALSE(incidence.is_valid());
+	incidence.build();
+	EXPECT_TRUE(incidence.is_valid());
+	EXPECT_EQ(incidence.nb_vertices(), cmap_.nb_cells<Vertex::ORBIT>());
+}
+
 #undef NB_MAX
 
 } // namespace cgogn
@@ -0,0 +1,171 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <cgogn/core/container/chunk_allocator.h>
+#include <cgogn/core/container/chunk_array_container.h>
+#include <cgogn/core/container/chunk_stack.h>
+
+namespace cgogn
+{
+
+class ChunkAllocatorTest : public ::testing::Test
+{
+public:
+
+	using ChunkArrayContainer = cgogn::ChunkArrayContainer<64u, uint32>;
+	template <class T> using ChunkArray = cgogn::ChunkArray<64u, T>;
+
+	ChunkAllocator allocator_;
+
+	void SetUp()
+	{
+		set_chunk_allocator(&allocator_);
+	}
+
+	void TearDown()
+	{
+		set_chunk_allocator(nullptr);
+	}
+};
+
+TEST_F(ChunkAllocatorTest, alignment)
+{
+	for (std::size_t bytes : { 64ul, 1000ul, 4096ul, 100000ul })
+	{
+		void* chunk = allocator_.allocate(bytes);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(chunk) % allocator_.alignment(bytes), 0u);
+		allocator_.deallocate(chunk, bytes);
+	}
+	EXPECT_EQ(allocator_.alignment(64ul), ChunkAllocator::CACHE_LINE_SIZE);
+	EXPECT_EQ(allocator_.alignment(8192ul), ChunkAllocator::PAGE_SIZE);
+}
+
+TEST_F(ChunkAllocatorTest, recycling)
+{
+	void* chunk = allocator_.allocate(1024ul);
+	allocator_.deallocate(chunk, 1024ul);
+	EXPECT_EQ(allocator_.cached_bytes(), 1024ul);
+	EXPECT_EQ(allocator_.allocate(1024ul), chunk);
+	EXPECT_EQ(allocator_.cached_bytes(), 0ul);
+	allocator_.deallocate(chunk, 1024ul);
+
+	allocator_.set_max_cached_bytes(0ul);
+	EXPECT_EQ(allocator_.cached_bytes(), 0ul);
+	allocator_.deallocate(allocator_.allocate(1024ul), 1024ul);
+	EXPECT_EQ(allocator_.cached_bytes(), 0ul);
+}
+
+TEST_F(ChunkAllocatorTest, concurrent_settings)
+{
+	// the settings can be changed while other threads allocate and release chunks
+	std::vector<std::thread> threads;
+	for (uint32 t = 0u; t < 3u; ++t)
+	{
+		threads.emplace_back([this] ()
+		{
+			for (uint32 i = 0u; i < 1000u; ++i)
+				allocator_.deallocate(allocator_.allocate(1024ul), 1024ul);
+		});
+	}
+	for (uint32 i = 0u; i < 1000u; ++i)
+	{
+		allocator_.set_max_cached_bytes(i % 2u == 0u ? 0ul : 4096ul);
+		allocator_.set_huge_pages(i % 2u == 0u);
+	}
+	for (std::thread& t : threads)
+		t.join();
+
+	EXPECT_EQ(allocator_.max_cached_bytes(), 4096ul);
+	EXPECT_LE(allocator_.cached_bytes(), 4096ul);
+}
+
+TEST_F(ChunkAllocatorTest, chunk_arrays)
+{
+	ChunkArrayContainer ca_cont;
+	for (uint32 i = 0u; i < 1000u; ++i)
+		ca_cont.insert_lines<1>();
+
+	ChunkArray<float64>* values = ca_cont.add_chunk_array<float64>("values");
+	for (uint32 i = 0u; i < 1000u; ++i)
+		EXPECT_EQ((*values)[i], 0.0);
+	uint32 chunk_bytes;
+	std::vector<const void*> chunks = values->chunks_pointers(chunk_bytes);
+	EXPECT_EQ(chunk_bytes, 64u * sizeof(float64));
+
+	const std::size_t bytes = chunks.size() * chunk_bytes;
+	ca_cont.remove_chunk_array(values);
+	EXPECT_EQ(allocator_.cached_bytes(), bytes);
+
+	// the chunks of the removed attribute are reused (and cleared) by the new one
+	ChunkArray<float64>* others = ca_cont.add_chunk_array<float64>("others");
+	EXPECT_EQ(allocator_.cached_bytes(), 0ul);
+	std::vector<const void*> others_chunks = others->chunks_pointers(chunk_bytes);
+	std::sort(chunks.begin(), chunks.end());
+	std::sort(others_chunks.begin(), others_chunks.end());
+	EXPECT_EQ(chunks, others_chunks);
+	for (uint32 i = 0u; i < 1000u; ++i)
+		EXPECT_EQ((*others)[i], 0.0);
+}
+
+TEST_F(ChunkAllocatorTest, chunk_stack)
+{
+	ChunkStack<64u, uint32> stack;
+	for (uint32 i = 0u; i < 100u; ++i)
+		stack.push(i);
+	EXPECT_EQ(stack.nb_chunks(), 2u);
+	while (stack.size() > 64u)
+		stack.pop();
+
+	// the head (the 64th element) is in the second chunk, which is kept
+	stack.compact();
+	EXPECT_EQ(stack.nb_chunks(), 2u);
+	EXPECT_EQ(stack.head(), 63u);
+	EXPECT_EQ(allocator_.cached_bytes(), 0ul);
+
+	// the second chunk is given back to the allocator
+	stack.pop();
+	stack.compact();
+	EXPECT_EQ(stack.nb_chunks(), 1u);
+	EXPECT_EQ(stack.head(), 62u);
+	EXPECT_EQ(allocator_.cached_bytes(), 64u * sizeof(uint32));
+
+	// and reused when the stack grows again
+	for (uint32 i = 63u; i < 200u; ++i)
+		stack.push(i);
+	EXPECT_EQ(stack.nb_chunks(), 4u);
+	EXPECT_EQ(allocator_.cached_bytes(), 0ul);
+	for (uint32 i = 200u; i > 0u; --i)
+	{
+		EXPECT_EQ(stack.head(), i - 1u);
+		stack.pop();
+	}
+	EXPECT_TRUE(stack.empty());
+}
+
+} // namespace cgogn
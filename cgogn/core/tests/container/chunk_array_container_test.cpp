@@ -23,7 +23,10 @@
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+
 #include <cgogn/core/container/chunk_array_container.h>
+#include <cgogn/core/utils/thread_pool.h>
 
 namespace cgogn
 {
@@ -78,9 +81,154 @@ TEST_F(ChunkArrayContainerTest, testRemove)
 
 	EXPECT_EQ(ca_cont.size(),40u);
 
-	EXPECT_EQ(i1,37u);
+	EXPECT_EQ(i1,3u);
 	EXPECT_EQ(i2,19u);
-	EXPECT_EQ(i3,3u);
+	EXPECT_EQ(i3,37u);
+}
+
+TEST_F(ChunkArrayContainerTest, test_iteration)
+{
+	ChunkArrayContainer ca_cont;
+
+	for (uint32 i = 0; i < 200; ++i)
+		ca_cont.insert_lines<1>();
+
+	// empty the chunks [16,80) and [160,192), keep a few isolated lines
+	for (uint32 i = 0; i < 200; ++i)
+		if ((i >= 16 && i < 80) || (i >= 160 && i < 192) || (i % 7 == 0))
+			ca_cont.remove_lines<1>(i);
+
+	std::vector<uint32> expected;
+	for (uint32 i = 0; i < 200; ++i)
+		if (ca_cont.used(i))
+			expected.push_back(i);
+
+	std::vector<uint32> forward;
+	for (uint32 i = ca_cont.begin(); i != ca_cont.end(); ca_cont.next(i))
+		forward.push_back(i);
+	EXPECT_EQ(forward, expected);
+
+	std::vector<uint32> backward;
+	for (uint32 i = ca_cont.rbegin(); i != ca_cont.rend(); ca_cont.rnext(i))
+		backward.push_back(i);
+	std::reverse(backward.begin(), backward.end());
+	EXPECT_EQ(backward, expected);
+
+	// holes are refilled from the lowest one
+	EXPECT_EQ(ca_cont.insert_lines<1>(), 0u);
+	EXPECT_EQ(ca_cont.insert_lines<1>(), 7u);
+	EXPECT_EQ(ca_cont.insert_lines<1>(), 14u);
+	EXPECT_EQ(ca_cont.insert_lines<1>(), 16u);
+}
+
+TEST_F(ChunkArrayContainerTest, test_dirty_chunks)
+{
+	ChunkArray<float32> ca;
+	cgogn::ChunkVersions seen;
+
+	// the new chunks are modified
+	ca.set_nb_chunks(4u);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({0u, 1u, 2u, 3u}));
+	EXPECT_TRUE(ca.modified_chunks(seen).empty());
+
+	ca[20u] = 1.0f;
+	ca.set_dirty(20u);
+	ca.set_dirty(47u, 50u);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({1u, 2u, 3u}));
+
+	// each consumer has its own state
+	cgogn::ChunkVersions other;
+	EXPECT_EQ(ca.modified_chunks(other), std::vector<uint32>({0u, 1u, 2u, 3u}));
+	ca.set_dirty(0u);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({0u}));
+	EXPECT_EQ(ca.modified_chunks(other), std::vector<uint32>({0u}));
+
+	ca.add_chunk();
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({4u}));
+	ca.set_nb_chunks(2u);
+	EXPECT_TRUE(ca.modified_chunks(seen).empty());
+	ca.set_nb_chunks(3u);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({2u}));
+	// a reallocated chunk is modified for a consumer that has seen the previous one
+	EXPECT_EQ(ca.modified_chunks(other), std::vector<uint32>({2u}));
+
+	ca.set_all_values(0.0f);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({0u, 1u, 2u}));
+
+	// the versions of another array are forgotten
+	ChunkArray<float32> ca2;
+	ca2.set_nb_chunks(3u);
+	EXPECT_EQ(ca2.modified_chunks(seen), std::vector<uint32>({0u, 1u, 2u}));
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({0u, 1u, 2u}));
+
+	// the modifications of the elements through the array
+	ca.copy_element(1u, 40u);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({0u}));
+	ca.move_element(17u, 33u);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({1u, 2u}));
+	ca.swap_elements(2u, 40u);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({0u, 2u}));
+	ca2.copy_external_element(20u, &ca, 2u);
+	EXPECT_TRUE(ca.modified_chunks(seen).empty());
+	EXPECT_EQ(ca2.modified_chunks(other), std::vector<uint32>({0u, 1u, 2u}));
+	ca2.copy_external_element(20u, &ca, 2u);
+	EXPECT_EQ(ca2.modified_chunks(other), std::vector<uint32>({1u}));
+	std::istringstream in("3.5");
+	ca.import_element(35u, in);
+	EXPECT_EQ(ca.modified_chunks(seen), std::vector<uint32>({2u}));
+	EXPECT_EQ(ca[35u], 3.5f);
+
+	cgogn::ChunkArrayBool<16u> cab;
+	cgogn::ChunkVersions seen_bool;
+	cab.set_nb_chunks(2u);
+	cab.modified_chunks(seen_bool);
+	cab.copy_element(20u, 1u);
+	EXPECT_EQ(cab.modified_chunks(seen_bool), std::vector<uint32>({1u}));
+	cab.swap_elements(3u, 4u);
+	EXPECT_EQ(cab.modified_chunks(seen_bool), std::vector<uint32>({0u}));
+
+	// concurrent reports
+	ca.set_nb_chunks(100u);
+	ca.modified_chunks(seen);
+	cgogn::parallel_for(0u, 100u * 16u, 8u, [&] (uint32 first, uint32 last)
+	{
+		for (uint32 i = first; i < last; ++i)
+			if (i % 48u == 0u)
+				ca.set_dirty(i);
+	});
+	std::vector<uint32> expected;
+	for (uint32 c = 0u; c < 100u; c += 3u)
+		expected.push_back(c);
+	EXPECT_EQ(ca.modified_chunks(seen), expected);
+}
+
+TEST_F(ChunkArrayContainerTest, test_append_lines)
+{
+	ChunkArrayContainer ca_cont;
+	ChunkArray<uint32>* indices = ca_cont.add_chunk_array<uint32>("indices");
+
+	for (uint32 i = 0u; i < 10u; ++i)
+		ca_cont.insert_lines<1>();
+	ca_cont.remove_lines<1>(3u);
+
+	// the hole is not reused
+	EXPECT_EQ(ca_cont.append_lines(40u), 10u);
+	EXPECT_EQ(ca_cont.size(), 49u);
+	EXPECT_EQ(ca_cont.end(), 50u);
+	EXPECT_FALSE(ca_cont.used(3u));
+	for (uint32 i = 10u; i < 50u; ++i)
+	{
+		EXPECT_TRUE(ca_cont.used(i));
+		EXPECT_EQ(ca_cont.nb_refs(i), 1u);
+		(*indices)[i] = i;
+	}
+
+	// the next insertions fill the hole then the following chunks
+	EXPECT_EQ(ca_cont.insert_lines<1>(), 3u);
+	for (uint32 i = 50u; i < 70u; ++i)
+		EXPECT_EQ(ca_cont.insert_lines<1>(), i);
+	EXPECT_EQ(ca_cont.size(), 70u);
+	EXPECT_EQ((*indices)[49u], 49u);
 }
 
 TEST_F(ChunkArrayContainerTest, test_compact)
@@ -139,6 +287,43 @@ TEST_F(ChunkArrayContainerTest, test_compact)
 
 }
 
+TEST_F(ChunkArrayContainerTest, test_compact_order)
+{
+	using DATA = uint32;
+	ChunkArrayContainer ca_cont;
+	ChunkArray<DATA>* indices = ca_cont.add_chunk_array<DATA>("indices");
+
+	for (uint32 i = 0; i < 40; ++i)
+	{
+		ca_cont.insert_lines<1>();
+		indices->operator[](i) = i;
+	}
+
+	for (uint32 i = 0; i < 40; i += 3)
+		ca_cont.remove_lines<1>(i);
+
+	EXPECT_EQ(ca_cont.size(), 26u);
+
+	// reverse order of the used lines, except line 1 that is not given
+	std::vector<uint32> order;
+	for (uint32 i = 39; i > 1; --i)
+		if (ca_cont.used(i))
+			order.push_back(i);
+
+	std::vector<uint32> old_new = ca_cont.compact<1>(order);
+
+	EXPECT_EQ(ca_cont.size(), 26u);
+	EXPECT_EQ(ca_cont.end(), 26u);
+	for (uint32 k = 0; k < order.size(); ++k)
+	{
+		EXPECT_EQ(old_new[order[k]], k);
+		EXPECT_EQ(indices->operator[](k), order[k]);
+	}
+	EXPECT_EQ(old_new[1], 25u);
+	EXPECT_EQ(indices->operator[](25), 1u);
+	EXPECT_EQ(old_new[0], std::numeric_limits<uint32>::max());
+}
+
 TEST_F(ChunkArrayContainerTest, test_compact_tri)
 {
 	using DATA = uint32;
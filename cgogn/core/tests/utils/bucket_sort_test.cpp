@@ -0,0 +1,70 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <cgogn/core/utils/bucket_sort.h>
+
+TEST(BucketSortTest, parallel_bucket_sort)
+{
+	const cgogn::uint32 nb_keys = 5000u;
+	const cgogn::uint32 nb = 300000u;
+
+	// every 7th element has no bucket
+	auto key = [] (cgogn::uint32 i) -> cgogn::uint32
+	{
+		return i % 7u == 0u ? cgogn::INVALID_INDEX : (i * 2654435761u) % nb_keys;
+	};
+
+	std::vector<cgogn::uint32> offsets;
+	std::vector<cgogn::uint32> elements;
+	cgogn::parallel_bucket_sort(nb_keys, nb, key, offsets, elements);
+
+	ASSERT_EQ(offsets.size(), nb_keys + 1u);
+	EXPECT_EQ(offsets.front(), 0u);
+	EXPECT_EQ(offsets.back(), nb - (nb + 6u) / 7u);
+	EXPECT_EQ(elements.size(), offsets.back());
+
+	bool ok = true;
+	for (cgogn::uint32 k = 0u; k < nb_keys; ++k)
+	{
+		for (cgogn::uint32 j = offsets[k]; j < offsets[k + 1u]; ++j)
+		{
+			ok &= key(elements[j]) == k;
+			if (j > offsets[k])
+				ok &= elements[j - 1u] < elements[j];
+		}
+	}
+	EXPECT_TRUE(ok);
+}
+
+TEST(BucketSortTest, empty)
+{
+	std::vector<cgogn::uint32> offsets;
+	std::vector<cgogn::uint32> elements;
+	cgogn::parallel_bucket_sort(3u, 0u, [] (cgogn::uint32) { return 0u; }, offsets, elements);
+	EXPECT_EQ(offsets, std::vector<cgogn::uint32>(4u, 0u));
+	EXPECT_TRUE(elements.empty());
+}
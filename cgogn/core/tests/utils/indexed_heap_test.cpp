@@ -0,0 +1,94 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <cgogn/core/utils/indexed_heap.h>
+
+TEST(IndexedHeapTest, sorted_pop)
+{
+	const cgogn::uint32 nb = 10000u;
+	std::mt19937 gen(42u);
+	std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+	cgogn::IndexedHeap<double> heap;
+	std::vector<double> priorities(nb);
+	for (cgogn::uint32 i = 0u; i < nb; ++i)
+	{
+		priorities[i] = dist(gen);
+		heap.set(i, priorities[i]);
+	}
+	EXPECT_EQ(heap.size(), nb);
+
+	// increase, decrease and remove some priorities
+	for (cgogn::uint32 i = 0u; i < nb; i += 3u)
+	{
+		priorities[i] = i % 2u == 0u ? priorities[i] * 0.5 : priorities[i] + 1.0;
+		heap.set(i, priorities[i]);
+	}
+	for (cgogn::uint32 i = 1u; i < nb; i += 5u)
+	{
+		heap.erase(i);
+		EXPECT_FALSE(heap.contains(i));
+	}
+	heap.erase(nb + 10u);
+
+	std::vector<double> expected;
+	for (cgogn::uint32 i = 0u; i < nb; ++i)
+	{
+		if (heap.contains(i))
+		{
+			EXPECT_EQ(heap.priority(i), priorities[i]);
+			expected.push_back(priorities[i]);
+		}
+	}
+	std::sort(expected.begin(), expected.end());
+	EXPECT_EQ(heap.size(), cgogn::uint32(expected.size()));
+
+	std::vector<double> popped;
+	while (!heap.empty())
+	{
+		const double p = heap.top_priority();
+		EXPECT_EQ(priorities[heap.pop()], p);
+		popped.push_back(p);
+	}
+	EXPECT_EQ(popped, expected);
+}
+
+TEST(IndexedHeapTest, clear)
+{
+	cgogn::IndexedHeap<cgogn::uint32, 2u> heap;
+	heap.reserve(10u);
+	for (cgogn::uint32 i = 0u; i < 10u; ++i)
+		heap.set(i, 10u - i);
+	EXPECT_EQ(heap.top(), 9u);
+	heap.clear();
+	EXPECT_TRUE(heap.empty());
+	EXPECT_FALSE(heap.contains(9u));
+	heap.set(25u, 1u);
+	EXPECT_EQ(heap.pop(), 25u);
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include <cgogn/core/utils/thread_pool.h>
+
+TEST(ThreadPoolTest, enqueue)
+{
+	cgogn::ThreadPool* pool = cgogn::thread_pool();
+
+	std::atomic<cgogn::uint32> counter(0u);
+	std::vector<std::future<void>> futures;
+	for (cgogn::uint32 i = 0u; i < 100u; ++i)
+		futures.push_back(pool->enqueue([&counter] () { ++counter; }));
+	for (auto& fu : futures)
+		fu.wait();
+
+	EXPECT_EQ(counter.load(), 100u);
+}
+
+TEST(ThreadPoolTest, parallel_for)
+{
+	const cgogn::uint32 nb = 100000u;
+	std::vector<cgogn::uint32> values(nb, 0u);
+
+	cgogn::parallel_for(0u, nb, 64u, [&values] (cgogn::uint32 first, cgogn::uint32 last)
+	{
+		for (cgogn::uint32 i = first; i < last; ++i)
+			values[i] += i;
+	});
+
+	bool ok = true;
+	for (cgogn::uint32 i = 0u; i < nb; ++i)
+		ok &= (values[i] == i);
+	EXPECT_TRUE(ok);
+
+	// empty range
+	cgogn::parallel_for(10u, 10u, 1u, [] (cgogn::uint32, cgogn::uint32) { FAIL(); });
+}
+
+TEST(ThreadPoolTest, nested_parallel_for)
+{
+	std::atomic<cgogn::uint32> counter(0u);
+
+	cgogn::parallel_for(0u, 16u, 1u, [&counter] (cgogn::uint32 first, cgogn::uint32 last)
+	{
+		for (cgogn::uint32 i = first; i < last; ++i)
+		{
+			cgogn::parallel_for(0u, 1000u, 10u, [&counter] (cgogn::uint32 f, cgogn::uint32 l)
+			{
+				counter += l - f;
+			});
+		}
+	});
+
+	EXPECT_EQ(counter.load(), 16000u);
+}
+
+TEST(ThreadPoolTest, thread_index)
+{
+	cgogn::ThreadPool* pool = cgogn::thread_pool();
+	const cgogn::uint32 nb_workers = pool->nb_workers();
+
+	std::vector<cgogn::uint32> nb_per_thread(nb_workers, 0u);
+	pool->parallel_for(0u, 10000u, 16u, [&] (cgogn::uint32 first, cgogn::uint32 last)
+	{
+		nb_per_thread[cgogn::current_thread_index()] += last - first;
+	});
+
+	cgogn::uint32 total = 0u;
+	for (cgogn::uint32 n : nb_per_thread)
+		total += n;
+	EXPECT_EQ(total, 10000u);
+}
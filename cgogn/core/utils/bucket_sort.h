@@ -0,0 +1,147 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_BUCKET_SORT_H_
+#define CGOGN_CORE_UTILS_BUCKET_SORT_H_
+
+#include <vector>
+#include <algorithm>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/assert.h>
+#include <cgogn/core/utils/type_traits.h>
+#include <cgogn/core/utils/thread.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief sort the elements [0, nb_elements) in buckets given by their key, in parallel
+ * The elements of the bucket k are elements[offsets[k]] ... elements[offsets[k+1]-1], in increasing order.
+ * The sort is a stable LSD radix sort on the keys: each pass counts the digits of fixed blocks of elements
+ * in parallel, then scatters the blocks at their position, without any atomic operation.
+ * @param nb_keys number of buckets
+ * @param nb_elements number of elements
+ * @param key function (uint32 element) -> uint32 that returns the bucket of an element in [0, nb_keys),
+ * or INVALID_INDEX for an element that is not put in any bucket
+ * @param offsets filled with the nb_keys+1 offsets of the buckets in elements
+ * @param elements filled with the sorted elements
+ */
+template <typename KEY>
+void parallel_bucket_sort(uint32 nb_keys, uint32 nb_elements, const KEY& key, std::vector<uint32>& offsets, std::vector<uint32>& elements)
+{
+	static_assert(is_func_parameter_same<KEY, uint32>::value, "Wrong function parameter type");
+
+	const uint32 RADIX_BITS = 11u;
+	const uint32 RADIX = 1u << RADIX_BITS;
+	const uint32 BLOCK_SIZE = 1u << 16u;
+
+	// the elements without bucket are put in an extra bucket nb_keys, removed at the end
+	std::vector<uint32> keys(nb_elements);
+	elements.resize(nb_elements);
+	parallel_for(0u, nb_elements, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+	{
+		for (uint32 i = first; i < last; ++i)
+		{
+			const uint32 k = key(i);
+			cgogn_message_assert(k < nb_keys || k == INVALID_INDEX, "parallel_bucket_sort: key out of range");
+			keys[i] = k == INVALID_INDEX ? nb_keys : k;
+			elements[i] = i;
+		}
+	});
+
+	uint32 nb_bits = 0u;
+	while (nb_bits < 32u && (nb_keys >> nb_bits) != 0u)
+		++nb_bits;
+
+	const uint32 nb_blocks = (nb_elements + BLOCK_SIZE - 1u) / BLOCK_SIZE;
+	std::vector<uint32> histograms(std::size_t(nb_blocks) * RADIX);
+	std::vector<uint32> tmp_keys(nb_elements);
+	std::vector<uint32> tmp_elements(nb_elements);
+
+	for (uint32 shift = 0u; shift < nb_bits; shift += RADIX_BITS)
+	{
+		std::fill(histograms.begin(), histograms.end(), 0u);
+		parallel_for(0u, nb_blocks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 b = first; b < last; ++b)
+			{
+				uint32* h = &histograms[std::size_t(b) * RADIX];
+				for (uint32 i = b * BLOCK_SIZE, end = std::min(nb_elements, (b + 1u) * BLOCK_SIZE); i < end; ++i)
+					++h[(keys[i] >> shift) & (RADIX - 1u)];
+			}
+		});
+
+		// histograms become the first position of each (digit, block)
+		uint32 sum = 0u;
+		for (uint32 d = 0u; d < RADIX; ++d)
+		{
+			for (uint32 b = 0u; b < nb_blocks; ++b)
+			{
+				uint32& h = histograms[std::size_t(b) * RADIX + d];
+				const uint32 count = h;
+				h = sum;
+				sum += count;
+			}
+		}
+
+		parallel_for(0u, nb_blocks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 b = first; b < last; ++b)
+			{
+				uint32* h = &histograms[std::size_t(b) * RADIX];
+				for (uint32 i = b * BLOCK_SIZE, end = std::min(nb_elements, (b + 1u) * BLOCK_SIZE); i < end; ++i)
+				{
+					const uint32 pos = h[(keys[i] >> shift) & (RADIX - 1u)]++;
+					tmp_keys[pos] = keys[i];
+					tmp_elements[pos] = elements[i];
+				}
+			}
+		});
+
+		keys.swap(tmp_keys);
+		elements.swap(tmp_elements);
+	}
+
+	// offsets of the buckets: each element starting a new key fills the offsets of the keys up to it
+	offsets.resize(nb_keys + 1u);
+	parallel_for(0u, nb_elements, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+	{
+		for (uint32 i = first; i < last; ++i)
+		{
+			const uint32 first_key = i == 0u ? 0u : keys[i - 1u] + 1u;
+			for (uint32 k = first_key; k <= keys[i]; ++k)
+				offsets[k] = i;
+		}
+	});
+	const uint32 last_key = nb_elements == 0u ? 0u : keys[nb_elements - 1u] + 1u;
+	for (uint32 k = last_key; k <= nb_keys; ++k)
+		offsets[k] = nb_elements;
+
+	elements.resize(offsets[nb_keys]);
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_BUCKET_SORT_H_
@@ -0,0 +1,222 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_INDEXED_HEAP_H_
+#define CGOGN_CORE_UTILS_INDEXED_HEAP_H_
+
+#include <vector>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/assert.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The IndexedHeap class is a min priority queue of indices (e.g. cell embeddings) stored in an implicit d-ary heap.
+ * The position of each index in the heap is stored in a table indexed by the indices, so that the priority
+ * of an index can be changed or the index removed in O(log n), without any per element allocation.
+ * Between equal priorities, the order is unspecified.
+ * @tparam PRIORITY the type of the priorities (compared with <)
+ * @tparam ARITY the number of children of a node of the heap (4 keeps a node and its children in a cache line)
+ */
+template <typename PRIORITY, uint32 ARITY = 4u>
+class IndexedHeap
+{
+	static_assert(ARITY >= 2u, "IndexedHeap: the arity must be at least 2");
+
+public:
+
+	using Self = IndexedHeap<PRIORITY, ARITY>;
+
+	inline IndexedHeap()
+	{}
+
+	/**
+	 * @brief reserve the memory for the indices [0, nb_indices)
+	 */
+	inline void reserve(uint32 nb_indices)
+	{
+		if (nb_indices > positions_.size())
+			positions_.resize(nb_indices, INVALID_INDEX);
+		nodes_.reserve(nb_indices);
+	}
+
+	inline bool empty() const { return nodes_.empty(); }
+
+	inline uint32 size() const { return uint32(nodes_.size()); }
+
+	inline bool contains(uint32 index) const
+	{
+		return index < positions_.size() && positions_[index] != INVALID_INDEX;
+	}
+
+	inline const PRIORITY& priority(uint32 index) const
+	{
+		cgogn_message_assert(contains(index), "IndexedHeap: index not in the heap");
+		return nodes_[positions_[index]].priority_;
+	}
+
+	/**
+	 * @return the index of minimal priority
+	 */
+	inline uint32 top() const
+	{
+		cgogn_message_assert(!empty(), "IndexedHeap: empty heap");
+		return nodes_[0u].index_;
+	}
+
+	inline const PRIORITY& top_priority() const
+	{
+		cgogn_message_assert(!empty(), "IndexedHeap: empty heap");
+		return nodes_[0u].priority_;
+	}
+
+	/**
+	 * @brief insert the index with the given priority, or change its priority if it is already in the heap
+	 */
+	inline void set(uint32 index, const PRIORITY& p)
+	{
+		if (index >= positions_.size())
+			positions_.resize(index + 1u, INVALID_INDEX);
+
+		uint32 pos = positions_[index];
+		if (pos == INVALID_INDEX)
+		{
+			pos = uint32(nodes_.size());
+			nodes_.push_back(Node{p, index});
+			sift_up(pos);
+		}
+		else if (p < nodes_[pos].priority_)
+		{
+			nodes_[pos].priority_ = p;
+			sift_up(pos);
+		}
+		else
+		{
+			nodes_[pos].priority_ = p;
+			sift_down(pos);
+		}
+	}
+
+	/**
+	 * @brief remove the index from the heap (nothing is done if it is not in the heap)
+	 */
+	inline void erase(uint32 index)
+	{
+		if (!contains(index))
+			return;
+
+		const uint32 pos = positions_[index];
+		positions_[index] = INVALID_INDEX;
+		const Node last = nodes_.back();
+		nodes_.pop_back();
+		if (pos == nodes_.size())
+			return;
+
+		nodes_[pos] = last;
+		positions_[last.index_] = pos;
+		if (pos > 0u && last.priority_ < nodes_[parent(pos)].priority_)
+			sift_up(pos);
+		else
+			sift_down(pos);
+	}
+
+	/**
+	 * @brief remove the index of minimal priority from the heap
+	 * @return the removed index
+	 */
+	inline uint32 pop()
+	{
+		const uint32 index = top();
+		erase(index);
+		return index;
+	}
+
+	inline void clear()
+	{
+		for (const Node& n : nodes_)
+			positions_[n.index_] = INVALID_INDEX;
+		nodes_.clear();
+	}
+
+private:
+
+	struct Node
+	{
+		PRIORITY priority_;
+		uint32 index_;
+	};
+
+	static inline uint32 parent(uint32 pos) { return (pos - 1u) / ARITY; }
+	static inline uint32 first_child(uint32 pos) { return pos * ARITY + 1u; }
+
+	inline void sift_up(uint32 pos)
+	{
+		const Node n = nodes_[pos];
+		while (pos > 0u)
+		{
+			const uint32 p = parent(pos);
+			if (!(n.priority_ < nodes_[p].priority_))
+				break;
+			nodes_[pos] = nodes_[p];
+			positions_[nodes_[pos].index_] = pos;
+			pos = p;
+		}
+		nodes_[pos] = n;
+		positions_[n.index_] = pos;
+	}
+
+	inline void sift_down(uint32 pos)
+	{
+		const Node n = nodes_[pos];
+		const uint32 size = uint32(nodes_.size());
+		for (;;)
+		{
+			const uint32 first = first_child(pos);
+			if (first >= size)
+				break;
+			const uint32 last = first + ARITY < size ? first + ARITY : size;
+			uint32 min = first;
+			for (uint32 c = first + 1u; c < last; ++c)
+			{
+				if (nodes_[c].priority_ < nodes_[min].priority_)
+					min = c;
+			}
+			if (!(nodes_[min].priority_ < n.priority_))
+				break;
+			nodes_[pos] = nodes_[min];
+			positions_[nodes_[pos].index_] = pos;
+			pos = min;
+		}
+		nodes_[pos] = n;
+		positions_[n.index_] = pos;
+	}
+
+	std::vector<Node> nodes_;
+	std::vector<uint32> positions_;
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_INDEXED_HEAP_H_
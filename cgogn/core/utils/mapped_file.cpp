@@ -0,0 +1,179 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/utils/mapped_file.h>
+#include <cgogn/core/utils/logger.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cgogn
+{
+
+MappedFile::MappedFile() :
+	data_(nullptr),
+	size_(0ul)
+#ifdef _WIN32
+	,file_handle_(nullptr)
+	,mapping_handle_(nullptr)
+#endif
+{}
+
+#ifdef _WIN32
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& filename)
+{
+	std::shared_ptr<MappedFile> mf(new MappedFile());
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		cgogn_log_error("MappedFile::open") << "Unable to open the file \"" << filename << "\".";
+		return nullptr;
+	}
+	mf->file_handle_ = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		cgogn_log_error("MappedFile::open") << "Empty or unreadable file \"" << filename << "\".";
+		return nullptr;
+	}
+	mf->size_ = std::size_t(size.QuadPart);
+
+	// PAGE_WRITECOPY + FILE_MAP_COPY: written pages are private copies
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		cgogn_log_error("MappedFile::open") << "Unable to map the file \"" << filename << "\".";
+		return nullptr;
+	}
+	mf->mapping_handle_ = mapping;
+
+	mf->data_ = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+	if (mf->data_ == nullptr)
+	{
+		cgogn_log_error("MappedFile::open") << "Unable to map the file \"" << filename << "\".";
+		return nullptr;
+	}
+
+	return mf;
+}
+
+MappedFile::~MappedFile()
+{
+	if (data_ != nullptr)
+		UnmapViewOfFile(data_);
+	if (mapping_handle_ != nullptr)
+		CloseHandle(mapping_handle_);
+	if (file_handle_ != nullptr)
+		CloseHandle(file_handle_);
+}
+
+#else
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& filename)
+{
+	const int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		cgogn_log_error("MappedFile::open") << "Unable to open the file \"" << filename << "\".";
+		return nullptr;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		cgogn_log_error("MappedFile::open") << "Empty or unreadable file \"" << filename << "\".";
+		::close(fd);
+		return nullptr;
+	}
+
+	// MAP_PRIVATE + PROT_WRITE: written pages are private copies
+	void* addr = mmap(nullptr, std::size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	::close(fd); // the mapping keeps its own reference on the file
+	if (addr == MAP_FAILED)
+	{
+		cgogn_log_error("MappedFile::open") << "Unable to map the file \"" << filename << "\".";
+		return nullptr;
+	}
+
+	std::shared_ptr<MappedFile> mf(new MappedFile());
+	mf->data_ = static_cast<char*>(addr);
+	mf->size_ = std::size_t(st.st_size);
+	return mf;
+}
+
+MappedFile::~MappedFile()
+{
+	if (data_ != nullptr)
+		munmap(data_, size_);
+}
+
+#endif // _WIN32
+
+MemoryStreambuf::MemoryStreambuf(const char* data, std::size_t size)
+{
+	char* p = const_cast<char*>(data);
+	this->setg(p, p, p + size);
+}
+
+std::size_t MemoryStreambuf::position() const
+{
+	return std::size_t(this->gptr() - this->eback());
+}
+
+MemoryStreambuf::pos_type MemoryStreambuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+	if (!(which & std::ios_base::in))
+		return pos_type(off_type(-1));
+
+	char* p = nullptr;
+	switch (dir)
+	{
+		case std::ios_base::beg: p = this->eback() + off; break;
+		case std::ios_base::cur: p = this->gptr() + off; break;
+		default: p = this->egptr() + off; break;
+	}
+	if (p < this->eback() || p > this->egptr())
+		return pos_type(off_type(-1));
+
+	this->setg(this->eback(), p, this->egptr());
+	return pos_type(off_type(p - this->eback()));
+}
+
+MemoryStreambuf::pos_type MemoryStreambuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+} // namespace cgogn
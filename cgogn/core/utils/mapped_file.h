@@ -0,0 +1,112 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_MAPPED_FILE_H_
+#define CGOGN_CORE_UTILS_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+#include <cgogn/core/dll.h>
+#include <cgogn/core/utils/definitions.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief read-only file mapped in memory with a private (copy-on-write) view.
+ * The pages are loaded on demand by the system and can be written:
+ * a written page is copied and the modification never reaches the file.
+ * Objects that use the mapped memory keep a shared_ptr on the MappedFile.
+ */
+class CGOGN_CORE_API MappedFile final
+{
+public:
+
+	/**
+	 * @brief map the whole file in memory
+	 * @param filename name of the file
+	 * @return the mapped file or nullptr if the file can not be mapped
+	 */
+	static std::shared_ptr<MappedFile> open(const std::string& filename);
+
+	~MappedFile();
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(MappedFile);
+
+	inline char* data() const { return data_; }
+
+	inline std::size_t size() const { return size_; }
+
+	/**
+	 * @brief test if a pointer lies in the mapped memory
+	 */
+	inline bool contains(const void* ptr) const
+	{
+		const char* p = static_cast<const char*>(ptr);
+		return p >= data_ && p < data_ + size_;
+	}
+
+	/**
+	 * @return the alignment of the chunks stored in mapped files (the page size),
+	 * so that copy-on-write of a chunk never touches its neighbours
+	 */
+	static inline std::size_t alignment() { return 4096ul; }
+
+private:
+
+	MappedFile();
+
+	char* data_;
+	std::size_t size_;
+#ifdef _WIN32
+	void* file_handle_;
+	void* mapping_handle_;
+#endif
+};
+
+/**
+ * @brief streambuf reading a memory area (used to read serialized data from a MappedFile)
+ */
+class CGOGN_CORE_API MemoryStreambuf : public std::streambuf
+{
+public:
+
+	MemoryStreambuf(const char* data, std::size_t size);
+
+	/**
+	 * @return the number of bytes read
+	 */
+	std::size_t position() const;
+
+protected:
+
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_MAPPED_FILE_H_
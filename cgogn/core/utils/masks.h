@@ -26,8 +26,13 @@
 
 #include <vector>
 #include <array>
+#include <atomic>
+#include <algorithm>
+#include <functional>
 
 #include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread.h>
+#include <cgogn/core/utils/thread_pool.h>
 #include <cgogn/core/basic/cell.h>
 #include <cgogn/core/cmap/attribute.h>
 
@@ -366,6 +371,13 @@ private:
 template <typename MAP>
 uint32 FilteredQuickTraversor<MAP>::fqt_counter_ = 0u;
 
+/**
+ * @brief The CellCache class
+ * A CellCache stores the darts of the cells of some orbits in flat vectors that can be traversed
+ * (see map.foreach_cell and map.parallel_foreach_cell) or split in equal ranges by the workers.
+ * In embedded mode (see set_embedded), it also stores the embedding index of each cell, so that the
+ * attributes of the cached cells can be accessed without going through the embeddings of the map.
+ */
 template <typename MAP>
 class CellCache : public CellTraversor
 {
@@ -379,7 +391,8 @@ public:
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(CellCache);
 
 	inline CellCache(const MAP& m) : Inherit(),
-		map_(m)
+		map_(m),
+		embedded_cells_(0u)
 	{}
 
 	template <typename CellType>
@@ -400,14 +413,71 @@ public:
 		return cells_[CellType::ORBIT].size();
 	}
 
+	/**
+	 * @return the darts of the cached cells of type CellType
+	 */
+	template <typename CellType>
+	inline const std::vector<Dart>& cells() const
+	{
+		return cells_[CellType::ORBIT];
+	}
+
+	/**
+	 * @return the embedding indices of the cached cells of type CellType (empty if they are not stored)
+	 */
+	template <typename CellType>
+	inline const std::vector<uint32>& embeddings() const
+	{
+		return embeddings_[CellType::ORBIT];
+	}
+
+	/**
+	 * @brief store (or not) the embedding indices of the cells of type CellType from the next build
+	 * The orbit must be embedded in the map.
+	 */
+	template <typename CellType>
+	inline void set_embedded(bool b = true)
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		cgogn_message_assert(!b || map_.template is_embedded<CellType>(), "CellCache::set_embedded: the orbit is not embedded");
+		if (b)
+			embedded_cells_ |= orbit_mask<CellType>();
+		else
+		{
+			embedded_cells_ &= ~orbit_mask<CellType>();
+			embeddings_[ORBIT].clear();
+			embeddings_[ORBIT].shrink_to_fit();
+		}
+	}
+
+	template <typename CellType>
+	inline bool is_embedded() const
+	{
+		return (embedded_cells_ & orbit_mask<CellType>()) != 0u;
+	}
+
 	template <typename CellType, typename MASK, typename DartSelectionFunction>
 	inline void build(const MASK& mask, const DartSelectionFunction& dart_select)
 	{
 		static_assert(is_func_return_same<DartSelectionFunction, Dart>::value && is_func_parameter_same<DartSelectionFunction, CellType>::value, "Badly formed DartSelectionFunction");
 		static const Orbit ORBIT = CellType::ORBIT;
-		cells_[ORBIT].clear();
-		cells_[ORBIT].reserve(4096u);
-		map_.foreach_cell([&] (CellType c) { cells_[ORBIT].push_back(dart_select(c)); }, mask);
+		this->template clear<CellType>();
+		if (map_.template is_embedded<CellType>())
+			cells_[ORBIT].reserve(map_.template attribute_container<ORBIT>().size());
+		else
+			cells_[ORBIT].reserve(4096u);
+		if (this->template is_embedded<CellType>())
+		{
+			embeddings_[ORBIT].reserve(cells_[ORBIT].capacity());
+			map_.foreach_cell([&] (CellType c)
+			{
+				cells_[ORBIT].push_back(dart_select(c));
+				embeddings_[ORBIT].push_back(map_.embedding(c));
+			},
+			mask);
+		}
+		else
+			map_.foreach_cell([&] (CellType c) { cells_[ORBIT].push_back(dart_select(c)); }, mask);
 		traversed_cells_ |= orbit_mask<CellType>();
 	}
 
@@ -429,12 +499,120 @@ public:
 		);
 	}
 
+	/**
+	 * @brief build the cache of the cells of type CellType selected by the filter function in parallel
+	 * The cells are stored in the same order as with build (order of their first dart).
+	 * The filter and dart selection functions are called by the workers.
+	 * Non embedded orbits are built sequentially.
+	 */
+	template <typename CellType, typename FilterFunction, typename DartSelectionFunction>
+	inline void parallel_build(const FilterFunction& filter, const DartSelectionFunction& dart_select)
+	{
+		static_assert(is_func_return_same<FilterFunction, bool>::value && is_func_parameter_same<FilterFunction, CellType>::value, "Badly formed FilterFunction");
+		static_assert(is_func_return_same<DartSelectionFunction, Dart>::value && is_func_parameter_same<DartSelectionFunction, CellType>::value, "Badly formed DartSelectionFunction");
+		static const Orbit ORBIT = CellType::ORBIT;
+
+		if (!map_.template is_embedded<CellType>())
+			return this->build<CellType>(filter, dart_select);
+
+		const auto& topology = map_.topology_container();
+		const uint32 nb_darts = topology.end();
+		const uint32 nb_blocks = (nb_darts + PARALLEL_BUFFER_SIZE - 1u) / PARALLEL_BUFFER_SIZE;
+		const auto foreach_block_dart = [&] (uint32 block, const std::function<void(Dart)>& f)
+		{
+			const uint32 last = std::min(nb_darts, (block + 1u) * PARALLEL_BUFFER_SIZE);
+			for (uint32 i = block * PARALLEL_BUFFER_SIZE; i < last; ++i)
+			{
+				if (topology.used(i) && !map_.is_boundary(Dart(i)))
+					f(Dart(i));
+			}
+		};
+
+		// a cell is represented by its first dart (in index order)
+		std::vector<std::atomic<uint32>> first_dart(map_.template attribute_container<ORBIT>().end());
+		thread_pool()->parallel_for(0u, uint32(first_dart.size()), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				first_dart[i].store(INVALID_INDEX, std::memory_order_relaxed);
+		});
+		thread_pool()->parallel_for(0u, nb_blocks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 b = first; b < last; ++b)
+			{
+				foreach_block_dart(b, [&] (Dart d)
+				{
+					std::atomic<uint32>& fd = first_dart[map_.embedding(CellType(d))];
+					uint32 current = fd.load(std::memory_order_relaxed);
+					while (d.index < current && !fd.compare_exchange_weak(current, d.index, std::memory_order_relaxed))
+					{}
+				});
+			}
+		});
+
+		// each block keeps the cells it represents, then the blocks are concatenated in order
+		const bool embedded = this->template is_embedded<CellType>();
+		std::vector<std::vector<Dart>> block_cells(nb_blocks);
+		std::vector<std::vector<uint32>> block_embeddings(embedded ? nb_blocks : 0u);
+		thread_pool()->parallel_for(0u, nb_blocks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 b = first; b < last; ++b)
+			{
+				foreach_block_dart(b, [&] (Dart d)
+				{
+					const CellType c(d);
+					const uint32 emb = map_.embedding(c);
+					if (first_dart[emb].load(std::memory_order_relaxed) == d.index && filter(c))
+					{
+						block_cells[b].push_back(dart_select(c));
+						if (embedded)
+							block_embeddings[b].push_back(emb);
+					}
+				});
+			}
+		});
+
+		this->template clear<CellType>();
+		std::size_t nb_cells = 0u;
+		for (const auto& bc : block_cells)
+			nb_cells += bc.size();
+		cells_[ORBIT].reserve(nb_cells);
+		for (const auto& bc : block_cells)
+			cells_[ORBIT].insert(cells_[ORBIT].end(), bc.begin(), bc.end());
+		if (embedded)
+		{
+			embeddings_[ORBIT].reserve(nb_cells);
+			for (const auto& be : block_embeddings)
+				embeddings_[ORBIT].insert(embeddings_[ORBIT].end(), be.begin(), be.end());
+		}
+		traversed_cells_ |= orbit_mask<CellType>();
+	}
+
+	template <typename CellType, typename FilterFunction>
+	inline void parallel_build(const FilterFunction& filter)
+	{
+		this->parallel_build<CellType>(
+			filter,
+			[] (CellType c) -> Dart { return c.dart; }
+		);
+	}
+
+	template <typename CellType>
+	inline void parallel_build()
+	{
+		this->parallel_build<CellType>(
+			[] (CellType) { return true; },
+			[] (CellType c) -> Dart { return c.dart; }
+		);
+	}
+
 	template <typename CellType, typename DartSelectionFunction>
 	inline void add(CellType c, const DartSelectionFunction& dart_select)
 	{
 		static_assert(is_func_return_same<DartSelectionFunction, Dart>::value && is_func_parameter_same<DartSelectionFunction, CellType>::value, "Badly formed DartSelectionFunction");
 		static const Orbit ORBIT = CellType::ORBIT;
 		cells_[ORBIT].push_back(dart_select(c));
+		if (this->template is_embedded<CellType>())
+			embeddings_[ORBIT].push_back(map_.embedding(c));
 	}
 
 	template <typename CellType>
@@ -448,12 +626,15 @@ public:
 	{
 		static const Orbit ORBIT = CellType::ORBIT;
 		cells_[ORBIT].clear();
+		embeddings_[ORBIT].clear();
 	}
 
 private:
 
 	const MAP& map_;
 	std::array<std::vector<Dart>, NB_ORBITS> cells_;
+	std::array<std::vector<uint32>, NB_ORBITS> embeddings_;
+	uint32 embedded_cells_;
 };
 
 template <typename MAP>
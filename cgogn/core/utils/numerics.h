@@ -32,6 +32,10 @@
 
 #include <cgogn/core/utils/assert.h>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace cgogn
 {
 
@@ -142,6 +146,36 @@ inline Scalar clamp(const Scalar x, const Scalar min, const Scalar max)
 	return std::min(max, std::max(min, x));
 }
 
+/**
+ * @brief number of trailing zero bits of a non null 64 bits word (index of its lowest set bit)
+ */
+inline uint32 trailing_zeros(uint64 x)
+{
+	cgogn_message_assert(x != 0u, "trailing_zeros: null word");
+#ifdef _MSC_VER
+	unsigned long r;
+	_BitScanForward64(&r, x);
+	return uint32(r);
+#else
+	return uint32(__builtin_ctzll(x));
+#endif
+}
+
+/**
+ * @brief number of leading zero bits of a non null 64 bits word (63 - index of its highest set bit)
+ */
+inline uint32 leading_zeros(uint64 x)
+{
+	cgogn_message_assert(x != 0u, "leading_zeros: null word");
+#ifdef _MSC_VER
+	unsigned long r;
+	_BitScanReverse64(&r, x);
+	return 63u - uint32(r);
+#else
+	return uint32(__builtin_clzll(x));
+#endif
+}
+
 template<typename T, std::size_t bytes, typename enable = void>
 struct fixed_precision {};
 
@@ -25,6 +25,11 @@
 #define CGOGN_CORE_UTILS_PARA_FOR_ELT_H_
 
 #include <vector>
+#include <array>
+#include <tuple>
+#include <limits>
+#include <iterator>
+#include <algorithm>
 #include <type_traits>
 #include <utility>
 
@@ -35,6 +40,113 @@
 
 namespace cgogn
 {
+namespace internal
+{
+	/**
+	 * @brief is_random_access_iterator<IT>::value is true if IT declares the random access iterator category
+	 * (iterators that do not declare any category are considered as sequential)
+	 */
+	template <typename IT>
+	struct is_random_access_iterator
+	{
+		template <typename I>
+		static typename std::is_base_of<std::random_access_iterator_tag, typename I::iterator_category>::type test(int);
+		template <typename I>
+		static typename std::is_pointer<I>::type test(...);
+
+		static const bool value = decltype(test<IT>(0))::value;
+	};
+
+	/**
+	 * @brief parallel traversal of a container with random access iterators:
+	 * each worker processes its own contiguous ranges of elements
+	 */
+	template <typename CONT, typename FUNC>
+	void parallel_foreach_element(CONT& cont, const FUNC& f, std::true_type)
+	{
+		using IterElt = decltype(cont.begin());
+
+		const IterElt first = cont.begin();
+		const uint32 nb = uint32(std::distance(first, cont.end()));
+
+		cgogn::thread_pool()->parallel_for(0u, nb, PARALLEL_BUFFER_SIZE, [&first, &f] (uint32 b, uint32 e)
+		{
+			for (IterElt it = first + b, last = first + e; it != last; ++it)
+				f(*it);
+		});
+	}
+
+	/**
+	 * @brief parallel traversal of a container with sequential iterators:
+	 * the calling thread fills buffers of iterators that are processed by the workers
+	 */
+	template <typename CONT, typename FUNC>
+	void parallel_foreach_element(CONT& cont, const FUNC& f, std::false_type)
+	{
+		using IterElt = decltype(cont.begin());
+		using T_ELT = decltype(*(cont.begin()));
+		using VectItELt = std::vector<IterElt>;
+		using Future = std::future<typename std::result_of<FUNC(T_ELT)>::type>;
+
+		ThreadPool* thread_pool = cgogn::thread_pool();
+		uint32 nb_workers = thread_pool->nb_workers();
+
+		std::array<std::vector<VectItELt*>, 2> elts_buffers;
+		std::array<std::vector<Future>, 2> futures;
+		elts_buffers[0].reserve(nb_workers);
+		elts_buffers[1].reserve(nb_workers);
+		futures[0].reserve(nb_workers);
+		futures[1].reserve(nb_workers);
+
+		Buffers<IterElt> buffs;
+
+		IterElt it = cont.begin();
+		IterElt last = cont.end();
+
+		uint32 i = 0u; // buffer id (0/1)
+		uint32 j = 0u; // thread id (0..nb_workers)
+		while (it != last)
+		{
+			// fill buffer
+			elts_buffers[i].push_back(buffs.buffer());
+			VectItELt& elts = *elts_buffers[i].back();
+			elts.reserve(PARALLEL_BUFFER_SIZE);
+			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it!= last; ++it,++k)
+			{
+				elts.push_back(it);
+			}
+			// launch thread
+			futures[i].push_back(thread_pool->enqueue([&elts, &f] ()
+			{
+				for (auto e : elts)
+					f(*e);
+			}));
+			// next thread
+			if (++j == nb_workers)
+			{	// again from 0 & change buffer
+				j = 0;
+				i = (i+1u) % 2u;
+				for (auto& fu : futures[i])
+					fu.wait();
+				for (auto& b : elts_buffers[i])
+					buffs.release_buffer(b);
+				futures[i].clear();
+				elts_buffers[i].clear();
+			}
+		}
+
+		// clean all at end
+		for (auto& fu : futures[0u])
+			fu.wait();
+		for (auto& b : elts_buffers[0u])
+			buffs.release_buffer(b);
+		for (auto& fu : futures[1u])
+			fu.wait();
+		for (auto& b : elts_buffers[1u])
+			buffs.release_buffer(b);
+	}
+} // namespace internal
+
 /**
  * @brief apply f function on each element of a container in parallel
  * @param cont container
@@ -55,73 +167,14 @@ void parallel_foreach_element(CONT& cont, const FUNC& f)
 				   ||(!std::is_const<CONT>::value)),
 				  "Wrong function parameter type");
 
-
-	using VectItELt = std::vector<IterElt>;
-	using Future = std::future<typename std::result_of<FUNC(T_ELT)>::type>;
-
-	ThreadPool* thread_pool = cgogn::thread_pool();
-	uint32 nb_workers = thread_pool->nb_workers();
-
-	if (nb_workers == 0)
+	if (cgogn::thread_pool()->nb_workers() == 0)
 	{
 		for (T_ELT e: cont)
 			f(e);
 		return;
 	}
 
-	std::array<std::vector<VectItELt*>, 2> elts_buffers;
-	std::array<std::vector<Future>, 2> futures;
-	elts_buffers[0].reserve(nb_workers);
-	elts_buffers[1].reserve(nb_workers);
-	futures[0].reserve(nb_workers);
-	futures[1].reserve(nb_workers);
-
-	Buffers<IterElt> buffs;
-
-	IterElt it = cont.begin();
-	IterElt last = cont.end();
-
-	uint32 i = 0u; // buffer id (0/1)
-	uint32 j = 0u; // thread id (0..nb_workers)
-	while (it != last)
-	{
-		// fill buffer
-		elts_buffers[i].push_back(buffs.buffer());
-		VectItELt& elts = *elts_buffers[i].back();
-		elts.reserve(PARALLEL_BUFFER_SIZE);
-		for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it!= last; ++it,++k)
-		{
-			elts.push_back(it);
-		}
-		// launch thread
-		futures[i].push_back(thread_pool->enqueue([&elts, &f] ()
-		{
-			for (auto e : elts)
-				f(*e);
-		}));
-		// next thread
-		if (++j == nb_workers)
-		{	// again from 0 & change buffer
-			j = 0;
-			i = (i+1u) % 2u;
-			for (auto& fu : futures[i])
-				fu.wait();
-			for (auto& b : elts_buffers[i])
-				buffs.release_buffer(b);
-			futures[i].clear();
-			elts_buffers[i].clear();
-		}
-	}
-
-	// clean all at end
-	for (auto& fu : futures[0u])
-		fu.wait();
-	for (auto& b : elts_buffers[0u])
-		buffs.release_buffer(b);
-	for (auto& fu : futures[1u])
-		fu.wait();
-	for (auto& b : elts_buffers[1u])
-		buffs.release_buffer(b);
+	internal::parallel_foreach_element(cont, f, std::integral_constant<bool, internal::is_random_access_iterator<IterElt>::value>());
 }
 
 
@@ -148,8 +201,68 @@ namespace internal
 	};
 
 
+	/**
+	 * @brief compile time helpers on a tuple of iterators
+	 */
+	template <typename ITS, std::size_t I = std::tuple_size<ITS>::value>
+	struct tuple_iterators
+	{
+		using Previous = tuple_iterators<ITS, I-1u>;
+		using It = typename std::tuple_element<I-1u, ITS>::type;
+
+		static const bool random_access = Previous::random_access && is_random_access_iterator<It>::value;
+
+		static inline void advance(ITS& its, std::ptrdiff_t n)
+		{
+			Previous::advance(its, n);
+			std::get<I-1u>(its) += n;
+		}
+
+		static inline std::ptrdiff_t min_distance(const ITS& firsts, const ITS& lasts)
+		{
+			return std::min(Previous::min_distance(firsts, lasts), std::distance(std::get<I-1u>(firsts), std::get<I-1u>(lasts)));
+		}
+	};
+
+	template <typename ITS>
+	struct tuple_iterators<ITS, 0u>
+	{
+		static const bool random_access = true;
+		static inline void advance(ITS&, std::ptrdiff_t) {}
+		static inline std::ptrdiff_t min_distance(const ITS&, const ITS&) { return std::numeric_limits<std::ptrdiff_t>::max(); }
+	};
+
+	/**
+	 * @brief parallel traversal of containers with random access iterators:
+	 * each worker processes its own contiguous ranges of elements
+	 */
+	template <typename PFP, typename FUNC>
+	void parallel_foreach_elements(PFP& p, const FUNC& f, std::true_type)
+	{
+		using Iterators = typename PFP::Iterators;
+		using TI = tuple_iterators<Iterators>;
+
+		const Iterators firsts = p.begin();
+		const uint32 nb = uint32(TI::min_distance(firsts, p.end()));
+
+		cgogn::thread_pool()->parallel_for(0u, nb, PARALLEL_BUFFER_SIZE, [&firsts, &f] (uint32 b, uint32 e)
+		{
+			Iterators its = firsts;
+			TI::advance(its, std::ptrdiff_t(b));
+			for (uint32 k = b; k < e; ++k)
+			{
+				PFP::call(f, its);
+				TI::advance(its, 1);
+			}
+		});
+	}
+
+	/**
+	 * @brief parallel traversal of containers with sequential iterators:
+	 * the calling thread fills buffers of iterators that are processed by the workers
+	 */
 	template < typename PFP, typename FUNC>
-	void parallel_foreach_elements(PFP p, const FUNC& f)
+	void parallel_foreach_elements(PFP& p, const FUNC& f, std::false_type)
 	{
 		using Iterators = typename PFP::Iterators;
 
@@ -159,19 +272,6 @@ namespace internal
 		ThreadPool* thread_pool = cgogn::thread_pool();
 		uint32 nb_workers = thread_pool->nb_workers();
 
-		// mono-thread case
-		if (nb_workers == 0)
-		{
-			Iterators its = p.begin();
-			Iterators ends = p.end();
-			while (PFP::diff(its, ends))
-			{
-				PFP::call(f, its);
-				p.next(its);
-			}
-			return;
-		}
-
 		std::array<std::vector<VectItELt*>, 2> elts_buffers;
 		std::array<std::vector<Future>, 2> futures;
 		elts_buffers[0].reserve(nb_workers);
@@ -226,6 +326,27 @@ namespace internal
 			buffs.release_buffer(b);
 	}
 
+
+	template <typename PFP, typename FUNC>
+	void parallel_foreach_elements(PFP p, const FUNC& f)
+	{
+		using Iterators = typename PFP::Iterators;
+
+		// mono-thread case
+		if (cgogn::thread_pool()->nb_workers() == 0)
+		{
+			Iterators its = p.begin();
+			Iterators ends = p.end();
+			while (PFP::diff(its, ends))
+			{
+				PFP::call(f, its);
+				p.next(its);
+			}
+			return;
+		}
+
+		parallel_foreach_elements(p, f, std::integral_constant<bool, tuple_iterators<Iterators>::random_access>());
+	}
 }
 
 #define CONT(I) std::get<I>(c_)
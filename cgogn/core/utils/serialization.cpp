@@ -35,6 +35,12 @@ CGOGN_CORE_API bool known_size<std::string>(std::string const* /*src*/)
 	return false;
 }
 
+template <>
+CGOGN_CORE_API bool raw_data<std::string>(std::string const* /*src*/)
+{
+	return false;
+}
+
 // load string
 template <>
 CGOGN_CORE_API void load<std::string>(std::istream& istream, std::string* dest, std::size_t quantity)
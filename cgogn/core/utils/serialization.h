@@ -28,6 +28,7 @@
 #include <vector>
 #include <list>
 #include <array>
+#include <type_traits>
 
 #include <cgogn/core/utils/assert.h>
 #include <cgogn/core/utils/endian.h>
@@ -172,6 +173,41 @@ bool known_size(std::array<U, size> const* /*src*/)
 	return false;
 }
 
+// data saved as a raw copy of its memory (thus usable as is from a mapped file) ?
+// only the trivially copyable types by default, plain types that are not trivially copyable
+// (e.g. fixed size Eigen matrices) can specialize is_raw_data
+template <typename T>
+struct is_raw_data : public std::is_trivially_copyable<T>
+{};
+
+// types with specific save/load functions must overload it
+template <typename T>
+bool raw_data(T const* /*src*/)
+{
+	return is_raw_data<T>::value;
+}
+
+template <>
+CGOGN_CORE_API bool raw_data<std::string>(std::string const* /*src*/);
+
+template <typename U>
+bool raw_data(std::vector<U> const* /*src*/)
+{
+	return false;
+}
+
+template <typename U>
+bool raw_data(std::list<U> const* /*src*/)
+{
+	return false;
+}
+
+template <typename U, std::size_t size>
+bool raw_data(std::array<U, size> const* /*src*/)
+{
+	return sizeof(std::array<U, size>) == size * sizeof(U) && raw_data(static_cast<U const*>(nullptr));
+}
+
 // first step : declare all overrides of load and save
 template <typename U>
 void load(std::istream& istream, std::vector<U>* dest, std::size_t quantity);
@@ -28,19 +28,65 @@ namespace cgogn
 
 {
 
+// pool of which the current thread is a worker (nullptr for other threads)
+static CGOGN_TLS ThreadPool* worker_pool_ = nullptr;
+
+ThreadPool::TaskQueue::TaskQueue() :
+	tasks_(256u),
+	top_(0u),
+	size_(0u)
+{}
+
+void ThreadPool::TaskQueue::push_bottom(const Task& t)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	const uint32 capacity = uint32(tasks_.size());
+	if (size_ == capacity)
+	{
+		// unroll the ring buffer in a twice bigger one
+		std::vector<Task> tasks(2u * capacity);
+		for (uint32 i = 0u; i < size_; ++i)
+			tasks[i] = tasks_[(top_ + i) & (capacity - 1u)];
+		tasks_.swap(tasks);
+		top_ = 0u;
+	}
+	tasks_[(top_ + size_) & (uint32(tasks_.size()) - 1u)] = t;
+	++size_;
+}
+
+bool ThreadPool::TaskQueue::pop_bottom(Task& t)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (size_ == 0u)
+		return false;
+	--size_;
+	t = tasks_[(top_ + size_) & (uint32(tasks_.size()) - 1u)];
+	return true;
+}
+
+bool ThreadPool::TaskQueue::steal_top(Task& t)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (size_ == 0u)
+		return false;
+	t = tasks_[top_];
+	top_ = (top_ + 1u) & (uint32(tasks_.size()) - 1u);
+	--size_;
+	return true;
+}
+
 ThreadPool::~ThreadPool()
 {
 	nb_working_workers_ = uint32(workers_.size());
-	condition_running_.notify_all();
 
 	{
-		std::unique_lock<std::mutex> lock(queue_mutex_);
+		std::lock_guard<std::mutex> lock_run(running_mutex_);
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
 		stop_ = true;
 	}
-#if !(defined(CGOGN_WIN_VER) && (CGOGN_WIN_VER <= 61))
 	condition_running_.notify_all();
 	condition_.notify_all();
-#endif
+
 	for(std::thread &worker: workers_)
 		worker.join();
 }
@@ -48,65 +94,197 @@ ThreadPool::~ThreadPool()
 
 
 ThreadPool::ThreadPool(const std::string& name, uint32 shift_index)
-	:  name_(name), stop_(false), shift_index_(shift_index)
+	:  name_(name),
+	  nb_queued_tasks_(0u),
+	  nb_sleeping_workers_(0u),
+	  next_queue_(0u),
+	  stop_(false),
+	  shift_index_(shift_index)
 {
 	uint32 nb_ww = std::thread::hardware_concurrency();
 	this->nb_working_workers_ = nb_ww;
+
+	queues_.reserve(nb_ww);
+	for (uint32 i = 0u; i < nb_ww; ++i)
+		queues_.emplace_back(new TaskQueue());
+
 	for(uint32 i = 0u; i< nb_ww; ++i)
 	{
 		workers_.emplace_back(
 		[this, i] () -> void
 		{
 			cgogn::thread_start(i,this->shift_index_);
+			worker_pool_ = this;
 			for(;;)
 			{
-				while (i >= this->nb_working_workers_)
+				if (i >= this->nb_working_workers_)
 				{
 					std::unique_lock<std::mutex> lock(this->running_mutex_);
-					this->condition_running_.wait(lock);
+					this->condition_running_.wait(
+						lock,
+						[this, i] { return this->stop_ || i < this->nb_working_workers_; }
+					);
+					continue;
 				}
 
-				std::unique_lock<std::mutex> lock(this->queue_mutex_);
+				Task task;
+				if (this->pop_task(i, task))
+				{
+					// the number of working workers may have been reduced since the test above
+					if (i < this->nb_working_workers_)
+						this->execute_task(task);
+					else
+						this->push_task(task);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(this->sleep_mutex_);
+				++this->nb_sleeping_workers_;
 				this->condition_.wait(
 					lock,
-					[this] { return this->stop_ || !this->tasks_.empty(); }
+					[this] { return this->stop_ || this->nb_queued_tasks_ > 0u; }
 				);
+				--this->nb_sleeping_workers_;
 
-				if (this->stop_ && this->tasks_.empty())
+				if (this->stop_ && this->nb_queued_tasks_ == 0u)
 				{
+					worker_pool_ = nullptr;
 					cgogn::thread_stop();
 					return;
 				}
+			}
+		});
+	}
+}
 
-				if (i < this->nb_working_workers_)
-				{
-					PackagedTask task = std::move(this->tasks_.front());
-					this->tasks_.pop();
-					lock.unlock();
+void ThreadPool::wake_workers(bool all)
+{
+	if (nb_sleeping_workers_ == 0u)
+		return;
+	std::lock_guard<std::mutex> lock(sleep_mutex_);
+	if (all)
+		condition_.notify_all();
+	else
+		condition_.notify_one();
+}
+
+void ThreadPool::push_task(const Task& t)
+{
+	// a worker of this pool pushes in its own queue, other threads distribute their tasks over the working workers
+	uint32 q;
+	if (worker_pool_ == this)
+		q = current_thread_index();
+	else
+		q = next_queue_++ % std::max(nb_working_workers_.load(), 1u);
+
+	// counted before being pushed so that the counter never underflows when the task is stolen immediately
+	++nb_queued_tasks_;
+	queues_[q]->push_bottom(t);
+	wake_workers(false);
+}
+
+bool ThreadPool::pop_task(uint32 worker, Task& t)
+{
+	if (nb_queued_tasks_ == 0u)
+		return false;
+
+	bool found = queues_[worker]->pop_bottom(t);
+	// steal in the queues of the other workers (also the non-working ones that may still have tasks)
+	const uint32 nb_queues = uint32(queues_.size());
+	for (uint32 i = 1u; !found && i < nb_queues; ++i)
+		found = queues_[(worker + i) % nb_queues]->steal_top(t);
+
+	if (found)
+		--nb_queued_tasks_;
+	return found;
+}
+
+void ThreadPool::execute_task(Task& t)
+{
+	if (t.job_ == nullptr)
+	{
 #if defined(_MSC_VER) && _MSC_VER < 1900
-					(*task)();
+		(**t.packaged_)();
 #else
-					task();
+		(*t.packaged_)();
 #endif
-				}
-				else
-				{
-					lock.unlock();
-					condition_.notify_one();
-				}
-			}
-		});
+		delete t.packaged_;
+		return;
+	}
+
+	// split the range: the right halves are left for the thieves
+	RangeJob* job = t.job_;
+	uint32 first = t.first_;
+	uint32 last = t.last_;
+	while (last - first > job->grain_)
+	{
+		const uint32 middle = first + (last - first) / 2u;
+		push_task(Task{job, nullptr, middle, last});
+		last = middle;
+	}
+
+	job->body_(job->func_, first, last);
+
+	const uint32 nb = last - first;
+	if (job->remaining_.fetch_sub(nb) == nb)
+	{
+		std::lock_guard<std::mutex> lock(job->mutex_);
+		job->finished_ = true;
+		job->condition_.notify_all();
 	}
 }
 
+bool ThreadPool::is_worker_thread() const
+{
+	return worker_pool_ == this;
+}
 
+void ThreadPool::run_job(RangeJob& job, uint32 first, uint32 last)
+{
+	if (worker_pool_ == this)
+	{
+		// nested loop: the calling worker processes tasks while the loop is not finished
+		push_task(Task{&job, nullptr, first, last});
+		const uint32 worker = current_thread_index();
+		while (job.remaining_ != 0u)
+		{
+			Task task;
+			if (pop_task(worker, task))
+				execute_task(task);
+			else
+				std::this_thread::yield();
+		}
+	}
+	else
+	{
+		// give one contiguous part of the range to each working worker
+		const uint32 nb_parts = std::min(uint32(nb_working_workers_), last - first);
+		const uint32 part_size = (last - first) / nb_parts;
+		const uint32 rest = (last - first) % nb_parts;
+		nb_queued_tasks_ += nb_parts;
+		uint32 b = first;
+		for (uint32 i = 0u; i < nb_parts; ++i)
+		{
+			const uint32 e = b + part_size + (i < rest ? 1u : 0u);
+			queues_[i]->push_bottom(Task{&job, nullptr, b, e});
+			b = e;
+		}
+		wake_workers(true);
+	}
+
+	std::unique_lock<std::mutex> lock(job.mutex_);
+	job.condition_.wait(lock, [&job] { return job.finished_; });
+}
 
 void ThreadPool::set_nb_workers(uint32 nb )
 {
-	if (nb == 0xffffffff)
-		nb_working_workers_ = uint32(workers_.size());
-	else
-		nb_working_workers_ = std::min(uint32(workers_.size()), nb);
+	{
+		std::lock_guard<std::mutex> lock(running_mutex_);
+		if (nb == 0xffffffff)
+			nb_working_workers_ = uint32(workers_.size());
+		else
+			nb_working_workers_ = std::min(uint32(workers_.size()), nb);
+	}
 
 	condition_running_.notify_all();
 
@@ -114,4 +292,3 @@ void ThreadPool::set_nb_workers(uint32 nb )
 }
 
 } // namespace cgogn
-
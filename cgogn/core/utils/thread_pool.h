@@ -22,11 +22,11 @@
 *******************************************************************************/
 
 /*
- * IMPORTANT : The ThreadPool code (thread_pool.h and thread_pool.cpp) is
- * based on "A Simple c++11 threadpool implementation" found on github
+ * IMPORTANT : The ThreadPool code (thread_pool.h and thread_pool.cpp) was
+ * initially based on "A Simple c++11 threadpool implementation" found on github
  * (https://github.com/progschj/ThreadPool, latest commit : 9a42ec1 )
  * (c) 2012 Jakob Progsch, Václav Zeman
- * It has been modified to fit to our purposes.
+ * It has been modified to fit to our purposes (per-worker work-stealing queues).
  * A copy of its license is provided in the following lines.
  */
 
@@ -57,10 +57,10 @@
 #define CGOGN_CORE_UTILS_THREADPOOL_H_
 
 #include <vector>
-#include <queue>
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <future>
 #include <functional>
@@ -68,10 +68,20 @@
 #include <cgogn/core/utils/logger.h>
 #include <cgogn/core/utils/assert.h>
 #include <cgogn/core/utils/thread.h>
+#include <cgogn/core/utils/type_traits.h>
 
 namespace cgogn
 {
 
+/**
+ * @brief Pool of worker threads with one task queue per worker.
+ * A worker pops the tasks of its own queue in LIFO order and, when it is empty,
+ * steals the oldest tasks of the other queues.
+ * Two kinds of tasks can be submitted:
+ *  - enqueue(f): a single function, with a std::future to wait for its completion
+ *  - parallel_for(first, last, grain, f): a fork/join loop over an index range that is
+ *    recursively split by the workers (no allocation is done for the submission)
+ */
 class CGOGN_CORE_API ThreadPool final
 {
 public:
@@ -88,8 +98,24 @@ public:
 	template <class F, class... Args>
 	std::future<void> enqueue(const F& f, Args&&... args);
 
+	/**
+	 * @brief apply f on sub-ranges of [first, last) in parallel and wait for the end of the loop
+	 * @param first first index of the range
+	 * @param last index after the last index of the range
+	 * @param grain ranges with less than grain indices are not split anymore
+	 * @param f function with 2 parameters (uint32 first, uint32 last) that processes a sub-range
+	 * When called from a worker of this pool (nested loop), the calling worker also processes ranges while waiting.
+	 */
+	template <typename FUNC>
+	void parallel_for(uint32 first, uint32 last, uint32 grain, const FUNC& f);
+
 	~ThreadPool();
 
+	/**
+	 * @return true if the calling thread is a worker of this pool
+	 */
+	bool is_worker_thread() const;
+
 	/**
 	 * @brief get the number of currently working thread for parallel algos
 	 */
@@ -113,6 +139,70 @@ public:
 	void set_nb_workers(uint32 nb = 0xffffffff);
 
 private:
+
+	/**
+	 * @brief shared state of a parallel_for, lives on the stack of the caller
+	 */
+	struct RangeJob
+	{
+		void (*body_)(const void*, uint32, uint32);
+		const void* func_;
+		uint32 grain_;
+		std::atomic<uint32> remaining_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		bool finished_;
+
+		inline RangeJob(void (*body)(const void*, uint32, uint32), const void* func, uint32 grain, uint32 nb) :
+			body_(body), func_(func), grain_(grain), remaining_(nb), finished_(false)
+		{}
+	};
+
+	/**
+	 * @brief a task is either a range of a RangeJob or an enqueued PackagedTask
+	 */
+	struct Task
+	{
+		RangeJob* job_;
+		PackagedTask* packaged_;
+		uint32 first_;
+		uint32 last_;
+	};
+
+	/**
+	 * @brief double ended queue of tasks stored in a ring buffer (only grows, never shrinks)
+	 */
+	class TaskQueue
+	{
+	public:
+
+		TaskQueue();
+		CGOGN_NOT_COPYABLE_NOR_MOVABLE(TaskQueue);
+
+		void push_bottom(const Task& t);
+		bool pop_bottom(Task& t);
+		bool steal_top(Task& t);
+
+	private:
+
+		std::mutex mutex_;
+		std::vector<Task> tasks_;
+		uint32 top_;
+		uint32 size_;
+	};
+
+	template <typename FUNC>
+	static void call_range(const void* f, uint32 first, uint32 last)
+	{
+		(*static_cast<const FUNC*>(f))(first, last);
+	}
+
+	void push_task(const Task& t);
+	bool pop_task(uint32 worker, Task& t);
+	void execute_task(Task& t);
+	void run_job(RangeJob& job, uint32 first, uint32 last);
+	void wake_workers(bool all);
+
 #pragma warning(push)
 #pragma warning(disable:4251)
 
@@ -121,16 +211,19 @@ private:
 
 	// need to keep track of threads so we can join them
 	std::vector<std::thread> workers_;
-	// the task queue
-	std::queue<PackagedTask> tasks_;
+	// one task queue per worker
+	std::vector<std::unique_ptr<TaskQueue>> queues_;
 
-	// synchronization
-	std::mutex queue_mutex_;
+	// synchronization of idle workers
+	std::mutex sleep_mutex_;
 	std::condition_variable condition_;
-	bool stop_;
+	std::atomic<uint32> nb_queued_tasks_;
+	std::atomic<uint32> nb_sleeping_workers_;
+	std::atomic<uint32> next_queue_;
+	std::atomic<bool> stop_;
 
 	// limit usage to the n-th first workers
-	uint32 nb_working_workers_;
+	std::atomic<uint32> nb_working_workers_;
 	std::mutex running_mutex_;
 	std::condition_variable condition_running_;
 
@@ -148,32 +241,45 @@ std::future<void> ThreadPool::enqueue(const F& f, Args&&... args)
 	static_assert(std::is_same<typename std::result_of<F(Args...)>::type,void>::value,"The thread pool only accept non-returning functions.");
 
 #if defined(_MSC_VER) && _MSC_VER < 1900
-	PackagedTask task = std::make_shared<std::packaged_task<void()>>(std::bind(f, std::forward<Args>(args)...));
-	std::future<void> res = task->get_future();
+	PackagedTask* task = new PackagedTask(std::make_shared<std::packaged_task<void()>>(std::bind(f, std::forward<Args>(args)...)));
+	std::future<void> res = (*task)->get_future();
 #else
-	PackagedTask task([&, f]() -> void
+	PackagedTask* task = new PackagedTask([&, f]() -> void
 	{
 		f(std::forward<Args>(args)...);
 	});
-	std::future<void> res = task.get_future();
+	std::future<void> res = task->get_future();
 #endif
 
+	if (stop_)
 	{
-		std::unique_lock<std::mutex> lock(queue_mutex_);
-		// don't allow enqueueing after stopping the pool
-		if (stop_)
-		{
-			cgogn_log_error("ThreadPool::enqueue") << "Enqueue on stopped ThreadPool.";
-			cgogn_assert_not_reached("enqueue on stopped ThreadPool");
-		}
-		// Push work back on the queue
-		tasks_.push(std::move(task));
+		cgogn_log_error("ThreadPool::enqueue") << "Enqueue on stopped ThreadPool.";
+		cgogn_assert_not_reached("enqueue on stopped ThreadPool");
 	}
-	// Notify a thread that there is new work to perform
-	condition_.notify_one();
+
+	push_task(Task{nullptr, task, 0u, 0u});
 	return res;
 }
 
+template <typename FUNC>
+void ThreadPool::parallel_for(uint32 first, uint32 last, uint32 grain, const FUNC& f)
+{
+	static_assert(is_ith_func_parameter_same<FUNC, 0, uint32>::value && is_ith_func_parameter_same<FUNC, 1, uint32>::value,
+		"parallel_for: given function should take two uint32 (first, last) as parameters");
+
+	if (first >= last)
+		return;
+
+	if (nb_working_workers_ == 0u)
+	{
+		f(first, last);
+		return;
+	}
+
+	RangeJob job(&call_range<FUNC>, &f, std::max(grain, 1u), last - first);
+	run_job(job, first, last);
+}
+
 /**
  * launch an external thread
  */
@@ -183,6 +289,19 @@ std::future<void> launch_thread(const F& f, Args&&... args)
 	return external_thread_pool()->enqueue(f, args...);
 }
 
+/**
+ * @brief apply f on sub-ranges of [first, last) in parallel with the internal thread pool
+ * @param first first index of the range
+ * @param last index after the last index of the range
+ * @param grain minimal size of the processed sub-ranges
+ * @param f function with 2 parameters (uint32 first, uint32 last)
+ */
+template <typename FUNC>
+inline void parallel_for(uint32 first, uint32 last, uint32 grain, const FUNC& f)
+{
+	thread_pool()->parallel_for(first, last, grain, f);
+}
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_UTILS_THREADPOOL_H_
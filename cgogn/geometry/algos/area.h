@@ -31,6 +31,7 @@
 #include <cgogn/core/cmap/attribute.h>
 
 #include <cgogn/core/utils/masks.h>
+#include <cgogn/core/cmap/scatter.h>
 
 namespace cgogn
 {
@@ -175,6 +176,50 @@ inline void compute_incident_faces_area(
 	mask);
 }
 
+namespace internal
+{
+
+template <typename CellType, typename MAP, typename VERTEX_ATTR>
+inline void compute_incident_faces_area(
+	const MAP& map,
+	const VERTEX_ATTR& position,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, CellType::ORBIT>& area,
+	std::false_type)
+{
+	geometry::compute_incident_faces_area<CellType>(map, AllCellsFilter(), position, area);
+}
+
+// the vertices and edges of a face are given by its phi1 darts:
+// the area of each face is computed once and scattered to them
+template <typename CellType, typename MAP, typename VERTEX_ATTR>
+inline void compute_incident_faces_area(
+	const MAP& map,
+	const VERTEX_ATTR& position,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, CellType::ORBIT>& area,
+	std::true_type)
+{
+	using Scalar = ScalarOf<InsideTypeOf<VERTEX_ATTR>>;
+	using Face = typename MAP::Face;
+
+	map.parallel_foreach_cell([&] (CellType c)
+	{
+		area[c] = Scalar(0);
+	});
+
+	parallel_scatter(map, area, [&] (Face f, ScatterAccumulator<Scalar, CellType::ORBIT>& acc)
+	{
+		const Scalar a = geometry::area(map, f, position);
+		Dart d = f.dart;
+		do
+		{
+			acc(CellType(d), a);
+			d = map.phi1(d);
+		} while (d != f.dart);
+	});
+}
+
+} // namespace internal
+
 template <typename CellType, typename MAP, typename VERTEX_ATTR>
 inline void compute_incident_faces_area(
 	const MAP& map,
@@ -183,7 +228,8 @@ inline void compute_incident_faces_area(
 {
 	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
 
-	compute_incident_faces_area<CellType>(map, AllCellsFilter(), position, area);
+	internal::compute_incident_faces_area<CellType>(map, position, area, std::integral_constant<bool,
+		std::is_same<CellType, typename MAP::Vertex>::value || std::is_same<CellType, typename MAP::Edge>::value>());
 }
 
 } // namespace geometry
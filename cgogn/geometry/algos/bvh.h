@@ -0,0 +1,824 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_BVH_H_
+#define CGOGN_GEOMETRY_ALGOS_BVH_H_
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/basic/cell.h>
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/ear_triangulation.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * @brief The BVH class is a bounding volume hierarchy over the triangles of the faces of a map
+ * (the faces incident to the boundary for a volume map), that accelerates ray, segment and closest point queries.
+ *
+ * The faces are triangulated (ear triangulation of the non triangular faces) and the hierarchy is built by build
+ * with a binned surface area heuristic: the top of the tree is split sequentially and the subtrees are built in parallel.
+ * The triangles reference the vertex embeddings, so that after an edition of the positions only (no topological change),
+ * refit updates the boxes of the nodes in linear time without rebuilding the tree.
+ * The batched queries process their queries in parallel.
+ */
+template <typename VEC3, typename MAP>
+class BVH
+{
+public:
+
+	using Scalar = ScalarOf<VEC3>;
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+
+	template <typename T>
+	using VertexAttribute = typename MAP::template VertexAttribute<T>;
+
+	/// maximal number of triangles of a leaf
+	static const uint32 MAX_LEAF_SIZE = 4u;
+	/// number of bins of the surface area heuristic
+	static const uint32 NB_BINS = 16u;
+	/// the nodes with less triangles are the roots of the subtrees built in parallel
+	static const uint32 SUBTREE_SIZE = 4096u;
+	/// number of queries of a batch processed by a thread at once
+	static const uint32 QUERY_GRAIN = 64u;
+
+	/**
+	 * @brief result of a query: the face, the point of the face and its distance to the origin of the query
+	 * (the face is not valid if nothing has been found)
+	 */
+	struct Hit
+	{
+		Face face;
+		VEC3 point;
+		Scalar distance;
+	};
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(BVH);
+
+	BVH(const MAP& map, const VertexAttribute<VEC3>& position) :
+		map_(map),
+		position_(position)
+	{}
+
+	inline const MAP& map() const { return map_; }
+	inline const VertexAttribute<VEC3>& position() const { return position_; }
+	inline bool is_built() const { return !nodes_.empty(); }
+	inline uint32 nb_triangles() const { return uint32(triangles_.size()); }
+	inline uint32 nb_nodes() const { return uint32(nodes_.size()); }
+
+	/**
+	 * @brief triangulate the faces and build the hierarchy, must be called after each topological change
+	 */
+	void build()
+	{
+		nodes_.clear();
+		triangles_.clear();
+
+		std::vector<Face> faces;
+		map_.foreach_cell([&] (Face f)
+		{
+			if (is_surface_face(f))
+				faces.push_back(f);
+		});
+		const uint32 nb_faces = uint32(faces.size());
+
+		std::vector<uint32> offsets(nb_faces + 1u, 0u);
+		for (uint32 i = 0u; i < nb_faces; ++i)
+			offsets[i + 1u] = offsets[i] + map_.codegree(faces[i]) - 2u;
+		const uint32 nb = offsets[nb_faces];
+		if (nb == 0u)
+			return;
+
+		std::vector<Triangle> triangles(nb);
+		parallel_for(0u, nb_faces, PARALLEL_BUFFER_SIZE / 4u, [&] (uint32 first, uint32 last)
+		{
+			std::vector<uint32> ear_indices;
+			for (uint32 i = first; i < last; ++i)
+			{
+				const Face f = faces[i];
+				Triangle* t = &triangles[offsets[i]];
+				if (offsets[i + 1u] - offsets[i] == 1u)
+				{
+					t->vertices = {{ map_.embedding(Vertex(f.dart)), map_.embedding(Vertex(map_.phi1(f.dart))), map_.embedding(Vertex(map_.phi_1(f.dart))) }};
+					t->face = f;
+				}
+				else
+				{
+					ear_indices.clear();
+					append_ear_triangulation(map_, f, position_, ear_indices);
+					for (std::size_t k = 0u; k < ear_indices.size(); k += 3u, ++t)
+					{
+						t->vertices = {{ ear_indices[k], ear_indices[k + 1u], ear_indices[k + 2u] }};
+						t->face = f;
+					}
+				}
+			}
+		});
+
+		std::vector<Box> boxes(nb);
+		std::vector<Vec> centroids(nb);
+		indices_.resize(nb);
+		parallel_for(0u, nb, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				boxes[i] = triangle_box(triangles[i]);
+				centroids[i] = (boxes[i].min + boxes[i].max) * Scalar(0.5);
+				indices_[i] = i;
+			}
+		});
+
+		// the top of the tree, down to the subtrees
+		std::vector<Range> subtrees;
+		nodes_.resize(1u);
+		build_nodes(nodes_, Range{0u, 0u, nb}, boxes, centroids, &subtrees);
+
+		// the subtrees
+		std::vector<std::vector<Node>> subtree_nodes(subtrees.size());
+		parallel_for(0u, uint32(subtrees.size()), 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				const Range& r = subtrees[i];
+				subtree_nodes[i].resize(1u);
+				build_nodes(subtree_nodes[i], Range{0u, r.first, r.last}, boxes, centroids, nullptr);
+			}
+		});
+
+		// splice the subtrees (their nodes are stored after their root that keeps its index)
+		for (uint32 i = 0u; i < subtrees.size(); ++i)
+		{
+			const std::vector<Node>& local = subtree_nodes[i];
+			const uint32 base = uint32(nodes_.size()) - 1u;
+			nodes_.insert(nodes_.end(), local.begin() + 1, local.end());
+			nodes_[subtrees[i].node] = local[0];
+			const auto shift = [&] (Node& n) { if (n.count == 0u) n.first += base; };
+			shift(nodes_[subtrees[i].node]);
+			for (uint32 j = base + 1u, end = uint32(nodes_.size()); j < end; ++j)
+				shift(nodes_[j]);
+			std::vector<Node>().swap(subtree_nodes[i]);
+		}
+
+		// store the triangles in the order of the leaves
+		triangles_.resize(nb);
+		parallel_for(0u, nb, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				triangles_[i] = triangles[indices_[i]];
+		});
+		std::vector<uint32>().swap(indices_);
+	}
+
+	/**
+	 * @brief update the boxes of the nodes after a modification of the positions
+	 * (the topology and the embeddings of the vertices must not have changed since the last build)
+	 */
+	void refit()
+	{
+		cgogn_message_assert(is_built(), "BVH: the hierarchy is not built");
+
+		const uint32 nb = nb_nodes();
+		parallel_for(0u, nb, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				Node& n = nodes_[i];
+				if (n.count > 0u)
+				{
+					Box b = triangle_box(triangles_[n.first]);
+					for (uint32 t = n.first + 1u; t < n.first + n.count; ++t)
+						b.merge(triangle_box(triangles_[t]));
+					n.box = b;
+				}
+			}
+		});
+
+		// the children of a node are stored after it
+		for (uint32 i = nb; i-- > 0u;)
+		{
+			Node& n = nodes_[i];
+			if (n.count == 0u)
+			{
+				n.box = nodes_[n.first].box;
+				n.box.merge(nodes_[n.first + 1u].box);
+			}
+		}
+	}
+
+	/**
+	 * @brief find the first intersection of the ray (origin, direction) with the faces, at most at max_distance
+	 * @return true if a face is hit
+	 */
+	bool intersect(const VEC3& origin, const VEC3& direction, Hit& hit, Scalar max_distance = std::numeric_limits<Scalar>::max()) const
+	{
+		std::vector<uint32> stack;
+		return intersect(to_vec(origin), to_vec(direction), max_distance, hit, stack);
+	}
+
+	/**
+	 * @brief find the intersection of the segment [A, B] with the faces that is the closest to A
+	 * @return true if a face is hit
+	 */
+	bool intersect_segment(const VEC3& A, const VEC3& B, Hit& hit) const
+	{
+		std::vector<uint32> stack;
+		const Vec a = to_vec(A);
+		const Vec ab = to_vec(B) - a;
+		return intersect(a, ab, ab.norm(), hit, stack);
+	}
+
+	/**
+	 * @brief find all the faces hit by the ray (origin, direction), sorted by distance to the origin
+	 * (each face appears once with its closest intersection)
+	 */
+	void intersect_all(const VEC3& origin, const VEC3& direction, std::vector<Hit>& hits) const
+	{
+		hits.clear();
+		if (!is_built())
+			return;
+
+		const Vec o = to_vec(origin);
+		const Vec d = to_vec(direction).normalized();
+		const Vec inv_d = d.cwiseInverse();
+
+		std::vector<uint32> stack(1u, 0u);
+		while (!stack.empty())
+		{
+			const Node& n = nodes_[stack.back()];
+			stack.pop_back();
+			Scalar t;
+			if (!intersect_box(n.box, o, inv_d, std::numeric_limits<Scalar>::max(), t))
+				continue;
+			if (n.count == 0u)
+			{
+				stack.push_back(n.first);
+				stack.push_back(n.first + 1u);
+			}
+			else
+			{
+				for (uint32 i = n.first; i < n.first + n.count; ++i)
+				{
+					if (intersect_triangle(triangles_[i], o, d, t))
+						hits.push_back(Hit{triangles_[i].face, to_vec3(o + d * t), t});
+				}
+			}
+		}
+
+		std::sort(hits.begin(), hits.end(), [] (const Hit& h1, const Hit& h2)
+		{
+			return h1.face.dart.index < h2.face.dart.index || (h1.face.dart == h2.face.dart && h1.distance < h2.distance);
+		});
+		hits.erase(std::unique(hits.begin(), hits.end(), [] (const Hit& h1, const Hit& h2) { return h1.face.dart == h2.face.dart; }), hits.end());
+		std::sort(hits.begin(), hits.end(), [] (const Hit& h1, const Hit& h2) { return h1.distance < h2.distance; });
+	}
+
+	/**
+	 * @brief find the point of the faces that is the closest to P, at most at max_distance
+	 * @return true if a point is found
+	 */
+	bool closest_point(const VEC3& P, Hit& hit, Scalar max_distance = std::numeric_limits<Scalar>::max()) const
+	{
+		std::vector<uint32> stack;
+		return closest_point(to_vec(P), max_distance, hit, stack);
+	}
+
+	/**
+	 * @brief batched version of intersect: hits[i] is the first hit of the ray (origins[i], directions[i])
+	 */
+	void intersect(const std::vector<VEC3>& origins, const std::vector<VEC3>& directions, std::vector<Hit>& hits) const
+	{
+		cgogn_message_assert(origins.size() == directions.size(), "BVH: the numbers of origins and directions differ");
+		hits.resize(origins.size());
+		parallel_for(0u, uint32(origins.size()), QUERY_GRAIN, [&] (uint32 first, uint32 last)
+		{
+			std::vector<uint32> stack;
+			for (uint32 i = first; i < last; ++i)
+				intersect(to_vec(origins[i]), to_vec(directions[i]), std::numeric_limits<Scalar>::max(), hits[i], stack);
+		});
+	}
+
+	/**
+	 * @brief batched version of intersect_segment: hits[i] is the hit of the segment [A[i], B[i]] that is the closest to A[i]
+	 */
+	void intersect_segments(const std::vector<VEC3>& A, const std::vector<VEC3>& B, std::vector<Hit>& hits) const
+	{
+		cgogn_message_assert(A.size() == B.size(), "BVH: the numbers of extremities differ");
+		hits.resize(A.size());
+		parallel_for(0u, uint32(A.size()), QUERY_GRAIN, [&] (uint32 first, uint32 last)
+		{
+			std::vector<uint32> stack;
+			for (uint32 i = first; i < last; ++i)
+			{
+				const Vec a = to_vec(A[i]);
+				const Vec ab = to_vec(B[i]) - a;
+				intersect(a, ab, ab.norm(), hits[i], stack);
+			}
+		});
+	}
+
+	/**
+	 * @brief batched version of closest_point: hits[i] is the closest point of points[i]
+	 */
+	void closest_points(const std::vector<VEC3>& points, std::vector<Hit>& hits) const
+	{
+		hits.resize(points.size());
+		parallel_for(0u, uint32(points.size()), QUERY_GRAIN, [&] (uint32 first, uint32 last)
+		{
+			std::vector<uint32> stack;
+			for (uint32 i = first; i < last; ++i)
+				closest_point(to_vec(points[i]), std::numeric_limits<Scalar>::max(), hits[i], stack);
+		});
+	}
+
+private:
+
+	using Vec = Eigen::Matrix<Scalar, 3, 1>;
+
+	struct Box
+	{
+		Vec min;
+		Vec max;
+
+		inline void merge(const Box& b)
+		{
+			min = min.cwiseMin(b.min);
+			max = max.cwiseMax(b.max);
+		}
+
+		inline Scalar half_area() const
+		{
+			const Vec d = max - min;
+			return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+		}
+	};
+
+	/// a leaf stores count triangles from first, an internal node (count = 0) has its children at first and first + 1
+	struct Node
+	{
+		Box box;
+		uint32 first;
+		uint32 count;
+	};
+
+	struct Triangle
+	{
+		std::array<uint32, 3> vertices;
+		Face face;
+	};
+
+	/// the triangles [first, last) of indices_ under the given node
+	struct Range
+	{
+		uint32 node;
+		uint32 first;
+		uint32 last;
+	};
+
+	template <typename M = MAP>
+	auto is_surface_face(Face f) const -> typename std::enable_if<M::DIMENSION == 3u, bool>::type
+	{
+		return map_.is_incident_to_boundary(f);
+	}
+
+	template <typename M = MAP>
+	auto is_surface_face(Face) const -> typename std::enable_if<M::DIMENSION != 3u, bool>::type
+	{
+		return true;
+	}
+
+	static inline Vec to_vec(const VEC3& p)
+	{
+		return Vec(p[0], p[1], p[2]);
+	}
+
+	static inline VEC3 to_vec3(const Vec& p)
+	{
+		VEC3 r;
+		r[0] = p[0];
+		r[1] = p[1];
+		r[2] = p[2];
+		return r;
+	}
+
+	inline Vec point(uint32 v) const
+	{
+		return to_vec(position_[v]);
+	}
+
+	inline Box triangle_box(const Triangle& t) const
+	{
+		const Vec p0 = point(t.vertices[0]);
+		const Vec p1 = point(t.vertices[1]);
+		const Vec p2 = point(t.vertices[2]);
+		return Box{p0.cwiseMin(p1).cwiseMin(p2), p0.cwiseMax(p1).cwiseMax(p2)};
+	}
+
+	/**
+	 * @brief build the nodes under root.node, the nodes with at most SUBTREE_SIZE triangles are not split
+	 * but appended to subtrees if subtrees is not null
+	 */
+	void build_nodes(std::vector<Node>& nodes, const Range& root, const std::vector<Box>& boxes, const std::vector<Vec>& centroids, std::vector<Range>* subtrees)
+	{
+		std::vector<Range> stack(1u, root);
+		while (!stack.empty())
+		{
+			const Range r = stack.back();
+			stack.pop_back();
+
+			Box b = boxes[indices_[r.first]];
+			for (uint32 i = r.first + 1u; i < r.last; ++i)
+				b.merge(boxes[indices_[i]]);
+			nodes[r.node].box = b;
+
+			const uint32 count = r.last - r.first;
+			if (subtrees && count <= SUBTREE_SIZE)
+			{
+				subtrees->push_back(r);
+				continue;
+			}
+
+			if (count <= MAX_LEAF_SIZE)
+			{
+				nodes[r.node].first = r.first;
+				nodes[r.node].count = count;
+				continue;
+			}
+
+			const uint32 mid = split(r.first, r.last, boxes, centroids);
+			const uint32 child = uint32(nodes.size());
+			nodes[r.node].first = child;
+			nodes[r.node].count = 0u;
+			nodes.resize(child + 2u);
+			stack.push_back(Range{child, r.first, mid});
+			stack.push_back(Range{child + 1u, mid, r.last});
+		}
+	}
+
+	/**
+	 * @brief split the triangles [first, last) of indices_ along the best plane of the binned surface area heuristic
+	 * @return the index of the first triangle of the second part
+	 */
+	uint32 split(uint32 first, uint32 last, const std::vector<Box>& boxes, const std::vector<Vec>& centroids)
+	{
+		Box cbox{centroids[indices_[first]], centroids[indices_[first]]};
+		for (uint32 i = first + 1u; i < last; ++i)
+			cbox.merge(Box{centroids[indices_[i]], centroids[indices_[i]]});
+
+		Scalar best_cost = std::numeric_limits<Scalar>::max();
+		uint32 best_axis = 3u;
+		uint32 best_bin = 0u;
+		for (uint32 axis = 0u; axis < 3u; ++axis)
+		{
+			const Scalar extent = cbox.max[axis] - cbox.min[axis];
+			if (!(extent > Scalar(0)))
+				continue;
+			const Scalar scale = Scalar(NB_BINS) / extent;
+
+			std::array<Box, NB_BINS> bin_boxes;
+			std::array<uint32, NB_BINS> bin_counts;
+			bin_counts.fill(0u);
+			for (uint32 i = first; i < last; ++i)
+			{
+				const uint32 t = indices_[i];
+				const uint32 bin = std::min(NB_BINS - 1u, uint32((centroids[t][axis] - cbox.min[axis]) * scale));
+				if (bin_counts[bin]++ == 0u)
+					bin_boxes[bin] = boxes[t];
+				else
+					bin_boxes[bin].merge(boxes[t]);
+			}
+
+			// cost of the right parts, swept from the right
+			std::array<Scalar, NB_BINS> right_costs;
+			Box right;
+			uint32 right_count = 0u;
+			for (uint32 bin = NB_BINS - 1u; bin > 0u; --bin)
+			{
+				if (bin_counts[bin] > 0u)
+				{
+					if (right_count == 0u)
+						right = bin_boxes[bin];
+					else
+						right.merge(bin_boxes[bin]);
+					right_count += bin_counts[bin];
+				}
+				right_costs[bin] = right_count > 0u ? right.half_area() * Scalar(right_count) : Scalar(0);
+			}
+
+			Box left;
+			uint32 left_count = 0u;
+			for (uint32 bin = 0u; bin < NB_BINS - 1u; ++bin)
+			{
+				if (bin_counts[bin] > 0u)
+				{
+					if (left_count == 0u)
+						left = bin_boxes[bin];
+					else
+						left.merge(bin_boxes[bin]);
+					left_count += bin_counts[bin];
+				}
+				if (left_count == 0u || left_count == last - first)
+					continue;
+				const Scalar cost = left.half_area() * Scalar(left_count) + right_costs[bin + 1u];
+				if (cost < best_cost)
+				{
+					best_cost = cost;
+					best_axis = axis;
+					best_bin = bin;
+				}
+			}
+		}
+
+		const uint32 mid = (first + last) / 2u;
+		if (best_axis == 3u)
+			return mid; // all the centroids are equal
+
+		const Scalar scale = Scalar(NB_BINS) / (cbox.max[best_axis] - cbox.min[best_axis]);
+		const auto it = std::partition(indices_.begin() + first, indices_.begin() + last, [&] (uint32 t)
+		{
+			return std::min(NB_BINS - 1u, uint32((centroids[t][best_axis] - cbox.min[best_axis]) * scale)) <= best_bin;
+		});
+		const uint32 split = uint32(it - indices_.begin());
+		if (split == first || split == last)
+		{
+			std::nth_element(indices_.begin() + first, indices_.begin() + mid, indices_.begin() + last, [&] (uint32 t1, uint32 t2)
+			{
+				return centroids[t1][best_axis] < centroids[t2][best_axis];
+			});
+			return mid;
+		}
+		return split;
+	}
+
+	/**
+	 * @brief slab test of the ray o + t d, t in [0, t_max] (inv_d is the inverse of d)
+	 * @return true if the box is hit, t_entry is the parameter of the entry point
+	 */
+	static inline bool intersect_box(const Box& b, const Vec& o, const Vec& inv_d, Scalar t_max, Scalar& t_entry)
+	{
+		Scalar t0 = Scalar(0);
+		Scalar t1 = t_max;
+		for (uint32 a = 0u; a < 3u; ++a)
+		{
+			Scalar t_near = (b.min[a] - o[a]) * inv_d[a];
+			Scalar t_far = (b.max[a] - o[a]) * inv_d[a];
+			if (t_near > t_far)
+				std::swap(t_near, t_far);
+			t0 = t_near > t0 ? t_near : t0;
+			t1 = t_far < t1 ? t_far : t1;
+			if (t0 > t1)
+				return false;
+		}
+		t_entry = t0;
+		return true;
+	}
+
+	/**
+	 * @brief intersection of the ray o + t d, t >= 0, with the (two-sided) triangle (Moller-Trumbore)
+	 */
+	inline bool intersect_triangle(const Triangle& tri, const Vec& o, const Vec& d, Scalar& t) const
+	{
+		const Vec p0 = point(tri.vertices[0]);
+		const Vec e1 = point(tri.vertices[1]) - p0;
+		const Vec e2 = point(tri.vertices[2]) - p0;
+		const Vec pv = d.cross(e2);
+		const Scalar det = e1.dot(pv);
+		if (det == Scalar(0))
+			return false;
+		const Scalar inv_det = Scalar(1) / det;
+		const Vec tv = o - p0;
+		const Scalar u = tv.dot(pv) * inv_det;
+		if (u < Scalar(0) || u > Scalar(1))
+			return false;
+		const Vec qv = tv.cross(e1);
+		const Scalar v = d.dot(qv) * inv_det;
+		if (v < Scalar(0) || u + v > Scalar(1))
+			return false;
+		t = e2.dot(qv) * inv_det;
+		return t >= Scalar(0);
+	}
+
+	/**
+	 * @brief closest point of the triangle (a, b, c) to p (Ericson, Real-Time Collision Detection, 5.1.5)
+	 */
+	static inline Vec closest_point_triangle(const Vec& p, const Vec& a, const Vec& b, const Vec& c)
+	{
+		const Vec ab = b - a;
+		const Vec ac = c - a;
+		const Vec ap = p - a;
+		const Scalar d1 = ab.dot(ap);
+		const Scalar d2 = ac.dot(ap);
+		if (d1 <= Scalar(0) && d2 <= Scalar(0))
+			return a;
+
+		const Vec bp = p - b;
+		const Scalar d3 = ab.dot(bp);
+		const Scalar d4 = ac.dot(bp);
+		if (d3 >= Scalar(0) && d4 <= d3)
+			return b;
+
+		const Scalar vc = d1 * d4 - d3 * d2;
+		if (vc <= Scalar(0) && d1 >= Scalar(0) && d3 <= Scalar(0))
+			return a + ab * (d1 / (d1 - d3));
+
+		const Vec cp = p - c;
+		const Scalar d5 = ab.dot(cp);
+		const Scalar d6 = ac.dot(cp);
+		if (d6 >= Scalar(0) && d5 <= d6)
+			return c;
+
+		const Scalar vb = d5 * d2 - d1 * d6;
+		if (vb <= Scalar(0) && d2 >= Scalar(0) && d6 <= Scalar(0))
+			return a + ac * (d2 / (d2 - d6));
+
+		const Scalar va = d3 * d6 - d5 * d4;
+		if (va <= Scalar(0) && (d4 - d3) >= Scalar(0) && (d5 - d6) >= Scalar(0))
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		const Scalar denom = Scalar(1) / (va + vb + vc);
+		return a + ab * (vb * denom) + ac * (vc * denom);
+	}
+
+	static inline Scalar squared_distance_box(const Box& b, const Vec& p)
+	{
+		const Vec d = (b.min - p).cwiseMax(p - b.max).cwiseMax(Vec::Zero());
+		return d.squaredNorm();
+	}
+
+	/**
+	 * @brief closest hit of the ray o + t d at a distance at most max_distance, the nearest child is visited first
+	 */
+	bool intersect(const Vec& o, const Vec& direction, Scalar max_distance, Hit& hit, std::vector<uint32>& stack) const
+	{
+		hit.face = Face();
+		if (!is_built() || !(direction.squaredNorm() > Scalar(0)))
+			return false;
+
+		const Vec d = direction.normalized();
+		const Vec inv_d = d.cwiseInverse();
+		Scalar best = max_distance;
+		uint32 best_triangle = INVALID_INDEX;
+
+		Scalar t;
+		stack.clear();
+		if (intersect_box(nodes_[0].box, o, inv_d, best, t))
+			stack.push_back(0u);
+		while (!stack.empty())
+		{
+			const Node& n = nodes_[stack.back()];
+			stack.pop_back();
+			// the best hit may have been improved since the node was pushed
+			if (!intersect_box(n.box, o, inv_d, best, t))
+				continue;
+			if (n.count == 0u)
+			{
+				Scalar t0, t1;
+				const bool hit0 = intersect_box(nodes_[n.first].box, o, inv_d, best, t0);
+				const bool hit1 = intersect_box(nodes_[n.first + 1u].box, o, inv_d, best, t1);
+				if (hit0 && hit1)
+				{
+					// the nearest child is on top of the stack
+					stack.push_back(t0 <= t1 ? n.first + 1u : n.first);
+					stack.push_back(t0 <= t1 ? n.first : n.first + 1u);
+				}
+				else if (hit0)
+					stack.push_back(n.first);
+				else if (hit1)
+					stack.push_back(n.first + 1u);
+			}
+			else
+			{
+				for (uint32 i = n.first; i < n.first + n.count; ++i)
+				{
+					if (intersect_triangle(triangles_[i], o, d, t) && t <= best)
+					{
+						best = t;
+						best_triangle = i;
+					}
+				}
+			}
+		}
+
+		if (best_triangle == INVALID_INDEX)
+			return false;
+		hit.face = triangles_[best_triangle].face;
+		hit.point = to_vec3(o + d * best);
+		hit.distance = best;
+		return true;
+	}
+
+	/**
+	 * @brief closest point to p at a distance at most max_distance, the nearest child is visited first
+	 */
+	bool closest_point(const Vec& p, Scalar max_distance, Hit& hit, std::vector<uint32>& stack) const
+	{
+		hit.face = Face();
+		if (!is_built())
+			return false;
+
+		Scalar best = max_distance < std::sqrt(std::numeric_limits<Scalar>::max()) ? max_distance * max_distance : std::numeric_limits<Scalar>::max();
+		uint32 best_triangle = INVALID_INDEX;
+		Vec best_point;
+
+		stack.clear();
+		if (squared_distance_box(nodes_[0].box, p) <= best)
+			stack.push_back(0u);
+		while (!stack.empty())
+		{
+			const Node& n = nodes_[stack.back()];
+			stack.pop_back();
+			if (squared_distance_box(n.box, p) > best)
+				continue;
+			if (n.count == 0u)
+			{
+				const Scalar d0 = squared_distance_box(nodes_[n.first].box, p);
+				const Scalar d1 = squared_distance_box(nodes_[n.first + 1u].box, p);
+				const uint32 near = d0 <= d1 ? n.first : n.first + 1u;
+				const uint32 far = d0 <= d1 ? n.first + 1u : n.first;
+				if (std::max(d0, d1) <= best)
+					stack.push_back(far);
+				if (std::min(d0, d1) <= best)
+					stack.push_back(near);
+			}
+			else
+			{
+				for (uint32 i = n.first; i < n.first + n.count; ++i)
+				{
+					const Triangle& tri = triangles_[i];
+					if (squared_distance_box(triangle_box(tri), p) > best)
+						continue;
+					const Vec q = closest_point_triangle(p, point(tri.vertices[0]), point(tri.vertices[1]), point(tri.vertices[2]));
+					const Scalar d2 = (q - p).squaredNorm();
+					if (d2 <= best)
+					{
+						best = d2;
+						best_triangle = i;
+						best_point = q;
+					}
+				}
+			}
+		}
+
+		if (best_triangle == INVALID_INDEX)
+			return false;
+		hit.face = triangles_[best_triangle].face;
+		hit.point = to_vec3(best_point);
+		hit.distance = std::sqrt(best);
+		return true;
+	}
+
+private:
+
+	const MAP& map_;
+	const VertexAttribute<VEC3>& position_;
+
+	std::vector<Node> nodes_;
+	std::vector<Triangle> triangles_;
+	std::vector<uint32> indices_;
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_EXTERNAL_TEMPLATES_CPP_))
+extern template class CGOGN_GEOMETRY_API BVH<Eigen::Vector3f, CMap2>;
+extern template class CGOGN_GEOMETRY_API BVH<Eigen::Vector3d, CMap2>;
+extern template class CGOGN_GEOMETRY_API BVH<Eigen::Vector3f, CMap3>;
+extern template class CGOGN_GEOMETRY_API BVH<Eigen::Vector3d, CMap3>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_EXTERNAL_TEMPLATES_CPP_))
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_BVH_H_
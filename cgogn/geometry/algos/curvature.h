@@ -26,6 +26,7 @@
 
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/geometry/algos/selection.h>
+#include <cgogn/geometry/algos/spatial_hash_grid.h>
 #include <cgogn/geometry/algos/length.h>
 #include <cgogn/geometry/functions/intersection.h>
 #include <cgogn/core/cmap/attribute.h>
@@ -37,6 +38,77 @@ namespace cgogn
 namespace geometry
 {
 
+namespace internal
+{
+
+/**
+ * @brief set the curvatures of v from its normal cycle tensor
+ */
+template <typename VERTEX_ATTR>
+void set_curvature(
+	const Cell<Orbit::PHI21> v,
+	Eigen::Matrix3d& tensor,
+	const Attribute<InsideTypeOf<VERTEX_ATTR>, Orbit::PHI21>& normal,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI21>& kmax,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI21>& kmin,
+	VERTEX_ATTR& Kmax,
+	VERTEX_ATTR& Kmin,
+	VERTEX_ATTR& Knormal
+)
+{
+	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
+	using Scalar = ScalarOf<VEC3>;
+
+	const VEC3& normal_v = normal[v];
+	Eigen::Vector3d e_normal_v(normal_v[0], normal_v[1], normal_v[2]);
+
+	// project the tensor
+	Eigen::Matrix3d proj;
+	proj.setIdentity();
+	proj -= e_normal_v * e_normal_v.transpose();
+	tensor = proj * tensor * proj;
+
+	// solve eigen problem
+	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(tensor);
+	const Eigen::Vector3d& ev = solver.eigenvalues();
+	const Eigen::Matrix3d& evec = solver.eigenvectors();
+
+	// sort eigen components : ev[inormal] has minimal absolute value ; kmin = ev[imin] <= ev[imax] = kmax
+	uint32 inormal = 0, imin, imax;
+	if (fabs(ev[1]) < fabs(ev[inormal])) inormal = 1;
+	if (fabs(ev[2]) < fabs(ev[inormal])) inormal = 2;
+	imin = (inormal + 1) % 3;
+	imax = (inormal + 2) % 3;
+	if (ev[imax] < ev[imin]) { std::swap(imin, imax); }
+
+	// set curvatures from sorted eigen components
+	// warning : Kmin and Kmax are switched w.r.t. kmin and kmax
+
+	// normal direction : minimal absolute eigen value
+	VEC3& Knormal_v = Knormal[v];
+	Knormal_v[0] = evec(0, inormal);
+	Knormal_v[1] = evec(1, inormal);
+	Knormal_v[2] = evec(2, inormal);
+	if (Knormal_v.dot(normal_v) < 0)
+		Knormal_v *= Scalar(-1); // change orientation
+
+	// min curvature
+	kmin[v] = ev[imin];
+	VEC3& Kmin_v = Kmin[v];
+	Kmin_v[0] = evec(0, imax);
+	Kmin_v[1] = evec(1, imax);
+	Kmin_v[2] = evec(2, imax);
+
+	// max curvature
+	kmax[v] = ev[imax];
+	VEC3& Kmax_v = Kmax[v];
+	Kmax_v[0] = evec(0, imin);
+	Kmax_v[1] = evec(1, imin);
+	Kmax_v[2] = evec(2, imin);
+}
+
+} // namespace internal
+
 //template <typename VEC3, typename MAP>
 //void curvature(
 //	const MAP& map,
@@ -109,52 +181,7 @@ void curvature(
 
 	tensor /= neighborhood.area(position);
 
-	const VEC3& normal_v = normal[v];
-	Eigen::Vector3d e_normal_v(normal_v[0], normal_v[1], normal_v[2]);
-
-	// project the tensor
-	Eigen::Matrix3d proj;
-	proj.setIdentity();
-	proj -= e_normal_v * e_normal_v.transpose();
-	tensor = proj * tensor * proj;
-
-	// solve eigen problem
-	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(tensor);
-	const Eigen::Vector3d& ev = solver.eigenvalues();
-	const Eigen::Matrix3d& evec = solver.eigenvectors();
-
-	// sort eigen components : ev[inormal] has minimal absolute value ; kmin = ev[imin] <= ev[imax] = kmax
-	uint32 inormal = 0, imin, imax;
-	if (fabs(ev[1]) < fabs(ev[inormal])) inormal = 1;
-	if (fabs(ev[2]) < fabs(ev[inormal])) inormal = 2;
-	imin = (inormal + 1) % 3;
-	imax = (inormal + 2) % 3;
-	if (ev[imax] < ev[imin]) { std::swap(imin, imax); }
-
-	// set curvatures from sorted eigen components
-	// warning : Kmin and Kmax are switched w.r.t. kmin and kmax
-
-	// normal direction : minimal absolute eigen value
-	VEC3& Knormal_v = Knormal[v];
-	Knormal_v[0] = evec(0, inormal);
-	Knormal_v[1] = evec(1, inormal);
-	Knormal_v[2] = evec(2, inormal);
-	if (Knormal_v.dot(normal_v) < 0)
-		Knormal_v *= Scalar(-1); // change orientation
-
-	// min curvature
-	kmin[v] = ev[imin];
-	VEC3& Kmin_v = Kmin[v];
-	Kmin_v[0] = evec(0, imax);
-	Kmin_v[1] = evec(1, imax);
-	Kmin_v[2] = evec(2, imax);
-
-	// max curvature
-	kmax[v] = ev[imax];
-	VEC3& Kmax_v = Kmax[v];
-	Kmax_v[0] = evec(0, imin);
-	Kmax_v[1] = evec(1, imin);
-	Kmax_v[2] = evec(2, imin);
+	internal::set_curvature(v, tensor, normal, kmax, kmin, Kmax, Kmin, Knormal);
 }
 
 
@@ -203,6 +230,136 @@ void compute_curvature(
 	compute_curvature(map, AllCellsFilter(), radius, position, normal, edge_angle, edge_area, kmax, kmin, Kmax, Kmin, Knormal);
 }
 
+/**
+ * @brief compute_curvature on all the vertices of the grid, the neighborhood of each vertex being the vertices
+ * of the sphere (position[v], radius) found in the grid instead of a flooding of the map from v
+ * (the face areas at the border of the neighborhoods are estimated for triangles only, as in Collector_WithinSphere)
+ */
+template <typename MAP, typename VEC3, typename VERTEX_ATTR>
+void compute_curvature(
+	const MAP& map,
+	const SpatialHashGrid<VEC3, MAP>& grid,
+	ScalarOf<InsideTypeOf<VERTEX_ATTR>> radius,
+	const VERTEX_ATTR& position,
+	const VERTEX_ATTR& normal,
+	const Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI2>& edge_angle,
+	const Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI2>& edge_area,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI21>& kmax,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI21>& kmin,
+	VERTEX_ATTR& Kmax,
+	VERTEX_ATTR& Kmin,
+	VERTEX_ATTR& Knormal
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, Orbit::PHI21>::value,"position must be a vertex attribute");
+	static_assert(std::is_same<VEC3, InsideTypeOf<VERTEX_ATTR>>::value, "the grid and the attributes must have the same vector type");
+	cgogn_message_assert(&grid.map() == &map && grid.is_built(), "compute_curvature: the grid is not built");
+
+	using Scalar = ScalarOf<VEC3>;
+	using Vertex2 = Cell<Orbit::PHI21>;
+	using Edge2 = Cell<Orbit::PHI2>;
+	using Face2 = Cell<Orbit::PHI1>;
+
+	unused_parameters(edge_area);
+
+	// per thread marks of the vertices of the current neighborhood (indexed by vertex embedding)
+	const uint32 nb_threads = thread_pool()->nb_workers() + 1u;
+	const uint32 nb_embeddings = map.template attribute_container<Vertex2::ORBIT>().end();
+	std::vector<std::vector<uint32>> marks_th(nb_threads);
+	std::vector<uint32> stamps_th(nb_threads, 0u);
+
+	// the edge terms of the tensor are shared by the neighborhoods (indexed by edge embedding)
+	std::vector<Eigen::Matrix3d> edge_tensors(map.template attribute_container<Edge2::ORBIT>().end());
+	map.parallel_foreach_cell([&] (Edge2 e)
+	{
+		std::pair<Vertex2, Vertex2> vv = map.vertices(e);
+		const VEC3& p1 = position[vv.first];
+		const VEC3& p2 = position[vv.second];
+		Eigen::Vector3d ev = Eigen::Vector3d(p2[0], p2[1], p2[2]) - Eigen::Vector3d(p1[0], p1[1], p1[2]);
+		edge_tensors[map.embedding(e)] = (ev * ev.transpose()) * edge_angle[e] * (Scalar(1) / ev.norm());
+	});
+
+	grid.parallel_foreach_neighborhood(radius, [&] (Vertex2 v, const std::vector<Vertex2>& neighbors)
+	{
+		const uint32 th = current_thread_index();
+		std::vector<uint32>& marks = marks_th[th];
+		if (marks.empty())
+			marks.assign(nb_embeddings, 0u);
+		const uint32 stamp = ++stamps_th[th];
+		for (Vertex2 w : neighbors)
+			marks[map.embedding(w)] = stamp;
+
+		const VEC3& center = position[v];
+		const auto inside = [&] (Dart d) { return marks[map.embedding(Vertex2(d))] == stamp; };
+		const auto edge_tensor = [&] (Dart d) -> const Eigen::Matrix3d& { return edge_tensors[map.embedding(Edge2(d))]; };
+
+		Eigen::Matrix3d tensor;
+		tensor.setZero();
+		Scalar neighborhood_area = 0;
+
+		// the darts d of the vertices of the sphere: Vertex(d) is inside
+		for (Vertex2 w : neighbors)
+		{
+			map.foreach_dart_of_orbit(w, [&] (Dart d)
+			{
+				const Dart f = map.phi1(d);
+				if (inside(f))
+				{
+					// edges and faces inside the sphere are counted from their dart of lowest index
+					if (d.index < map.phi2(d).index)
+						tensor += edge_tensor(d);
+					if (!map.is_boundary(d))
+					{
+						bool first = true;
+						map.foreach_dart_of_orbit(Face2(d), [&] (Dart dd) -> bool
+						{
+							first = dd.index >= d.index;
+							return first;
+						});
+						bool all_in = first;
+						if (first)
+						{
+							map.foreach_dart_of_orbit(Face2(d), [&] (Dart dd) -> bool
+							{
+								all_in = inside(dd);
+								return all_in;
+							});
+						}
+						if (all_in)
+							neighborhood_area += geometry::area(map, Face2(d), position);
+					}
+				}
+				else
+				{
+					// Vertex(f) is outside: d is at the border of the sphere
+					Scalar alpha;
+					geometry::intersection_sphere_segment<VEC3>(center, radius, position[Vertex2(d)], position[Vertex2(f)], alpha);
+					tensor += edge_tensor(d) * alpha;
+					if (!map.is_boundary(d))
+					{
+						const Dart g = map.phi1(f);
+						Scalar beta;
+						if (inside(g))
+						{
+							geometry::intersection_sphere_segment<VEC3>(center, radius, position[Vertex2(g)], position[Vertex2(f)], beta);
+							neighborhood_area += (alpha + beta - alpha * beta) * geometry::area(map, Face2(d), position);
+						}
+						else
+						{
+							geometry::intersection_sphere_segment<VEC3>(center, radius, position[Vertex2(d)], position[Vertex2(g)], beta);
+							neighborhood_area += alpha * beta * geometry::area(map, Face2(d), position);
+						}
+					}
+				}
+			});
+		}
+
+		tensor /= neighborhood_area;
+
+		internal::set_curvature(v, tensor, normal, kmax, kmin, Kmax, Kmin, Knormal);
+	});
+}
+
 } // namespace geometry
 
 } // namespace cgogn
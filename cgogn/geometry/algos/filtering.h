@@ -26,6 +26,8 @@
 
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/core/utils/masks.h>
+#include <cgogn/core/cmap/csr_incidence.h>
+#include <cgogn/geometry/algos/spatial_hash_grid.h>
 
 namespace cgogn
 {
@@ -74,6 +76,43 @@ void filter_average(
 	filter_average(map, AllCellsFilter(), attribute_in, attribute_out);
 }
 
+/**
+ * @brief filter_average on all the vertices of the map, using a CSRIncidence snapshot of the map
+ * for the adjacency of the vertices
+ */
+template <typename MAP, typename VERTEX_ATTR>
+void filter_average(
+	const MAP& map,
+	const CSRIncidence<MAP>& incidence,
+	const VERTEX_ATTR& attribute_in,
+	VERTEX_ATTR& attribute_out
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"attribute_in & attribute_out must be a vertex attribute");
+	cgogn_message_assert(&incidence.map() == &map && incidence.is_valid(), "filter_average: the incidence snapshot is not up to date");
+	unused_parameters(map);
+
+	using T = InsideTypeOf<VERTEX_ATTR>;
+	using Scalar = ScalarOf<T>;
+	using Vertex = typename MAP::Vertex;
+
+	parallel_for(0u, incidence.nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+	{
+		for (uint32 i = first; i < last; ++i)
+		{
+			T sum;
+			set_zero(sum);
+			uint32 count = 0;
+			for (Dart d : incidence.adjacent_vertices(i))
+			{
+				sum += attribute_in[Vertex(d)];
+				++count;
+			}
+			attribute_out[Vertex(incidence.vertices()[i])] = sum / Scalar(count);
+		}
+	});
+}
+
 template <typename MAP, typename MASK, typename VERTEX_ATTR>
 void filter_bilateral(
 	const MAP& map,
@@ -140,6 +179,68 @@ void filter_bilateral(
 	filter_bilateral(map, AllCellsFilter(), position_in, position_out, normal);
 }
 
+/**
+ * @brief filter_bilateral on all the vertices of the grid, the neighbors of a vertex v being the vertices
+ * of the sphere (position_in[v], radius) found in the grid (built on position_in) instead of the adjacent vertices
+ */
+template <typename MAP, typename VEC3, typename VERTEX_ATTR>
+void filter_bilateral(
+	const MAP& map,
+	const SpatialHashGrid<VEC3, MAP>& grid,
+	ScalarOf<InsideTypeOf<VERTEX_ATTR>> radius,
+	const VERTEX_ATTR& position_in,
+	VERTEX_ATTR& position_out,
+	const VERTEX_ATTR& normal
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position_in, position_out & normal must be a vertex attribute");
+	static_assert(std::is_same<VEC3, InsideTypeOf<VERTEX_ATTR>>::value, "the grid and the attributes must have the same vector type");
+	cgogn_message_assert(&grid.map() == &map && grid.is_built(), "filter_bilateral: the grid is not built");
+
+	using Scalar = ScalarOf<VEC3>;
+	using Vertex = typename MAP::Vertex;
+	using Edge = typename MAP::Edge;
+
+	Scalar length_sum = 0;
+	Scalar angle_sum = 0;
+	uint32 nb_edges = 0;
+
+	map.foreach_cell([&] (Edge e)
+	{
+		std::pair<Vertex, Vertex> v = map.vertices(e);
+		VEC3 edge = position_in[v.first] - position_in[v.second];
+		length_sum += edge.norm();
+		angle_sum += angle(normal[v.first], normal[v.second]);
+		++nb_edges;
+	});
+
+	Scalar sigmaC = 1.0 * (length_sum / Scalar(nb_edges));
+	Scalar sigmaS = 2.5 * (angle_sum / Scalar(nb_edges));
+
+	grid.parallel_foreach_neighborhood(radius, [&] (Vertex v, const std::vector<Vertex>& neighbors)
+	{
+		const VEC3& n = normal[v];
+
+		Scalar sum = 0, normalizer = 0;
+		for (Vertex av : neighbors)
+		{
+			if (av.dart == v.dart) // the neighbors are given with the darts of the grid
+				continue;
+			VEC3 edge = position_in[av] - position_in[v];
+			Scalar t = edge.norm();
+			Scalar h = n.dot(edge);
+			Scalar wcs = std::exp((-1.0 * (t * t) / (2.0 * sigmaC * sigmaC)) + (-1.0 * (h * h) / (2.0 * sigmaS * sigmaS)));
+			sum += wcs * h;
+			normalizer += wcs;
+		}
+
+		if (normalizer > 0)
+			position_out[v] = position_in[v] + ((sum / normalizer) * n);
+		else
+			position_out[v] = position_in[v];
+	});
+}
+
 template <typename MAP, typename MASK, typename VERTEX_ATTR>
 void filter_taubin(
 	const MAP& map,
@@ -0,0 +1,404 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_HEAT_METHOD_H_
+#define CGOGN_GEOMETRY_ALGOS_HEAT_METHOD_H_
+
+#include <vector>
+#include <array>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/csr_incidence.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/geometry/types/eigen.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * @brief The HeatMethod class computes geodesic distances on a surface with the heat method (Crane et al. 2013):
+ * - the heat u diffused from the sources during a time t is given by (M + t L) u = delta_sources,
+ * - the normalized gradient X = -grad(u) / |grad(u)| of the heat gives the direction of the geodesics,
+ * - the distance phi is the solution of the Poisson equation L phi = -div(X), shifted to be null on the sources,
+ * where L is the (positive) cotangent Laplacian and M is the lumped mass matrix of the surface.
+ *
+ * The faces of the map are triangulated by fans and the vertices are numbered as in the given CSRIncidence snapshot.
+ * The matrices are assembled in parallel and their sparse Cholesky (LDLT) factorizations are computed once by update
+ * and reused by all the queries, so that each query costs two back-substitutions per distance field.
+ * The positions are copied by update: it must be called again when the positions or the snapshot change.
+ */
+template <typename VEC3, typename MAP>
+class HeatMethod
+{
+	static_assert(MAP::DIMENSION == 2u, "HeatMethod: only surfaces are supported");
+
+public:
+
+	using Scalar = ScalarOf<VEC3>;
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+
+	template <typename T>
+	using VertexAttribute = typename MAP::template VertexAttribute<T>;
+
+	using SparseMatrix = Eigen::SparseMatrix<float64>;
+	using Solver = Eigen::SimplicialLDLT<SparseMatrix>;
+	using Matrix = Eigen::Matrix<float64, Eigen::Dynamic, Eigen::Dynamic>;
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(HeatMethod);
+
+	/**
+	 * @param map the map
+	 * @param incidence a built CSRIncidence snapshot of the map
+	 * @param position the position of the vertices
+	 * @param time_factor the diffusion time t is time_factor times the squared mean edge length
+	 */
+	HeatMethod(const MAP& map, const CSRIncidence<MAP>& incidence, const VertexAttribute<VEC3>& position, Scalar time_factor = Scalar(1)) :
+		incidence_(incidence),
+		position_(position),
+		time_factor_(float64(time_factor)),
+		time_(0.0),
+		factorized_(false)
+	{
+		cgogn_message_assert(&incidence.map() == &map, "HeatMethod: the incidence snapshot is not a snapshot of the map");
+		unused_parameters(map);
+	}
+
+	/**
+	 * @brief copy the positions, assemble the matrices and compute their factorizations
+	 * @return false if a factorization failed (e.g. for a mesh with degenerated faces)
+	 */
+	bool update()
+	{
+		cgogn_message_assert(incidence_.is_valid(), "HeatMethod: the incidence snapshot is not up to date");
+
+		const uint32 nb_vertices = incidence_.nb_vertices();
+		const uint32 nb_faces = incidence_.nb_faces();
+
+		points_.resize(nb_vertices);
+		parallel_for(0u, nb_vertices, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				const VEC3& p = position_[Vertex(incidence_.vertices()[i])];
+				points_[i] = Eigen::Vector3d(float64(p[0]), float64(p[1]), float64(p[2]));
+			}
+		});
+
+		// fan triangulation of the faces
+		std::vector<uint32> face_offsets(nb_faces + 1u, 0u);
+		for (uint32 f = 0u; f < nb_faces; ++f)
+			face_offsets[f + 1u] = face_offsets[f] + incidence_.incident_vertices(f).size() - 2u;
+		const uint32 nb_triangles = face_offsets[nb_faces];
+
+		triangles_.resize(nb_triangles);
+		parallel_for(0u, nb_faces, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+			{
+				const auto vertices = incidence_.incident_vertices(f);
+				const Dart* d = vertices.begin();
+				const uint32 v0 = incidence_.vertex_index(d[0]);
+				for (uint32 k = 0u, end = vertices.size() - 2u; k < end; ++k)
+					triangles_[face_offsets[f] + k] = {{ v0, incidence_.vertex_index(d[k + 1u]), incidence_.vertex_index(d[k + 2u]) }};
+			}
+		});
+
+		// the triangle corners of each vertex
+		corner_offsets_.assign(nb_vertices + 1u, 0u);
+		for (const auto& t : triangles_)
+			for (uint32 v : t)
+				++corner_offsets_[v + 1u];
+		for (uint32 i = 0u; i < nb_vertices; ++i)
+			corner_offsets_[i + 1u] += corner_offsets_[i];
+		corners_.resize(3u * nb_triangles);
+		{
+			std::vector<uint32> position(corner_offsets_.begin(), corner_offsets_.end() - 1);
+			for (uint32 t = 0u; t < nb_triangles; ++t)
+				for (uint32 k = 0u; k < 3u; ++k)
+					corners_[position[triangles_[t][k]]++] = 3u * t + k;
+		}
+
+		// cotangent of the angle of each corner, area of each triangle and mean edge length
+		cotangents_.resize(3u * nb_triangles);
+		std::vector<float64> triangle_area(nb_triangles);
+		std::vector<float64> edge_length(nb_triangles);
+		parallel_for(0u, nb_triangles, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 t = first; t < last; ++t)
+			{
+				edge_length[t] = 0.0;
+				for (uint32 k = 0u; k < 3u; ++k)
+				{
+					const Eigen::Vector3d& p = points_[triangles_[t][k]];
+					const Eigen::Vector3d e1 = points_[triangles_[t][(k + 1u) % 3u]] - p;
+					const Eigen::Vector3d e2 = points_[triangles_[t][(k + 2u) % 3u]] - p;
+					const float64 sine = e1.cross(e2).norm();
+					cotangents_[3u * t + k] = sine > 0.0 ? e1.dot(e2) / sine : 0.0;
+					edge_length[t] += e1.norm();
+				}
+				triangle_area[t] = 0.5 * (points_[triangles_[t][1]] - points_[triangles_[t][0]]).cross(points_[triangles_[t][2]] - points_[triangles_[t][0]]).norm();
+			}
+		});
+
+		float64 mean_edge_length = 0.0;
+		for (float64 l : edge_length)
+			mean_edge_length += l;
+		mean_edge_length /= std::max(1.0, 3.0 * float64(nb_triangles));
+		time_ = time_factor_ * mean_edge_length * mean_edge_length;
+
+		// assembly of the Laplacian and mass matrices (4 Laplacian and 1 mass entries per triangle corner)
+		using Triplet = Eigen::Triplet<float64>;
+		std::vector<Triplet> laplacian_triplets(12u * nb_triangles);
+		std::vector<Triplet> mass_triplets(3u * nb_triangles);
+		parallel_for(0u, nb_triangles, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 t = first; t < last; ++t)
+			{
+				for (uint32 k = 0u; k < 3u; ++k)
+				{
+					// the corner k weights the opposite edge (i, j)
+					const uint32 i = triangles_[t][(k + 1u) % 3u];
+					const uint32 j = triangles_[t][(k + 2u) % 3u];
+					const float64 w = 0.5 * cotangents_[3u * t + k];
+					Triplet* l = &laplacian_triplets[12u * t + 4u * k];
+					l[0] = Triplet(i, i, w);
+					l[1] = Triplet(j, j, w);
+					l[2] = Triplet(i, j, -w);
+					l[3] = Triplet(j, i, -w);
+					mass_triplets[3u * t + k] = Triplet(triangles_[t][k], triangles_[t][k], triangle_area[t] / 3.0);
+				}
+			}
+		});
+
+		SparseMatrix laplacian(nb_vertices, nb_vertices);
+		laplacian.setFromTriplets(laplacian_triplets.begin(), laplacian_triplets.end());
+		SparseMatrix mass(nb_vertices, nb_vertices);
+		mass.setFromTriplets(mass_triplets.begin(), mass_triplets.end());
+
+		// the Laplacian is only semi-definite: it is slightly regularized by the mass matrix for the Poisson equation
+		const float64 regularization = 1e-8 * laplacian.diagonal().sum() / std::max(mass.diagonal().sum(), std::numeric_limits<float64>::min());
+
+		const SparseMatrix heat_matrix = mass + time_ * laplacian;
+		const SparseMatrix poisson_matrix = laplacian + regularization * mass;
+		heat_solver_.compute(heat_matrix);
+		poisson_solver_.compute(poisson_matrix);
+
+		factorized_ = heat_solver_.info() == Eigen::Success && poisson_solver_.info() == Eigen::Success;
+		if (!factorized_)
+			cgogn_log_error("HeatMethod::update") << "The factorization of the matrices failed.";
+		return factorized_;
+	}
+
+	/**
+	 * @return true if the matrices have been factorized and the topology of the map has not changed since
+	 */
+	inline bool is_valid() const
+	{
+		return factorized_ && incidence_.is_valid();
+	}
+
+	/// the diffusion time used by the last update
+	inline float64 time() const { return time_; }
+
+	/**
+	 * @brief compute the geodesic distance of each vertex to the nearest source
+	 * @param[in] sources the source vertices
+	 * @param[out] distance the distance of the vertices (unchanged if the matrices cannot be factorized)
+	 * @return false if the matrices cannot be factorized
+	 */
+	bool compute(const std::vector<Vertex>& sources, VertexAttribute<Scalar>& distance)
+	{
+		std::vector<std::vector<uint32>> columns(1u);
+		for (Vertex v : sources)
+			columns[0].push_back(incidence_.vertex_index(v.dart));
+
+		Matrix phi;
+		if (!solve(columns, phi))
+			return false;
+
+		parallel_for(0u, incidence_.nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				distance[Vertex(incidence_.vertices()[i])] = Scalar(phi(i, 0));
+		});
+		return true;
+	}
+
+	/**
+	 * @brief compute in one batch the geodesic distances of each vertex to each source
+	 * @param[in] sources the K source vertices
+	 * @param[out] distances the K-wide distance vectors of the vertices, in the order of the incidence snapshot:
+	 * distances[i*K + k] is the distance of the i-th vertex to the k-th source (empty if the matrices cannot be factorized)
+	 * @return false if the matrices cannot be factorized
+	 */
+	bool compute_batch(const std::vector<Vertex>& sources, std::vector<Scalar>& distances)
+	{
+		const std::size_t nb_fields = sources.size();
+		std::vector<std::vector<uint32>> columns(nb_fields);
+		for (std::size_t k = 0u; k < nb_fields; ++k)
+			columns[k].push_back(incidence_.vertex_index(sources[k].dart));
+
+		Matrix phi;
+		if (!solve(columns, phi))
+		{
+			distances.clear();
+			return false;
+		}
+
+		distances.resize(std::size_t(incidence_.nb_vertices()) * nb_fields);
+		parallel_for(0u, incidence_.nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				for (std::size_t k = 0u; k < nb_fields; ++k)
+					distances[i * nb_fields + k] = Scalar(phi(i, k));
+		});
+		return true;
+	}
+
+private:
+
+	/**
+	 * @brief compute the distance fields of the given sets of sources (one column per set)
+	 * @return false if the matrices cannot be factorized
+	 */
+	bool solve(const std::vector<std::vector<uint32>>& sources, Matrix& phi)
+	{
+		if (!is_valid() && !update())
+		{
+			cgogn_log_error("HeatMethod::solve") << "The distances cannot be computed without the factorization of the matrices.";
+			return false;
+		}
+
+		const uint32 nb_vertices = incidence_.nb_vertices();
+		const uint32 nb_triangles = uint32(triangles_.size());
+		const uint32 nb_columns = uint32(sources.size());
+
+		Matrix delta = Matrix::Zero(nb_vertices, nb_columns);
+		for (uint32 c = 0u; c < nb_columns; ++c)
+			for (uint32 s : sources[c])
+				delta(s, c) = 1.0;
+
+		// diffuse the heat (the columns are solved in parallel)
+		Matrix heat(nb_vertices, nb_columns);
+		parallel_for(0u, nb_columns, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+				heat.col(c) = heat_solver_.solve(delta.col(c));
+		});
+
+		// integrated divergence of the normalized gradient of the heat in each triangle corner
+		Matrix corner_divergence(3u * nb_triangles, nb_columns);
+		parallel_for(0u, nb_triangles, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 t = first; t < last; ++t)
+			{
+				const std::array<uint32, 3>& tri = triangles_[t];
+				const Eigen::Vector3d normal = (points_[tri[1]] - points_[tri[0]]).cross(points_[tri[2]] - points_[tri[0]]);
+				for (uint32 c = 0u; c < nb_columns; ++c)
+				{
+					// the gradient is the sum of the rotated opposite edges weighted by the heat of the corners
+					Eigen::Vector3d gradient = Eigen::Vector3d::Zero();
+					for (uint32 k = 0u; k < 3u; ++k)
+						gradient += heat(tri[k], c) * normal.cross(points_[tri[(k + 2u) % 3u]] - points_[tri[(k + 1u) % 3u]]);
+					const float64 norm = gradient.norm();
+					const Eigen::Vector3d x = norm > 0.0 ? Eigen::Vector3d(-gradient / norm) : Eigen::Vector3d::Zero();
+
+					for (uint32 k = 0u; k < 3u; ++k)
+					{
+						const Eigen::Vector3d& p = points_[tri[k]];
+						const uint32 k1 = (k + 1u) % 3u;
+						const uint32 k2 = (k + 2u) % 3u;
+						corner_divergence(3u * t + k, c) = 0.5 * (
+							cotangents_[3u * t + k2] * (points_[tri[k1]] - p).dot(x) +
+							cotangents_[3u * t + k1] * (points_[tri[k2]] - p).dot(x));
+					}
+				}
+			}
+		});
+
+		Matrix divergence(nb_vertices, nb_columns);
+		parallel_for(0u, nb_vertices, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				for (uint32 c = 0u; c < nb_columns; ++c)
+				{
+					float64 sum = 0.0;
+					for (uint32 k = corner_offsets_[i]; k < corner_offsets_[i + 1u]; ++k)
+						sum += corner_divergence(corners_[k], c);
+					divergence(i, c) = -sum;
+				}
+			}
+		});
+
+		// recover the distance from its gradient and shift it to be null on the sources
+		phi.resize(nb_vertices, nb_columns);
+		parallel_for(0u, nb_columns, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+			{
+				phi.col(c) = poisson_solver_.solve(divergence.col(c));
+				float64 shift = std::numeric_limits<float64>::max();
+				for (uint32 s : sources[c])
+					shift = std::min(shift, phi(s, c));
+				if (sources[c].empty())
+					shift = phi.col(c).minCoeff();
+				phi.col(c).array() -= shift;
+			}
+		});
+
+		return true;
+	}
+
+	const CSRIncidence<MAP>& incidence_;
+	const VertexAttribute<VEC3>& position_;
+	float64 time_factor_;
+	float64 time_;
+	bool factorized_;
+
+	std::vector<Eigen::Vector3d> points_;
+	std::vector<std::array<uint32, 3>> triangles_;
+	std::vector<float64> cotangents_;
+	std::vector<uint32> corner_offsets_;
+	std::vector<uint32> corners_;
+
+	Solver heat_solver_;
+	Solver poisson_solver_;
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_EXTERNAL_TEMPLATES_CPP_))
+extern template class CGOGN_GEOMETRY_API HeatMethod<Eigen::Vector3f, CMap2>;
+extern template class CGOGN_GEOMETRY_API HeatMethod<Eigen::Vector3d, CMap2>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_EXTERNAL_TEMPLATES_CPP_))
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_HEAT_METHOD_H_
@@ -28,6 +28,8 @@
 #include <cgogn/core/basic/cell.h>
 #include <cgogn/core/cmap/attribute.h>
 #include <cgogn/core/utils/masks.h>
+#include <cgogn/core/cmap/csr_incidence.h>
+#include <cgogn/core/cmap/scatter.h>
 
 #include <cgogn/geometry/algos/area.h>
 #include <cgogn/geometry/functions/basics.h>
@@ -188,6 +190,11 @@ inline void compute_normal(
 }
 
 
+/**
+ * @brief compute the normal of all the vertices of the map:
+ * the normal and area of each face are computed once and scattered to its vertices
+ * with the weights of normal(map, v, position)
+ */
 template <typename MAP, typename VERTEX_ATTR>
 inline void compute_normal(
 	const MAP& map,
@@ -197,7 +204,95 @@ inline void compute_normal(
 {
 	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
 
-	compute_normal(map, AllCellsFilter(), position, vertex_normal);
+	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
+	using Scalar = ScalarOf<VEC3>;
+	using Vertex = typename MAP::Vertex;
+
+	map.parallel_foreach_cell([&] (Cell<Orbit::PHI21> v)
+	{
+		vertex_normal[v] = VEC3{Scalar{0}, Scalar{0}, Scalar{0}};
+	});
+
+	parallel_scatter(map, vertex_normal, [&] (Cell<Orbit::PHI1> f, ScatterAccumulator<VEC3, Orbit::PHI21>& acc)
+	{
+		const VEC3 face_normal = normal(map, f, position);
+		const Scalar face_area = convex_area(map, f, position);
+		Dart d = f.dart;
+		do
+		{
+			const VEC3& p = position[Vertex(d)];
+			const VEC3& p1 = position[Vertex(map.phi1(d))];
+			const VEC3& p2 = position[Vertex(map.phi_1(d))];
+			const Scalar l = (p1-p).squaredNorm() * (p2-p).squaredNorm();
+			VEC3 n = face_normal;
+			if (l != Scalar(0))
+				n *= face_area / l;
+			acc(Cell<Orbit::PHI21>(d), n);
+			d = map.phi1(d);
+		} while (d != f.dart);
+	});
+
+	map.parallel_foreach_cell([&] (Cell<Orbit::PHI21> v)
+	{
+		normalize_safe(vertex_normal[v]);
+	});
+}
+
+
+/**
+ * @brief compute the normal of all the vertices of the map, using a CSRIncidence snapshot of the map:
+ * the normal and area of each face are computed once, then the normals of the incident faces are
+ * weighted as in normal(map, v, position)
+ */
+template <typename MAP, typename VERTEX_ATTR>
+inline void compute_normal(
+	const MAP& map,
+	const CSRIncidence<MAP>& incidence,
+	const VERTEX_ATTR& position,
+	Attribute<InsideTypeOf<VERTEX_ATTR>, Orbit::PHI21>& vertex_normal
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+	cgogn_message_assert(&incidence.map() == &map && incidence.is_valid(), "compute_normal: the incidence snapshot is not up to date");
+
+	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
+	using Scalar = ScalarOf<VEC3>;
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+
+	std::vector<VEC3> face_normal(incidence.nb_faces());
+	std::vector<Scalar> face_area(incidence.nb_faces());
+	parallel_for(0u, incidence.nb_faces(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+	{
+		for (uint32 i = first; i < last; ++i)
+		{
+			const Face f(incidence.faces()[i]);
+			face_normal[i] = normal(map, f, position);
+			face_area[i] = convex_area(map, f, position);
+		}
+	});
+
+	parallel_for(0u, incidence.nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+	{
+		for (uint32 i = first; i < last; ++i)
+		{
+			VEC3 n{Scalar{0}, Scalar{0}, Scalar{0}};
+			const VEC3& p = position[Vertex(incidence.vertices()[i])];
+			for (Dart d : incidence.incident_faces(i))
+			{
+				const uint32 f = incidence.face_index(d);
+				VEC3 facen = face_normal[f];
+				const VEC3& p1 = position[Vertex(map.phi1(d))];
+				const VEC3& p2 = position[Vertex(map.phi_1(d))];
+				const Scalar l = (p1-p).squaredNorm() * (p2-p).squaredNorm();
+				if (l != Scalar(0))
+					facen *= face_area[f] / l;
+				n += facen;
+			}
+			normalize_safe(n);
+			vertex_normal[Vertex(incidence.vertices()[i])] = n;
+		}
+	});
 }
 
 
@@ -34,6 +34,7 @@
 #include <cgogn/geometry/functions/intersection.h>
 #include <cgogn/geometry/functions/distance.h>
 #include <cgogn/geometry/algos/ear_triangulation.h>
+#include <cgogn/geometry/algos/bvh.h>
 
 #include <tuple>
 
@@ -117,24 +118,39 @@ inline void picking_internal_face(
 	std::sort(selected.begin(), selected.end(), dist_sort);
 }
 
-template <typename MAP, typename VERTEX_ATTR>
-bool picking(
-	const MAP& m,
-	const VERTEX_ATTR& position,
-	const InsideTypeOf<VERTEX_ATTR>& A,
-	const InsideTypeOf<VERTEX_ATTR>& B,
-	typename std::vector<typename MAP::Face>& selected
+/**
+ * @brief pick the faces of the map hit by the ray (A, AB) with a BVH of the map,
+ * same result as the brute force version (the faces in the BVH of a volume map are the faces incident to the boundary)
+ */
+template <typename VEC3, typename MAP>
+inline void picking_internal_face(
+	const BVH<VEC3, MAP>& bvh,
+	const VEC3& A,
+	const VEC3& B,
+	typename std::vector<std::tuple<typename MAP::Face, VEC3, ScalarOf<VEC3>>>& selected
 )
 {
-	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
-	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
-	using Scalar = ScalarOf<VEC3>;
-	using Face = typename MAP::Face;
-	using Triplet = typename std::tuple<Face, VEC3, Scalar>;
+	using Hit = typename BVH<VEC3, MAP>::Hit;
 
-	std::vector<Triplet> sel;
-	picking_internal_face(m, position, A, B, sel);
+	cgogn_message_assert((B - A).squaredNorm() > 0.0, "line must be defined by 2 different points");
+
+	std::vector<Hit> hits;
+	bvh.intersect_all(A, B - A, hits);
+	for (const Hit& h : hits)
+		selected.push_back(std::make_tuple(h.face, h.point, h.distance * h.distance));
+}
+
+namespace internal
+{
 
+template <typename MAP, typename VERTEX_ATTR>
+bool picked_cells(
+	const MAP&,
+	const VERTEX_ATTR&,
+	const typename std::vector<std::tuple<typename MAP::Face, InsideTypeOf<VERTEX_ATTR>, ScalarOf<InsideTypeOf<VERTEX_ATTR>>>>& sel,
+	typename std::vector<typename MAP::Face>& selected
+)
+{
 	selected.clear();
 	for (const auto& fs : sel)
 		selected.push_back(std::get<0>(fs));
@@ -143,24 +159,17 @@ bool picking(
 }
 
 template <typename MAP, typename VERTEX_ATTR>
-bool picking(
+bool picked_cells(
 	const MAP& m,
 	const VERTEX_ATTR& position,
-	const InsideTypeOf<VERTEX_ATTR>& A,
-	const InsideTypeOf<VERTEX_ATTR>& B,
+	const typename std::vector<std::tuple<typename MAP::Face, InsideTypeOf<VERTEX_ATTR>, ScalarOf<InsideTypeOf<VERTEX_ATTR>>>>& sel,
 	typename std::vector<typename MAP::Vertex>& selected
 )
 {
-	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
-
 	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
 	using Scalar = ScalarOf<VEC3>;
 	using Vertex = typename MAP::Vertex;
 	using Face = typename MAP::Face;
-	using Triplet = typename std::tuple<Face, VEC3, Scalar>;
-
-	std::vector<Triplet> sel;
-	picking_internal_face(m, position, A, B, sel);
 
 	DartMarkerStore<MAP> dm(m);
 	selected.clear();
@@ -193,24 +202,18 @@ bool picking(
 }
 
 template <typename MAP, typename VERTEX_ATTR>
-bool picking(
+bool picked_cells(
 	const MAP& m,
 	const VERTEX_ATTR& position,
-	const InsideTypeOf<VERTEX_ATTR>& A,
-	const InsideTypeOf<VERTEX_ATTR>& B,
+	const typename std::vector<std::tuple<typename MAP::Face, InsideTypeOf<VERTEX_ATTR>, ScalarOf<InsideTypeOf<VERTEX_ATTR>>>>& sel,
 	typename std::vector<typename MAP::Edge>& selected
 )
 {
-	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
 	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
 	using Scalar = ScalarOf<VEC3>;
 	using Vertex = typename MAP::Vertex;
 	using Edge = typename MAP::Edge;
 	using Face = typename MAP::Face;
-	using Triplet = typename std::tuple<Face, VEC3, Scalar>;
-
-	std::vector<Triplet> sel;
-	picking_internal_face(m, position, A, B, sel);
 
 	DartMarkerStore<MAP> dm(m);
 	selected.clear();
@@ -245,23 +248,15 @@ bool picking(
 }
 
 template <typename MAP, typename VERTEX_ATTR>
-bool picking(
+bool picked_cells(
 	const MAP& m,
-	const VERTEX_ATTR& position,
-	const InsideTypeOf<VERTEX_ATTR>& A,
-	const InsideTypeOf<VERTEX_ATTR>& B,
+	const VERTEX_ATTR&,
+	const typename std::vector<std::tuple<typename MAP::Face, InsideTypeOf<VERTEX_ATTR>, ScalarOf<InsideTypeOf<VERTEX_ATTR>>>>& sel,
 	typename std::vector<typename MAP::Volume>& selected
 )
 {
-	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
-	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
-	using Scalar = ScalarOf<VEC3>;
 	using Face = typename MAP::Face;
 	using Volume = typename MAP::Volume;
-	using Triplet = typename std::tuple<Face, VEC3, Scalar>;
-
-	std::vector<Triplet> sel;
-	picking_internal_face(m, position, A, B, sel);
 
 	selected.clear();
 	DartMarker<MAP> dm(m);
@@ -281,6 +276,56 @@ bool picking(
 	return !selected.empty();
 }
 
+} // namespace internal
+
+/**
+ * @brief pick the cells (Vertex, Edge, Face or Volume) of the map along the ray (A, AB), sorted by distance to A
+ * @return true if a cell is picked
+ */
+template <typename MAP, typename VERTEX_ATTR, typename CELL>
+bool picking(
+	const MAP& m,
+	const VERTEX_ATTR& position,
+	const InsideTypeOf<VERTEX_ATTR>& A,
+	const InsideTypeOf<VERTEX_ATTR>& B,
+	typename std::vector<CELL>& selected
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
+	using Scalar = ScalarOf<VEC3>;
+	using Face = typename MAP::Face;
+	using Triplet = typename std::tuple<Face, VEC3, Scalar>;
+
+	std::vector<Triplet> sel;
+	picking_internal_face(m, position, A, B, sel);
+
+	return internal::picked_cells(m, position, sel, selected);
+}
+
+/**
+ * @brief pick the cells (Vertex, Edge, Face or Volume) of the map along the ray (A, AB) with a BVH of the map
+ * instead of testing all the faces
+ * @return true if a cell is picked
+ */
+template <typename VEC3, typename MAP, typename CELL>
+bool picking(
+	const BVH<VEC3, MAP>& bvh,
+	const VEC3& A,
+	const VEC3& B,
+	typename std::vector<CELL>& selected
+)
+{
+	using Scalar = ScalarOf<VEC3>;
+	using Face = typename MAP::Face;
+	using Triplet = typename std::tuple<Face, VEC3, Scalar>;
+
+	std::vector<Triplet> sel;
+	picking_internal_face(bvh, A, B, sel);
+
+	return internal::picked_cells(bvh.map(), bvh.position(), sel, selected);
+}
+
 } // namespace geometry
 
 } // namespace cgogn
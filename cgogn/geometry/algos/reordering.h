@@ -0,0 +1,337 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_REORDERING_H_
+#define CGOGN_GEOMETRY_ALGOS_REORDERING_H_
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include <cgogn/core/basic/dart.h>
+#include <cgogn/core/basic/dart_marker.h>
+#include <cgogn/core/cmap/attribute.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+
+/**
+ * Dart orderings that improve the memory locality of a map.
+ * They are meant to be given to MAP::compact(order), e.g.:
+ *     map.compact(geometry::hilbert_order(map, position));
+ */
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+namespace internal
+{
+
+/**
+ * @brief spread the 21 lowest bits of x (bit i goes to bit 3*i)
+ */
+inline uint64 spread_bits_3(uint64 x)
+{
+	x &= 0x1fffffu;
+	x = (x | x << 32) & 0x1f00000000ffffull;
+	x = (x | x << 16) & 0x1f0000ff0000ffull;
+	x = (x | x << 8) & 0x100f00f00f00f00full;
+	x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+	x = (x | x << 2) & 0x1249249249249249ull;
+	return x;
+}
+
+/**
+ * @brief Morton (Z-order) code of a point of [0, 2^21)^3
+ */
+inline uint64 morton_code(uint32 x, uint32 y, uint32 z)
+{
+	return spread_bits_3(x) | (spread_bits_3(y) << 1) | (spread_bits_3(z) << 2);
+}
+
+/**
+ * @brief Hilbert code of a point of [0, 2^21)^3
+ * (J. Skilling, Programming the Hilbert curve, AIP Conference Proceedings 707, 2004)
+ */
+inline uint64 hilbert_code(uint32 x, uint32 y, uint32 z)
+{
+	uint32 X[3] = { x, y, z };
+	const uint32 M = 1u << 20;
+
+	// inverse undo excess work
+	for (uint32 Q = M; Q > 1u; Q >>= 1)
+	{
+		const uint32 P = Q - 1u;
+		for (uint32 i = 0u; i < 3u; ++i)
+		{
+			if (X[i] & Q)
+				X[0] ^= P;
+			else
+			{
+				const uint32 t = (X[0] ^ X[i]) & P;
+				X[0] ^= t;
+				X[i] ^= t;
+			}
+		}
+	}
+
+	// Gray encode
+	X[1] ^= X[0];
+	X[2] ^= X[1];
+	uint32 t = 0u;
+	for (uint32 Q = M; Q > 1u; Q >>= 1)
+	{
+		if (X[2] & Q)
+			t ^= Q - 1u;
+	}
+	X[0] ^= t;
+	X[1] ^= t;
+	X[2] ^= t;
+
+	// the transposed code is interleaved with X[0] as the most significant axis
+	return (spread_bits_3(X[0]) << 2) | (spread_bits_3(X[1]) << 1) | spread_bits_3(X[2]);
+}
+
+/**
+ * @brief append the darts of the given vertices (in this order) to a dart order
+ */
+template <typename MAP>
+std::vector<Dart> vertices_darts(const MAP& map, const std::vector<typename MAP::Vertex>& vertices)
+{
+	std::vector<Dart> order;
+	order.reserve(map.nb_darts());
+	for (typename MAP::Vertex v : vertices)
+		map.foreach_dart_of_orbit(v, [&] (Dart d) { order.push_back(d); });
+	return order;
+}
+
+/**
+ * @brief order the darts of a map by vertices, the vertices being sorted by a space filling curve code of their position
+ * @param code function (uint32, uint32, uint32) -> uint64 that computes the code of a quantized position
+ */
+template <typename MAP, typename VERTEX_ATTR, typename CODE>
+std::vector<Dart> space_filling_curve_order(const MAP& map, const VERTEX_ATTR& position, const CODE& code)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value, "position must be a vertex attribute");
+
+	using Vertex = typename MAP::Vertex;
+	using VEC = InsideTypeOf<VERTEX_ATTR>;
+	using Scalar = ScalarOf<VEC>;
+	static const uint32 DIM = vector_traits<VEC>::SIZE < 3u ? uint32(vector_traits<VEC>::SIZE) : 3u;
+
+	std::vector<Vertex> vertices;
+	vertices.reserve(map.template nb_cells<Vertex::ORBIT>());
+	map.foreach_cell([&] (Vertex v) { vertices.push_back(v); });
+	if (vertices.empty())
+		return std::vector<Dart>();
+
+	// bounding box
+	Scalar bb_min[3] = { 0, 0, 0 };
+	Scalar bb_max[3] = { 0, 0, 0 };
+	for (uint32 j = 0u; j < DIM; ++j)
+		bb_min[j] = bb_max[j] = position[vertices[0]][j];
+	for (Vertex v : vertices)
+	{
+		const VEC& p = position[v];
+		for (uint32 j = 0u; j < DIM; ++j)
+		{
+			bb_min[j] = std::min(bb_min[j], p[j]);
+			bb_max[j] = std::max(bb_max[j], p[j]);
+		}
+	}
+	Scalar extent = Scalar(0);
+	for (uint32 j = 0u; j < DIM; ++j)
+		extent = std::max(extent, bb_max[j] - bb_min[j]);
+	const Scalar scale = extent > Scalar(0) ? Scalar((1u << 21) - 1u) / extent : Scalar(0);
+
+	// codes of the vertices (computed in parallel)
+	std::vector<std::pair<uint64, uint32>> codes(vertices.size());
+	parallel_for(0u, uint32(vertices.size()), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+	{
+		for (uint32 i = first; i < last; ++i)
+		{
+			const VEC& p = position[vertices[i]];
+			uint32 q[3] = { 0u, 0u, 0u };
+			for (uint32 j = 0u; j < DIM; ++j)
+				q[j] = std::min(uint32((p[j] - bb_min[j]) * scale), (1u << 21) - 1u);
+			codes[i] = std::make_pair(code(q[0], q[1], q[2]), i);
+		}
+	});
+	std::sort(codes.begin(), codes.end());
+
+	std::vector<Vertex> sorted;
+	sorted.reserve(vertices.size());
+	for (const auto& c : codes)
+		sorted.push_back(vertices[c.second]);
+
+	return vertices_darts(map, sorted);
+}
+
+} // namespace internal
+
+/**
+ * @brief order the darts of a surface map face by face, the faces being visited in breadth-first order
+ * through their edges (the darts of a face are consecutive and adjacent faces are close in memory)
+ * @return the darts of the non boundary faces of the map
+ */
+template <typename MAP>
+std::vector<Dart> bfs_face_order(const MAP& map)
+{
+	using Face = typename MAP::Face;
+
+	std::vector<Dart> order;
+	order.reserve(map.nb_darts());
+
+	DartMarker<MAP> dm(map);
+	std::vector<Face> queue;
+	map.foreach_cell([&] (Face f)
+	{
+		if (dm.is_marked(f.dart))
+			return;
+
+		dm.mark_orbit(f);
+		queue.clear();
+		queue.push_back(f);
+		for (std::size_t i = 0u; i < queue.size(); ++i)
+		{
+			const Face g = queue[i];
+			map.foreach_dart_of_orbit(g, [&] (Dart d) { order.push_back(d); });
+			map.foreach_adjacent_face_through_edge(g, [&] (Face h)
+			{
+				if (!dm.is_marked(h.dart))
+				{
+					dm.mark_orbit(h);
+					queue.push_back(h);
+				}
+			});
+		}
+	});
+
+	return order;
+}
+
+/**
+ * @brief order the darts of a map by vertices, the vertices being sorted along the Morton (Z-order) curve of their position
+ */
+template <typename MAP, typename VERTEX_ATTR>
+std::vector<Dart> morton_order(const MAP& map, const VERTEX_ATTR& position)
+{
+	return internal::space_filling_curve_order(map, position, &internal::morton_code);
+}
+
+/**
+ * @brief order the darts of a map by vertices, the vertices being sorted along the Hilbert curve of their position
+ */
+template <typename MAP, typename VERTEX_ATTR>
+std::vector<Dart> hilbert_order(const MAP& map, const VERTEX_ATTR& position)
+{
+	return internal::space_filling_curve_order(map, position, &internal::hilbert_code);
+}
+
+/**
+ * @brief order the darts of a map by vertices, the vertices being sorted by the reverse Cuthill-McKee algorithm
+ * on the vertex graph (reduces the bandwidth of the vertex adjacency)
+ */
+template <typename MAP>
+std::vector<Dart> reverse_cuthill_mckee_order(const MAP& map)
+{
+	using Vertex = typename MAP::Vertex;
+
+	// local index of the vertices, stored per dart
+	uint32 nb_dart_indices = 0u;
+	map.foreach_dart([&] (Dart d) { nb_dart_indices = std::max(nb_dart_indices, d.index + 1u); });
+
+	std::vector<Vertex> vertices;
+	std::vector<uint32> vertex_index(nb_dart_indices, std::numeric_limits<uint32>::max());
+	map.foreach_cell([&] (Vertex v)
+	{
+		const uint32 index = uint32(vertices.size());
+		vertices.push_back(v);
+		map.foreach_dart_of_orbit(v, [&] (Dart d) { vertex_index[d.index] = index; });
+	});
+	const uint32 nb_vertices = uint32(vertices.size());
+
+	// adjacency in CSR form
+	std::vector<uint32> offsets(nb_vertices + 1u, 0u);
+	std::vector<uint32> neighbors;
+	neighbors.reserve(2u * nb_vertices);
+	for (uint32 i = 0u; i < nb_vertices; ++i)
+	{
+		map.foreach_adjacent_vertex_through_edge(vertices[i], [&] (Vertex w)
+		{
+			neighbors.push_back(vertex_index[w.dart.index]);
+		});
+		offsets[i + 1u] = uint32(neighbors.size());
+	}
+	auto degree = [&] (uint32 i) { return offsets[i + 1u] - offsets[i]; };
+
+	// vertices by increasing degree (start vertices of the components)
+	std::vector<uint32> by_degree(nb_vertices);
+	for (uint32 i = 0u; i < nb_vertices; ++i)
+		by_degree[i] = i;
+	std::stable_sort(by_degree.begin(), by_degree.end(), [&] (uint32 a, uint32 b) { return degree(a) < degree(b); });
+
+	std::vector<uint32> cm;
+	cm.reserve(nb_vertices);
+	std::vector<bool> visited(nb_vertices, false);
+	std::vector<uint32> adjacent;
+	for (uint32 s : by_degree)
+	{
+		if (visited[s])
+			continue;
+		visited[s] = true;
+		cm.push_back(s);
+		for (std::size_t k = cm.size() - 1u; k < cm.size(); ++k)
+		{
+			const uint32 i = cm[k];
+			adjacent.clear();
+			for (uint32 n = offsets[i]; n < offsets[i + 1u]; ++n)
+			{
+				const uint32 j = neighbors[n];
+				if (!visited[j])
+				{
+					visited[j] = true;
+					adjacent.push_back(j);
+				}
+			}
+			std::sort(adjacent.begin(), adjacent.end(), [&] (uint32 a, uint32 b) { return degree(a) < degree(b); });
+			cm.insert(cm.end(), adjacent.begin(), adjacent.end());
+		}
+	}
+
+	std::vector<Vertex> sorted;
+	sorted.reserve(nb_vertices);
+	for (auto it = cm.rbegin(); it != cm.rend(); ++it)
+		sorted.push_back(vertices[*it]);
+
+	return internal::vertices_darts(map, sorted);
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_REORDERING_H_
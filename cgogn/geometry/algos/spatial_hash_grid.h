@@ -0,0 +1,346 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_SPATIAL_HASH_GRID_H_
+#define CGOGN_GEOMETRY_ALGOS_SPATIAL_HASH_GRID_H_
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/type_traits.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/functions/inclusion.h>
+#include <cgogn/geometry/algos/reordering.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * @brief The SpatialHashGrid class indexes the vertices of a map in a uniform grid whose non empty cells are stored
+ * in a hash table, so that the vertices within a sphere are found by visiting the grid cells that overlap the sphere,
+ * without any traversal or marking of the map.
+ * The vertices are sorted along the Morton curve of their cell: the vertices of a cell are contiguous
+ * and the neighborhoods of consecutive vertices are close in memory.
+ *
+ * The neighborhoods are euclidean: they contain all the vertices in the sphere (geometry::in_sphere),
+ * even those that are not connected to the center inside the sphere.
+ * The queries are the most efficient when the cell size is close to the radius of the queries.
+ * The positions are copied by build: it must be called again when the positions or the vertices change.
+ */
+template <typename VEC3, typename MAP>
+class SpatialHashGrid
+{
+public:
+
+	using Scalar = ScalarOf<VEC3>;
+	using Vertex = typename MAP::Vertex;
+
+	template <typename T>
+	using VertexAttribute = typename MAP::template VertexAttribute<T>;
+
+	/// number of queries of a batch processed by a thread at once
+	static const uint32 QUERY_GRAIN = 64u;
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(SpatialHashGrid);
+
+	/**
+	 * @param map the map
+	 * @param position the position of the vertices
+	 * @param cell_size the size of the cells of the grid
+	 */
+	SpatialHashGrid(const MAP& map, const VertexAttribute<VEC3>& position, Scalar cell_size) :
+		map_(map),
+		position_(position),
+		cell_size_(cell_size),
+		built_(false)
+	{
+		cgogn_message_assert(cell_size > Scalar(0), "SpatialHashGrid: the cell size must be positive");
+	}
+
+	inline const MAP& map() const { return map_; }
+	inline const VertexAttribute<VEC3>& position() const { return position_; }
+	inline Scalar cell_size() const { return cell_size_; }
+	inline bool is_built() const { return built_; }
+	inline uint32 nb_vertices() const { return uint32(vertices_.size()); }
+
+	/**
+	 * @brief copy the positions, sort the vertices along the Morton curve of their cell and hash the cells
+	 */
+	void build()
+	{
+		std::vector<Vertex> vertices;
+		map_.foreach_cell([&] (Vertex v) { vertices.push_back(v); });
+		const uint32 nb = uint32(vertices.size());
+
+		std::vector<GridCell> cells(nb);
+		parallel_for(0u, nb, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				cells[i] = cell_of(position_[vertices[i]]);
+		});
+
+		min_cell_ = GridCell{{ 0, 0, 0 }};
+		max_cell_ = GridCell{{ -1, -1, -1 }};
+		if (nb > 0u)
+		{
+			min_cell_ = max_cell_ = cells[0];
+			for (const GridCell& c : cells)
+			{
+				for (uint32 a = 0u; a < 3u; ++a)
+				{
+					min_cell_[a] = std::min(min_cell_[a], c[a]);
+					max_cell_[a] = std::max(max_cell_[a], c[a]);
+				}
+			}
+		}
+		cgogn_message_assert(max_cell_[0] - min_cell_[0] < (1 << 21) && max_cell_[1] - min_cell_[1] < (1 << 21) && max_cell_[2] - min_cell_[2] < (1 << 21),
+			"SpatialHashGrid: the cell size is too small for the extent of the positions");
+
+		std::vector<std::pair<uint64, uint32>> sorted(nb);
+		parallel_for(0u, nb, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				sorted[i] = std::make_pair(key_of(cells[i]), i);
+		});
+		std::sort(sorted.begin(), sorted.end());
+
+		vertices_.resize(nb);
+		points_.resize(nb);
+		parallel_for(0u, nb, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				vertices_[i] = vertices[sorted[i].second];
+				points_[i] = position_[vertices_[i]];
+			}
+		});
+
+		// hash table of the non empty cells (open addressing, at most half full)
+		uint32 nb_cells = 0u;
+		for (uint32 i = 0u; i < nb; ++i)
+			if (i == 0u || sorted[i].first != sorted[i - 1u].first)
+				++nb_cells;
+		uint32 table_size = 2u;
+		while (table_size < 2u * nb_cells)
+			table_size <<= 1u;
+		table_mask_ = table_size - 1u;
+		table_.assign(table_size, CellRange{EMPTY_KEY, 0u, 0u});
+		for (uint32 i = 0u; i < nb;)
+		{
+			const uint64 key = sorted[i].first;
+			uint32 last = i + 1u;
+			while (last < nb && sorted[last].first == key)
+				++last;
+			uint32 slot = hash_of(key);
+			while (table_[slot].key != EMPTY_KEY)
+				slot = (slot + 1u) & table_mask_;
+			table_[slot] = CellRange{key, i, last};
+			i = last;
+		}
+
+		built_ = true;
+	}
+
+	/**
+	 * @brief call f(v) for each vertex v of the grid within the sphere (center, radius)
+	 */
+	template <typename FUNC>
+	void foreach_vertex_within(const VEC3& center, Scalar radius, const FUNC& f) const
+	{
+		static_assert(is_func_parameter_same<FUNC, Vertex>::value, "Wrong function cell parameter type");
+		cgogn_message_assert(built_, "SpatialHashGrid: the grid is not built");
+
+		// the cells overlapping the sphere, clamped to the cells of the vertices
+		GridCell lo, hi;
+		for (uint32 a = 0u; a < 3u; ++a)
+		{
+			lo[a] = std::max(min_cell_[a], coordinate(center[a] - radius));
+			hi[a] = std::min(max_cell_[a], coordinate(center[a] + radius));
+		}
+
+		GridCell c;
+		for (c[2] = lo[2]; c[2] <= hi[2]; ++c[2])
+		{
+			for (c[1] = lo[1]; c[1] <= hi[1]; ++c[1])
+			{
+				for (c[0] = lo[0]; c[0] <= hi[0]; ++c[0])
+				{
+					const uint64 key = key_of(c);
+					uint32 slot = hash_of(key);
+					while (table_[slot].key != key && table_[slot].key != EMPTY_KEY)
+						slot = (slot + 1u) & table_mask_;
+					const CellRange& r = table_[slot];
+					if (r.key == EMPTY_KEY)
+						continue;
+					for (uint32 j = r.first; j < r.last; ++j)
+					{
+						if (in_sphere(points_[j], center, radius))
+							f(vertices_[j]);
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief get the vertices within the sphere (center, radius)
+	 */
+	void vertices_within(const VEC3& center, Scalar radius, std::vector<Vertex>& result) const
+	{
+		result.clear();
+		foreach_vertex_within(center, radius, [&] (Vertex v) { result.push_back(v); });
+	}
+
+	/**
+	 * @brief batched version of vertices_within: the vertices within the sphere (centers[i], radius)
+	 * are result[offsets[i]], ..., result[offsets[i + 1] - 1]
+	 */
+	void vertices_within(const std::vector<VEC3>& centers, Scalar radius, std::vector<uint32>& offsets, std::vector<Vertex>& result) const
+	{
+		const uint32 nb_queries = uint32(centers.size());
+		const uint32 nb_blocks = (nb_queries + QUERY_GRAIN - 1u) / QUERY_GRAIN;
+
+		// each block of queries is answered in its own buffer, then the buffers are concatenated
+		std::vector<std::vector<Vertex>> block_results(nb_blocks);
+		offsets.assign(nb_queries + 1u, 0u);
+		parallel_for(0u, nb_blocks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 k = first; k < last; ++k)
+			{
+				std::vector<Vertex>& block = block_results[k];
+				for (uint32 i = k * QUERY_GRAIN, end = std::min(nb_queries, (k + 1u) * QUERY_GRAIN); i < end; ++i)
+				{
+					const std::size_t size = block.size();
+					foreach_vertex_within(centers[i], radius, [&] (Vertex v) { block.push_back(v); });
+					offsets[i + 1u] = uint32(block.size() - size);
+				}
+			}
+		});
+
+		std::vector<uint32> block_offsets(nb_blocks + 1u, 0u);
+		for (uint32 k = 0u; k < nb_blocks; ++k)
+			block_offsets[k + 1u] = block_offsets[k] + uint32(block_results[k].size());
+		for (uint32 i = 0u; i < nb_queries; ++i)
+			offsets[i + 1u] += offsets[i];
+
+		result.resize(block_offsets[nb_blocks]);
+		parallel_for(0u, nb_blocks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 k = first; k < last; ++k)
+				std::copy(block_results[k].begin(), block_results[k].end(), result.begin() + block_offsets[k]);
+		});
+	}
+
+	/**
+	 * @brief call f(v, neighbors) in parallel for each vertex v of the grid,
+	 * neighbors being the vertices within the sphere (position[v], radius), v included
+	 * (the buffer of the neighbors is reused by the thread for its next vertices)
+	 */
+	template <typename FUNC>
+	void parallel_foreach_neighborhood(Scalar radius, const FUNC& f) const
+	{
+		cgogn_message_assert(built_, "SpatialHashGrid: the grid is not built");
+
+		// the vertices are visited in Morton order for the locality of the neighborhoods
+		parallel_for(0u, nb_vertices(), QUERY_GRAIN, [&] (uint32 first, uint32 last)
+		{
+			std::vector<Vertex> neighbors;
+			for (uint32 i = first; i < last; ++i)
+			{
+				neighbors.clear();
+				foreach_vertex_within(points_[i], radius, [&] (Vertex v) { neighbors.push_back(v); });
+				f(vertices_[i], neighbors);
+			}
+		});
+	}
+
+private:
+
+	using GridCell = std::array<int32, 3>;
+
+	/// the vertices of the cell of Morton code key are vertices_[first], ..., vertices_[last - 1]
+	struct CellRange
+	{
+		uint64 key;
+		uint32 first;
+		uint32 last;
+	};
+
+	static const uint64 EMPTY_KEY = ~uint64(0);
+
+	inline int32 coordinate(Scalar x) const
+	{
+		return int32(std::floor(x / cell_size_));
+	}
+
+	inline GridCell cell_of(const VEC3& p) const
+	{
+		return GridCell{{ coordinate(p[0]), coordinate(p[1]), coordinate(p[2]) }};
+	}
+
+	inline uint64 key_of(const GridCell& c) const
+	{
+		return internal::morton_code(uint32(c[0] - min_cell_[0]), uint32(c[1] - min_cell_[1]), uint32(c[2] - min_cell_[2]));
+	}
+
+	inline uint32 hash_of(uint64 key) const
+	{
+		return uint32((key * 0x9e3779b97f4a7c15ull) >> 32) & table_mask_;
+	}
+
+	const MAP& map_;
+	const VertexAttribute<VEC3>& position_;
+	Scalar cell_size_;
+	bool built_;
+
+	GridCell min_cell_;
+	GridCell max_cell_;
+	uint32 table_mask_;
+	std::vector<CellRange> table_;
+	std::vector<Vertex> vertices_;
+	std::vector<VEC3> points_;
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_EXTERNAL_TEMPLATES_CPP_))
+extern template class CGOGN_GEOMETRY_API SpatialHashGrid<Eigen::Vector3f, CMap2>;
+extern template class CGOGN_GEOMETRY_API SpatialHashGrid<Eigen::Vector3d, CMap2>;
+extern template class CGOGN_GEOMETRY_API SpatialHashGrid<Eigen::Vector3f, CMap3>;
+extern template class CGOGN_GEOMETRY_API SpatialHashGrid<Eigen::Vector3d, CMap3>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_EXTERNAL_TEMPLATES_CPP_))
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_SPATIAL_HASH_GRID_H_
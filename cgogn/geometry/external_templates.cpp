@@ -27,6 +27,9 @@
 #include <cgogn/geometry/types/vec.h>
 #include <cgogn/geometry/algos/angle.h>
 #include <cgogn/geometry/algos/selection.h>
+#include <cgogn/geometry/algos/heat_method.h>
+#include <cgogn/geometry/algos/bvh.h>
+#include <cgogn/geometry/algos/spatial_hash_grid.h>
 #include <cgogn/geometry/types/aabb.h>
 #include <cgogn/geometry/types/obb.h>
 
@@ -50,6 +53,22 @@ template CGOGN_GEOMETRY_API class Collector_WithinSphere<Eigen::Vector3d, CMap2>
 template CGOGN_GEOMETRY_API class Collector_WithinSphere<Eigen::Vector3f, CMap3>;
 template CGOGN_GEOMETRY_API class Collector_WithinSphere<Eigen::Vector3d, CMap3>;
 
+/// HEAT METHOD
+template class CGOGN_GEOMETRY_API HeatMethod<Eigen::Vector3f, CMap2>;
+template class CGOGN_GEOMETRY_API HeatMethod<Eigen::Vector3d, CMap2>;
+
+/// BVH
+template class CGOGN_GEOMETRY_API BVH<Eigen::Vector3f, CMap2>;
+template class CGOGN_GEOMETRY_API BVH<Eigen::Vector3d, CMap2>;
+template class CGOGN_GEOMETRY_API BVH<Eigen::Vector3f, CMap3>;
+template class CGOGN_GEOMETRY_API BVH<Eigen::Vector3d, CMap3>;
+
+/// SPATIAL HASH GRID
+template class CGOGN_GEOMETRY_API SpatialHashGrid<Eigen::Vector3f, CMap2>;
+template class CGOGN_GEOMETRY_API SpatialHashGrid<Eigen::Vector3d, CMap2>;
+template class CGOGN_GEOMETRY_API SpatialHashGrid<Eigen::Vector3f, CMap3>;
+template class CGOGN_GEOMETRY_API SpatialHashGrid<Eigen::Vector3d, CMap3>;
+
 /// AABB
 template class CGOGN_GEOMETRY_API AABB<Eigen::Vector3d>;
 template class CGOGN_GEOMETRY_API AABB<Eigen::Vector3f>;
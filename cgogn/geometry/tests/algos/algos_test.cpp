@@ -29,6 +29,8 @@
 #include <cgogn/geometry/algos/centroid.h>
 #include <cgogn/geometry/algos/normal.h>
 #include <cgogn/geometry/algos/ear_triangulation.h>
+#include <cgogn/geometry/algos/reordering.h>
+#include <cgogn/geometry/algos/filtering.h>
 
 #include <cgogn/io/map_import.h>
 #include <cgogn/core/utils/type_traits.h>
@@ -210,3 +212,113 @@ TYPED_TEST(Algos_TEST, EarTriangulation)
 //	EXPECT_TRUE(this->map2_.nb_boundary_cells() == 1);
 	EXPECT_TRUE(this->map2_.template nb_cells<Edge::ORBIT>() == 7);
 }
+
+TYPED_TEST(Algos_TEST, Reordering)
+{
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, Vertex>("position");
+	for (uint32 n = 3; n < 8; ++n)
+		this->add_polygone(n);
+
+	auto check = [&] (const std::vector<Dart>& order)
+	{
+		std::vector<TypeParam> before;
+		this->map2_.foreach_dart([&] (Dart d) { before.push_back(vertex_position[Vertex(d)]); });
+
+		this->map2_.compact(order);
+		EXPECT_TRUE(this->map2_.check_map_integrity());
+
+		std::vector<TypeParam> after;
+		this->map2_.foreach_dart([&] (Dart d) { after.push_back(vertex_position[Vertex(d)]); });
+
+		// the darts given in the order come first, in this order, and keep their vertex position
+		for (uint32 i = 0; i < order.size(); ++i)
+			EXPECT_TRUE(after[i] == before[order[i].index]);
+	};
+
+	check(cgogn::geometry::bfs_face_order(this->map2_));
+	check(cgogn::geometry::morton_order(this->map2_, vertex_position));
+	check(cgogn::geometry::hilbert_order(this->map2_, vertex_position));
+	check(cgogn::geometry::reverse_cuthill_mckee_order(this->map2_));
+}
+
+TYPED_TEST(Algos_TEST, CSRIncidence)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, Vertex>("position");
+	for (uint32 n = 3; n < 8; ++n)
+		this->add_polygone(n);
+	// split the polygons and lift their vertices to get vertices with several non coplanar incident faces
+	std::vector<Face> faces;
+	this->map2_.foreach_cell([&] (Face f) { if (this->map2_.codegree(f) > 3) faces.push_back(f); });
+	for (Face f : faces)
+		this->map2_.cut_face(f.dart, this->map2_.phi1(this->map2_.phi1(f.dart)));
+	uint32 k = 0;
+	this->map2_.foreach_cell([&] (Vertex v) { vertex_position[v][2] = Scalar(0.1) * Scalar(k++ % 3); });
+
+	cgogn::CSRIncidence<CMap2> incidence(this->map2_);
+	incidence.build();
+	EXPECT_TRUE(incidence.is_valid());
+
+	VertexAttribute<TypeParam> normal = this->map2_.template add_attribute<TypeParam, Vertex>("normal");
+	VertexAttribute<TypeParam> csr_normal = this->map2_.template add_attribute<TypeParam, Vertex>("csr_normal");
+	cgogn::geometry::compute_normal(this->map2_, vertex_position, normal);
+	cgogn::geometry::compute_normal(this->map2_, incidence, vertex_position, csr_normal);
+
+	VertexAttribute<TypeParam> average = this->map2_.template add_attribute<TypeParam, Vertex>("average");
+	VertexAttribute<TypeParam> csr_average = this->map2_.template add_attribute<TypeParam, Vertex>("csr_average");
+	cgogn::geometry::filter_average(this->map2_, vertex_position, average);
+	cgogn::geometry::filter_average(this->map2_, incidence, vertex_position, csr_average);
+
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		for (uint32 i = 0; i < 3; ++i)
+		{
+			EXPECT_NEAR(normal[v][i], csr_normal[v][i], Scalar(1e-5));
+			EXPECT_NEAR(average[v][i], csr_average[v][i], Scalar(1e-5));
+		}
+	});
+
+	this->map2_.cut_edge(Edge(faces[0].dart));
+	EXPECT_FALSE(incidence.is_valid());
+}
+
+TYPED_TEST(Algos_TEST, ScatteredNormalAndArea)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, Vertex>("position");
+	for (uint32 n = 3; n < 8; ++n)
+		this->add_polygone(n);
+	std::vector<Face> faces;
+	this->map2_.foreach_cell([&] (Face f) { if (this->map2_.codegree(f) > 3) faces.push_back(f); });
+	for (Face f : faces)
+		this->map2_.cut_face(f.dart, this->map2_.phi1(this->map2_.phi1(f.dart)));
+	uint32 k = 0;
+	this->map2_.foreach_cell([&] (Vertex v) { vertex_position[v][2] = Scalar(0.1) * Scalar(k++ % 3); });
+
+	// the overloads without mask scatter the face quantities, the ones with a mask gather them
+	VertexAttribute<TypeParam> normal = this->map2_.template add_attribute<TypeParam, Vertex>("normal");
+	VertexAttribute<TypeParam> scattered_normal = this->map2_.template add_attribute<TypeParam, Vertex>("scattered_normal");
+	cgogn::geometry::compute_normal(this->map2_, cgogn::AllCellsFilter(), vertex_position, normal);
+	cgogn::geometry::compute_normal(this->map2_, vertex_position, scattered_normal);
+
+	VertexAttribute<Scalar> area = this->map2_.template add_attribute<Scalar, Vertex>("area");
+	VertexAttribute<Scalar> scattered_area = this->map2_.template add_attribute<Scalar, Vertex>("scattered_area");
+	cgogn::geometry::compute_incident_faces_area<Vertex>(this->map2_, cgogn::AllCellsFilter(), vertex_position, area);
+	cgogn::geometry::compute_incident_faces_area<Vertex>(this->map2_, vertex_position, scattered_area);
+
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		for (uint32 i = 0; i < 3; ++i)
+			EXPECT_NEAR(normal[v][i], scattered_normal[v][i], Scalar(1e-5));
+		EXPECT_NEAR(area[v], scattered_area[v], Scalar(1e-5));
+	});
+
+	CMap2::EdgeAttribute<Scalar> edge_area = this->map2_.template add_attribute<Scalar, Edge>("edge_area");
+	CMap2::EdgeAttribute<Scalar> scattered_edge_area = this->map2_.template add_attribute<Scalar, Edge>("scattered_edge_area");
+	cgogn::geometry::compute_incident_faces_area<Edge>(this->map2_, cgogn::AllCellsFilter(), vertex_position, edge_area);
+	cgogn::geometry::compute_incident_faces_area<Edge>(this->map2_, vertex_position, scattered_edge_area);
+	this->map2_.foreach_cell([&] (Edge e)
+	{
+		EXPECT_NEAR(edge_area[e], scattered_edge_area[e], Scalar(1e-5));
+	});
+}
@@ -0,0 +1,197 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <random>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/types/vec.h>
+#include <cgogn/geometry/algos/bvh.h>
+#include <cgogn/geometry/algos/picking.h>
+
+#include <cgogn/modeling/tiling/square_tore.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using StdArrayf = cgogn::geometry::Vec_T<std::array<float32,3>>;
+using StdArrayd = cgogn::geometry::Vec_T<std::array<float64,3>>;
+using EigenVec3f = Eigen::Vector3f;
+using EigenVec3d = Eigen::Vector3d;
+using VecTypes = testing::Types<StdArrayf, EigenVec3f, StdArrayd ,EigenVec3d>;
+
+using CMap2 = cgogn::CMap2;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+
+/**
+ * @brief The BVH_TEST class builds a tore of quads (triangulated by the BVH)
+ * and random rays going through the hole of the tore from the outside.
+ */
+template <typename Vec_T>
+class BVH_TEST : public testing::Test
+{
+protected:
+
+	using Scalar = typename cgogn::geometry::vector_traits<Vec_T>::Scalar;
+
+	CMap2 map2_;
+	VertexAttribute<Vec_T> position_;
+	std::vector<Vec_T> origins_;
+	std::vector<Vec_T> targets_;
+
+	BVH_TEST()
+	{
+		position_ = map2_.add_attribute<Vec_T, Vertex>("position");
+		cgogn::modeling::SquareTore<CMap2> tore(map2_, 30u, 20u);
+		tore.embed_into_tore(position_, 5.0f, 1.5f);
+
+		std::mt19937 gen(42u);
+		std::uniform_real_distribution<Scalar> d(Scalar(-1), Scalar(1));
+		for (uint32 i = 0u; i < 100u; ++i)
+		{
+			origins_.push_back(Vec_T(Scalar(12) * d(gen), Scalar(12) * d(gen), Scalar(12)));
+			targets_.push_back(Vec_T(Scalar(4) * d(gen), Scalar(4) * d(gen), Scalar(0.5) * d(gen)));
+		}
+	}
+
+	/// the distance from P to the smooth tore approximated by the mesh
+	Scalar tore_distance(const Vec_T& P) const
+	{
+		const Scalar rho = std::sqrt(P[0] * P[0] + P[1] * P[1]) - Scalar(5);
+		return std::abs(std::sqrt(rho * rho + P[2] * P[2]) - Scalar(1.5));
+	}
+
+	void expect_same_picking(const cgogn::geometry::BVH<Vec_T, CMap2>& bvh)
+	{
+		for (uint32 i = 0u; i < origins_.size(); ++i)
+		{
+			std::vector<Face> expected;
+			std::vector<Face> picked;
+			cgogn::geometry::picking(map2_, position_, origins_[i], targets_[i], expected);
+			cgogn::geometry::picking(bvh, origins_[i], targets_[i], picked);
+			ASSERT_EQ(picked.size(), expected.size());
+			for (uint32 j = 0u; j < picked.size(); ++j)
+				EXPECT_TRUE(picked[j].dart == expected[j].dart);
+		}
+	}
+};
+
+TYPED_TEST_CASE(BVH_TEST, VecTypes);
+
+TYPED_TEST(BVH_TEST, PickingMatchesBruteForce)
+{
+	cgogn::geometry::BVH<TypeParam, CMap2> bvh(this->map2_, this->position_);
+	bvh.build();
+	EXPECT_EQ(bvh.nb_triangles(), 2u * this->map2_.template nb_cells<Face::ORBIT>());
+	this->expect_same_picking(bvh);
+
+	std::vector<Vertex> vertices;
+	std::vector<Vertex> expected_vertices;
+	cgogn::geometry::picking(bvh, this->origins_[0], this->targets_[0], vertices);
+	cgogn::geometry::picking(this->map2_, this->position_, this->origins_[0], this->targets_[0], expected_vertices);
+	EXPECT_EQ(vertices.size(), expected_vertices.size());
+}
+
+TYPED_TEST(BVH_TEST, RefitAfterMovingVertices)
+{
+	cgogn::geometry::BVH<TypeParam, CMap2> bvh(this->map2_, this->position_);
+	bvh.build();
+	const uint32 nb_nodes = bvh.nb_nodes();
+
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		TypeParam& p = this->position_[v];
+		p[0] *= 1.5;
+		p[2] *= 2.0;
+	});
+	bvh.refit();
+
+	EXPECT_EQ(bvh.nb_nodes(), nb_nodes);
+	this->expect_same_picking(bvh);
+}
+
+TYPED_TEST(BVH_TEST, ClosestPoints)
+{
+	using Scalar = typename TestFixture::Scalar;
+	using Hit = typename cgogn::geometry::BVH<TypeParam, CMap2>::Hit;
+
+	cgogn::geometry::BVH<TypeParam, CMap2> bvh(this->map2_, this->position_);
+	bvh.build();
+
+	std::vector<Hit> hits;
+	bvh.closest_points(this->targets_, hits);
+	ASSERT_EQ(hits.size(), this->targets_.size());
+	for (uint32 i = 0u; i < hits.size(); ++i)
+	{
+		const TypeParam& P = this->targets_[i];
+		ASSERT_TRUE(hits[i].face.is_valid());
+		EXPECT_NEAR(hits[i].distance, Scalar((hits[i].point - P).norm()), 1e-4);
+		EXPECT_NEAR(hits[i].distance, this->tore_distance(P), 0.05);
+		this->map2_.foreach_cell([&] (Vertex v)
+		{
+			EXPECT_LE(hits[i].distance, Scalar((this->position_[v] - P).norm()) + Scalar(1e-4));
+		});
+	}
+}
+
+TYPED_TEST(BVH_TEST, BatchedRaysAndSegments)
+{
+	using Scalar = typename TestFixture::Scalar;
+	using Hit = typename cgogn::geometry::BVH<TypeParam, CMap2>::Hit;
+
+	cgogn::geometry::BVH<TypeParam, CMap2> bvh(this->map2_, this->position_);
+	bvh.build();
+
+	std::vector<TypeParam> directions;
+	for (uint32 i = 0u; i < this->origins_.size(); ++i)
+		directions.push_back(this->targets_[i] - this->origins_[i]);
+
+	std::vector<Hit> hits;
+	std::vector<Hit> segment_hits;
+	bvh.intersect(this->origins_, directions, hits);
+	bvh.intersect_segments(this->origins_, this->targets_, segment_hits);
+	ASSERT_EQ(hits.size(), this->origins_.size());
+	ASSERT_EQ(segment_hits.size(), this->origins_.size());
+
+	for (uint32 i = 0u; i < hits.size(); ++i)
+	{
+		std::vector<Face> picked;
+		cgogn::geometry::picking(this->map2_, this->position_, this->origins_[i], this->targets_[i], picked);
+		EXPECT_EQ(hits[i].face.is_valid(), !picked.empty());
+		if (picked.empty())
+			continue;
+		EXPECT_TRUE(hits[i].face.dart == picked.front().dart);
+
+		const Scalar length = Scalar(directions[i].norm());
+		EXPECT_EQ(segment_hits[i].face.is_valid(), hits[i].distance <= length);
+		if (segment_hits[i].face.is_valid())
+		{
+			EXPECT_TRUE(segment_hits[i].face.dart == hits[i].face.dart);
+		}
+	}
+}
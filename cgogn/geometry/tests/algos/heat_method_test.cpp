@@ -0,0 +1,158 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/csr_incidence.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/types/vec.h>
+#include <cgogn/geometry/algos/heat_method.h>
+
+#include <cgogn/modeling/tiling/triangular_grid.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using StdArrayf = cgogn::geometry::Vec_T<std::array<float32,3>>;
+using StdArrayd = cgogn::geometry::Vec_T<std::array<float64,3>>;
+using EigenVec3f = Eigen::Vector3f;
+using EigenVec3d = Eigen::Vector3d;
+using VecTypes = testing::Types<StdArrayf, EigenVec3f, StdArrayd ,EigenVec3d>;
+
+using CMap2 = cgogn::CMap2;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using Vertex = CMap2::Vertex;
+
+/**
+ * @brief The HeatMethod_TEST class builds a flat triangulated grid, on which the geodesic distances are
+ * the euclidean distances.
+ */
+template <typename Vec_T>
+class HeatMethod_TEST : public testing::Test
+{
+protected:
+
+	using Scalar = typename cgogn::geometry::vector_traits<Vec_T>::Scalar;
+
+	CMap2 map2_;
+	VertexAttribute<Vec_T> position_;
+	VertexAttribute<Scalar> distance_;
+	std::vector<Vertex> vertices_;
+
+	HeatMethod_TEST()
+	{
+		position_ = map2_.add_attribute<Vec_T, Vertex>("position");
+		distance_ = map2_.add_attribute<Scalar, Vertex>("distance");
+		cgogn::modeling::TriangularGrid<CMap2> grid(map2_, 40u, 40u);
+		grid.embed_into_grid(position_, 1.0f, 1.0f, 0.0f);
+		map2_.foreach_cell([&] (Vertex v) { vertices_.push_back(v); });
+	}
+
+	/// the mean relative error of the distances to the given source, far from the source
+	float64 mean_relative_error(Vertex source, const std::function<float64(Vertex)>& distance)
+	{
+		float64 error = 0.0;
+		uint32 count = 0u;
+		for (Vertex v : vertices_)
+		{
+			const float64 d = float64((position_[v] - position_[source]).norm());
+			if (d > 0.2)
+			{
+				error += std::abs(distance(v) - d) / d;
+				++count;
+			}
+		}
+		return error / float64(count);
+	}
+};
+
+TYPED_TEST_CASE(HeatMethod_TEST, VecTypes);
+
+TYPED_TEST(HeatMethod_TEST, DistanceToOneSource)
+{
+	cgogn::CSRIncidence<CMap2> incidence(this->map2_);
+	incidence.build();
+	cgogn::geometry::HeatMethod<TypeParam, CMap2> heat(this->map2_, incidence, this->position_);
+	EXPECT_TRUE(heat.update());
+
+	const Vertex source = this->vertices_[this->vertices_.size() / 2u];
+	heat.compute({source}, this->distance_);
+
+	EXPECT_NEAR(this->distance_[source], 0.0, 1e-6);
+	for (Vertex v : this->vertices_)
+		EXPECT_GE(this->distance_[v], -1e-6);
+	EXPECT_LT(this->mean_relative_error(source, [&] (Vertex v) { return float64(this->distance_[v]); }), 0.03);
+}
+
+TYPED_TEST(HeatMethod_TEST, BatchedSources)
+{
+	using Scalar = typename TestFixture::Scalar;
+
+	cgogn::CSRIncidence<CMap2> incidence(this->map2_);
+	incidence.build();
+	cgogn::geometry::HeatMethod<TypeParam, CMap2> heat(this->map2_, incidence, this->position_);
+
+	const std::vector<Vertex> sources = {
+		this->vertices_.front(),
+		this->vertices_[this->vertices_.size() / 3u],
+		this->vertices_.back()
+	};
+	std::vector<Scalar> distances;
+	heat.compute_batch(sources, distances);
+	ASSERT_EQ(distances.size(), 3u * incidence.nb_vertices());
+
+	// each field of the batch is the field of its source and the factorization is reused
+	for (uint32 k = 0u; k < 3u; ++k)
+	{
+		heat.compute({sources[k]}, this->distance_);
+		for (uint32 i = 0u; i < incidence.nb_vertices(); ++i)
+			EXPECT_NEAR(distances[3u * i + k], this->distance_[Vertex(incidence.vertices()[i])], 1e-4);
+	}
+}
+
+TYPED_TEST(HeatMethod_TEST, DegeneratedMesh)
+{
+	using Scalar = typename TestFixture::Scalar;
+
+	// all the faces are degenerated: the matrices are null and cannot be factorized
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		this->position_[v] = TypeParam(Scalar(0), Scalar(0), Scalar(0));
+		this->distance_[v] = Scalar(7);
+	});
+
+	cgogn::CSRIncidence<CMap2> incidence(this->map2_);
+	incidence.build();
+	cgogn::geometry::HeatMethod<TypeParam, CMap2> heat(this->map2_, incidence, this->position_);
+	EXPECT_FALSE(heat.update());
+
+	EXPECT_FALSE(heat.compute({this->vertices_.front()}, this->distance_));
+	for (Vertex v : this->vertices_)
+		EXPECT_EQ(this->distance_[v], Scalar(7));
+
+	std::vector<Scalar> distances(3u, Scalar(1));
+	EXPECT_FALSE(heat.compute_batch({this->vertices_.front(), this->vertices_.back()}, distances));
+	EXPECT_TRUE(distances.empty());
+}
@@ -0,0 +1,187 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <random>
+#include <algorithm>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/types/vec.h>
+#include <cgogn/geometry/algos/spatial_hash_grid.h>
+#include <cgogn/geometry/algos/normal.h>
+#include <cgogn/geometry/algos/angle.h>
+#include <cgogn/geometry/algos/curvature.h>
+#include <cgogn/geometry/algos/filtering.h>
+
+#include <cgogn/modeling/tiling/triangular_tore.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using StdArrayf = cgogn::geometry::Vec_T<std::array<float32,3>>;
+using StdArrayd = cgogn::geometry::Vec_T<std::array<float64,3>>;
+using EigenVec3f = Eigen::Vector3f;
+using EigenVec3d = Eigen::Vector3d;
+using VecTypes = testing::Types<StdArrayf, EigenVec3f, StdArrayd ,EigenVec3d>;
+
+using CMap2 = cgogn::CMap2;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+template <typename T>
+using EdgeAttribute = CMap2::EdgeAttribute<T>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+
+/**
+ * @brief The SpatialHashGrid_TEST class builds a triangulated tore.
+ */
+template <typename Vec_T>
+class SpatialHashGrid_TEST : public testing::Test
+{
+protected:
+
+	using Scalar = typename cgogn::geometry::vector_traits<Vec_T>::Scalar;
+
+	CMap2 map2_;
+	VertexAttribute<Vec_T> position_;
+
+	SpatialHashGrid_TEST()
+	{
+		position_ = map2_.add_attribute<Vec_T, Vertex>("position");
+		cgogn::modeling::TriangularTore<CMap2> tore(map2_, 60u, 30u);
+		tore.embed_into_tore(position_, 5.0f, 1.5f);
+	}
+
+	/// the sorted embeddings of the vertices
+	std::vector<uint32> embeddings(const std::vector<Vertex>& vertices) const
+	{
+		std::vector<uint32> result;
+		for (Vertex v : vertices)
+			result.push_back(map2_.embedding(v));
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+};
+
+TYPED_TEST_CASE(SpatialHashGrid_TEST, VecTypes);
+
+TYPED_TEST(SpatialHashGrid_TEST, VerticesWithinMatchesBruteForce)
+{
+	using Scalar = typename TestFixture::Scalar;
+
+	cgogn::geometry::SpatialHashGrid<TypeParam, CMap2> grid(this->map2_, this->position_, Scalar(0.5));
+	grid.build();
+	EXPECT_EQ(grid.nb_vertices(), this->map2_.template nb_cells<Vertex::ORBIT>());
+
+	std::mt19937 gen(42u);
+	std::uniform_real_distribution<Scalar> d(Scalar(-7), Scalar(7));
+	std::vector<TypeParam> centers;
+	for (uint32 i = 0u; i < 200u; ++i)
+		centers.push_back(TypeParam(d(gen), d(gen), d(gen) / Scalar(4)));
+
+	std::vector<uint32> offsets;
+	std::vector<Vertex> batch;
+	grid.vertices_within(centers, Scalar(0.8), offsets, batch);
+	ASSERT_EQ(offsets.size(), centers.size() + 1u);
+	ASSERT_EQ(offsets.back(), batch.size());
+
+	for (uint32 i = 0u; i < centers.size(); ++i)
+	{
+		std::vector<Vertex> expected;
+		this->map2_.foreach_cell([&] (Vertex v)
+		{
+			if (cgogn::geometry::in_sphere(this->position_[v], centers[i], Scalar(0.8)))
+				expected.push_back(v);
+		});
+
+		std::vector<Vertex> found;
+		grid.vertices_within(centers[i], Scalar(0.8), found);
+		EXPECT_EQ(this->embeddings(found), this->embeddings(expected));
+		EXPECT_EQ(this->embeddings(std::vector<Vertex>(batch.begin() + offsets[i], batch.begin() + offsets[i + 1u])), this->embeddings(expected));
+	}
+}
+
+TYPED_TEST(SpatialHashGrid_TEST, CurvatureMatchesCollector)
+{
+	using Scalar = typename TestFixture::Scalar;
+
+	VertexAttribute<TypeParam> normal = this->map2_.template add_attribute<TypeParam, Vertex>("normal");
+	EdgeAttribute<Scalar> edge_angle = this->map2_.template add_attribute<Scalar, Edge>("edge_angle");
+	EdgeAttribute<Scalar> edge_area = this->map2_.template add_attribute<Scalar, Edge>("edge_area");
+	cgogn::geometry::compute_normal(this->map2_, this->position_, normal);
+	cgogn::geometry::compute_angle_between_face_normals(this->map2_, this->position_, edge_angle);
+
+	VertexAttribute<Scalar> kmax = this->map2_.template add_attribute<Scalar, Vertex>("kmax");
+	VertexAttribute<Scalar> kmin = this->map2_.template add_attribute<Scalar, Vertex>("kmin");
+	VertexAttribute<TypeParam> Kmax = this->map2_.template add_attribute<TypeParam, Vertex>("Kmax");
+	VertexAttribute<TypeParam> Kmin = this->map2_.template add_attribute<TypeParam, Vertex>("Kmin");
+	VertexAttribute<TypeParam> Knormal = this->map2_.template add_attribute<TypeParam, Vertex>("Knormal");
+	cgogn::geometry::compute_curvature(this->map2_, Scalar(0.6), this->position_, normal, edge_angle, edge_area, kmax, kmin, Kmax, Kmin, Knormal);
+
+	VertexAttribute<Scalar> grid_kmax = this->map2_.template add_attribute<Scalar, Vertex>("grid_kmax");
+	VertexAttribute<Scalar> grid_kmin = this->map2_.template add_attribute<Scalar, Vertex>("grid_kmin");
+	VertexAttribute<TypeParam> grid_Kmax = this->map2_.template add_attribute<TypeParam, Vertex>("grid_Kmax");
+	VertexAttribute<TypeParam> grid_Kmin = this->map2_.template add_attribute<TypeParam, Vertex>("grid_Kmin");
+	VertexAttribute<TypeParam> grid_Knormal = this->map2_.template add_attribute<TypeParam, Vertex>("grid_Knormal");
+	cgogn::geometry::SpatialHashGrid<TypeParam, CMap2> grid(this->map2_, this->position_, Scalar(0.6));
+	grid.build();
+	cgogn::geometry::compute_curvature(this->map2_, grid, Scalar(0.6), this->position_, normal, edge_angle, edge_area, grid_kmax, grid_kmin, grid_Kmax, grid_Kmin, grid_Knormal);
+
+	// the neighborhoods are the same on the tore, only the order of the sums changes
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_NEAR(grid_kmax[v], kmax[v], 1e-3 * std::abs(kmax[v]) + 1e-4);
+		EXPECT_NEAR(grid_kmin[v], kmin[v], 1e-3 * std::abs(kmin[v]) + 1e-4);
+		EXPECT_NEAR(std::abs(grid_Knormal[v].dot(Knormal[v])), 1.0, 1e-3);
+	});
+}
+
+TYPED_TEST(SpatialHashGrid_TEST, BilateralFilter)
+{
+	using Scalar = typename TestFixture::Scalar;
+
+	VertexAttribute<TypeParam> normal = this->map2_.template add_attribute<TypeParam, Vertex>("normal");
+	VertexAttribute<TypeParam> filtered = this->map2_.template add_attribute<TypeParam, Vertex>("filtered");
+	cgogn::geometry::compute_normal(this->map2_, this->position_, normal);
+
+	cgogn::geometry::SpatialHashGrid<TypeParam, CMap2> grid(this->map2_, this->position_, Scalar(0.5));
+	grid.build();
+
+	// without neighbors the vertices do not move
+	cgogn::geometry::filter_bilateral(this->map2_, grid, Scalar(1e-3), this->position_, filtered, normal);
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_NEAR((filtered[v] - this->position_[v]).norm(), 0.0, 1e-6);
+	});
+
+	// the vertices move along their normal, toward the inside of the convex parts of the tore
+	cgogn::geometry::filter_bilateral(this->map2_, grid, Scalar(0.5), this->position_, filtered, normal);
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		const TypeParam move = filtered[v] - this->position_[v];
+		EXPECT_NEAR((move - normal[v] * move.dot(normal[v])).norm(), 0.0, 1e-5);
+		EXPECT_LT(move.norm(), 0.1);
+	});
+}
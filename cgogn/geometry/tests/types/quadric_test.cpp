@@ -0,0 +1,109 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/geometry/types/quadric.h>
+#include <cgogn/geometry/types/geometry_traits.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using StdArrayf = cgogn::geometry::Vec_T<std::array<float32,3>>;
+using StdArrayd = cgogn::geometry::Vec_T<std::array<float64,3>>;
+using EigenVec3f = Eigen::Vector3f;
+using EigenVec3d = Eigen::Vector3d;
+using VecTypes = testing::Types<StdArrayf, EigenVec3f, StdArrayd ,EigenVec3d>;
+
+using Quadric = cgogn::geometry::Quadric;
+
+template <typename Vec_T>
+class Quadric_TEST : public testing::Test {};
+
+TYPED_TEST_CASE(Quadric_TEST, VecTypes );
+
+TEST(Quadric_TEST, NameOfType)
+{
+	EXPECT_EQ(cgogn::name_of_type(Quadric()), "cgogn::geometry::Quadric_T<float64>");
+	EXPECT_EQ(sizeof(Quadric), 10u * sizeof(float64));
+	EXPECT_EQ(sizeof(cgogn::geometry::Quadric_T<float32>), 10u * sizeof(float32));
+}
+
+TYPED_TEST(Quadric_TEST, Evaluate)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+
+	Quadric q(TypeParam{Scalar(1), Scalar(0), Scalar(0)}, TypeParam{Scalar(0), Scalar(1), Scalar(0)}, TypeParam{Scalar(0), Scalar(0), Scalar(1)});
+	q += Quadric(TypeParam{Scalar(0), Scalar(0), Scalar(0)}, TypeParam{Scalar(1), Scalar(0), Scalar(0)}, TypeParam{Scalar(0), Scalar(2), Scalar(0)});
+
+	// same values as the dense matrix
+	const Eigen::Matrix4d m = q.matrix();
+	EXPECT_EQ(m, m.transpose());
+	for (const TypeParam& p : { TypeParam{Scalar(0), Scalar(0), Scalar(0)}, TypeParam{Scalar(1), Scalar(2), Scalar(3)}, TypeParam{Scalar(-2), Scalar(0.5), Scalar(1)} })
+	{
+		const Eigen::Vector4d h = Eigen::Vector4d(float64(p[0]), float64(p[1]), float64(p[2]), 1.0);
+		EXPECT_NEAR(q(p), Scalar(h.dot(m * h)), Scalar(1e-5));
+		EXPECT_NEAR(q(h), h.dot(m * h), 1e-12);
+	}
+	// (1,1,1) is at a distance 2/sqrt(3) of the plane x + y + z = 1 and 1 of the plane z = 0
+	EXPECT_NEAR(q(TypeParam{Scalar(1), Scalar(1), Scalar(1)}), Scalar(4.0 / 3.0 + 1.0), Scalar(1e-5));
+}
+
+TYPED_TEST(Quadric_TEST, Optimized)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+
+	// three planes x = 1, y = 2, z = 3 meet at (1,2,3)
+	Quadric q(TypeParam{Scalar(1), Scalar(0), Scalar(0)}, TypeParam{Scalar(1), Scalar(1), Scalar(0)}, TypeParam{Scalar(1), Scalar(0), Scalar(1)});
+	q += Quadric(TypeParam{Scalar(0), Scalar(2), Scalar(0)}, TypeParam{Scalar(0), Scalar(2), Scalar(1)}, TypeParam{Scalar(1), Scalar(2), Scalar(0)});
+	TypeParam p{Scalar(0), Scalar(0), Scalar(0)};
+	EXPECT_FALSE(q.optimized(p));
+	q += Quadric(TypeParam{Scalar(0), Scalar(0), Scalar(3)}, TypeParam{Scalar(1), Scalar(0), Scalar(3)}, TypeParam{Scalar(0), Scalar(1), Scalar(3)});
+	EXPECT_TRUE(q.optimized(p));
+	EXPECT_NEAR(p[0], Scalar(1), Scalar(1e-5));
+	EXPECT_NEAR(p[1], Scalar(2), Scalar(1e-5));
+	EXPECT_NEAR(p[2], Scalar(3), Scalar(1e-5));
+	EXPECT_NEAR(q(p), Scalar(0), Scalar(1e-5));
+
+	Eigen::Vector4d h;
+	EXPECT_TRUE(q.optimized(h));
+	EXPECT_TRUE(h.isApprox(Eigen::Vector4d(1.0, 2.0, 3.0, 1.0)));
+}
+
+TYPED_TEST(Quadric_TEST, BatchEvaluate)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+
+	std::vector<Quadric> quadrics;
+	std::vector<TypeParam> points;
+	for (uint32 i = 0u; i < 2u * Quadric::BATCH_SIZE + 3u; ++i)
+	{
+		const Scalar s(i);
+		quadrics.push_back(Quadric(TypeParam{s, Scalar(0), Scalar(1)}, TypeParam{Scalar(1), s, Scalar(0)}, TypeParam{Scalar(0), Scalar(1), s + Scalar(1)}));
+		points.push_back(TypeParam{Scalar(0.5) * s, Scalar(1), -s});
+	}
+	std::vector<Scalar> values(quadrics.size());
+	Quadric::evaluate(quadrics.size(), quadrics.data(), points.data(), values.data());
+	for (std::size_t i = 0u; i < quadrics.size(); ++i)
+		EXPECT_NEAR(values[i], quadrics[i](points[i]), std::abs(values[i]) * Scalar(1e-6));
+}
@@ -24,7 +24,9 @@
 #ifndef CGOGN_GEOMETRY_TYPES_EIGEN_H_
 #define CGOGN_GEOMETRY_TYPES_EIGEN_H_
 
+#include <type_traits>
 #include <cgogn/core/utils/definitions.h>
+#include <cgogn/core/utils/serialization.h>
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 #include <unsupported/Eigen/AlignedVector3>
@@ -37,6 +39,17 @@ namespace geometry
 
 } // namespace geometry
 
+namespace serialization
+{
+
+// fixed size matrices are plain arrays of coefficients and can be used as is from a mapped file
+template <typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct is_raw_data<Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols>> : public std::integral_constant<bool,
+	Rows != Eigen::Dynamic && Cols != Eigen::Dynamic && std::is_trivially_copyable<Scalar>::value>
+{};
+
+} // namespace serialization
+
 } // namespace cgogn
 
 #endif // CGOGN_GEOMETRY_TYPES_EIGEN_H_
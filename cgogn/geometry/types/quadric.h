@@ -24,7 +24,13 @@
 #ifndef CGOGN_GEOMETRY_TYPES_QUADRIC_H_
 #define CGOGN_GEOMETRY_TYPES_QUADRIC_H_
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
 #include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/name_types.h>
 
 #include <cgogn/geometry/dll.h>
 #include <cgogn/geometry/types/geometry_traits.h>
@@ -36,153 +42,197 @@ namespace cgogn
 namespace geometry
 {
 
-class Quadric
+/**
+ * @brief The Quadric_T class is the symmetric 4x4 matrix Q of a quadric error q(p) = (p,1)^T Q (p,1).
+ * Only the 10 coefficients of the upper triangle are stored (row by row),
+ * the operations are written on the packed coefficients to be vectorized by the compiler
+ * and the optimal position is given by the closed-form solution of a 3x3 system.
+ */
+template <typename SCALAR>
+class Quadric_T
 {
-public:
+	static_assert(std::is_floating_point<SCALAR>::value, "The coefficients of a quadric must be floating point numbers");
 
-	using Self = Quadric;
+public:
 
-//	using Vec3f = Eigen::Vector3f;
-	using Vec3d = Eigen::Vector3d;
-//	using Vec4f = Eigen::Vector4f;
-	using Vec4d = Eigen::Vector4d;
+	using Self = Quadric_T<SCALAR>;
+	using Scalar = SCALAR;
 
-	using Matrix4d = Eigen::Matrix4d;
+	static const uint32 SIZE = 10u;
 
-	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	/// number of quadrics evaluated together by evaluate
+	static const uint32 BATCH_SIZE = 8u;
 
-	inline Quadric()
+	inline Quadric_T()
 	{
-		matrix_.setZero();
+		zero();
 	}
 
+	/**
+	 * @brief quadric of the squared distance to the plane of the triangle (p1, p2, p3)
+	 */
 	template <typename VEC3>
-	inline Quadric(const VEC3& p1, const VEC3& p2, const VEC3& p3)
+	inline Quadric_T(const VEC3& p1, const VEC3& p2, const VEC3& p3)
 	{
 		Plane3D plane(p1, p2, p3);
-		const Vec3d& n = plane.normal();
-		Vec4d p = Vec4d(n[0], n[1], n[2], plane.d());
-		matrix_ = p * p.transpose();
+		const Eigen::Vector3d& n = plane.normal();
+		const std::array<Scalar, 4> p = {{ Scalar(n[0]), Scalar(n[1]), Scalar(n[2]), Scalar(plane.d()) }};
+		uint32 k = 0u;
+		for (uint32 i = 0u; i < 4u; ++i)
+			for (uint32 j = i; j < 4u; ++j)
+				coefficients_[k++] = p[i] * p[j];
 	}
 
-	Quadric(const Self& q)
-	{
-		matrix_ = q.matrix_;
-	}
+	Quadric_T(const Self& q) = default;
+	Self& operator=(const Self& q) = default;
 
 	inline void zero()
 	{
-		matrix_.setZero();
+		coefficients_.fill(Scalar(0));
 	}
 
-	Self& operator=(const Self& q)
+	inline Self& operator+=(const Self& q)
 	{
-		matrix_ = q.matrix_;
+		for (uint32 i = 0u; i < SIZE; ++i)
+			coefficients_[i] += q.coefficients_[i];
 		return *this;
 	}
 
-	Quadric& operator+=(const Self& q)
+	inline Self operator+(const Self& q) const
 	{
-		matrix_ += q.matrix_;
-		return *this;
+		Self res(*this);
+		res += q;
+		return res;
 	}
 
-	template <typename VEC3>
-	auto operator()(const VEC3& v)
-		-> typename std::enable_if<is_dim_of<VEC3, 3>::value && std::is_same<ScalarOf<VEC3>, double>::value, double>::type
-	{
-		return (*this)(Vec4d(v[0], v[1], v[2], 1.));
-	}
+	/**
+	 * @return the coefficients of the upper triangle of the matrix, row by row
+	 */
+	inline const std::array<Scalar, SIZE>& coefficients() const { return coefficients_; }
 
-	template <typename VEC3>
-	auto operator()(const VEC3& v)
-		-> typename std::enable_if<is_dim_of<VEC3, 3>::value && !std::is_same<ScalarOf<VEC3>, double>::value, ScalarOf<VEC3>>::type
+	/**
+	 * @return the coefficient (i,j) of the matrix
+	 */
+	inline Scalar operator()(uint32 i, uint32 j) const
 	{
-		using Scalar = ScalarOf<VEC3>;
-
-		return Scalar((*this)(Vec4d(double(v[0]), double(v[1]), double(v[2]), 1.)));
+		if (i > j)
+			std::swap(i, j);
+		// the rows 0, 1, 2, 3 of the upper triangle start at 0, 4, 7, 9
+		return coefficients_[i * (7u - i) / 2u + j];
 	}
 
-	inline double operator()(const Vec4d& v)
+	template <typename VEC3>
+	inline auto operator()(const VEC3& v) const
+		-> typename std::enable_if<is_dim_of<VEC3, 3>::value, ScalarOf<VEC3>>::type
 	{
-		return v.transpose() * matrix_ * v;
+		return ScalarOf<VEC3>(value(Scalar(v[0]), Scalar(v[1]), Scalar(v[2])));
 	}
 
+	/**
+	 * @brief evaluate the quadric at the homogeneous point v
+	 */
 	template <typename VEC4>
-	auto operator()(const VEC4& v)
-		-> typename std::enable_if<is_dim_of<VEC4, 4>::value && !std::is_same<VEC4, Vec4d>::value, typename vector_traits<VEC4>::Scalar>::type
+	inline auto operator()(const VEC4& v) const
+		-> typename std::enable_if<is_dim_of<VEC4, 4>::value, typename vector_traits<VEC4>::Scalar>::type
 	{
-		using Scalar = typename vector_traits<VEC4>::Scalar;
+		using VScalar = typename vector_traits<VEC4>::Scalar;
 
-		Vec4d vd;
-		vd[0] = double(v[0]);
-		vd[1] = double(v[1]);
-		vd[2] = double(v[2]);
-		vd[3] = double(v[3]);
-		double res = vd.transpose() * matrix_ * vd;
-		return Scalar(res);
+		const std::array<Scalar, 4> p = {{ Scalar(v[0]), Scalar(v[1]), Scalar(v[2]), Scalar(v[3]) }};
+		Scalar res(0);
+		uint32 k = 0u;
+		for (uint32 i = 0u; i < 4u; ++i)
+		{
+			res += coefficients_[k++] * p[i] * p[i];
+			for (uint32 j = i + 1u; j < 4u; ++j)
+				res += Scalar(2) * coefficients_[k++] * p[i] * p[j];
+		}
+		return VScalar(res);
 	}
 
+	/**
+	 * @brief compute the position that minimizes the quadric by solving the 3x3 linear system of its gradient
+	 * @return false (v unchanged) if the system is singular
+	 */
 	template <typename VEC3>
-	auto optimized(VEC3& v)
+	inline auto optimized(VEC3& v) const
 		-> typename std::enable_if<is_dim_of<VEC3, 3>::value, bool>::type
 	{
-		using Scalar = ScalarOf<VEC3>;
-
-		Vec4d hv;
-		bool b = optimized(hv);
-		if (b)
-		{
-			v[0] = Scalar(hv[0]);
-			v[1] = Scalar(hv[1]);
-			v[2] = Scalar(hv[2]);
-		}
-		return b;
+		using VScalar = ScalarOf<VEC3>;
+
+		std::array<Scalar, 3> p;
+		if (!solve(p))
+			return false;
+		v[0] = VScalar(p[0]);
+		v[1] = VScalar(p[1]);
+		v[2] = VScalar(p[2]);
+		return true;
 	}
 
+	/**
+	 * @brief compute the homogeneous position (w = 1) that minimizes the quadric
+	 * @return false (v unchanged) if the system is singular
+	 */
 	template <typename VEC4>
-	auto optimized(VEC4& v)
-		-> typename std::enable_if<is_dim_of<VEC4, 4>::value && std::is_same<VEC4, Vec4d>::value, bool>::type
+	inline auto optimized(VEC4& v) const
+		-> typename std::enable_if<is_dim_of<VEC4, 4>::value, bool>::type
 	{
-		Matrix4d m(matrix_);
-		for (uint32 i = 0; i < 3; ++i) m(3,i) = 0.;
-		m(3,3) = 1.;
-		Matrix4d inverse;
-		double determinant;
-		bool invertible;
-		m.computeInverseAndDetWithCheck(inverse, determinant, invertible);
-		if (invertible)
-			v = inverse * Vec4d(0.,0.,0.,1.);
-		return invertible;
+		using VScalar = typename vector_traits<VEC4>::Scalar;
+
+		std::array<Scalar, 3> p;
+		if (!solve(p))
+			return false;
+		v[0] = VScalar(p[0]);
+		v[1] = VScalar(p[1]);
+		v[2] = VScalar(p[2]);
+		v[3] = VScalar(1);
+		return true;
 	}
 
-	template <typename VEC4>
-	auto optimized(VEC4& v)
-		-> typename std::enable_if<(vector_traits<VEC4>::SIZE ==4) && !std::is_same<VEC4, Vec4d>::value, bool>::type
-	{
-		using Scalar = typename vector_traits<VEC4>::Scalar;
-
-		Matrix4d m(matrix_);
-		for (uint32 i = 0; i < 3; ++i) m(3,i) = 0.;
-		m(3,3) = 1.;
-		Matrix4d inverse;
-		double determinant;
-		bool invertible;
-		m.computeInverseAndDetWithCheck(inverse, determinant, invertible);
-		if (invertible)
+	/**
+	 * @brief evaluate n quadrics at n points: values[i] = quadrics[i](points[i])
+	 * The quadrics are evaluated by batches of BATCH_SIZE whose coefficients are transposed,
+	 * so that the evaluations of a batch are vectorized.
+	 */
+	template <typename VEC3, typename T>
+	static void evaluate(std::size_t n, const Self* quadrics, const VEC3* points, T* values)
+	{
+		std::array<std::array<Scalar, BATCH_SIZE>, SIZE> c;
+		std::array<std::array<Scalar, BATCH_SIZE>, 3> p;
+		std::array<Scalar, BATCH_SIZE> res;
+		for (std::size_t first = 0u; first < n; first += BATCH_SIZE)
 		{
-			Vec4d vd = inverse * Vec4d(0.,0.,0.,1.);
-			v[0] = Scalar(vd[0]);
-			v[1] = Scalar(vd[1]);
-			v[2] = Scalar(vd[2]);
-			v[3] = Scalar(vd[3]);
+			const uint32 size = uint32(std::min(std::size_t(BATCH_SIZE), n - first));
+			for (uint32 b = 0u; b < BATCH_SIZE; ++b)
+			{
+				// the last batch is completed with its first element
+				const std::size_t i = first + (b < size ? b : 0u);
+				for (uint32 k = 0u; k < SIZE; ++k)
+					c[k][b] = quadrics[i].coefficients_[k];
+				for (uint32 k = 0u; k < 3u; ++k)
+					p[k][b] = Scalar(points[i][k]);
+			}
+			for (uint32 b = 0u; b < BATCH_SIZE; ++b)
+				res[b] = batch_value(c, p, b);
+			for (uint32 b = 0u; b < size; ++b)
+				values[first + b] = T(res[b]);
 		}
-		return invertible;
+	}
+
+	/**
+	 * @return the dense 4x4 matrix of the quadric
+	 */
+	inline Eigen::Matrix<Scalar, 4, 4> matrix() const
+	{
+		Eigen::Matrix<Scalar, 4, 4> m;
+		for (uint32 i = 0u; i < 4u; ++i)
+			for (uint32 j = 0u; j < 4u; ++j)
+				m(i, j) = (*this)(i, j);
+		return m;
 	}
 
 	static std::string cgogn_name_of_type()
 	{
-		return std::string("cgogn::geometry::Quadric");
+		return std::string("cgogn::geometry::Quadric_T<") + name_of_type(Scalar()) + std::string(">");
 	}
 
 	inline friend std::ostream& operator<<(std::ostream& out, const Self&)
@@ -197,9 +247,65 @@ public:
 
 private:
 
-	Matrix4d matrix_;
+	// q(x,y,z) = x (c0 x + 2 (c1 y + c2 z + c3)) + y (c4 y + 2 (c5 z + c6)) + z (c7 z + 2 c8) + c9
+	inline Scalar value(Scalar x, Scalar y, Scalar z) const
+	{
+		const std::array<Scalar, SIZE>& c = coefficients_;
+		return
+			x * (c[0] * x + Scalar(2) * (c[1] * y + c[2] * z + c[3])) +
+			y * (c[4] * y + Scalar(2) * (c[5] * z + c[6])) +
+			z * (c[7] * z + Scalar(2) * c[8]) +
+			c[9];
+	}
+
+	static inline Scalar batch_value(
+		const std::array<std::array<Scalar, BATCH_SIZE>, SIZE>& c,
+		const std::array<std::array<Scalar, BATCH_SIZE>, 3>& p,
+		uint32 b
+	)
+	{
+		const Scalar x = p[0][b], y = p[1][b], z = p[2][b];
+		return
+			x * (c[0][b] * x + Scalar(2) * (c[1][b] * y + c[2][b] * z + c[3][b])) +
+			y * (c[4][b] * y + Scalar(2) * (c[5][b] * z + c[6][b])) +
+			z * (c[7][b] * z + Scalar(2) * c[8][b]) +
+			c[9][b];
+	}
+
+	// solve A p = -b with A the upper left 3x3 block and b the 3 first coefficients of the last column,
+	// with the cofactors of the symmetric matrix A
+	inline bool solve(std::array<Scalar, 3>& p) const
+	{
+		const std::array<Scalar, SIZE>& c = coefficients_;
+		const Scalar a00 = c[4] * c[7] - c[5] * c[5];
+		const Scalar a01 = c[2] * c[5] - c[1] * c[7];
+		const Scalar a02 = c[1] * c[5] - c[2] * c[4];
+		const Scalar a11 = c[0] * c[7] - c[2] * c[2];
+		const Scalar a12 = c[1] * c[2] - c[0] * c[5];
+		const Scalar a22 = c[0] * c[4] - c[1] * c[1];
+		const Scalar det = c[0] * a00 + c[1] * a01 + c[2] * a02;
+		// same invertibility threshold as the Eigen inverse of the 4x4 matrix previously used
+		if (!(std::abs(det) > Eigen::NumTraits<Scalar>::dummy_precision()))
+			return false;
+		const Scalar inv_det = Scalar(-1) / det;
+		p[0] = (a00 * c[3] + a01 * c[6] + a02 * c[8]) * inv_det;
+		p[1] = (a01 * c[3] + a11 * c[6] + a12 * c[8]) * inv_det;
+		p[2] = (a02 * c[3] + a12 * c[6] + a22 * c[8]) * inv_det;
+		return true;
+	}
+
+	std::array<Scalar, SIZE> coefficients_;
 };
 
+template <typename SCALAR>
+const uint32 Quadric_T<SCALAR>::SIZE;
+
+template <typename SCALAR>
+const uint32 Quadric_T<SCALAR>::BATCH_SIZE;
+
+/// quadric used by the decimation
+using Quadric = Quadric_T<float64>;
+
 } // namespace geometry
 
 } // namespace cgogn
@@ -0,0 +1,117 @@
+
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+
+#include <cgogn/core/cmap/cmap3.h>
+#include <cgogn/geometry/types/vec.h>
+#include <cgogn/io/volume_import.h>
+
+using namespace cgogn::numerics;
+
+using Map3 = cgogn::CMap3;
+using Vec3 = cgogn::geometry::Vec_T<std::array<float64, 3>>;
+
+/**
+ * @brief generates grids of n^3 cubes filled with hexahedra, tetrahedra (6 per cube)
+ * or both (hexahedra in the first half of the grid, connected to the tetrahedra by stamp volumes),
+ * and times the creation of the map from the generated volumes.
+ */
+class GridImport : public cgogn::io::VolumeImport<Map3>
+{
+public:
+
+	enum GridType
+	{
+		HEXA = 0,
+		TETRA,
+		MIXED
+	};
+
+	GridImport(Map3& map) : cgogn::io::VolumeImport<Map3>(map)
+	{}
+
+	void generate(uint32 n, GridType type, bool shuffle)
+	{
+		const uint32 m = n + 1u;
+		const auto id = [m] (uint32 i, uint32 j, uint32 k) { return (k * m + j) * m + i; };
+
+		cgogn::io::VolumeImport<Map3>::ChunkArray<Vec3>* position = this->template add_vertex_attribute<Vec3>("position");
+		for (uint32 k = 0u; k < m; ++k)
+			for (uint32 j = 0u; j < m; ++j)
+				for (uint32 i = 0u; i < m; ++i)
+					(*position)[this->insert_line_vertex_container()] = Vec3(float64(i), float64(j), float64(k));
+
+		std::vector<uint32> cubes(n * n * n);
+		for (uint32 c = 0u; c < cubes.size(); ++c)
+			cubes[c] = c;
+		if (shuffle)
+			std::shuffle(cubes.begin(), cubes.end(), std::mt19937(42u));
+
+		this->reserve(6u * uint32(cubes.size()));
+		for (uint32 c : cubes)
+		{
+			const uint32 i = c % n;
+			const uint32 j = (c / n) % n;
+			const uint32 k = c / (n * n);
+			std::array<uint32, 8> p = {{
+				id(i, j, k), id(i+1u, j, k), id(i+1u, j+1u, k), id(i, j+1u, k),
+				id(i, j, k+1u), id(i+1u, j, k+1u), id(i+1u, j+1u, k+1u), id(i, j+1u, k+1u)
+			}};
+
+			if (type == HEXA || (type == MIXED && i < n / 2u))
+			{
+				this->template reorient_hexa<Vec3>(*position, p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+				this->add_hexa(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+			}
+			else
+			{
+				// Kuhn subdivision of the cube along its diagonal (p0, p6)
+				static const std::array<std::array<uint32, 2>, 6> paths = {{
+					{{1u, 2u}}, {{1u, 5u}}, {{3u, 2u}}, {{3u, 7u}}, {{4u, 5u}}, {{4u, 7u}}
+				}};
+				for (const auto& path : paths)
+				{
+					uint32 p0 = p[0], p1 = p[path[0]], p2 = p[path[1]], p3 = p[6];
+					this->template reorient_tetra<Vec3>(*position, p0, p1, p2, p3);
+					this->add_tetra(p0, p1, p2, p3);
+				}
+			}
+		}
+	}
+};
+
+int main(int argc, char** argv)
+{
+	uint32 n = 50u;
+	if (argc < 2)
+		cgogn_log_info("bench_volume_import") << "USAGE: " << argv[0] << " [grid size] [shuffle]. Using grid size " << n << ".";
+	else
+		n = uint32(std::atoi(argv[1]));
+	const bool shuffle = argc > 2;
+
+	const std::array<std::string, 3> names = {{ "hexa", "tetra", "mixed" }};
+	for (uint32 t = GridImport::HEXA; t <= GridImport::MIXED; ++t)
+	{
+		Map3 map;
+		GridImport import(map);
+		import.generate(n, GridImport::GridType(t), shuffle);
+
+		std::chrono::time_point<std::chrono::system_clock> start, end;
+		start = std::chrono::system_clock::now();
+
+		import.create_map();
+
+		end = std::chrono::system_clock::now();
+		std::chrono::duration<float64> elapsed_seconds = end - start;
+
+		cgogn_log_info("bench_volume_import") << names[t] << " grid: "
+			<< map.nb_cells<Map3::Volume::ORBIT>() << " volumes, "
+			<< map.nb_cells<Map3::Face::ORBIT>() << " faces, "
+			<< map.nb_cells<Map3::Vertex::ORBIT>() << " vertices created in "
+			<< elapsed_seconds.count() << "s";
+	}
+
+	return 0;
+}
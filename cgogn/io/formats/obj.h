@@ -37,7 +37,10 @@
 #include <cgogn/io/graph_import.h>
 #include <cgogn/io/graph_export.h>
 
+#include <cgogn/io/text_reader.h>
+
 #include <iomanip>
+#include <algorithm>
 
 namespace cgogn
 {
@@ -207,175 +210,153 @@ protected:
 
 	virtual bool import_file_impl(const std::string& filename) override
 	{
-		std::ifstream fp(filename.c_str(), std::ios::in);
-
-		ChunkArray<VEC3>* position = this->template add_vertex_attribute<VEC3>("position");
-		ChunkArray<VEC3>* normal = nullptr;
-		std::vector<VEC3> norm_buff;
-
-		std::string line, tag;
-		bool has_normals = false;
-
-		do
-		{
-			fp >> tag;
-			getline_safe(fp, line);
-		} while (tag != std::string("vn") && (!fp.eof()));
-
-		if (tag == "vn")
+		TextReader reader;
+		if (!reader.open(filename))
 		{
-			has_normals = true;
-			norm_buff.reserve(1024);
-			do
-			{
-				if (tag == std::string("vn"))
-				{
-					std::stringstream oss(line);
-
-					float64 x, y, z;
-					oss >> x;
-					oss >> y;
-					oss >> z;
-					float64 n = std::sqrt(x*x+y*y+z*z);
-					norm_buff.emplace_back(Scalar(x/n), Scalar(y/n), Scalar(z/n));
-				}
-
-				fp >> tag;
-				getline_safe(fp, line);
-			} while (!fp.eof());
+			cgogn_log_error("ObjSurfaceImport::import_file_impl") << "Unable to read the file \"" << filename << "\".";
+			return false;
 		}
 
-		fp.clear();
-		fp.seekg(0, std::ios::beg);
-
-		do
-		{
-			fp >> tag;
-			getline_safe(fp, line);
-		} while (tag != std::string("v"));
-
-		// lecture des sommets
-		std::vector<uint32> vertices_id;
-		vertices_id.reserve(102400);
-		uint32 max_id = 0;
+		const std::vector<const char*> chunks = TextReader::split_lines(reader.begin(), reader.end());
+		const uint32 nb_chunks = uint32(chunks.size()) - 1u;
 
-		uint32 i = 0;
-		do
+		// count the vertices and normals of each chunk to know the index of the first ones
+		std::vector<uint32> first_vertex(nb_chunks + 1u, 0u);
+		std::vector<uint32> first_normal(nb_chunks + 1u, 0u);
+		TextReader::parallel_foreach_chunk(chunks, [&] (uint32 c, const char* first, const char* last)
 		{
-			if (tag == std::string("v"))
+			for (const char* l = first; l != last; l = next_line(l, last))
 			{
-				std::stringstream oss(line);
-
-				float64 x, y, z;
-				oss >> x;
-				oss >> y;
-				oss >> z;
-
-				VEC3 pos{Scalar(x), Scalar(y), Scalar(z)};
-
-				uint32 vertex_id = this->insert_line_vertex_container();
-				(*position)[vertex_id] = pos;
-
-				vertices_id.push_back(vertex_id);
-
-				if (vertex_id > max_id)
-					max_id = vertex_id;
-				i++;
+				const char* q = l;
+				if (read_keyword(q, last, "v"))
+					++first_vertex[c + 1u];
+				else if (read_keyword(q, last, "vn"))
+					++first_normal[c + 1u];
 			}
-
-			fp >> tag;
-			getline_safe(fp, line);
-		} while (!fp.eof());
-
-		if (has_normals)
+		});
+		for (uint32 c = 0u; c < nb_chunks; ++c)
 		{
-			normal = this->template add_vertex_attribute<VEC3>("normal");
-			normal->set_all_values(VEC3(0,0,0));
+			first_vertex[c + 1u] += first_vertex[c];
+			first_normal[c + 1u] += first_normal[c];
 		}
+		const uint32 nb_vertices = first_vertex[nb_chunks];
+		const uint32 nb_normals = first_normal[nb_chunks];
+		const bool has_normals = nb_normals > 0u;
 
-		fp.clear();
-		fp.seekg(0, std::ios::beg);
-
-		do
-		{
-			fp >> tag;
-			getline_safe(fp, line);
-		} while (tag != std::string("f"));
-
-		this->faces_nb_edges_.reserve(vertices_id.size() * 2);
-		this->faces_vertex_indices_.reserve(vertices_id.size() * 8);
-
-		std::vector<uint32> table;
-		table.reserve(64);
-		std::vector<uint32> tableN;
-		table.reserve(64);
-		do
+		ChunkArray<VEC3>* position = this->template add_vertex_attribute<VEC3>("position");
+		std::vector<uint32> vertices_id;
+		vertices_id.reserve(nb_vertices);
+		for (uint32 i = 0u; i < nb_vertices; ++i)
+			vertices_id.push_back(this->insert_line_vertex_container());
+		std::vector<VEC3> norm_buff(nb_normals);
+
+		// read vertices positions directly in the attribute, normals in norm_buff and faces in buffers per chunk.
+		// the indices of the faces are resolved to 0-based indices (relative indices are negative)
+		std::vector<std::vector<uint32>> chunk_nb_edges(nb_chunks);
+		std::vector<std::vector<uint32>> chunk_indices(nb_chunks);
+		std::vector<std::vector<uint32>> chunk_normal_indices(nb_chunks);
+		std::vector<uint8> chunk_valid(nb_chunks, 1u);
+		TextReader::parallel_foreach_chunk(chunks, [&] (uint32 c, const char* first, const char* last)
 		{
-			if (tag == std::string("f")) // lecture d'une face
+			uint32 vertex_index = first_vertex[c];
+			uint32 normal_index = first_normal[c];
+			const auto resolve = [] (int32 index, uint32 nb_defined, uint32 nb) -> uint32
 			{
-				std::stringstream oss(line);
+				const uint32 i = index > 0 ? uint32(index - 1) : (index < 0 ? nb_defined - uint32(-index) : INVALID_INDEX);
+				return i < nb ? i : INVALID_INDEX;
+			};
 
-				table.clear();
-				tableN.clear();
-				while (!oss.eof())  // lecture de tous les indices
+			for (const char* l = first; l != last; l = next_line(l, last))
+			{
+				const char* q = l;
+				if (read_keyword(q, last, "v"))
 				{
-					std::string str;
-					oss >> str;
-
-					uint32 ind = 0;
-
-					while ((ind < str.length()) && (str[ind] != '/'))
-						ind++;
-
-					if (ind > 0)
+					float64 x, y, z;
+					if (!read_double(q, last, x) || !read_double(q, last, y) || !read_double(q, last, z))
 					{
-						uint32 index;
-						std::stringstream iss(str.substr(0, ind));
-						iss >> index;
-						table.push_back(index);
+						chunk_valid[c] = 0u;
+						return;
 					}
-					if (has_normals)
+					(*position)[vertices_id[vertex_index++]] = VEC3{Scalar(x), Scalar(y), Scalar(z)};
+				}
+				else if (read_keyword(q, last, "vn"))
+				{
+					float64 x, y, z;
+					if (!read_double(q, last, x) || !read_double(q, last, y) || !read_double(q, last, z))
 					{
-						// jump over /?/ (v/vt/vn)
-						++ind;
-						while ((ind < str.length()) && (str[ind] != '/'))
-							++ind;
-
-						if (ind < str.length())
-						{
-							uint32 index;
-							std::stringstream iss(str.substr(ind+1, str.length()));
-							iss >> index;
-							tableN.push_back(index);
-						}
-						else
-							tableN.push_back(table.back());
+						chunk_valid[c] = 0u;
+						return;
 					}
+					const float64 n = std::sqrt(x*x+y*y+z*z);
+					norm_buff[normal_index++] = VEC3{Scalar(x/n), Scalar(y/n), Scalar(z/n)};
 				}
-
-				uint32 n = uint32(table.size());
-				this->faces_nb_edges_.push_back(n);
-				for (uint32 j = 0; j < n; ++j)
+				else if (read_keyword(q, last, "f"))
 				{
-					uint32 index = table[j] - 1; // indices start at 1
-					this->faces_vertex_indices_.push_back(vertices_id[index]);
-					if (has_normals)
+					uint32 n = 0u;
+					int32 v;
+					while (read_int(q, last, v))
 					{
-						auto k = vertices_id[index];
-						(*normal)[k] += norm_buff[tableN[j] - 1];
+						const uint32 vi = resolve(v, vertex_index, nb_vertices);
+						uint32 ni = vi;
+						// v/vt/vn, v//vn or v/vt
+						if (q != last && *q == '/')
+						{
+							++q;
+							int32 t;
+							read_int(q, last, t);
+							if (q != last && *q == '/')
+							{
+								++q;
+								int32 vn;
+								ni = read_int(q, last, vn) ? resolve(vn, normal_index, nb_normals) : INVALID_INDEX;
+							}
+						}
+						if (vi == INVALID_INDEX || (has_normals && ni >= nb_normals))
+						{
+							chunk_valid[c] = 0u;
+							return;
+						}
+						chunk_indices[c].push_back(vi);
+						if (has_normals)
+							chunk_normal_indices[c].push_back(ni);
+						++n;
 					}
+					chunk_nb_edges[c].push_back(n);
 				}
 			}
-			fp >> tag;
-			getline_safe(fp, line);
-		} while (!fp.eof());
+		});
+
+		if (std::find(chunk_valid.begin(), chunk_valid.end(), 0u) != chunk_valid.end())
+		{
+			cgogn_log_error("ObjSurfaceImport::import_file_impl") << "File \"" << filename << "\" is not a valid obj file.";
+			return false;
+		}
+
+		this->faces_nb_edges_.reserve(vertices_id.size() * 2);
+		this->faces_vertex_indices_.reserve(vertices_id.size() * 8);
+		for (uint32 c = 0u; c < nb_chunks; ++c)
+		{
+			this->faces_nb_edges_.insert(this->faces_nb_edges_.end(), chunk_nb_edges[c].begin(), chunk_nb_edges[c].end());
+			for (uint32 index : chunk_indices[c])
+				this->faces_vertex_indices_.push_back(vertices_id[index]);
+		}
 
-		// normalize
 		if (has_normals)
 		{
-			for(auto j: vertices_id)
+			ChunkArray<VEC3>* normal = this->template add_vertex_attribute<VEC3>("normal");
+			normal->set_all_values(VEC3(0,0,0));
+
+			for (uint32 c = 0u; c < nb_chunks; ++c)
+			{
+				for (std::size_t j = 0u, nb = chunk_indices[c].size(); j < nb; ++j)
+					(*normal)[vertices_id[chunk_indices[c][j]]] += norm_buff[chunk_normal_indices[c][j]];
+			}
+
+			// normalize
+			for (auto j : vertices_id)
 				(*normal)[j].normalize();
 		}
+
 		return true;
 	}
 };
@@ -32,8 +32,12 @@
 
 #include <cgogn/io/surface_import.h>
 #include <cgogn/io/surface_export.h>
+#include <cgogn/io/text_reader.h>
 
 #include <iomanip>
+#include <array>
+#include <algorithm>
+#include <cstring>
 
 namespace cgogn
 {
@@ -77,43 +81,145 @@ protected:
 		if (line.rfind("BINARY") != std::string::npos)
 			return this->import_off_bin(fp);
 
-		// read number of vertices, edges, faces
-		const uint32 nb_vertices = this->read_uint(fp,line);
-		const uint32 nb_faces = this->read_uint(fp,line);
-		/*const uint32 nb_edges_ =*/ this->read_uint(fp,line);
-		this->reserve(nb_faces);
+		fp.close();
+		return this->import_off_ascii(filename);
+	}
+
+	inline bool import_off_ascii(const std::string& filename)
+	{
+		TextReader reader;
+		if (!reader.open(filename))
+		{
+			cgogn_log_error("OffSurfaceImport::import_off_ascii") << "Unable to read the file \"" << filename << "\".";
+			return false;
+		}
+		const char* end = reader.end();
+
+		// read number of vertices, faces, edges after the OFF keyword
+		const char* p = reader.begin();
+		{
+			const char* header_end = next_line(p, end);
+			for (const char* q = p; q + 3 <= header_end; ++q)
+			{
+				if (std::strncmp(q, "OFF", 3u) == 0)
+					p = q + 3;
+			}
+		}
+		std::array<uint32, 3> counts;
+		for (uint32& count : counts)
+		{
+			p = skip_to_token(p, end);
+			if (!read_uint(p, end, count) || !is_token_end(p, end))
+			{
+				cgogn_log_error("OffSurfaceImport::import_off_ascii") << "Invalid header in file \"" << filename << "\".";
+				return false;
+			}
+		}
+		const uint32 nb_vertices = counts[0];
+		const uint32 nb_faces = counts[1];
 
 		ChunkArray<VEC3>* position = this->template add_vertex_attribute<VEC3>("position");
 
-		// read vertices position
 		std::vector<uint32> vertices_id;
 		vertices_id.reserve(nb_vertices);
-
-		for (uint32 i = 0; i < nb_vertices; ++i)
+		for (uint32 i = 0u; i < nb_vertices; ++i)
+			vertices_id.push_back(this->insert_line_vertex_container());
+
+		// the records are whitespace separated tokens (that can be split or grouped on lines in any way):
+		// count them in each chunk to know which token each chunk starts with
+		const std::vector<const char*> chunks = TextReader::split_lines(p, end);
+		const uint32 nb_chunks = uint32(chunks.size()) - 1u;
+		std::vector<uint32> first_token(nb_chunks + 1u, 0u);
+		TextReader::parallel_foreach_chunk(chunks, [&] (uint32 c, const char* first, const char* last)
 		{
+			uint32 nb = 0u;
+			for (const char* q = skip_to_token(first, last); q != last; q = skip_to_token(skip_token(q, last), last))
+				++nb;
+			first_token[c + 1u] = nb;
+		});
+		for (uint32 c = 0u; c < nb_chunks; ++c)
+			first_token[c + 1u] += first_token[c];
+
+		// the 3 * nb_vertices first tokens are the coordinates of the vertices, read directly in the attribute,
+		// the next ones are read as integers in buffers per chunk (INVALID_INDEX for the tokens that are not)
+		const uint32 nb_coordinates = 3u * nb_vertices;
+		std::vector<std::vector<uint32>> chunk_tokens(nb_chunks);
+		std::vector<uint8> chunk_valid(nb_chunks, 1u);
+		TextReader::parallel_foreach_chunk(chunks, [&] (uint32 c, const char* first, const char* last)
+		{
+			uint32 token = first_token[c];
+			if (first_token[c + 1u] > nb_coordinates)
+				chunk_tokens[c].reserve(first_token[c + 1u] - std::max(token, nb_coordinates));
+			for (const char* q = skip_to_token(first, last); q != last; q = skip_to_token(q, last), ++token)
+			{
+				if (token < nb_coordinates)
+				{
+					float64 x;
+					if (!read_double(q, last, x) || !is_token_end(q, last))
+					{
+						chunk_valid[c] = 0u;
+						return;
+					}
+					(*position)[vertices_id[token / 3u]][token % 3u] = Scalar(x);
+				}
+				else
+				{
+					uint32 value;
+					if (!read_uint(q, last, value) || !is_token_end(q, last))
+					{
+						value = INVALID_INDEX;
+						q = skip_token(q, last);
+					}
+					chunk_tokens[c].push_back(value);
+				}
+			}
+		});
 
-			float64 x = this->read_double(fp,line);
-			float64 y = this->read_double(fp,line);
-			float64 z = this->read_double(fp,line);
-
-			VEC3 pos{Scalar(x), Scalar(y), Scalar(z)};
-
-			uint32 vertex_id = this->insert_line_vertex_container();
-			(*position)[vertex_id] = pos;
-
-			vertices_id.push_back(vertex_id);
+		if (first_token[nb_chunks] < nb_coordinates || std::find(chunk_valid.begin(), chunk_valid.end(), 0u) != chunk_valid.end())
+		{
+			cgogn_log_error("OffSurfaceImport::import_off_ascii") << "File \"" << filename << "\" is not a valid off file.";
+			return false;
 		}
 
-		// read faces (vertex indices)
-		for (uint32 i = 0u; i < nb_faces ; ++i)
+		// the faces records (size then vertices) are chained: read them from the integers of the chunks
+		uint32 c = 0u;
+		std::size_t t = 0u;
+		auto next_token = [&] (uint32& value) -> bool
 		{
-			uint32 n = this->read_uint(fp,line);
-			this->faces_nb_edges_.push_back(n);
-			for (uint32 j = 0; j < n; ++j)
+			while (c < nb_chunks && t == chunk_tokens[c].size())
 			{
-				uint32 index = this->read_uint(fp,line);
-				this->faces_vertex_indices_.push_back(vertices_id[index]);
+				++c;
+				t = 0u;
 			}
+			if (c == nb_chunks)
+				return false;
+			value = chunk_tokens[c][t++];
+			return true;
+		};
+
+		this->reserve(nb_faces);
+		for (uint32 f = 0u; f < nb_faces; ++f)
+		{
+			uint32 n;
+			if (!next_token(n))
+			{
+				cgogn_log_warning("OffSurfaceImport::import_off_ascii") << "File \"" << filename << "\" contains only " << f << " of its " << nb_faces << " faces.";
+				break;
+			}
+			bool valid = n != INVALID_INDEX;
+			for (uint32 j = 0u; valid && j < n; ++j)
+			{
+				uint32 index;
+				valid = next_token(index) && index < nb_vertices;
+				if (valid)
+					this->faces_vertex_indices_.push_back(vertices_id[index]);
+			}
+			if (!valid)
+			{
+				cgogn_log_error("OffSurfaceImport::import_off_ascii") << "File \"" << filename << "\" is not a valid off file.";
+				return false;
+			}
+			this->faces_nb_edges_.push_back(n);
 		}
 
 		return true;
@@ -214,30 +320,6 @@ protected:
 
 		return true;
 	}
-
-private:
-
-	static inline float64 read_double(std::istream& fp, std::string& line)
-	{
-		fp >> line;
-		while (line[0] == '#')
-		{
-			fp.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-			fp >> line;
-		}
-		return std::stod(line);
-	}
-
-	static inline uint32 read_uint(std::istream& fp, std::string& line)
-	{
-		fp >> line;
-		while (line[0] == '#')
-		{
-			fp.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-			fp >> line;
-		}
-		return uint32((std::stoul(line)));
-	}
 };
 
 template <typename MAP>
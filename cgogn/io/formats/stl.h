@@ -30,9 +30,9 @@
 
 #include <cgogn/io/surface_import.h>
 #include <cgogn/io/surface_export.h>
+#include <cgogn/io/text_reader.h>
 
 #include <iomanip>
-#include <map>
 #include <algorithm>
 
 namespace cgogn
@@ -74,7 +74,7 @@ protected:
 
 private:
 
-	// put compare function here because lambda version do not compile on VS2013
+	// lexicographic order of the positions
 	inline static bool comp_fct(const VEC3& v1, const VEC3& v2)
 	{
 		return std::lexicographical_compare(&v1[0], &v1[0] + 3, &v2[0], &v2[0] + 3);
@@ -82,53 +82,57 @@ private:
 
 	bool import_ascii(const std::string& filename, ChunkArray<VEC3>* position, ChunkArray<VEC3>* normal)
 	{
-		std::ifstream fp(filename, std::ios::in);
-		std::map<VEC3, uint32, bool(*)(const VEC3&, const VEC3&)> vertices_set(comp_fct);
-
-		std::string line;
-		getline_safe(fp, line); // 1st line : solid name
+		TextReader reader;
+		if (!reader.open(filename))
+		{
+			cgogn_log_error("StlSurfaceImport::import_ascii") << "Unable to read the file \"" << filename << "\".";
+			return false;
+		}
 
-		while (fp.good())
+		// read the "facet normal" and "vertex" lines of each chunk, other lines are ignored
+		const std::vector<const char*> chunks = TextReader::split_lines(reader.begin(), reader.end());
+		const uint32 nb_chunks = uint32(chunks.size()) - 1u;
+		std::vector<std::vector<VEC3>> chunk_normals(nb_chunks);
+		std::vector<std::vector<VEC3>> chunk_positions(nb_chunks);
+		std::vector<uint8> chunk_valid(nb_chunks, 1u);
+		TextReader::parallel_foreach_chunk(chunks, [&] (uint32 c, const char* first, const char* last)
 		{
-			getline_safe(fp, line); // facet normal ni nj nk
-			std::stringstream stream_normal(line);
-			VEC3 norm;
-			stream_normal >> line;
-			if (to_lower(line) == "endsolid")
+			for (const char* l = first; l != last; l = next_line(l, last))
 			{
-				getline_safe(fp, line); // if there's another solid, 1st line : solid name
-				continue;
+				const char* q = l;
+				std::vector<VEC3>* values = nullptr;
+				if (read_keyword(q, last, "facet") && read_keyword(q, last, "normal"))
+					values = &chunk_normals[c];
+				else if (read_keyword(q, last, "vertex"))
+					values = &chunk_positions[c];
+				else
+					continue;
+
+				float64 x, y, z;
+				if (!read_double(q, last, x) || !read_double(q, last, y) || !read_double(q, last, z))
+				{
+					chunk_valid[c] = 0u;
+					return;
+				}
+				values->push_back(VEC3{Scalar(x), Scalar(y), Scalar(z)});
 			}
-			stream_normal >> line >> norm[0] >> norm[1] >> norm[2];
-			const uint32 face_id = this->insert_line_vertex_container();
-			(*normal)[face_id] = norm;
-			getline_safe(fp, line); // outer loop
+		});
 
-			std::array<VEC3, 3> pos;
-			for (uint32 i = 0u; i < 3; ++i)
-			{
-				getline_safe(fp, line);
-				std::stringstream stream_pos(line);
-				stream_pos >> line >> pos[i][0] >> pos[i][1] >> pos[i][2];
-				const auto it =  vertices_set.find(pos[i]);
-				uint32 vertex_id{UINT32_MAX};
+		std::vector<VEC3> normals;
+		std::vector<VEC3> positions;
+		for (uint32 c = 0u; c < nb_chunks; ++c)
+		{
+			normals.insert(normals.end(), chunk_normals[c].begin(), chunk_normals[c].end());
+			positions.insert(positions.end(), chunk_positions[c].begin(), chunk_positions[c].end());
+		}
 
-				if (it == vertices_set.end())
-				{
-					vertex_id = this->insert_line_face_container();
-					vertices_set.insert(std::make_pair(pos[i], vertex_id));
-//					indices_set.push_back(vertex_id);
-				} else
-					vertex_id = it->second;
-
-				(*position)[vertex_id] = pos[i];
-				this->faces_vertex_indices_.push_back(vertex_id);
-			}
-			this->faces_nb_edges_.push_back(3u);
-			getline_safe(fp, line); // endloop
-			getline_safe(fp, line); // endfacet
+		if (std::find(chunk_valid.begin(), chunk_valid.end(), 0u) != chunk_valid.end() || positions.size() != 3u * normals.size())
+		{
+			cgogn_log_error("StlSurfaceImport::import_ascii") << "File \"" << filename << "\" is not a valid stl file.";
+			return false;
 		}
 
+		this->add_triangles(positions, normals, position, normal);
 		return true;
 	}
 
@@ -139,12 +143,14 @@ private:
 		std::array<uint32, 21> header;
 		fp.read(reinterpret_cast<char*>(&header[0]), 21u* sizeof(uint32));
 		const uint32 nb_faces = swap_endianness_native_little(*reinterpret_cast<uint32*>(&header[20]));
-		this->reserve(nb_faces);
 
 		std::array<float32, 3> normal_buffer;
 		std::array<float32, 9> position_buffer;
 
-		std::map<VEC3, uint32, bool(*)(const VEC3&, const VEC3&)> vertices_set(comp_fct);
+		std::vector<VEC3> normals;
+		std::vector<VEC3> positions;
+		normals.reserve(nb_faces);
+		positions.reserve(3u * nb_faces);
 
 		for(uint32 i = 0u; i < nb_faces; ++i)
 		{
@@ -157,29 +163,57 @@ private:
 			for (auto& x : position_buffer)
 				x = swap_endianness_native_little(x);
 
-			const uint32 face_id = this->insert_line_vertex_container();
-			const VEC3 norm{Scalar(normal_buffer[0]), Scalar(normal_buffer[1]), Scalar(normal_buffer[2])};
-			(*normal)[face_id] = norm;
-
+			normals.push_back(VEC3{Scalar(normal_buffer[0]), Scalar(normal_buffer[1]), Scalar(normal_buffer[2])});
 			for(uint32 vid = 0u; vid < 3u ; ++vid)
-			{
-				const VEC3 pos{Scalar(position_buffer[3u*vid]), Scalar(position_buffer[3u*vid + 1u]), Scalar(position_buffer[3u*vid + 2u])};
-				const auto it =  vertices_set.find(pos);
-				uint32 vertex_id{UINT32_MAX};
+				positions.push_back(VEC3{Scalar(position_buffer[3u*vid]), Scalar(position_buffer[3u*vid + 1u]), Scalar(position_buffer[3u*vid + 2u])});
+		}
 
-				if (it == vertices_set.end())
-				{
-					vertex_id = this->insert_line_face_container();
-					vertices_set.insert(std::make_pair(pos, vertex_id));
-				} else
-					vertex_id = it->second;
+		this->add_triangles(positions, normals, position, normal);
+		return true;
+	}
+
+	/**
+	 * @brief add the triangles given by the 3 positions of their vertices.
+	 * The vertices with the same position are merged and numbered in order of first appearance.
+	 */
+	void add_triangles(const std::vector<VEC3>& positions, const std::vector<VEC3>& normals, ChunkArray<VEC3>* position, ChunkArray<VEC3>* normal)
+	{
+		const uint32 nb_positions = uint32(positions.size());
+
+		// sort the positions to find the first occurrence of each one
+		std::vector<uint32> order(nb_positions);
+		for (uint32 i = 0u; i < nb_positions; ++i)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&] (uint32 i, uint32 j) { return comp_fct(positions[i], positions[j]); });
+
+		std::vector<uint32> first_occurrence(nb_positions);
+		for (uint32 k = 0u; k < nb_positions; ++k)
+		{
+			const bool is_first = k == 0u || comp_fct(positions[order[k - 1u]], positions[order[k]]);
+			first_occurrence[order[k]] = is_first ? order[k] : first_occurrence[order[k - 1u]];
+		}
 
-				(*position)[vertex_id] = pos;
-				this->faces_vertex_indices_.push_back(vertex_id);
+		this->reserve(uint32(normals.size()));
+		std::vector<uint32> vertex_id(nb_positions);
+		for (uint32 i = 0u; i < nb_positions; ++i)
+		{
+			const uint32 f = first_occurrence[i];
+			if (f == i)
+			{
+				vertex_id[i] = this->insert_line_vertex_container();
+				(*position)[vertex_id[i]] = positions[i];
 			}
+			else
+				vertex_id[i] = vertex_id[f];
+			this->faces_vertex_indices_.push_back(vertex_id[i]);
+		}
+
+		for (const VEC3& n : normals)
+		{
+			const uint32 face_id = this->insert_line_face_container();
+			(*normal)[face_id] = n;
 			this->faces_nb_edges_.push_back(3u);
 		}
-		return true;
 	}
 };
 
@@ -27,10 +27,13 @@
 #include <istream>
 #include <sstream>
 #include <set>
+#include <atomic>
+#include <algorithm>
 
 #include <cgogn/core/utils/endian.h>
 #include <cgogn/core/utils/name_types.h>
 #include <cgogn/core/utils/string.h>
+#include <cgogn/core/utils/bucket_sort.h>
 
 #include <cgogn/core/cmap/cmap3.h>
 
@@ -173,8 +176,6 @@ public:
 		if (face_container().nb_chunk_arrays() > 0)
 			mbuild_.template create_embedding<Face::ORBIT>();
 
-		auto darts_per_vertex = map_.template add_attribute<std::vector<Dart>, Vertex>("darts_per_vertex");
-
 		uint32 faces_vertex_index = 0;
 		std::vector<uint32> vertices_buffer;
 		vertices_buffer.reserve(16);
@@ -207,7 +208,6 @@ public:
 				{
 					const uint32 vertex_index = vertices_buffer[j];
 					mbuild_.template set_embedding<Vertex>(d, vertex_index);
-					darts_per_vertex[vertex_index].push_back(d);
 					d = map_.phi1(d);
 				}
 				if (map_.is_embedded(Face::ORBIT))
@@ -216,41 +216,8 @@ public:
 		}
 
 		bool need_vertex_unicity_check = false;
-		uint32 nb_boundary_edges = 0;
-
-		map_.foreach_dart([&] (Dart d)
-		{
-			if (map_.phi2(d) == d)
-			{
-				uint32 vertex_index = map_.embedding(Vertex(d));
-
-				std::vector<Dart>& next_vertex_darts = darts_per_vertex[Vertex(map_.phi1(d))];
-				bool phi2_found = false;
-				bool first_OK = true;
-
-				for (auto it = next_vertex_darts.begin();
-					 it != next_vertex_darts.end() && !phi2_found;
-					 ++it)
-				{
-					if (map_.embedding(Vertex(map_.phi1(*it))) == vertex_index)
-					{
-						if (map_.phi2(*it) == *it)
-						{
-							mbuild_.phi2_sew(d, *it);
-							phi2_found = true;
-						}
-						else
-							first_OK = false;
-					}
-				}
-
-				if (!phi2_found)
-					++nb_boundary_edges;
-
-				if (!first_OK)
-					need_vertex_unicity_check = true;
-			}
-		});
+		uint32 nb_boundary_edges = 0u;
+		sew_faces(nb_boundary_edges, need_vertex_unicity_check);
 
 		if (nb_boundary_edges > 0)
 		{
@@ -264,8 +231,6 @@ public:
 			cgogn_log_warning("create_map") << "Import Surface: non manifold vertices detected and corrected";
 		}
 
-		map_.remove_attribute(darts_per_vertex);
-
 		cgogn_assert(map_.template is_well_embedded<Vertex>());
 		if (map_.template is_embedded<Face::ORBIT>())
 		{
@@ -275,6 +240,110 @@ public:
 
 protected:
 
+	/**
+	 * @brief phi2-sew the faces created by create_map along their shared edges.
+	 * The half-edges are sorted in parallel in buckets by their smallest vertex index,
+	 * then in each bucket the k-th half-edge from v to w is sewn to the k-th half-edge from w to v
+	 * (in increasing dart order). The remaining half-edges are left on the boundary.
+	 * @param nb_boundary_edges filled with the number of half-edges left unsewn
+	 * @param need_vertex_unicity_check set to true if an edge is shared by more than two faces
+	 */
+	void sew_faces(uint32& nb_boundary_edges, bool& need_vertex_unicity_check)
+	{
+		const uint32 nb_darts = map_.topology_container().end();
+		const uint32 nb_vertices = vertex_container().end();
+
+		// vertices of the half-edges, read once from the map
+		std::vector<uint32> from(nb_darts);
+		std::vector<uint32> to(nb_darts);
+		parallel_for(0u, nb_darts, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				if (map_.topology_container().used(i))
+				{
+					from[i] = map_.embedding(Vertex(Dart(i)));
+					to[i] = map_.embedding(Vertex(map_.phi1(Dart(i))));
+				}
+				else
+					from[i] = INVALID_INDEX;
+			}
+		});
+
+		std::vector<uint32> offsets;
+		std::vector<uint32> half_edges;
+		parallel_bucket_sort(nb_vertices, nb_darts, [&] (uint32 i) -> uint32
+		{
+			return from[i] == INVALID_INDEX ? INVALID_INDEX : std::min(from[i], to[i]);
+		},
+		offsets, half_edges);
+
+		std::atomic<uint32> nb_unsewn(0u);
+		std::atomic<bool> non_manifold(false);
+
+		parallel_for(0u, nb_vertices, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			// (other vertex, dart) of the half-edges leaving (out) or reaching (in) the bucket vertex
+			std::vector<std::pair<uint32, uint32>> out;
+			std::vector<std::pair<uint32, uint32>> in;
+			uint32 local_unsewn = 0u;
+			bool local_non_manifold = false;
+
+			for (uint32 v = first; v < last; ++v)
+			{
+				out.clear();
+				in.clear();
+				for (uint32 k = offsets[v]; k < offsets[v + 1u]; ++k)
+				{
+					const uint32 d = half_edges[k];
+					if (from[d] == v)
+						out.push_back(std::make_pair(to[d], d));
+					else
+						in.push_back(std::make_pair(from[d], d));
+				}
+				std::sort(out.begin(), out.end());
+				std::sort(in.begin(), in.end());
+
+				// merge the two sorted lists edge by edge
+				auto it_out = out.begin();
+				auto it_in = in.begin();
+				while (it_out != out.end() || it_in != in.end())
+				{
+					const uint32 w =
+						it_in == in.end() ? it_out->first :
+						it_out == out.end() ? it_in->first :
+						std::min(it_out->first, it_in->first);
+
+					bool sewn = false;
+					while (it_out != out.end() && it_out->first == w && it_in != in.end() && it_in->first == w)
+					{
+						mbuild_.phi2_sew(Dart(it_out->second), Dart(it_in->second));
+						++it_out;
+						++it_in;
+						sewn = true;
+					}
+					for (; it_out != out.end() && it_out->first == w; ++it_out)
+					{
+						++local_unsewn;
+						local_non_manifold |= sewn;
+					}
+					for (; it_in != in.end() && it_in->first == w; ++it_in)
+					{
+						++local_unsewn;
+						local_non_manifold |= sewn;
+					}
+				}
+			}
+
+			nb_unsewn.fetch_add(local_unsewn, std::memory_order_relaxed);
+			if (local_non_manifold)
+				non_manifold.store(true, std::memory_order_relaxed);
+		});
+
+		nb_boundary_edges = nb_unsewn.load();
+		need_vertex_unicity_check = non_manifold.load();
+	}
+
 	std::vector<uint32> faces_nb_edges_;
 	std::vector<uint32> faces_vertex_indices_;
 
@@ -0,0 +1,527 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+#include <ply.h>
+
+#include <cgogn/core/utils/endian.h>
+#include <cgogn/core/utils/logger.h>
+#include <cgogn/core/utils/unique_ptr.h>
+
+#include <cgogn/io/io_utils.h>
+#include <cgogn/io/text_reader.h>
+#include <cgogn/io/surface_stream.h>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+namespace
+{
+
+class OffAsciiStreamReader : public SurfaceStreamReader
+{
+public:
+
+	bool open(const std::string& filename)
+	{
+		if (!reader_.open(filename))
+			return false;
+		end_ = reader_.end();
+
+		// number of vertices, faces, edges after the OFF keyword
+		p_ = reader_.begin();
+		const char* header_end = next_line(p_, end_);
+		for (const char* q = p_; q + 3 <= header_end; ++q)
+		{
+			if (std::strncmp(q, "OFF", 3u) == 0)
+				p_ = q + 3;
+		}
+		std::array<uint32, 3> counts;
+		for (uint32& count : counts)
+		{
+			while (!read_uint(p_, end_, count))
+			{
+				if (p_ == end_ || !is_empty_line(p_, end_))
+					return false;
+				p_ = next_line(p_, end_);
+			}
+		}
+		p_ = next_line(p_, end_);
+		nb_vertices_ = counts[0];
+		nb_faces_ = counts[1];
+		return true;
+	}
+
+	bool read_vertex(std::array<float64, 3>& position) override
+	{
+		if (nb_read_vertices_ == nb_vertices_ || !next_non_empty_line())
+			return false;
+		for (float64& x : position)
+		{
+			if (!read_double(p_, end_, x))
+				return false;
+		}
+		p_ = next_line(p_, end_);
+		++nb_read_vertices_;
+		return true;
+	}
+
+	bool read_face(std::vector<uint32>& indices) override
+	{
+		uint32 n;
+		if (nb_read_faces_ == nb_faces_ || !next_non_empty_line() || !read_uint(p_, end_, n))
+			return false;
+		indices.resize(n);
+		for (uint32& index : indices)
+		{
+			if (!read_uint(p_, end_, index) || index >= nb_vertices_)
+				return false;
+		}
+		p_ = next_line(p_, end_);
+		++nb_read_faces_;
+		return true;
+	}
+
+private:
+
+	bool next_non_empty_line()
+	{
+		while (p_ != end_ && is_empty_line(p_, end_))
+			p_ = next_line(p_, end_);
+		return p_ != end_;
+	}
+
+	TextReader reader_;
+	const char* p_;
+	const char* end_;
+};
+
+class OffBinaryStreamReader : public SurfaceStreamReader
+{
+public:
+
+	bool open(const std::string& filename)
+	{
+		fp_.open(filename, std::ios::in | std::ios::binary);
+		std::string line;
+		std::getline(fp_, line);
+		std::array<uint32, 3> counts;
+		fp_.read(reinterpret_cast<char*>(counts.data()), sizeof(counts));
+		nb_vertices_ = swap_endianness_native_big(counts[0]);
+		nb_faces_ = swap_endianness_native_big(counts[1]);
+		return fp_.good();
+	}
+
+	bool read_vertex(std::array<float64, 3>& position) override
+	{
+		std::array<float32, 3> p;
+		if (nb_read_vertices_ == nb_vertices_ || !fp_.read(reinterpret_cast<char*>(p.data()), sizeof(p)))
+			return false;
+		for (uint32 i = 0u; i < 3u; ++i)
+			position[i] = float64(swap_endianness_native_big(p[i]));
+		++nb_read_vertices_;
+		return true;
+	}
+
+	bool read_face(std::vector<uint32>& indices) override
+	{
+		uint32 n;
+		if (nb_read_faces_ == nb_faces_ || !fp_.read(reinterpret_cast<char*>(&n), sizeof(n)))
+			return false;
+		indices.resize(swap_endianness_native_big(n));
+		if (!fp_.read(reinterpret_cast<char*>(indices.data()), std::streamsize(indices.size() * sizeof(uint32))))
+			return false;
+		for (uint32& index : indices)
+		{
+			index = swap_endianness_native_big(index);
+			if (index >= nb_vertices_)
+				return false;
+		}
+		++nb_read_faces_;
+		return true;
+	}
+
+private:
+
+	std::ifstream fp_;
+};
+
+/**
+ * @brief reads the vertex and face elements with the ply library, one element at a time
+ */
+class PlyStreamReader : public SurfaceStreamReader
+{
+public:
+
+	PlyStreamReader() :
+		ply_(nullptr),
+		vertex_element_(-1),
+		face_element_(-1),
+		element_(0)
+	{}
+
+	~PlyStreamReader() override
+	{
+		if (ply_)
+		{
+			close_ply(ply_);
+			free_ply(ply_);
+		}
+	}
+
+	bool open(const std::string& filename)
+	{
+		std::ifstream fs(filename);
+		std::string tag;
+		while (fs >> tag && tag != "format" && tag != "FORMAT") {}
+		fs >> tag;
+		if (!fs.good())
+			return false;
+		fs.close();
+
+		FILE* fp = std::fopen(filename.c_str(), tag == "ascii" || tag == "ASCII" ? "r" : "rb");
+		if (fp == nullptr)
+			return false;
+		ply_ = read_ply(fp);
+		if (ply_ == nullptr)
+			return false;
+
+		for (int32 i = 0; i < ply_->num_elem_types; ++i)
+		{
+			if (equal_strings(ply_->elems[i]->name, const_cast<char*>("vertex")))
+			{
+				vertex_element_ = i;
+				nb_vertices_ = uint32(ply_->elems[i]->num);
+			}
+			else if (equal_strings(ply_->elems[i]->name, const_cast<char*>("face")))
+			{
+				face_element_ = i;
+				nb_faces_ = uint32(ply_->elems[i]->num);
+			}
+		}
+		// the elements are read in the order of the file
+		if (vertex_element_ < 0 || face_element_ < vertex_element_)
+			return false;
+
+		next_element(vertex_element_);
+		if (!find_property("x") || !find_property("y") || !find_property("z"))
+			return false;
+		PlyProperty props[] = {
+			{const_cast<char*>("x"), PLY_Float64, PLY_Float64, 0, 0, 0, 0, 0},
+			{const_cast<char*>("y"), PLY_Float64, PLY_Float64, int32(sizeof(float64)), 0, 0, 0, 0},
+			{const_cast<char*>("z"), PLY_Float64, PLY_Float64, int32(2u * sizeof(float64)), 0, 0, 0, 0}
+		};
+		for (PlyProperty& prop : props)
+			setup_property_ply(ply_, &prop);
+		return true;
+	}
+
+	bool read_vertex(std::array<float64, 3>& position) override
+	{
+		if (nb_read_vertices_ == nb_vertices_)
+			return false;
+		get_element_ply(ply_, position.data());
+		++nb_read_vertices_;
+		return true;
+	}
+
+	bool read_face(std::vector<uint32>& indices) override
+	{
+		if (nb_read_faces_ == nb_faces_ || nb_read_vertices_ < nb_vertices_)
+			return false;
+		if (nb_read_faces_ == 0u)
+		{
+			next_element(face_element_);
+			const char* name = find_property("vertex_indices") ? "vertex_indices" : "vertex_index";
+			if (!find_property(name))
+				return false;
+			PlyProperty prop = {
+				const_cast<char*>(name), PLY_Int32, PLY_Uint32, int32(offsetof(PlyFace, indices)),
+				1, PLY_Uint8, PLY_Uint32, int32(offsetof(PlyFace, nb))
+			};
+			setup_property_ply(ply_, &prop);
+		}
+		PlyFace face;
+		get_element_ply(ply_, &face);
+		indices.assign(face.indices, face.indices + face.nb);
+		std::free(face.indices);
+		for (uint32 index : indices)
+		{
+			if (index >= nb_vertices_)
+				return false;
+		}
+		++nb_read_faces_;
+		return true;
+	}
+
+private:
+
+	struct PlyFace
+	{
+		uint32 nb;
+		uint32* indices;
+	};
+
+	bool find_property(const char* name) const
+	{
+		const PlyElement* elem = ply_->which_elem;
+		for (int32 j = 0; j < elem->nprops; ++j)
+		{
+			if (equal_strings(elem->props[j]->name, const_cast<char*>(name)))
+				return true;
+		}
+		return false;
+	}
+
+	// skip the elements (read in memory by the ply library) until the given one
+	void next_element(int32 element)
+	{
+		int32 count;
+		for (int32 i = element_; i < element; ++i)
+		{
+			setup_element_read_ply(ply_, i, &count);
+			if (i != vertex_element_)
+				get_other_element_ply(ply_);
+		}
+		setup_element_read_ply(ply_, element, &count);
+		element_ = element + 1;
+	}
+
+	PlyFile* ply_;
+	int32 vertex_element_;
+	int32 face_element_;
+	int32 element_;
+};
+
+} // namespace
+
+SurfaceStreamReader::SurfaceStreamReader() :
+	nb_vertices_(0u),
+	nb_faces_(0u),
+	nb_read_vertices_(0u),
+	nb_read_faces_(0u)
+{}
+
+SurfaceStreamReader::~SurfaceStreamReader()
+{}
+
+std::unique_ptr<SurfaceStreamReader> SurfaceStreamReader::open(const std::string& filename)
+{
+	switch (file_type(filename))
+	{
+		case FileType::FileType_OFF: {
+			std::ifstream fp(filename, std::ios::in | std::ios::binary);
+			std::string line;
+			std::getline(fp, line);
+			if (line.find("OFF") == std::string::npos)
+				break;
+			if (line.find("BINARY") != std::string::npos)
+			{
+				std::unique_ptr<OffBinaryStreamReader> reader = make_unique<OffBinaryStreamReader>();
+				if (reader->open(filename))
+					return std::unique_ptr<SurfaceStreamReader>(std::move(reader));
+			}
+			else
+			{
+				std::unique_ptr<OffAsciiStreamReader> reader = make_unique<OffAsciiStreamReader>();
+				if (reader->open(filename))
+					return std::unique_ptr<SurfaceStreamReader>(std::move(reader));
+			}
+			break;
+		}
+		case FileType::FileType_PLY: {
+			std::unique_ptr<PlyStreamReader> reader = make_unique<PlyStreamReader>();
+			if (reader->open(filename))
+				return std::unique_ptr<SurfaceStreamReader>(std::move(reader));
+			break;
+		}
+		default:
+			cgogn_log_warning("SurfaceStreamReader::open") << "SurfaceStreamReader does not handle files with extension \"" << extension(filename) << "\".";
+			return nullptr;
+	}
+	cgogn_log_error("SurfaceStreamReader::open") << "Unable to read the file \"" << filename << "\".";
+	return nullptr;
+}
+
+bool SurfaceStreamReader::skip_vertices()
+{
+	std::array<float64, 3> position;
+	while (nb_read_vertices_ < nb_vertices_)
+	{
+		if (!read_vertex(position))
+			return false;
+	}
+	return true;
+}
+
+SurfaceStreamWriter::SurfaceStreamWriter(const std::string& filename, bool binary) :
+	filename_(filename),
+	vertices_filename_(filename + ".vertices.tmp"),
+	faces_filename_(filename + ".faces.tmp"),
+	vertices_(vertices_filename_, std::ios::out | std::ios::binary | std::ios::trunc),
+	faces_(faces_filename_, std::ios::out | std::ios::binary | std::ios::trunc),
+	binary_(binary),
+	ply_(file_type(filename) == FileType::FileType_PLY),
+	closed_(false),
+	nb_vertices_(0u),
+	nb_faces_(0u)
+{}
+
+SurfaceStreamWriter::~SurfaceStreamWriter()
+{
+	if (!closed_)
+	{
+		vertices_.close();
+		faces_.close();
+		std::remove(vertices_filename_.c_str());
+		std::remove(faces_filename_.c_str());
+	}
+}
+
+bool SurfaceStreamWriter::good() const
+{
+	const FileType ft = file_type(filename_);
+	return vertices_.good() && faces_.good() && (ft == FileType::FileType_OFF || ft == FileType::FileType_PLY);
+}
+
+uint32 SurfaceStreamWriter::add_vertex(const std::array<float64, 3>& position)
+{
+	vertices_.write(reinterpret_cast<const char*>(position.data()), sizeof(position));
+	return nb_vertices_++;
+}
+
+void SurfaceStreamWriter::add_face(const uint32* indices, uint32 nb)
+{
+	faces_.write(reinterpret_cast<const char*>(&nb), sizeof(nb));
+	faces_.write(reinterpret_cast<const char*>(indices), std::streamsize(nb * sizeof(uint32)));
+	++nb_faces_;
+}
+
+bool SurfaceStreamWriter::close()
+{
+	vertices_.close();
+	faces_.close();
+	closed_ = true;
+
+	std::ifstream vertices(vertices_filename_, std::ios::in | std::ios::binary);
+	std::ifstream faces(faces_filename_, std::ios::in | std::ios::binary);
+	std::ofstream output(filename_, std::ios::out | std::ios::trunc | (binary_ ? std::ios::binary : std::ios::out));
+	bool ok = vertices.good() && faces.good() && output.good();
+
+	if (ok)
+	{
+		// header
+		if (ply_)
+		{
+			output << "ply" << std::endl;
+			output << "format " << (binary_ ? "binary_little_endian" : "ascii") << " 1.0" << std::endl;
+			output << "element vertex " << nb_vertices_ << std::endl;
+			output << "property float x" << std::endl << "property float y" << std::endl << "property float z" << std::endl;
+			output << "element face " << nb_faces_ << std::endl;
+			output << "property list uchar int vertex_indices" << std::endl;
+			output << "end_header" << std::endl;
+		}
+		else if (binary_)
+		{
+			output << "OFF BINARY" << std::endl;
+			const std::array<uint32, 3> counts = {{
+				swap_endianness_native_big(nb_vertices_), swap_endianness_native_big(nb_faces_), 0u
+			}};
+			output.write(reinterpret_cast<const char*>(counts.data()), sizeof(counts));
+		}
+		else
+		{
+			output << "OFF" << std::endl;
+			output << nb_vertices_ << " " << nb_faces_ << " 0" << std::endl;
+		}
+		output << std::setprecision(12);
+
+		// vertices
+		std::array<float64, 3> p;
+		for (uint32 i = 0u; i < nb_vertices_ && vertices.read(reinterpret_cast<char*>(p.data()), sizeof(p)); ++i)
+		{
+			if (binary_)
+			{
+				std::array<float32, 3> q;
+				for (uint32 j = 0u; j < 3u; ++j)
+					q[j] = ply_ ? swap_endianness_native_little(float32(p[j])) : swap_endianness_native_big(float32(p[j]));
+				output.write(reinterpret_cast<const char*>(q.data()), sizeof(q));
+			}
+			else
+				output << p[0] << " " << p[1] << " " << p[2] << std::endl;
+		}
+
+		// faces
+		std::vector<uint32> indices;
+		uint32 nb;
+		for (uint32 i = 0u; i < nb_faces_ && faces.read(reinterpret_cast<char*>(&nb), sizeof(nb)); ++i)
+		{
+			indices.resize(nb);
+			faces.read(reinterpret_cast<char*>(indices.data()), std::streamsize(nb * sizeof(uint32)));
+			if (binary_ && ply_)
+			{
+				const uint8 n = uint8(nb);
+				output.write(reinterpret_cast<const char*>(&n), 1u);
+				for (uint32& index : indices)
+					index = swap_endianness_native_little(index);
+			}
+			else if (binary_)
+			{
+				for (uint32& index : indices)
+					index = swap_endianness_native_big(index);
+				nb = swap_endianness_native_big(nb);
+				output.write(reinterpret_cast<const char*>(&nb), sizeof(nb));
+			}
+			if (binary_)
+				output.write(reinterpret_cast<const char*>(indices.data()), std::streamsize(indices.size() * sizeof(uint32)));
+			else
+			{
+				output << nb;
+				for (uint32 index : indices)
+					output << " " << index;
+				output << std::endl;
+			}
+		}
+		ok = vertices.good() && faces.good() && output.good();
+	}
+
+	vertices.close();
+	faces.close();
+	std::remove(vertices_filename_.c_str());
+	std::remove(faces_filename_.c_str());
+	if (!ok)
+		cgogn_log_error("SurfaceStreamWriter::close") << "Unable to write the file \"" << filename_ << "\".";
+	return ok;
+}
+
+} // namespace io
+
+} // namespace cgogn
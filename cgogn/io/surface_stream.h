@@ -0,0 +1,149 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_SURFACE_STREAM_H_
+#define CGOGN_IO_SURFACE_STREAM_H_
+
+#include <array>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cgogn/core/utils/definitions.h>
+#include <cgogn/core/utils/numerics.h>
+
+#include <cgogn/io/dll.h>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+/**
+ * @brief The SurfaceStreamReader class reads the vertices then the faces of a surface mesh file one by one
+ * without storing them, so that files larger than the memory can be processed.
+ * The OFF (ascii and binary) and PLY files are handled.
+ */
+class CGOGN_IO_API SurfaceStreamReader
+{
+public:
+
+	/**
+	 * @brief open a surface file and read its header
+	 * @return the reader or nullptr if the file cannot be read
+	 */
+	static std::unique_ptr<SurfaceStreamReader> open(const std::string& filename);
+
+	virtual ~SurfaceStreamReader();
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(SurfaceStreamReader);
+
+	inline uint32 nb_vertices() const { return nb_vertices_; }
+	inline uint32 nb_faces() const { return nb_faces_; }
+
+	/**
+	 * @brief read the position of the next vertex (the vertices are read before the faces)
+	 * @return false if there is no more vertex or the file is invalid
+	 */
+	virtual bool read_vertex(std::array<float64, 3>& position) = 0;
+
+	/**
+	 * @brief read the vertex indices of the next face (after all the vertices have been read)
+	 * @return false if there is no more face or the file is invalid
+	 */
+	virtual bool read_face(std::vector<uint32>& indices) = 0;
+
+	/**
+	 * @brief read all the vertices without keeping them
+	 */
+	bool skip_vertices();
+
+protected:
+
+	SurfaceStreamReader();
+
+	uint32 nb_vertices_;
+	uint32 nb_faces_;
+	uint32 nb_read_vertices_;
+	uint32 nb_read_faces_;
+};
+
+/**
+ * @brief The SurfaceStreamWriter class writes a surface mesh file from vertices and faces given one by one.
+ * The vertices and faces are buffered in temporary files next to the written file
+ * until close() writes the final file, whose header needs their numbers.
+ * The OFF (ascii or big endian binary) and PLY (ascii or little endian binary) files are handled.
+ */
+class CGOGN_IO_API SurfaceStreamWriter final
+{
+public:
+
+	SurfaceStreamWriter(const std::string& filename, bool binary);
+	~SurfaceStreamWriter();
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(SurfaceStreamWriter);
+
+	/**
+	 * @return true iff the temporary files are writable and the format of the file is handled
+	 */
+	bool good() const;
+
+	/**
+	 * @brief add a vertex
+	 * @return the index of the vertex in the file
+	 */
+	uint32 add_vertex(const std::array<float64, 3>& position);
+
+	/**
+	 * @brief add a face given by the indices (returned by add_vertex) of its nb vertices
+	 */
+	void add_face(const uint32* indices, uint32 nb);
+
+	inline uint32 nb_vertices() const { return nb_vertices_; }
+	inline uint32 nb_faces() const { return nb_faces_; }
+
+	/**
+	 * @brief write the file and remove the temporary files
+	 * @return true iff the file has been written
+	 */
+	bool close();
+
+private:
+
+	std::string filename_;
+	std::string vertices_filename_;
+	std::string faces_filename_;
+	std::ofstream vertices_;
+	std::ofstream faces_;
+	bool binary_;
+	bool ply_;
+	bool closed_;
+	uint32 nb_vertices_;
+	uint32 nb_faces_;
+};
+
+} // namespace io
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_SURFACE_STREAM_H_
@@ -24,6 +24,8 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <cstdio>
+#include <fstream>
 #include <cgogn/io/map_import.h>
 
 #define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
@@ -52,3 +54,31 @@ TEST(ImportTest, off_surface_import)
 	EXPECT_EQ(nbf, 1696u);
 	EXPECT_TRUE(expected_empty_error_output.empty());
 }
+
+TEST(ImportTest, off_surface_import_tokens)
+{
+	// the records of an ascii off file are whitespace separated tokens: they can be split or grouped on lines
+	const std::string filename("off_import_test.off");
+	{
+		std::ofstream out(filename);
+		out << "OFF\n# a comment\n4 2\n0\n";
+		out << "0 0 1\n0\n0 # comment in a record\n";
+		out << "0 0 1 0 1 1 0\n";
+		out << "3 0 1\n2\n3 1 3 2\n";
+	}
+
+	Map2 map2;
+	cgogn::io::import_surface<Vec3>(map2, filename);
+	auto pos = map2.get_attribute<Vec3, Map2::Vertex>("position");
+	EXPECT_TRUE(pos.is_valid());
+	EXPECT_TRUE(map2.check_map_integrity());
+	EXPECT_EQ(map2.nb_cells<Map2::Vertex::ORBIT>(), 4u);
+	EXPECT_EQ(map2.nb_cells<Map2::Face::ORBIT>(), 2u);
+	EXPECT_EQ(map2.nb_cells<Map2::Edge::ORBIT>(), 5u);
+
+	float64 sum = 0.0;
+	map2.foreach_cell([&] (Map2::Vertex v) { sum += pos[v][0] + 2.0 * pos[v][1] + 4.0 * pos[v][2]; });
+	EXPECT_EQ(sum, 4.0 + 2.0 + 1.0 + 2.0);
+
+	std::remove(filename.c_str());
+}
@@ -0,0 +1,125 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <cgogn/io/text_reader.h>
+
+using namespace cgogn::numerics;
+
+TEST(TextReaderTest, read_numbers)
+{
+	const std::string text(" 42 -17 +3 0.5 -1.25e2 3.14159265358979 1e-300 0.1234567890123456789 .5e1 abc");
+	const char* p = text.data();
+	const char* end = p + text.size();
+
+	uint32 u;
+	int32 i;
+	float64 d;
+	EXPECT_TRUE(cgogn::io::read_uint(p, end, u));
+	EXPECT_EQ(u, 42u);
+	EXPECT_FALSE(cgogn::io::read_uint(p, end, u));
+	EXPECT_TRUE(cgogn::io::read_int(p, end, i));
+	EXPECT_EQ(i, -17);
+	EXPECT_TRUE(cgogn::io::read_int(p, end, i));
+	EXPECT_EQ(i, 3);
+
+	for (const char* s : { "0.5", "-1.25e2", "3.14159265358979", "1e-300", "0.1234567890123456789", ".5e1" })
+	{
+		EXPECT_TRUE(cgogn::io::read_double(p, end, d));
+		EXPECT_EQ(d, std::strtod(s, nullptr));
+	}
+	EXPECT_FALSE(cgogn::io::read_double(p, end, d));
+	EXPECT_TRUE(cgogn::io::read_keyword(p, end, "abc"));
+	EXPECT_EQ(p, end);
+}
+
+TEST(TextReaderTest, split_lines)
+{
+	const std::string filename("text_reader_test.txt");
+	{
+		std::ofstream out(filename);
+		out << "# comment\n";
+		for (uint32 i = 0u; i < 10000u; ++i)
+			out << "v " << i << "\r\n\n";
+	}
+
+	{
+		cgogn::io::TextReader reader;
+		ASSERT_TRUE(reader.open(filename));
+
+		const std::vector<const char*> chunks = cgogn::io::TextReader::split_lines(reader.begin(), reader.end(), 1000u);
+		EXPECT_GT(chunks.size(), 2u);
+		EXPECT_EQ(chunks.front(), reader.begin());
+		EXPECT_EQ(chunks.back(), reader.end());
+
+		std::vector<uint32> sums(chunks.size() - 1u, 0u);
+		std::vector<uint32> nb_lines(chunks.size() - 1u, 0u);
+		cgogn::io::TextReader::parallel_foreach_chunk(chunks, [&] (uint32 c, const char* first, const char* last)
+		{
+			EXPECT_TRUE(first == reader.begin() || cgogn::io::is_end_of_line(first[-1]));
+			for (const char* l = first; l != last; l = cgogn::io::next_line(l, last))
+			{
+				if (cgogn::io::is_empty_line(l, last))
+					continue;
+				const char* q = l;
+				uint32 v;
+				EXPECT_TRUE(cgogn::io::read_keyword(q, last, "v"));
+				EXPECT_TRUE(cgogn::io::read_uint(q, last, v));
+				sums[c] += v;
+				++nb_lines[c];
+			}
+		});
+
+		uint32 sum = 0u;
+		uint32 nb = 0u;
+		for (uint32 c = 0u; c < sums.size(); ++c)
+		{
+			sum += sums[c];
+			nb += nb_lines[c];
+		}
+		EXPECT_EQ(nb, 10000u);
+		EXPECT_EQ(sum, 10000u * 9999u / 2u);
+	}
+
+	std::remove(filename.c_str());
+}
+
+TEST(TextReaderTest, tokens)
+{
+	const std::string text("  1 2.5\n\n# comment 3\r\n  4# comment\n\t5  ");
+	const char* end = text.data() + text.size();
+
+	std::vector<std::string> tokens;
+	for (const char* p = cgogn::io::skip_to_token(text.data(), end); p != end; )
+	{
+		const char* q = cgogn::io::skip_token(p, end);
+		EXPECT_TRUE(cgogn::io::is_token_end(q, end));
+		tokens.push_back(std::string(p, q));
+		p = cgogn::io::skip_to_token(q, end);
+	}
+	EXPECT_EQ(tokens, std::vector<std::string>({ "1", "2.5", "4", "5" }));
+}
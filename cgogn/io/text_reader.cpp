@@ -0,0 +1,182 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+#include <cgogn/io/text_reader.h>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+TextReader::TextReader() :
+	mapped_file_(nullptr),
+	buffer_(),
+	begin_(nullptr),
+	end_(nullptr)
+{}
+
+TextReader::~TextReader()
+{}
+
+bool TextReader::open(const std::string& filename)
+{
+	buffer_.clear();
+	mapped_file_ = MappedFile::open(filename);
+	if (mapped_file_)
+	{
+		begin_ = mapped_file_->data();
+		end_ = begin_ + mapped_file_->size();
+		return true;
+	}
+
+	// the file cannot be mapped: read it in one block
+	std::ifstream fp(filename, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!fp.good())
+		return false;
+	buffer_.resize(std::size_t(fp.tellg()));
+	fp.seekg(0, std::ios::beg);
+	fp.read(buffer_.data(), std::streamsize(buffer_.size()));
+	begin_ = buffer_.data();
+	end_ = begin_ + buffer_.size();
+	return fp.good() && !buffer_.empty();
+}
+
+std::vector<const char*> TextReader::split_lines(const char* first, const char* last, std::size_t chunk_bytes)
+{
+	std::vector<const char*> bounds;
+	bounds.push_back(first);
+	while (std::size_t(last - bounds.back()) > chunk_bytes)
+	{
+		const char* p = next_line(bounds.back() + chunk_bytes, last);
+		if (p == last)
+			break;
+		bounds.push_back(p);
+	}
+	bounds.push_back(last);
+	return bounds;
+}
+
+CGOGN_IO_API bool read_double(const char*& p, const char* end, float64& value)
+{
+	// powers of ten that are exactly represented by a float64
+	static const float64 exact_powers_of_ten[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	const uint64 max_exact_mantissa = uint64(1) << 53;
+
+	const char* start = skip_blanks(p, end);
+	const char* q = start;
+
+	const bool negative = q != end && *q == '-';
+	if (q != end && (*q == '-' || *q == '+'))
+		++q;
+
+	uint64 mantissa = 0u;
+	uint32 nb_digits = 0u;
+	int32 exponent = 0;
+	bool has_digits = false;
+	bool truncated = false;
+
+	const auto read_digit = [&] (bool fractional)
+	{
+		const uint32 d = uint32(*q - '0');
+		has_digits = true;
+		if (nb_digits < 19u)
+		{
+			mantissa = 10u * mantissa + d;
+			if (mantissa > 0u)
+				++nb_digits;
+			if (fractional)
+				--exponent;
+		}
+		else
+		{
+			truncated |= d != 0u;
+			if (!fractional)
+				++exponent;
+		}
+	};
+
+	for (; q != end && uint32(*q - '0') <= 9u; ++q)
+		read_digit(false);
+	if (q != end && *q == '.')
+	{
+		++q;
+		for (; q != end && uint32(*q - '0') <= 9u; ++q)
+			read_digit(true);
+	}
+
+	if (has_digits && q != end && (*q == 'e' || *q == 'E'))
+	{
+		const char* e = q + 1;
+		int32 exp10;
+		if (e != end && !is_blank(*e) && read_int(e, end, exp10))
+		{
+			exponent += exp10;
+			q = e;
+		}
+	}
+
+	if (has_digits && !truncated)
+	{
+		if (mantissa == 0u)
+		{
+			value = negative ? -0.0 : 0.0;
+			p = q;
+			return true;
+		}
+		if (mantissa <= max_exact_mantissa && exponent >= -22 && exponent <= 22)
+		{
+			// both operands are exact: the result is correctly rounded
+			const float64 m = float64(mantissa);
+			const float64 v = exponent >= 0 ? m * exact_powers_of_ten[exponent] : m / exact_powers_of_ten[-exponent];
+			value = negative ? -v : v;
+			p = q;
+			return true;
+		}
+	}
+
+	// long mantissas, large exponents, inf and nan go through strtod (the C locale is used during imports)
+	char buffer[128];
+	std::size_t length = 0u;
+	for (const char* c = start; c != end && length < sizeof(buffer) - 1u && !is_blank(*c) && !is_end_of_line(*c); ++c)
+		buffer[length++] = *c;
+	buffer[length] = '\0';
+	char* buffer_end = nullptr;
+	const float64 v = std::strtod(buffer, &buffer_end);
+	if (buffer_end == buffer)
+		return false;
+	value = v;
+	p = start + (buffer_end - buffer);
+	return true;
+}
+
+} // namespace io
+
+} // namespace cgogn
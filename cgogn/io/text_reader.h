@@ -0,0 +1,238 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_TEXT_READER_H_
+#define CGOGN_IO_TEXT_READER_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/mapped_file.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/io/dll.h>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+/**
+ * @brief The TextReader class gives a direct access to the characters of a text file.
+ * The file is mapped in memory (or read in one block if it cannot be mapped) and can be split
+ * in line-aligned chunks that are parsed in parallel with the allocation-free functions below.
+ * Numbers are always parsed with the C locale conventions.
+ */
+class CGOGN_IO_API TextReader final
+{
+public:
+
+	/// approximate size of the chunks parsed by a thread
+	static const std::size_t CHUNK_BYTES = 1u << 20;
+
+	TextReader();
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(TextReader);
+	~TextReader();
+
+	/**
+	 * @brief open the file and give access to its content
+	 * @return true iff the file is readable and not empty
+	 */
+	bool open(const std::string& filename);
+
+	inline const char* begin() const { return begin_; }
+	inline const char* end() const { return end_; }
+	inline std::size_t size() const { return std::size_t(end_ - begin_); }
+
+	/**
+	 * @brief split [first, last) in chunks of about chunk_bytes characters that end with a complete line
+	 * @return the bounds of the chunks (the nb_chunks + 1 first characters of the chunks, last included)
+	 */
+	static std::vector<const char*> split_lines(const char* first, const char* last, std::size_t chunk_bytes = CHUNK_BYTES);
+
+	/**
+	 * @brief call f(i, first, last) for each chunk i = [first, last) given by split_lines, in parallel
+	 */
+	template <typename FUNC>
+	static void parallel_foreach_chunk(const std::vector<const char*>& bounds, const FUNC& f)
+	{
+		const uint32 nb_chunks = uint32(bounds.size()) - 1u;
+		parallel_for(0u, nb_chunks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				f(i, bounds[i], bounds[i + 1u]);
+		});
+	}
+
+private:
+
+	std::shared_ptr<MappedFile> mapped_file_;
+	std::vector<char> buffer_;
+	const char* begin_;
+	const char* end_;
+};
+
+inline bool is_end_of_line(char c)
+{
+	return c == '\n' || c == '\r';
+}
+
+inline bool is_blank(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+/**
+ * @return the first non blank character of the line from p
+ */
+inline const char* skip_blanks(const char* p, const char* end)
+{
+	while (p != end && is_blank(*p))
+		++p;
+	return p;
+}
+
+/**
+ * @return the first character after the end of the line of p
+ */
+inline const char* next_line(const char* p, const char* end)
+{
+	while (p != end && !is_end_of_line(*p))
+		++p;
+	return p == end ? p : p + 1;
+}
+
+/**
+ * @return true if the line from p contains only blanks or a comment starting with '#'
+ */
+inline bool is_empty_line(const char* p, const char* end)
+{
+	p = skip_blanks(p, end);
+	return p == end || is_end_of_line(*p) || *p == '#';
+}
+
+/**
+ * @return the first character of the next token from p (blanks, line ends and comments from '#' to the end of their line are skipped)
+ */
+inline const char* skip_to_token(const char* p, const char* end)
+{
+	while (p != end)
+	{
+		if (*p == '#')
+			p = next_line(p, end);
+		else if (is_blank(*p) || is_end_of_line(*p))
+			++p;
+		else
+			break;
+	}
+	return p;
+}
+
+/**
+ * @return the first character after the token of p
+ */
+inline const char* skip_token(const char* p, const char* end)
+{
+	while (p != end && !is_blank(*p) && !is_end_of_line(*p) && *p != '#')
+		++p;
+	return p;
+}
+
+/**
+ * @return true if p is at the end of a token
+ */
+inline bool is_token_end(const char* p, const char* end)
+{
+	return p == end || is_blank(*p) || is_end_of_line(*p) || *p == '#';
+}
+
+/**
+ * @brief read the word (case insensitive) at the beginning of the line from p
+ * @return true and move p after the word if it is found
+ */
+inline bool read_keyword(const char*& p, const char* end, const char* word)
+{
+	const char* q = skip_blanks(p, end);
+	for (; *word != '\0'; ++word, ++q)
+	{
+		if (q == end || (*q | 0x20) != *word)
+			return false;
+	}
+	if (q != end && !is_blank(*q) && !is_end_of_line(*q))
+		return false;
+	p = q;
+	return true;
+}
+
+/**
+ * @brief read an unsigned integer after the blanks from p and move p after it
+ * @return false (p unchanged) if there is no integer
+ */
+inline bool read_uint(const char*& p, const char* end, uint32& value)
+{
+	const char* q = skip_blanks(p, end);
+	if (q != end && *q == '+')
+		++q;
+	if (q == end || uint32(*q - '0') > 9u)
+		return false;
+	uint32 v = 0u;
+	for (; q != end && uint32(*q - '0') <= 9u; ++q)
+		v = 10u * v + uint32(*q - '0');
+	value = v;
+	p = q;
+	return true;
+}
+
+/**
+ * @brief read a signed integer after the blanks from p and move p after it
+ * @return false (p unchanged) if there is no integer
+ */
+inline bool read_int(const char*& p, const char* end, int32& value)
+{
+	const char* q = skip_blanks(p, end);
+	const bool negative = q != end && *q == '-';
+	if (negative)
+		++q;
+	uint32 v;
+	if (!read_uint(q, end, v))
+		return false;
+	value = negative ? -int32(v) : int32(v);
+	p = q;
+	return true;
+}
+
+/**
+ * @brief read a floating point number (C locale conventions) after the blanks from p and move p after it.
+ * The usual numbers (at most 15 significant digits and small exponents) are converted exactly without strtod.
+ * @return false (p unchanged) if there is no number
+ */
+CGOGN_IO_API bool read_double(const char*& p, const char* end, float64& value);
+
+} // namespace io
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_TEXT_READER_H_
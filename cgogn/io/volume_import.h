@@ -26,8 +26,13 @@
 
 #include <istream>
 #include <set>
+#include <map>
+#include <array>
+#include <mutex>
+#include <algorithm>
 
 #include <cgogn/core/utils/string.h>
+#include <cgogn/core/utils/bucket_sort.h>
 
 #include <cgogn/core/cmap/cmap3.h>
 #include <cgogn/geometry/types/geometry_traits.h>
@@ -265,10 +270,7 @@ public:
 		if (volume_container().nb_chunk_arrays() > 0)
 			mbuild_.template create_embedding<Volume::ORBIT>();
 
-		auto darts_per_vertex = map_.template add_attribute<std::vector<Dart>, Vertex>("darts_per_vertex");
-
 		uint32 index = 0u;
-		typename MAP::DartMarker dart_marker(map_);
 		Dart d;
 		uint32 vol_emb = 0u;
 
@@ -293,18 +295,7 @@ public:
 				};
 
 				for (const Dart& dv : vertices_of_tetra)
-				{
-					const uint32 emb = this->volumes_vertex_indices_[index++];
-					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(dv), emb);
-
-					Dart dd = dv;
-					do
-					{
-						dart_marker.mark(dd);
-						darts_per_vertex[emb].push_back(dd);
-						dd = map_.phi1(map_.phi2(dd));
-					} while(dd != dv);
-				}
+					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(dv), this->volumes_vertex_indices_[index++]);
 			}
 			else if (vol_type == VolumeType::Pyramid) // pyramidal case
 			{
@@ -322,18 +313,7 @@ public:
 				};
 
 				for (Dart dv : vertices_of_pyramid)
-				{
-					const uint32 emb = this->volumes_vertex_indices_[index++];
-					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(dv), emb);
-
-					Dart dd = dv;
-					do
-					{
-						dart_marker.mark(dd);
-						darts_per_vertex[emb].push_back(dd);
-						dd = map_.phi1(map_.phi2(dd));
-					} while(dd != dv);
-				}
+					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(dv), this->volumes_vertex_indices_[index++]);
 			}
 			else if (vol_type == VolumeType::TriangularPrism) // prism case
 			{
@@ -352,18 +332,7 @@ public:
 				};
 
 				for (Dart dv : vertices_of_prism)
-				{
-					const uint32 emb = this->volumes_vertex_indices_[index++];
-					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(dv), emb);
-
-					Dart dd = dv;
-					do
-					{
-						dart_marker.mark(dd);
-						darts_per_vertex[emb].push_back(dd);
-						dd = map_.phi1(map_.phi2(dd));
-					} while(dd != dv);
-				}
+					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(dv), this->volumes_vertex_indices_[index++]);
 			}
 			else if (vol_type == VolumeType::Hexa) // hexahedral case
 			{
@@ -384,18 +353,7 @@ public:
 				};
 
 				for (Dart dv : vertices_of_hexa)
-				{
-					const uint32 emb = this->volumes_vertex_indices_[index++];
-					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(dv), emb);
-
-					Dart dd = dv;
-					do
-					{
-						dart_marker.mark(dd);
-						darts_per_vertex[emb].push_back(dd);
-						dd = map_.phi1(map_.phi2(dd));
-					} while(dd != dv);
-				}
+					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(dv), this->volumes_vertex_indices_[index++]);
 			}
 			else //end of hexa
 			{
@@ -410,148 +368,7 @@ public:
 		}
 
 		// reconstruct neighbourhood
-		uint32 nb_boundary_faces = 0u;
-
-		map_.foreach_dart([&] (Dart d)
-		{
-			if (dart_marker.is_marked(d))
-			{
-				Dart good_dart;
-
-				// 1st step : for every dart of the face we try to find a valid phi3 candidate. If we can't it's a boundary face.
-				{
-					Dart d_it = d;
-					do
-					{
-						const std::vector<Dart>& vec = darts_per_vertex[Vertex(map_.phi1(d_it))];
-						for (auto it = vec.begin(); it != vec.end() && good_dart.is_nil(); ++it)
-						{
-							if (map_.embedding(Vertex(map_.phi1(*it))) == map_.embedding(Vertex(d_it)) &&
-								map_.embedding(Vertex(map_.phi_1(*it))) == map_.embedding(Vertex(map_.phi1(map_.phi1(d_it)))))
-							{
-								good_dart = *it;
-							}
-						}
-						d_it = map_.phi1(d_it);
-					} while (good_dart.is_nil() && (d_it != d));
-					d = map_.phi_1(d_it);
-				}
-
-				if (!good_dart.is_nil()) //not a boundary faces
-				{
-					const uint32 degD = map_.codegree(Face(d));
-					const uint32 degGD = map_.codegree(Face(good_dart));
-
-					if (degD == degGD) // normal case : the two opposite faces have the same degree
-					{
-						mbuild_.sew_volumes_fp(d, good_dart);
-						dart_marker.unmark_orbit(Face(d));
-					}
-					else
-					{
-						// there is one face of degree 4 and one face of degree 3.
-						if (degD > degGD) // face of d is quad
-						{
-							const Dart another_d = map_.phi1(map_.phi1(d));
-							const std::vector<Dart>& vec = darts_per_vertex[Vertex(map_.phi_1(d))];
-
-							Dart another_good_dart;
-							for (auto it = vec.begin(); it != vec.end() && another_good_dart.is_nil(); ++it)
-							{
-								if (map_.embedding(Vertex(map_.phi1(*it))) == map_.embedding(Vertex(another_d)) &&
-									map_.embedding(Vertex(map_.phi_1(*it))) == map_.embedding(Vertex(map_.phi1(map_.phi1(another_d)))))
-								{
-									another_good_dart = *it ;
-								}
-							}
-
-							// we add a stamp volume between the faces
-							const Dart d_quad = mbuild_.add_stamp_volume_topo_fp();
-							{
-								if (map_.is_embedded(Volume::ORBIT))
-									mbuild_. new_orbit_embedding(Volume(d_quad));
-								Dart q1_it = d;
-								Dart q2_it = map_.phi_1(d_quad);
-								do
-								{
-									mbuild_.template set_orbit_embedding<Vertex>(Vertex2(q2_it), map_.embedding(Vertex(q1_it)));
-									q1_it = map_.phi1(q1_it);
-									q2_it = map_.phi_1(q2_it);
-								} while (q1_it != d);
-							}
-
-							mbuild_.sew_volumes_fp(d, map_.phi1(map_.phi1(d_quad)));
-							dart_marker.unmark_orbit(Face(d));
-
-							mbuild_.sew_volumes_fp(good_dart, map_.phi2(map_.phi1(map_.phi1(d_quad))));
-							dart_marker.unmark_orbit(Face(good_dart));
-
-							if (!another_good_dart.is_nil())
-							{
-								mbuild_.sew_volumes_fp(another_good_dart, map_.phi2(d_quad));
-								dart_marker.unmark_orbit(Face(another_good_dart));
-							}
-							else
-							{
-								dart_marker.unmark_orbit(Face2(map_.phi2(d_quad)));
-								++nb_boundary_faces;
-							}
-						}
-						else // face of d is tri
-						{
-							const Dart another_dart = map_.phi_1(d);
-							std::vector<Dart>& vec = darts_per_vertex[Vertex(d)];
-
-							Dart another_good_dart;
-							for (auto it = vec.begin(); it != vec.end() && another_good_dart.is_nil(); ++it)
-							{
-								if (map_.embedding(Vertex(map_.phi1(*it))) == map_.embedding(Vertex(another_dart)) &&
-									map_.embedding(Vertex(map_.phi_1(*it))) == map_.embedding(Vertex(map_.phi1(map_.phi1(good_dart)))))
-								{
-									another_good_dart = *it ;
-								}
-							}
-
-							const Dart d_quad = mbuild_.add_stamp_volume_topo_fp();
-							{
-								if (map_.is_embedded(Volume::ORBIT))
-									mbuild_.new_orbit_embedding(Volume(d_quad));
-								Dart q1_it = good_dart;
-								Dart q2_it = d_quad;
-								do
-								{
-									mbuild_.template set_orbit_embedding<Vertex>(Vertex2(q2_it), map_.embedding(Vertex(q1_it)));
-									q1_it = map_.phi1(q1_it);
-									q2_it = map_.phi_1(q2_it);
-								} while (q1_it != good_dart);
-							}
-
-							mbuild_.sew_volumes_fp(d_quad, map_.phi_1(good_dart));
-							dart_marker.unmark_orbit(Face(good_dart));
-
-							mbuild_.sew_volumes_fp(d, map_.phi2(map_.phi_1(d_quad)));
-							dart_marker.unmark_orbit(Face(d));
-
-							if (!another_good_dart.is_nil())
-							{
-								mbuild_.sew_volumes_fp(another_good_dart, map_.phi1(map_.phi2(map_.phi1(d_quad))));
-								dart_marker.unmark_orbit(Face(another_good_dart));
-							}
-							else
-							{
-								dart_marker.unmark_orbit(Face2(map_.phi1(map_.phi2(map_.phi1(d_quad)))));
-								++nb_boundary_faces;
-							}
-						}
-					}
-				}
-				else
-				{
-					dart_marker.unmark_orbit(Face2(d));
-					++nb_boundary_faces;
-				}
-			}
-		});
+		const uint32 nb_boundary_faces = sew_volumes();
 
 		if (nb_boundary_faces > 0)
 		{
@@ -561,8 +378,6 @@ public:
 
 		map_.template enforce_unique_orbit_embedding<Vertex::ORBIT>();
 
-		map_.remove_attribute(darts_per_vertex);
-
 		cgogn_assert(map_.template is_well_embedded<Vertex>());
 		if (map_.template is_embedded<Volume::ORBIT>())
 		{
@@ -572,6 +387,213 @@ public:
 
 protected:
 
+	// (smallest vertex, codegree, smallest neighbour, largest neighbour, vertex opposite to the smallest one in quads, orientation)
+	using FaceKey = std::array<uint32, 6>;
+
+	/**
+	 * @brief key of a face given by its vertices in phi1 order starting from its smallest vertex v0.
+	 * Two faces with the same key but opposite orientations are the two sides of the same face.
+	 */
+	static inline FaceKey face_key(uint32 codegree, uint32 v0, uint32 next, uint32 prev, uint32 opposite)
+	{
+		return FaceKey{{ v0, codegree, std::min(next, prev), std::max(next, prev), opposite, next < prev ? 0u : 1u }};
+	}
+
+	static inline FaceKey triangle_key(uint32 v0, uint32 v1, uint32 v2)
+	{
+		if (v1 < v0 && v1 < v2)
+			return face_key(3u, v1, v2, v0, INVALID_INDEX);
+		if (v2 < v0 && v2 < v1)
+			return face_key(3u, v2, v0, v1, INVALID_INDEX);
+		return face_key(3u, v0, v1, v2, INVALID_INDEX);
+	}
+
+	static inline bool same_vertices(const FaceKey& k1, const FaceKey& k2)
+	{
+		return std::equal(k1.begin(), k1.begin() + 5, k2.begin());
+	}
+
+	/**
+	 * @brief phi3-sew the volumes created by create_map along their shared faces.
+	 * Each face is represented by its dart on its smallest vertex. The faces are sorted in parallel in buckets
+	 * by this vertex, then in each bucket the k-th face is sewn to the k-th face with the same vertices and
+	 * the opposite orientation (in increasing dart order).
+	 * The quads left alone are then connected to the pairs of triangles that cover them with stamp volumes.
+	 * @return the number of faces left on the boundary
+	 */
+	uint32 sew_volumes()
+	{
+		const uint32 nb_darts = map_.topology_container().end();
+		const uint32 nb_vertices = vertex_container().end();
+
+		// vertices of the darts, read once from the map
+		std::vector<uint32> vertex(nb_darts);
+		parallel_for(0u, nb_darts, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				vertex[i] = map_.topology_container().used(i) ? map_.embedding(Vertex(Dart(i))) : INVALID_INDEX;
+		});
+
+		std::vector<uint32> offsets;
+		std::vector<uint32> faces;
+		parallel_bucket_sort(nb_vertices, nb_darts, [&] (uint32 i) -> uint32
+		{
+			if (vertex[i] == INVALID_INDEX)
+				return INVALID_INDEX;
+			for (Dart d = map_.phi1(Dart(i)); d.index != i; d = map_.phi1(d))
+			{
+				if (vertex[d.index] < vertex[i] || (vertex[d.index] == vertex[i] && d.index < i))
+					return INVALID_INDEX;
+			}
+			return vertex[i];
+		},
+		offsets, faces);
+
+		const auto key_of = [&] (Dart d) -> FaceKey
+		{
+			const uint32 codegree = map_.codegree(Face(d));
+			cgogn_message_assert(codegree <= 4u, "VolumeImport: faces of degree greater than 4 are not supported");
+			return face_key(
+				codegree,
+				vertex[d.index],
+				vertex[map_.phi1(d).index],
+				vertex[map_.phi_1(d).index],
+				codegree == 4u ? vertex[map_.phi1(map_.phi1(d)).index] : INVALID_INDEX
+			);
+		};
+
+		std::vector<uint32> unsewn;
+		std::mutex unsewn_mutex;
+
+		parallel_for(0u, nb_vertices, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			std::vector<std::pair<FaceKey, uint32>> keys;
+			std::vector<uint32> local_unsewn;
+
+			for (uint32 v = first; v < last; ++v)
+			{
+				keys.clear();
+				for (uint32 k = offsets[v]; k < offsets[v + 1u]; ++k)
+					keys.push_back(std::make_pair(key_of(Dart(faces[k])), faces[k]));
+				std::sort(keys.begin(), keys.end());
+
+				// in each run of faces with the same vertices, the first ones have orientation 0
+				auto it = keys.begin();
+				while (it != keys.end())
+				{
+					auto it_end = it;
+					while (it_end != keys.end() && same_vertices(it_end->first, it->first))
+						++it_end;
+					auto it_opposite = it;
+					while (it_opposite != it_end && it_opposite->first[5] == 0u)
+						++it_opposite;
+
+					auto it1 = it;
+					auto it2 = it_opposite;
+					for (; it1 != it_opposite && it2 != it_end; ++it1, ++it2)
+						mbuild_.sew_volumes_fp(Dart(it1->second), map_.phi_1(Dart(it2->second)));
+					for (; it1 != it_opposite; ++it1)
+						local_unsewn.push_back(it1->second);
+					for (; it2 != it_end; ++it2)
+						local_unsewn.push_back(it2->second);
+
+					it = it_end;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(unsewn_mutex);
+			unsewn.insert(unsewn.end(), local_unsewn.begin(), local_unsewn.end());
+		});
+
+		std::sort(unsewn.begin(), unsewn.end());
+
+		std::vector<Dart> quads;
+		std::map<FaceKey, Dart> triangles;
+		for (uint32 i : unsewn)
+		{
+			const Dart d(i);
+			const uint32 codegree = map_.codegree(Face(d));
+			if (codegree == 4u)
+				quads.push_back(d);
+			else if (codegree == 3u)
+				triangles.insert(std::make_pair(key_of(d), d));
+		}
+		if (quads.empty())
+			return uint32(unsewn.size());
+
+		// the dart of the face of t on the vertex v
+		const auto dart_of_vertex = [&] (Dart t, uint32 v) -> Dart
+		{
+			while (vertex[t.index] != v)
+				t = map_.phi1(t);
+			return t;
+		};
+
+		uint32 nb_boundary_faces = uint32(unsewn.size());
+		for (Dart d : quads)
+		{
+			// find a triangle opposite to (d, phi1(d), phi1(phi1(d))) along one of the two diagonals of the quad
+			auto good_face = triangles.end();
+			for (uint32 r = 0u; r < 4u && good_face == triangles.end(); ++r)
+			{
+				if (r > 0u)
+					d = map_.phi1(d);
+				good_face = triangles.find(triangle_key(
+					vertex[map_.phi1(d).index],
+					vertex[d.index],
+					vertex[map_.phi1(map_.phi1(d)).index]
+				));
+			}
+			if (good_face == triangles.end())
+				continue;
+
+			const Dart good_dart = dart_of_vertex(good_face->second, vertex[map_.phi1(d).index]);
+			triangles.erase(good_face);
+
+			Dart another_good_dart;
+			auto another_good_face = triangles.find(triangle_key(
+				vertex[map_.phi_1(d).index],
+				vertex[map_.phi1(map_.phi1(d)).index],
+				vertex[d.index]
+			));
+			if (another_good_face != triangles.end())
+			{
+				another_good_dart = dart_of_vertex(another_good_face->second, vertex[map_.phi_1(d).index]);
+				triangles.erase(another_good_face);
+			}
+
+			// we add a stamp volume between the faces
+			const Dart d_quad = mbuild_.add_stamp_volume_topo_fp();
+			{
+				if (map_.is_embedded(Volume::ORBIT))
+					mbuild_.new_orbit_embedding(Volume(d_quad));
+				Dart q1_it = d;
+				Dart q2_it = map_.phi_1(d_quad);
+				do
+				{
+					mbuild_.template set_orbit_embedding<Vertex>(Vertex2(q2_it), map_.embedding(Vertex(q1_it)));
+					q1_it = map_.phi1(q1_it);
+					q2_it = map_.phi_1(q2_it);
+				} while (q1_it != d);
+			}
+
+			mbuild_.sew_volumes_fp(d, map_.phi1(map_.phi1(d_quad)));
+			mbuild_.sew_volumes_fp(good_dart, map_.phi2(map_.phi1(map_.phi1(d_quad))));
+			// the quad and the first triangle are no longer on the boundary
+			nb_boundary_faces -= 2u;
+
+			if (!another_good_dart.is_nil())
+			{
+				mbuild_.sew_volumes_fp(another_good_dart, map_.phi2(d_quad));
+				--nb_boundary_faces;
+			}
+			else
+				++nb_boundary_faces;
+		}
+
+		return nb_boundary_faces;
+	}
+
 	template <typename T>
 	inline void reorient_hexa(const ChunkArray<T>& pos, uint32& p0, uint32& p1, uint32& p2, uint32& p3, uint32& p4, uint32& p5, uint32& p6, uint32& p7)
 	{
@@ -31,6 +31,7 @@
 #include <cgogn/core/cmap/cmap3.h>
 #include <cgogn/geometry/algos/centroid.h>
 #include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/modeling/algos/subdivision_plan.h>
 
 namespace cgogn
 {
@@ -63,6 +64,11 @@ typename MAP::Vertex quadrangule_face(MAP& map, typename MAP::Face f)
 	return Vertex(map.phi2(x));	// Return a dart of the central vertex
 }
 
+/**
+ * @brief Catmull-Clark subdivision
+ * The new positions are computed in parallel on the initial mesh, then the topology is refined:
+ * in one batch with a SubdivisionPlan when possible, with cut_edge and quadrangule_face otherwise.
+ */
 template < typename MAP, typename VERTEX_ATTR>
 void catmull_clark(MAP& map, VERTEX_ATTR& position)
 {
@@ -74,51 +80,41 @@ void catmull_clark(MAP& map, VERTEX_ATTR& position)
 	using Edge = typename MAP::Edge;
 	using Face = typename MAP::Face;
 
-	DartMarker<MAP> initial_edge_marker(map);
+	VERTEX_ATTR position2 = map.template add_attribute<VEC3, Vertex>("position_tempo_catmull_clark");
 
 	CellCache<MAP> initial_cache(map);
 	initial_cache.template build<Vertex>();
 	initial_cache.template build<Edge>();
 	initial_cache.template build<Face>();
 
-	map.foreach_cell([&] (Edge e) {	initial_edge_marker.mark_orbit(e); }, initial_cache);
+	SubdivisionPlan<MAP> plan(map, initial_cache);
 
-	map.foreach_cell([&] (Edge e)
+	// compute position of face points
+	std::vector<VEC3> face_points(plan.nb_faces());
+	parallel_for(0u, plan.nb_faces(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
 	{
-		std::pair<Vertex,Vertex> ve = map.vertices(e);
-		Vertex middle = map.cut_edge(e);
-		position[middle] = (position[ve.first] + position[ve.second]) / Scalar(2);
-	}
-	, initial_cache);
-
-	map.foreach_cell([&] (Face f)
-	{
-		Face ff = f;
-		if (!initial_edge_marker.is_marked(f.dart))
-			ff = Face(map.phi1(f.dart));
-
-		initial_edge_marker.unmark_orbit(ff);
-
-		VEC3 center = geometry::centroid(map, ff, position);
-		Vertex vc = quadrangule_face(map, ff);
-		position[vc] = center;
-	}
-	, initial_cache);
+		for (uint32 i = first; i < last; ++i)
+			face_points[i] = geometry::centroid(map, Face(plan.faces()[i]), position);
+	});
 
-	map.foreach_cell([&] (Edge e)
+	// compute position of edge points
+	std::vector<VEC3> edge_points(plan.nb_edges());
+	parallel_for(0u, plan.nb_edges(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
 	{
-		Dart e2 = map.phi2(e.dart);
-		if (!map.is_boundary(e.dart) && !map.is_boundary(e2))
+		for (uint32 i = first; i < last; ++i)
 		{
-			Vertex f1(map.template phi<11>(e.dart));
-			Vertex f2(map.phi_1(e2));
-			Vertex m(map.phi1(e.dart));
-			position[m] = (Scalar(2) * position[m] + position[f1] + position[f2]) / Scalar(4);
+			const Dart d = plan.edges()[i];
+			const Dart e = map.phi2(d);
+			edge_points[i] = position[Vertex(d)] + position[Vertex(e)];
+			if (!map.is_boundary(d) && !map.is_boundary(e))
+				edge_points[i] = (edge_points[i] + face_points[plan.face_index(d)] + face_points[plan.face_index(e)]) / Scalar(4);
+			else
+				edge_points[i] /= Scalar(2);
 		}
-	}
-	, initial_cache);
+	});
 
-	map.foreach_cell([&] (Vertex v)
+	// compute new position of old vertices
+	map.parallel_foreach_cell([&] (Vertex v)
 	{
 		VEC3 sum_face; // Sum_F
 		sum_face.setZero();
@@ -131,31 +127,67 @@ void catmull_clark(MAP& map, VERTEX_ATTR& position)
 		map.foreach_incident_edge(v, [&] (Edge e)
 		{
 			nb_e++;
-			sum_edge += position[Vertex(map.phi1(e.dart))];
+			sum_edge += edge_points[plan.edge_index(e.dart)];
 			if (!map.is_boundary(e.dart))
 			{
 				nb_f++;
-				sum_face += position[Vertex(map.template phi<11>(e.dart))];
+				sum_face += face_points[plan.face_index(e.dart)];
 			}
 			else
 				bound = e.dart;
 		});
 
-		if (nb_f > nb_e) // boundary case
+		if (nb_f < nb_e) // boundary case
 		{
-			Vertex e1(map.phi2(bound));
+			Vertex e1(map.phi1(bound));
 			Vertex e2(map.phi_1(bound));
-			position[v] = Scalar(3.0/8.0) * position[v] + Scalar(1.0/4.0) * (position[e1] + position[e2]);
+			position2[v] = Scalar(3.0/4.0) * position[v] + Scalar(1.0/8.0) * (position[e1] + position[e2]);
 		}
 		else
 		{
 			VEC3 delta = position[v] * Scalar(-3*nb_f);
 			delta += sum_face + Scalar(2) * sum_edge;
 			delta /= Scalar(nb_f * nb_f);
-			position[v] += delta;
+			position2[v] = position[v] + delta;
 		}
+	},
+	initial_cache);
+
+	if (plan.refine_catmull_clark())
+	{
+		parallel_for(0u, plan.nb_edges(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				position[plan.edge_vertex(i)] = edge_points[i];
+		});
+		parallel_for(0u, plan.nb_faces(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				position[plan.face_vertex(i)] = face_points[i];
+		});
 	}
-	, initial_cache);
+	else
+	{
+		DartMarker<MAP> initial_edge_marker(map);
+		map.foreach_cell([&] (Edge e) {	initial_edge_marker.mark_orbit(e); }, initial_cache);
+
+		for (uint32 i = 0u; i < plan.nb_edges(); ++i)
+			position[map.cut_edge(Edge(plan.edges()[i]))] = edge_points[i];
+
+		for (uint32 i = 0u; i < plan.nb_faces(); ++i)
+		{
+			Face ff(plan.faces()[i]);
+			if (!initial_edge_marker.is_marked(ff.dart))
+				ff = Face(map.phi1(ff.dart));
+
+			initial_edge_marker.unmark_orbit(ff);
+
+			position[quadrangule_face(map, ff)] = face_points[i];
+		}
+	}
+
+	map.parallel_foreach_cell([&] (Vertex v) { position[v] = position2[v]; }, initial_cache);
+	map.remove_attribute(position2);
 }
 
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_MODELING_EXTERNAL_TEMPLATES_CPP_))
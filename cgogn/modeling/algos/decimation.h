@@ -24,12 +24,17 @@
 #ifndef CGOGN_MODELING_ALGOS_DECIMATION_H_
 #define CGOGN_MODELING_ALGOS_DECIMATION_H_
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include <cgogn/modeling/dll.h>
 
 #include <cgogn/geometry/functions/basics.h>
 #include <cgogn/geometry/types/geometry_traits.h>
 
 #include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/scatter.h>
 
 #include <cgogn/modeling/decimation/edge_traversor_map_order.h>
 #include <cgogn/modeling/decimation/edge_traversor_edge_length.h>
@@ -141,9 +146,232 @@ void decimate(
 	delete approx;
 }
 
+/**
+ * @brief decimate the map in parallel by collapsing nb edges in batches of independent collapses
+ * At each round, the batch_ratio fraction of the candidate edges with the lowest costs is considered in increasing cost order
+ * and an edge is selected when the one-ring neighbourhoods of its vertices do not overlap the ones of the already selected edges.
+ * The selected edges are collapsed, then the costs and new positions of the edges around the new vertices are computed in parallel.
+ * A small batch_ratio follows the cost order more strictly (as decimate does), a larger one collapses more edges per round.
+ * The costs and positions are given by the same EdgeTraversorType and EdgeApproximatorType as in decimate.
+ * @param map the map
+ * @param position the position vertex attribute
+ * @param trav_type the cost of the edges
+ * @param approx_type the position of the vertex resulting from the collapse of an edge
+ * @param nb the number of edges to collapse
+ * @param batch_ratio the fraction (in (0,1]) of the candidate edges from which a batch is selected
+ */
+template <typename VERTEX_ATTR>
+void parallel_decimate(
+	CMap2& map,
+	VERTEX_ATTR& position,
+	EdgeTraversorType trav_type,
+	EdgeApproximatorType approx_type,
+	uint32 nb,
+	float32 batch_ratio = 0.1f
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, CMap2::Vertex::ORBIT>::value,"position must be a vertex attribute");
+
+	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
+	using Scalar = typename geometry::vector_traits<VEC3>::Scalar;
+	using Vertex = CMap2::Vertex;
+	using Edge = CMap2::Edge;
+	using Face = CMap2::Face;
+
+	const Scalar INVALID_COST = std::numeric_limits<Scalar>::max();
+	batch_ratio = std::min(std::max(batch_ratio, std::numeric_limits<float32>::min()), 1.0f);
+
+	CMap2::VertexAttribute<geometry::Quadric> quadric;
+	if (trav_type == EdgeTraversor_QEM_T)
+	{
+		// same name as in EdgeTraversor_QEM to be used by EdgeApproximator_QEM
+		quadric = map.add_attribute<geometry::Quadric, Vertex>("EdgeTraversor_QEM_Quadric");
+		map.parallel_foreach_cell([&] (Vertex v) { quadric[v].zero(); });
+		parallel_scatter(map, quadric, [&] (Face f, ScatterAccumulator<geometry::Quadric, Vertex::ORBIT>& acc)
+		{
+			Dart d = f.dart;
+			Dart d1 = map.phi1(d);
+			Dart d_1 = map.phi_1(d);
+			geometry::Quadric q(position[Vertex(d)], position[Vertex(d1)], position[Vertex(d_1)]);
+			acc(Vertex(d), q);
+			acc(Vertex(d1), q);
+			acc(Vertex(d_1), q);
+		});
+	}
+
+	EdgeApproximator<CMap2, VEC3>* approx = nullptr;
+	switch (approx_type)
+	{
+		case EdgeApproximator_MidEdge_T:
+			approx = new EdgeApproximator_MidEdge<CMap2, VEC3>(map, position);
+			break;
+		case EdgeApproximator_QEM_T:
+			approx = new EdgeApproximator_QEM<CMap2, VEC3>(map, position);
+			break;
+	}
+	approx->init();
+
+	CMap2::EdgeAttribute<Edge> edge = map.add_attribute<Edge, Edge>("parallel_decimate_edge");
+	CMap2::EdgeAttribute<Scalar> cost = map.add_attribute<Scalar, Edge>("parallel_decimate_cost");
+	CMap2::EdgeAttribute<VEC3> new_position = map.add_attribute<VEC3, Edge>("parallel_decimate_position");
+	CMap2::VertexAttribute<uint32> lock = map.add_attribute<uint32, Vertex>("parallel_decimate_lock");
+	lock.set_all_values(0u);
+
+	// only reads the map and writes the attributes of the given edge
+	auto evaluate = [&] (Edge e)
+	{
+		edge[e] = e;
+		if (!map.edge_can_collapse(e))
+		{
+			cost[e] = INVALID_COST;
+			return;
+		}
+		const VEC3 p = (*approx)(e);
+		new_position[e] = p;
+		switch (trav_type)
+		{
+			case EdgeTraversor_MapOrder_T:
+				cost[e] = Scalar(e.dart.index);
+				break;
+			case EdgeTraversor_EdgeLength_T:
+				cost[e] = geometry::length(map, e, position);
+				break;
+			case EdgeTraversor_QEM_T: {
+				std::pair<Vertex, Vertex> vertices = map.vertices(e);
+				geometry::Quadric q;
+				q += quadric[vertices.first];
+				q += quadric[vertices.second];
+				cost[e] = q(p);
+				break;
+			}
+		}
+	};
+	map.parallel_foreach_cell(evaluate);
+
+	const CMap2::ChunkArrayContainer<uint32>& edges = map.attribute_container<Edge::ORBIT>();
+	std::vector<std::vector<uint32>> blocks;
+	std::vector<uint32> candidates;
+	std::vector<Edge> batch;
+	std::vector<Vertex> centers;
+
+	uint32 count = 0u;
+	for (uint32 round = 1u; count < nb; ++round)
+	{
+		// gather the collapsible edges
+		const uint32 end = edges.end();
+		blocks.resize((end + PARALLEL_BUFFER_SIZE - 1u) / PARALLEL_BUFFER_SIZE);
+		parallel_for(0u, uint32(blocks.size()), 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 b = first; b < last; ++b)
+			{
+				blocks[b].clear();
+				for (uint32 i = b * PARALLEL_BUFFER_SIZE, e = std::min(end, i + PARALLEL_BUFFER_SIZE); i < e; ++i)
+				{
+					if (edges.used(i) && cost[i] != INVALID_COST)
+						blocks[b].push_back(i);
+				}
+			}
+		});
+		candidates.clear();
+		for (const auto& b : blocks)
+			candidates.insert(candidates.end(), b.begin(), b.end());
+		if (candidates.empty())
+			break;
+
+		const auto lower_cost = [&] (uint32 a, uint32 b) { return cost[a] < cost[b] || (cost[a] == cost[b] && a < b); };
+		const std::size_t nb_considered = std::max(std::size_t(1u), std::size_t(batch_ratio * float32(candidates.size())));
+		if (nb_considered < candidates.size())
+			std::nth_element(candidates.begin(), candidates.begin() + nb_considered, candidates.end(), lower_cost);
+		candidates.resize(nb_considered);
+		std::sort(candidates.begin(), candidates.end(), lower_cost);
+
+		// select the edges with non overlapping neighbourhoods
+		batch.clear();
+		for (uint32 i : candidates)
+		{
+			if (count + uint32(batch.size()) == nb)
+				break;
+			const Edge e = edge[i];
+			const std::pair<Vertex, Vertex> vertices = map.vertices(e);
+			bool free = lock[vertices.first] != round && lock[vertices.second] != round;
+			for (Vertex v : { vertices.first, vertices.second })
+				map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex w) { free = free && lock[w] != round; });
+			if (!free)
+				continue;
+			for (Vertex v : { vertices.first, vertices.second })
+			{
+				lock[v] = round;
+				map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex w) { lock[w] = round; });
+			}
+			batch.push_back(e);
+		}
+
+		// the collapses do not interact but the removal of the cells is not thread safe
+		centers.clear();
+		for (Edge e : batch)
+		{
+			if (!map.edge_can_collapse(e))
+			{
+				cost[e] = INVALID_COST;
+				centers.push_back(Vertex(e.dart));
+				continue;
+			}
+			const VEC3 p = new_position[e];
+			geometry::Quadric q;
+			if (quadric.is_valid())
+			{
+				std::pair<Vertex, Vertex> vertices = map.vertices(e);
+				q += quadric[vertices.first];
+				q += quadric[vertices.second];
+			}
+			const Vertex v = map.collapse_edge(e);
+			position[v] = p;
+			if (quadric.is_valid())
+				quadric[v] = q;
+			centers.push_back(v);
+			++count;
+		}
+
+		// update the edges whose vertices one-ring changed, i.e. the edges of the locked neighbourhoods:
+		// the edges of the new vertices are evaluated again, the others only change of collapsibility
+		// (an edge between two neighbourhoods is updated by its vertex of lower index)
+		parallel_for(0u, uint32(centers.size()), 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+			{
+				const Vertex v = centers[c];
+				map.foreach_incident_edge(v, evaluate);
+				map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex w)
+				{
+					map.foreach_incident_edge(w, [&] (Edge e)
+					{
+						const Vertex x(map.phi2(e.dart));
+						if (map.embedding(x) == map.embedding(v) || (lock[x] == round && map.embedding(x) < map.embedding(w)))
+							return;
+						if (cost[e] == INVALID_COST)
+							evaluate(e);
+						else if (!map.edge_can_collapse(e))
+							cost[e] = INVALID_COST;
+					});
+				});
+			}
+		});
+	}
+
+	map.remove_attribute(edge);
+	map.remove_attribute(cost);
+	map.remove_attribute(new_position);
+	map.remove_attribute(lock);
+	if (quadric.is_valid())
+		map.remove_attribute(quadric);
+	delete approx;
+}
+
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_MODELING_EXTERNAL_TEMPLATES_CPP_))
 extern template CGOGN_MODELING_API void decimate(CMap2&, CMap2::VertexAttribute<Eigen::Vector3f>&, EdgeTraversorType, EdgeApproximatorType, uint32);
 extern template CGOGN_MODELING_API void decimate(CMap2&, CMap2::VertexAttribute<Eigen::Vector3d>&, EdgeTraversorType, EdgeApproximatorType, uint32);
+extern template CGOGN_MODELING_API void parallel_decimate(CMap2&, CMap2::VertexAttribute<Eigen::Vector3f>&, EdgeTraversorType, EdgeApproximatorType, uint32, float32);
+extern template CGOGN_MODELING_API void parallel_decimate(CMap2&, CMap2::VertexAttribute<Eigen::Vector3d>&, EdgeTraversorType, EdgeApproximatorType, uint32, float32);
 #endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_MODELING_EXTERNAL_TEMPLATES_CPP_))
 
 } // namespace modeling
@@ -151,7 +151,7 @@ void doo_sabin(MAP& map, VERTEX_ATTR& position)
 				}
 				else
 				{
-					Scalar c2 = Scalar( (3.0+2.0*std::cos(2.0*M_PI*(Scalar(i-j))/Scalar(N))) /(4.0*N) );
+					Scalar c2 = Scalar( (3.0+2.0*std::cos(2.0*M_PI*(Scalar(i)-Scalar(j))/Scalar(N))) /(4.0*N) );
 					P += c2*buffer[j];
 				}
 			}
@@ -0,0 +1,714 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_MODELING_ALGOS_INDEXED_SUBDIVISION_H_
+#define CGOGN_MODELING_ALGOS_INDEXED_SUBDIVISION_H_
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+#include <cgogn/modeling/dll.h>
+#include <cgogn/core/utils/masks.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/geometry/types/geometry_traits.h>
+
+namespace cgogn
+{
+
+namespace modeling
+{
+
+/**
+ * @brief The IndexedSubdivision class subdivides a surface without building the refined combinatorial map.
+ * The surface is stored in flat arrays: the positions of the vertices and, for each face, a range of corners.
+ * The corner c is the half-edge of its face that starts at the vertex corner_vertex(c);
+ * its opposite corner in the adjacent face is corner_twin(c) (INVALID_INDEX on the boundary).
+ * Each level of Loop, Catmull-Clark or Doo-Sabin subdivision evaluates the stencils and writes the arrays
+ * of the next level in parallel (the new cells are numbered from the old ones, no search is needed).
+ * The result is given to the rendering buffers (see triangles) or to an importer when a map is needed (see export_surface).
+ */
+template <typename VEC3>
+class IndexedSubdivision
+{
+public:
+
+	using Self = IndexedSubdivision<VEC3>;
+	using Scalar = geometry::ScalarOf<VEC3>;
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(IndexedSubdivision);
+
+	/**
+	 * @brief copy the faces (boundary faces excluded) and the positions of the vertices of a surface map
+	 */
+	template <typename MAP, typename VERTEX_ATTR>
+	IndexedSubdivision(const MAP& map, const VERTEX_ATTR& position)
+	{
+		static_assert(MAP::DIMENSION == 2u, "IndexedSubdivision works only with 2D Maps.");
+		static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value, "position must be a vertex attribute");
+
+		using Vertex = typename MAP::Vertex;
+		using Face = typename MAP::Face;
+
+		CellCache<MAP> cache(map);
+		cache.template build<Vertex>();
+		cache.template build<Face>();
+		const std::vector<Dart>& vertices = cache.template cells<Vertex>();
+		const std::vector<Dart>& faces = cache.template cells<Face>();
+		const uint32 nb_v = uint32(vertices.size());
+		const uint32 nb_f = uint32(faces.size());
+		const uint32 nb_darts = map.topology_container().end();
+
+		std::vector<uint32> dart_vertex(nb_darts);
+		positions_.resize(nb_v);
+		parallel_for(0u, nb_v, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				positions_[i] = position[Vertex(vertices[i])];
+				map.foreach_dart_of_orbit(Vertex(vertices[i]), [&] (Dart d) { dart_vertex[d.index] = i; });
+			}
+		});
+
+		prefix_sum(nb_f, [&] (uint32 f) { return map.codegree(Face(faces[f])); }, face_offsets_);
+		const uint32 nb_c = face_offsets_[nb_f];
+
+		std::vector<uint32> dart_corner(nb_darts, INVALID_INDEX);
+		corner_vertex_.resize(nb_c);
+		corner_face_.resize(nb_c);
+		corner_twin_.resize(nb_c);
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+			{
+				uint32 c = face_offsets_[f];
+				map.foreach_dart_of_orbit(Face(faces[f]), [&] (Dart d)
+				{
+					dart_corner[d.index] = c;
+					corner_vertex_[c] = dart_vertex[d.index];
+					corner_face_[c] = f;
+					++c;
+				});
+			}
+		});
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+			{
+				map.foreach_dart_of_orbit(Face(faces[f]), [&] (Dart d)
+				{
+					corner_twin_[dart_corner[d.index]] = dart_corner[map.phi2(d).index];
+				});
+			}
+		});
+	}
+
+	inline uint32 nb_vertices() const { return uint32(positions_.size()); }
+	inline uint32 nb_faces() const { return uint32(face_offsets_.size()) - 1u; }
+	inline uint32 nb_corners() const { return uint32(corner_vertex_.size()); }
+
+	inline const std::vector<VEC3>& positions() const { return positions_; }
+
+	/**
+	 * @return the first corner of each face (and the number of corners at the end)
+	 */
+	inline const std::vector<uint32>& face_offsets() const { return face_offsets_; }
+
+	/**
+	 * @return the vertex of each corner: the vertices of the face f are face_vertices()[face_offsets()[f] .. face_offsets()[f+1]-1]
+	 */
+	inline const std::vector<uint32>& face_vertices() const { return corner_vertex_; }
+
+	inline uint32 corner_vertex(uint32 c) const { return corner_vertex_[c]; }
+	inline uint32 corner_twin(uint32 c) const { return corner_twin_[c]; }
+
+	/**
+	 * @brief apply nb_levels levels of Loop subdivision
+	 * @return false (the surface is unchanged) if a face is not a triangle
+	 */
+	bool loop(uint32 nb_levels = 1u)
+	{
+		for (uint32 f = 0u, nb_f = nb_faces(); f < nb_f; ++f)
+		{
+			if (face_offsets_[f + 1u] - face_offsets_[f] != 3u)
+				return false;
+		}
+		for (uint32 l = 0u; l < nb_levels; ++l)
+			loop_level();
+		return true;
+	}
+
+	/**
+	 * @brief apply nb_levels levels of Catmull-Clark subdivision
+	 */
+	void catmull_clark(uint32 nb_levels = 1u)
+	{
+		for (uint32 l = 0u; l < nb_levels; ++l)
+			catmull_clark_level();
+	}
+
+	/**
+	 * @brief apply nb_levels levels of Doo-Sabin subdivision
+	 * No face is created for the boundary edges and vertices, and the vertices of degree 2 do not create a face.
+	 */
+	void doo_sabin(uint32 nb_levels = 1u)
+	{
+		for (uint32 l = 0u; l < nb_levels; ++l)
+			doo_sabin_level();
+	}
+
+	/**
+	 * @brief fill indices with the vertices of a fan triangulation of the faces (for an index buffer)
+	 */
+	void triangles(std::vector<uint32>& indices) const
+	{
+		std::vector<uint32> offsets;
+		const uint32 nb_f = nb_faces();
+		const uint32 nb = prefix_sum(nb_f, [&] (uint32 f) { return 3u * (std::max(face_offsets_[f + 1u] - face_offsets_[f], 2u) - 2u); }, offsets);
+		indices.resize(nb);
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+			{
+				uint32 k = offsets[f];
+				for (uint32 c = face_offsets_[f] + 1u; c + 1u < face_offsets_[f + 1u]; ++c)
+				{
+					indices[k++] = corner_vertex_[face_offsets_[f]];
+					indices[k++] = corner_vertex_[c];
+					indices[k++] = corner_vertex_[c + 1u];
+				}
+			}
+		});
+	}
+
+	/**
+	 * @brief give the vertices (with their position) and the faces to an importer (e.g. a SurfaceImport)
+	 * The map is then built with import.create_map().
+	 */
+	template <typename IMPORT>
+	void export_surface(IMPORT& import, const std::string& position_name = "position") const
+	{
+		auto* position = import.template add_vertex_attribute<VEC3>(position_name);
+		const uint32 first_vertex = import.vertex_container().append_lines(nb_vertices());
+		parallel_for(0u, nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				(*position)[first_vertex + i] = positions_[i];
+		});
+
+		import.reserve(nb_faces());
+		std::vector<uint32> face;
+		for (uint32 f = 0u, nb_f = nb_faces(); f < nb_f; ++f)
+		{
+			face.clear();
+			for (uint32 c = face_offsets_[f]; c < face_offsets_[f + 1u]; ++c)
+				face.push_back(first_vertex + corner_vertex_[c]);
+			import.add_face(face);
+		}
+	}
+
+private:
+
+	/**
+	 * @brief offsets[i] = count(0) + ... + count(i-1) for i in [0, n] (counted in parallel by blocks)
+	 * @return the total count
+	 */
+	template <typename FUNC>
+	static uint32 prefix_sum(uint32 n, const FUNC& count, std::vector<uint32>& offsets)
+	{
+		const uint32 nb_blocks = (n + PARALLEL_BUFFER_SIZE - 1u) / PARALLEL_BUFFER_SIZE;
+		std::vector<uint32> block_offsets(nb_blocks + 1u, 0u);
+		offsets.resize(n + 1u);
+		parallel_for(0u, nb_blocks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 b = first; b < last; ++b)
+			{
+				uint32 sum = 0u;
+				for (uint32 i = b * PARALLEL_BUFFER_SIZE, end = std::min(n, (b + 1u) * PARALLEL_BUFFER_SIZE); i < end; ++i)
+				{
+					offsets[i] = sum;
+					sum += count(i);
+				}
+				block_offsets[b + 1u] = sum;
+			}
+		});
+		for (uint32 b = 0u; b < nb_blocks; ++b)
+			block_offsets[b + 1u] += block_offsets[b];
+		parallel_for(0u, nb_blocks, 1u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 b = first; b < last; ++b)
+			{
+				for (uint32 i = b * PARALLEL_BUFFER_SIZE, end = std::min(n, (b + 1u) * PARALLEL_BUFFER_SIZE); i < end; ++i)
+					offsets[i] += block_offsets[b];
+			}
+		});
+		offsets[n] = block_offsets[nb_blocks];
+		return offsets[n];
+	}
+
+	inline uint32 next(uint32 c) const
+	{
+		return c + 1u == face_offsets_[corner_face_[c] + 1u] ? face_offsets_[corner_face_[c]] : c + 1u;
+	}
+
+	inline uint32 prev(uint32 c) const
+	{
+		return c == face_offsets_[corner_face_[c]] ? face_offsets_[corner_face_[c] + 1u] - 1u : c - 1u;
+	}
+
+	/**
+	 * @return the next corner that starts at the vertex of c (INVALID_INDEX on the boundary)
+	 */
+	inline uint32 rotate(uint32 c) const
+	{
+		return corner_twin_[prev(c)];
+	}
+
+	/**
+	 * @brief number the edges from their corners (the lowest corner of an inner edge)
+	 * @return the number of edges
+	 */
+	uint32 number_edges(std::vector<uint32>& edge_index) const
+	{
+		const uint32 nb_e = prefix_sum(nb_corners(), [&] (uint32 c) { return uint32(corner_twin_[c] > c); }, edge_index);
+		parallel_for(0u, nb_corners(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+			{
+				if (corner_twin_[c] < c)
+					edge_index[c] = edge_index[corner_twin_[c]];
+			}
+		});
+		return nb_e;
+	}
+
+	/**
+	 * @brief give to each vertex its first corner around it (the one after the boundary for the boundary vertices)
+	 */
+	void first_corners(std::vector<uint32>& vertex_corner) const
+	{
+		vertex_corner.assign(nb_vertices(), INVALID_INDEX);
+		parallel_for(0u, nb_corners(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+			{
+				bool is_first = true;
+				if (corner_twin_[c] != INVALID_INDEX)
+				{
+					uint32 r = c;
+					do
+					{
+						r = rotate(r);
+						is_first = r != INVALID_INDEX && r >= c;
+					} while (is_first && r != c);
+				}
+				if (is_first)
+					vertex_corner[corner_vertex_[c]] = c;
+			}
+		});
+	}
+
+	/**
+	 * @brief call f(c) for the corners around the vertex of the first corner c0
+	 * @return true if the vertex is on the boundary
+	 */
+	template <typename FUNC>
+	inline bool foreach_vertex_corner(uint32 c0, const FUNC& f) const
+	{
+		uint32 c = c0;
+		do
+		{
+			f(c);
+			c = rotate(c);
+		} while (c != INVALID_INDEX && c != c0);
+		return c == INVALID_INDEX;
+	}
+
+	/**
+	 * @brief position of a boundary vertex from its first corner (3/4 v + 1/8 of its two neighbors on the boundary)
+	 */
+	inline VEC3 boundary_vertex_point(uint32 c0) const
+	{
+		uint32 last = c0;
+		foreach_vertex_corner(c0, [&] (uint32 c) { last = c; });
+		return Scalar(3.0/4.0) * positions_[corner_vertex_[c0]] +
+			Scalar(1.0/8.0) * (positions_[corner_vertex_[next(c0)]] + positions_[corner_vertex_[prev(last)]]);
+	}
+
+	/**
+	 * Each triangle (v0, v1, v2) of corners c0, c1, c2 and edge points m0, m1, m2 gives the faces
+	 * (v_k, m_k, m_k-1) for k = 0..2 (corners 12f+3k .. 12f+3k+2) and (m0, m1, m2) (corners 12f+9 .. 12f+11).
+	 */
+	void loop_level()
+	{
+		const uint32 nb_v = nb_vertices();
+		const uint32 nb_f = nb_faces();
+		std::vector<uint32> edge_index;
+		const uint32 nb_e = number_edges(edge_index);
+		std::vector<uint32> vertex_corner;
+		first_corners(vertex_corner);
+
+		std::vector<VEC3> positions(nb_v + nb_e);
+		parallel_for(0u, nb_v, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 v = first; v < last; ++v)
+			{
+				const uint32 c0 = vertex_corner[v];
+				positions[v] = positions_[v];
+				if (c0 == INVALID_INDEX)
+					continue;
+				VEC3 sum_edge;
+				sum_edge.setZero();
+				uint32 nb = 0u;
+				if (foreach_vertex_corner(c0, [&] (uint32 c) { sum_edge += positions_[corner_vertex_[next(c)]]; ++nb; }))
+					positions[v] = boundary_vertex_point(c0);
+				else
+				{
+					float64 beta = 3.0 / 16.0;
+					if (nb > 3u)
+						beta = 3.0 / (8.0 * nb);
+					positions[v] = Scalar(beta) * sum_edge + Scalar(1.0 - beta * nb) * positions_[v];
+				}
+			}
+		});
+		parallel_for(0u, nb_corners(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+			{
+				const uint32 t = corner_twin_[c];
+				if (t != INVALID_INDEX && t < c)
+					continue;
+				const VEC3& p1 = positions_[corner_vertex_[c]];
+				const VEC3& p2 = positions_[corner_vertex_[next(c)]];
+				if (t == INVALID_INDEX)
+					positions[nb_v + edge_index[c]] = Scalar(0.5) * (p1 + p2);
+				else
+					positions[nb_v + edge_index[c]] = Scalar(3.0/8.0) * (p1 + p2) +
+						Scalar(1.0/8.0) * (positions_[corner_vertex_[prev(c)]] + positions_[corner_vertex_[prev(t)]]);
+			}
+		});
+
+		std::vector<uint32> corner_vertex(12u * nb_f);
+		std::vector<uint32> corner_twin(12u * nb_f);
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+			{
+				const uint32 base = 12u * f;
+				for (uint32 k = 0u; k < 3u; ++k)
+				{
+					const uint32 c = 3u * f + k;
+					const uint32 c_prev = 3u * f + (k + 2u) % 3u;
+					const uint32 t = corner_twin_[c];
+					const uint32 t_prev = corner_twin_[c_prev];
+					corner_vertex[base + 3u * k] = corner_vertex_[c];
+					corner_vertex[base + 3u * k + 1u] = nb_v + edge_index[c];
+					corner_vertex[base + 3u * k + 2u] = nb_v + edge_index[c_prev];
+					corner_vertex[base + 9u + k] = nb_v + edge_index[c];
+					corner_twin[base + 3u * k] = t == INVALID_INDEX ? INVALID_INDEX : 12u * (t / 3u) + 3u * ((t + 1u) % 3u) + 2u;
+					corner_twin[base + 3u * k + 1u] = base + 9u + (k + 2u) % 3u;
+					corner_twin[base + 3u * k + 2u] = t_prev == INVALID_INDEX ? INVALID_INDEX : 12u * (t_prev / 3u) + 3u * (t_prev % 3u);
+					corner_twin[base + 9u + k] = base + 3u * ((k + 1u) % 3u) + 1u;
+				}
+			}
+		});
+
+		set_faces(std::move(positions), 4u * nb_f, 3u, std::move(corner_vertex), std::move(corner_twin));
+	}
+
+	/**
+	 * Each corner c of the face f, from v_k to v_k+1, gives the quad (v_k, m_k, F, m_k-1) (corners 4c .. 4c+3)
+	 * where m_k is the edge point of c, m_k-1 the one of prev(c) and F the face point of f.
+	 */
+	void catmull_clark_level()
+	{
+		const uint32 nb_v = nb_vertices();
+		const uint32 nb_f = nb_faces();
+		const uint32 nb_c = nb_corners();
+		std::vector<uint32> edge_index;
+		const uint32 nb_e = number_edges(edge_index);
+		std::vector<uint32> vertex_corner;
+		first_corners(vertex_corner);
+
+		std::vector<VEC3> positions(nb_v + nb_e + nb_f);
+		const uint32 first_face_point = nb_v + nb_e;
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+			{
+				VEC3 center;
+				center.setZero();
+				for (uint32 c = face_offsets_[f]; c < face_offsets_[f + 1u]; ++c)
+					center += positions_[corner_vertex_[c]];
+				positions[first_face_point + f] = center / Scalar(face_offsets_[f + 1u] - face_offsets_[f]);
+			}
+		});
+		parallel_for(0u, nb_c, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+			{
+				const uint32 t = corner_twin_[c];
+				if (t != INVALID_INDEX && t < c)
+					continue;
+				VEC3& p = positions[nb_v + edge_index[c]];
+				p = positions_[corner_vertex_[c]] + positions_[corner_vertex_[next(c)]];
+				if (t == INVALID_INDEX)
+					p /= Scalar(2);
+				else
+					p = (p + positions[first_face_point + corner_face_[c]] + positions[first_face_point + corner_face_[t]]) / Scalar(4);
+			}
+		});
+		parallel_for(0u, nb_v, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 v = first; v < last; ++v)
+			{
+				const uint32 c0 = vertex_corner[v];
+				positions[v] = positions_[v];
+				if (c0 == INVALID_INDEX)
+					continue;
+				VEC3 sum_face;
+				sum_face.setZero();
+				VEC3 sum_edge;
+				sum_edge.setZero();
+				int nb = 0;
+				if (foreach_vertex_corner(c0, [&] (uint32 c)
+				{
+					sum_edge += positions[nb_v + edge_index[c]];
+					sum_face += positions[first_face_point + corner_face_[c]];
+					++nb;
+				}))
+					positions[v] = boundary_vertex_point(c0);
+				else
+				{
+					VEC3 delta = positions_[v] * Scalar(-3 * nb);
+					delta += sum_face + Scalar(2) * sum_edge;
+					delta /= Scalar(nb * nb);
+					positions[v] = positions_[v] + delta;
+				}
+			}
+		});
+
+		std::vector<uint32> corner_vertex(4u * nb_c);
+		std::vector<uint32> corner_twin(4u * nb_c);
+		parallel_for(0u, nb_c, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+			{
+				const uint32 c_prev = prev(c);
+				const uint32 t = corner_twin_[c];
+				const uint32 t_prev = corner_twin_[c_prev];
+				corner_vertex[4u * c] = corner_vertex_[c];
+				corner_vertex[4u * c + 1u] = nb_v + edge_index[c];
+				corner_vertex[4u * c + 2u] = first_face_point + corner_face_[c];
+				corner_vertex[4u * c + 3u] = nb_v + edge_index[c_prev];
+				corner_twin[4u * c] = t == INVALID_INDEX ? INVALID_INDEX : 4u * next(t) + 3u;
+				corner_twin[4u * c + 1u] = 4u * next(c) + 2u;
+				corner_twin[4u * c + 2u] = 4u * c_prev + 1u;
+				corner_twin[4u * c + 3u] = t_prev == INVALID_INDEX ? INVALID_INDEX : 4u * t_prev;
+			}
+		});
+
+		set_faces(std::move(positions), nb_c, 4u, std::move(corner_vertex), std::move(corner_twin));
+	}
+
+	/**
+	 * The corner c of the old surface gives the new vertex c. The new faces are:
+	 *  - the face f made of the (new vertices of the) corners of f (same corners),
+	 *  - for the inner edge of the corners c < t, the quad (next(c), c, next(t), t) (corners nb_c + 4e .. nb_c + 4e+3),
+	 *  - for the inner vertex of degree n > 2, the face of its n corners in the order of rotate (corners after the quads).
+	 */
+	void doo_sabin_level()
+	{
+		const uint32 nb_v = nb_vertices();
+		const uint32 nb_f = nb_faces();
+		const uint32 nb_c = nb_corners();
+		std::vector<uint32> vertex_corner;
+		first_corners(vertex_corner);
+
+		std::vector<VEC3> positions(nb_c);
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+			{
+				const uint32 begin = face_offsets_[f];
+				const uint32 n = face_offsets_[f + 1u] - begin;
+				for (uint32 i = 0u; i < n; ++i)
+				{
+					VEC3 p;
+					p.setZero();
+					for (uint32 j = 0u; j < n; ++j)
+					{
+						if (j == i)
+							p += positions_[corner_vertex_[begin + j]] * Scalar(Scalar(n + 5u) / Scalar(4u * n));
+						else
+							p += positions_[corner_vertex_[begin + j]] * Scalar((3.0 + 2.0 * std::cos(2.0 * M_PI * (float64(i) - float64(j)) / float64(n))) / (4.0 * n));
+					}
+					positions[begin + i] = p;
+				}
+			}
+		});
+
+		// degree of the inner vertices (0 for the boundary vertices), rank of their corners
+		std::vector<uint32> degree(nb_v, 0u);
+		std::vector<uint32> rank(nb_c);
+		parallel_for(0u, nb_v, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 v = first; v < last; ++v)
+			{
+				if (vertex_corner[v] == INVALID_INDEX)
+					continue;
+				uint32 n = 0u;
+				if (!foreach_vertex_corner(vertex_corner[v], [&] (uint32 c) { rank[c] = n++; }))
+					degree[v] = n;
+			}
+		});
+		const auto has_face = [&] (uint32 v) { return degree[v] > 2u; };
+
+		std::vector<uint32> inner_edge_index;
+		const uint32 nb_inner_e = prefix_sum(nb_c, [&] (uint32 c) { return uint32(corner_twin_[c] != INVALID_INDEX && corner_twin_[c] > c); }, inner_edge_index);
+		std::vector<uint32> vertex_face_index;
+		const uint32 nb_vertex_faces = prefix_sum(nb_v, [&] (uint32 v) { return uint32(has_face(v)); }, vertex_face_index);
+		std::vector<uint32> vertex_face_offsets;
+		const uint32 nb_vertex_corners = prefix_sum(nb_v, [&] (uint32 v) { return has_face(v) ? degree[v] : 0u; }, vertex_face_offsets);
+
+		const uint32 first_edge_corner = nb_c;
+		const uint32 first_vertex_corner = nb_c + 4u * nb_inner_e;
+		const uint32 nb_new_c = first_vertex_corner + nb_vertex_corners;
+
+		// corner of the quad of the inner edge of c that goes from c to next(twin(c))
+		const auto edge_out = [&] (uint32 c) -> uint32
+		{
+			const uint32 t = corner_twin_[c];
+			return c < t ? first_edge_corner + 4u * inner_edge_index[c] + 1u : first_edge_corner + 4u * inner_edge_index[t] + 3u;
+		};
+		// opposite corner of edge_out(c)
+		const auto edge_out_twin = [&] (uint32 c) -> uint32
+		{
+			const uint32 v = corner_vertex_[c];
+			const uint32 y = next(corner_twin_[c]);
+			if (has_face(v))
+				return first_vertex_corner + vertex_face_offsets[v] + rank[y];
+			if (degree[v] == 2u)
+				return edge_out(y);
+			return INVALID_INDEX;
+		};
+
+		std::vector<uint32> corner_vertex(nb_new_c);
+		std::vector<uint32> corner_twin(nb_new_c);
+		std::vector<uint32> face_offsets(nb_f + nb_inner_e + nb_vertex_faces + 1u);
+		parallel_for(0u, nb_c, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 c = first; c < last; ++c)
+			{
+				const uint32 t = corner_twin_[c];
+				corner_vertex[c] = c;
+				corner_twin[c] = t == INVALID_INDEX ? INVALID_INDEX : first_edge_corner + 4u * inner_edge_index[std::min(c, t)] + (c < t ? 0u : 2u);
+				if (t == INVALID_INDEX || t < c)
+					continue;
+				const uint32 e = first_edge_corner + 4u * inner_edge_index[c];
+				face_offsets[nb_f + inner_edge_index[c]] = e;
+				corner_vertex[e] = next(c);
+				corner_vertex[e + 1u] = c;
+				corner_vertex[e + 2u] = next(t);
+				corner_vertex[e + 3u] = t;
+				corner_twin[e] = c;
+				corner_twin[e + 1u] = edge_out_twin(c);
+				corner_twin[e + 2u] = t;
+				corner_twin[e + 3u] = edge_out_twin(t);
+			}
+		});
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+				face_offsets[f] = face_offsets_[f];
+		});
+		parallel_for(0u, nb_v, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 v = first; v < last; ++v)
+			{
+				if (!has_face(v))
+					continue;
+				const uint32 base = first_vertex_corner + vertex_face_offsets[v];
+				face_offsets[nb_f + nb_inner_e + vertex_face_index[v]] = base;
+				foreach_vertex_corner(vertex_corner[v], [&] (uint32 y)
+				{
+					corner_vertex[base + rank[y]] = y;
+					corner_twin[base + rank[y]] = edge_out(rotate(y));
+				});
+			}
+		});
+		face_offsets.back() = nb_new_c;
+
+		positions_.swap(positions);
+		face_offsets_.swap(face_offsets);
+		corner_vertex_.swap(corner_vertex);
+		corner_twin_.swap(corner_twin);
+		update_corner_faces();
+	}
+
+	/**
+	 * @brief replace the surface by nb_faces faces of the same degree
+	 */
+	void set_faces(std::vector<VEC3>&& positions, uint32 nb_new_faces, uint32 degree, std::vector<uint32>&& corner_vertex, std::vector<uint32>&& corner_twin)
+	{
+		positions_ = std::move(positions);
+		corner_vertex_ = std::move(corner_vertex);
+		corner_twin_ = std::move(corner_twin);
+		face_offsets_.resize(nb_new_faces + 1u);
+		parallel_for(0u, nb_new_faces + 1u, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+				face_offsets_[f] = degree * f;
+		});
+		update_corner_faces();
+	}
+
+	void update_corner_faces()
+	{
+		corner_face_.resize(nb_corners());
+		parallel_for(0u, nb_faces(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 f = first; f < last; ++f)
+				std::fill(corner_face_.begin() + face_offsets_[f], corner_face_.begin() + face_offsets_[f + 1u], f);
+		});
+	}
+
+	std::vector<VEC3> positions_;
+	std::vector<uint32> face_offsets_;
+	std::vector<uint32> corner_vertex_;
+	std::vector<uint32> corner_face_;
+	std::vector<uint32> corner_twin_;
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_MODELING_EXTERNAL_TEMPLATES_CPP_))
+extern template class CGOGN_MODELING_API IndexedSubdivision<Eigen::Vector3f>;
+extern template class CGOGN_MODELING_API IndexedSubdivision<Eigen::Vector3d>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_MODELING_EXTERNAL_TEMPLATES_CPP_))
+
+} // namespace modeling
+
+} // namespace cgogn
+
+#endif // CGOGN_MODELING_ALGOS_INDEXED_SUBDIVISION_H_
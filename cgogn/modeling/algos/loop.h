@@ -31,6 +31,7 @@
 #include <cgogn/core/utils/masks.h>
 #include <cgogn/core/cmap/cmap3.h>
 #include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/modeling/algos/subdivision_plan.h>
 
 namespace cgogn
 {
@@ -38,6 +39,11 @@ namespace cgogn
 namespace modeling
 {
 
+/**
+ * @brief Loop subdivision of a triangle mesh
+ * The new positions are computed in parallel on the initial mesh, then the topology is refined:
+ * in one batch with a SubdivisionPlan when possible, with cut_edge and cut_face otherwise.
+ */
 template <typename MAP, typename VERTEX_ATTR>
 void loop(MAP& map, VERTEX_ATTR& position)
 {
@@ -51,33 +57,36 @@ void loop(MAP& map, VERTEX_ATTR& position)
 
 	VERTEX_ATTR position2 = map.template add_attribute<VEC3, Vertex>("position_tempo_loop");
 
-	DartMarker<MAP> initial_edge_marker(map);
-
 	CellCache<MAP> initial_cache(map);
 	initial_cache.template build<Vertex>();
 	initial_cache.template build<Edge>();
 	initial_cache.template build<Face>();
 
-	map.foreach_cell([&] (Edge e) {	initial_edge_marker.mark_orbit(e); }, initial_cache);
-
-	// cut edges
-	map.foreach_cell([&] (Edge e) { map.cut_edge(e); }, initial_cache);
+	SubdivisionPlan<MAP> plan(map, initial_cache);
 
 	// compute position of new edge points
-	map.foreach_cell([&] (Edge e)
+	std::vector<VEC3> edge_points(plan.nb_edges());
+	parallel_for(0u, plan.nb_edges(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
 	{
-		Vertex v1(e.dart);
-		Vertex v2(map.template phi<12>(e.dart));
-		Vertex nve(map.phi1(e.dart));
-		Vertex vr(map.template phi<2111>(e.dart));
-		Vertex vl(map.phi_1(map.phi_1(e.dart)));
-
-		position2[nve] = Scalar(3.0/8.0) * (position[v1] + position[v2]) + Scalar(1.0/8.0) * (position[vr] + position[vl]);
-	}
-	, initial_cache);
+		for (uint32 i = first; i < last; ++i)
+		{
+			const Dart d = plan.edges()[i];
+			const Dart e = map.phi2(d);
+			Vertex v1(d);
+			Vertex v2(e);
+			if (map.is_boundary(d) || map.is_boundary(e))
+				edge_points[i] = Scalar(0.5) * (position[v1] + position[v2]);
+			else
+			{
+				Vertex vr(map.phi_1(e));
+				Vertex vl(map.phi_1(d));
+				edge_points[i] = Scalar(3.0/8.0) * (position[v1] + position[v2]) + Scalar(1.0/8.0) * (position[vr] + position[vl]);
+			}
+		}
+	});
 
 	// compute new position of old vertices
-	map.foreach_cell([&] (Vertex v)
+	map.parallel_foreach_cell([&] (Vertex v)
 	{
 		VEC3 sum_edge;// Sum_E
 		sum_edge.setZero();
@@ -87,14 +96,14 @@ void loop(MAP& map, VERTEX_ATTR& position)
 		map.foreach_incident_edge(v, [&] (Edge e)
 		{
 			nb_e++;
-			sum_edge += position[Vertex(map.template phi<12>(e.dart))];
+			sum_edge += position[Vertex(map.phi2(e.dart))];
 			if (map.is_boundary(e.dart))
 				bound = e.dart;
 		});
 
 		if (!bound.is_nil()) // boundary case
 		{
-			Vertex e1(map.phi2(bound));
+			Vertex e1(map.phi1(bound));
 			Vertex e2(map.phi_1(bound));
 			position2[v] = Scalar(3.0/4.0) * position[v] + Scalar(1.0/8.0) * (position[e1]+position[e2]);
 		}
@@ -108,25 +117,43 @@ void loop(MAP& map, VERTEX_ATTR& position)
 	},
 	initial_cache);
 
-	// add edges inside faces
-	map.foreach_cell([&] (Face f)
+	if (plan.refine_loop())
+	{
+		parallel_for(0u, plan.nb_edges(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				position[plan.edge_vertex(i)] = edge_points[i];
+		});
+	}
+	else
 	{
-		Dart d0 = f.dart;
-		if (initial_edge_marker.is_marked(d0))
-			d0 = map.phi1(d0);
+		DartMarker<MAP> initial_edge_marker(map);
+		map.foreach_cell([&] (Edge e) {	initial_edge_marker.mark_orbit(e); }, initial_cache);
 
-		Dart d1 = map.template phi<11>(d0);
-		map.cut_face(d0, d1);
+		// cut edges
+		for (uint32 i = 0u; i < plan.nb_edges(); ++i)
+			position[map.cut_edge(Edge(plan.edges()[i]))] = edge_points[i];
 
-		Dart d2 = map.template phi<11>(d1);
-		map.cut_face(d1, d2);
+		// add edges inside faces
+		map.foreach_cell([&] (Face f)
+		{
+			Dart d0 = f.dart;
+			if (initial_edge_marker.is_marked(d0))
+				d0 = map.phi1(d0);
 
-		Dart d3 = map.template phi<11>(d2);
-		map.cut_face(d2, d3);
-	},
-	initial_cache);
+			Dart d1 = map.template phi<11>(d0);
+			map.cut_face(d0, d1);
+
+			Dart d2 = map.template phi<11>(d1);
+			map.cut_face(d1, d2);
+
+			Dart d3 = map.template phi<11>(d2);
+			map.cut_face(d2, d3);
+		},
+		initial_cache);
+	}
 
-	map.swap_attributes(position, position2);
+	map.parallel_foreach_cell([&] (Vertex v) { position[v] = position2[v]; }, initial_cache);
 	map.remove_attribute(position2);
 }
 
@@ -0,0 +1,660 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_MODELING_ALGOS_STREAMING_DECIMATION_H_
+#define CGOGN_MODELING_ALGOS_STREAMING_DECIMATION_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cgogn/core/utils/mapped_file.h>
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+
+#include <cgogn/modeling/algos/decimation.h>
+
+#include <cgogn/io/surface_import.h>
+#include <cgogn/io/surface_stream.h>
+
+namespace cgogn
+{
+
+namespace modeling
+{
+
+class StreamingDecimationOptions final
+{
+public:
+
+	inline StreamingDecimationOptions() :
+		ratio_(0.1f),
+		memory_budget_(std::size_t(1u) << 30u),
+		nb_passes_(2u),
+		binary_(true)
+	{}
+
+	inline StreamingDecimationOptions& ratio(float32 r) { ratio_ = r; return *this; }
+	inline StreamingDecimationOptions& memory_budget(std::size_t bytes) { memory_budget_ = bytes; return *this; }
+	inline StreamingDecimationOptions& nb_passes(uint32 nb) { nb_passes_ = nb; return *this; }
+	inline StreamingDecimationOptions& binary(bool b) { binary_ = b; return *this; }
+
+	/// fraction of the vertices of the input kept in the output
+	float32 ratio_;
+	/// memory (in bytes) used by the map of a chunk
+	std::size_t memory_budget_;
+	/// number of decimations of the whole mesh, the chunks boundaries moving from one pass to the next
+	uint32 nb_passes_;
+	/// write a binary output file
+	bool binary_;
+};
+
+namespace internal
+{
+
+/// estimated memory used by a triangle of a chunk: darts, vertex attributes, quadrics and decimation heap
+const std::size_t STREAMING_DECIMATION_BYTES_PER_FACE = 512u;
+
+/**
+ * @brief The StreamingChunkGrid class distributes faces in chunks of at most max_faces faces by the position of their centroid.
+ * The bounding box is divided in GRID_SIZE^3 cells and the cells with more than max_faces faces are recursively
+ * divided in SUBGRID_SIZE^3 cells (MAX_DEPTH times at most). The chunks are the ranges of cells, in Morton order,
+ * whose faces fit in max_faces. The faces of a cell still too dense at the last level are split in several chunks by their order.
+ * The faces are counted (count) as long as refine() divides cells, then the chunks are assigned (assign_chunks)
+ * and the faces are given to their chunk (chunk) in the same order as they have been counted.
+ */
+class StreamingChunkGrid final
+{
+public:
+
+	using Position = std::array<float64, 3>;
+
+	/// number of cells of the grid on each axis (6 bits per coordinate in the Morton codes)
+	static const uint32 GRID_SIZE = 64u;
+	/// number of sub-cells on each axis of a divided cell (3 bits per coordinate in the Morton codes)
+	static const uint32 SUBGRID_SIZE = 8u;
+	/// maximal number of divisions of a cell
+	static const uint32 MAX_DEPTH = 4u;
+
+	/**
+	 * @param origin the corner of the grid
+	 * @param inv_cell_size the inverse of the size of the cells of the grid on each axis
+	 * @param max_faces maximal number of faces of a chunk
+	 */
+	inline StreamingChunkGrid(const Position& origin, const Position& inv_cell_size, std::size_t max_faces) :
+		origin_(origin),
+		inv_cell_size_(inv_cell_size),
+		max_faces_(std::max(max_faces, std::size_t(1u)))
+	{
+		add_node(GRID_SIZE, 0u);
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(StreamingChunkGrid);
+
+	inline void count(const Position& centroid)
+	{
+		const std::pair<uint32, uint32> l = leaf(centroid);
+		++nodes_[l.first].value[l.second];
+	}
+
+	/**
+	 * @brief divide the cells with more than max_faces faces (that are not at the last level) and reset the counts
+	 * @return true if cells have been divided: the faces must be counted again
+	 */
+	inline bool refine()
+	{
+		bool refined = false;
+		for (uint32 n = 0u, nb_nodes = uint32(nodes_.size()); n < nb_nodes; ++n)
+		{
+			if (nodes_[n].depth == MAX_DEPTH)
+				continue;
+			for (uint32 code = 0u, nb_cells = uint32(nodes_[n].value.size()); code < nb_cells; ++code)
+			{
+				if (nodes_[n].child[code] < 0 && nodes_[n].value[code] > max_faces_)
+				{
+					const int32 child = int32(add_node(SUBGRID_SIZE, nodes_[n].depth + 1u));
+					nodes_[n].child[code] = child;
+					refined = true;
+				}
+			}
+		}
+		if (refined)
+		{
+			for (Node& node : nodes_)
+				std::fill(node.value.begin(), node.value.end(), 0u);
+		}
+		return refined;
+	}
+
+	/**
+	 * @brief gather the cells in chunks
+	 * @return the number of chunks
+	 */
+	inline uint32 assign_chunks()
+	{
+		uint32 nb_chunks = 0u;
+		std::size_t nb_chunk_faces = 0u;
+		std::function<void(uint32)> visit = [&] (uint32 n)
+		{
+			for (uint32 code = 0u, nb_cells = uint32(nodes_[n].value.size()); code < nb_cells; ++code)
+			{
+				if (nodes_[n].child[code] >= 0)
+				{
+					visit(uint32(nodes_[n].child[code]));
+					continue;
+				}
+				uint32& v = nodes_[n].value[code];
+				const std::size_t nb = v;
+				if (nb > max_faces_)
+				{
+					// dense cell: chunks of its own
+					if (nb_chunk_faces > 0u)
+						++nb_chunks;
+					v = nb_chunks;
+					dense_cells_[key(n, code)] = 0u;
+					nb_chunks += uint32((nb - 1u) / max_faces_);
+					nb_chunk_faces = nb - (nb - 1u) / max_faces_ * max_faces_;
+					continue;
+				}
+				if (nb_chunk_faces > 0u && nb_chunk_faces + nb > max_faces_)
+				{
+					++nb_chunks;
+					nb_chunk_faces = 0u;
+				}
+				nb_chunk_faces += nb;
+				v = nb_chunks;
+			}
+		};
+		visit(0u);
+		return nb_chunks + 1u;
+	}
+
+	/**
+	 * @return the chunk of the next face of centroid c (after assign_chunks)
+	 */
+	inline uint32 chunk(const Position& centroid)
+	{
+		const std::pair<uint32, uint32> l = leaf(centroid);
+		const uint32 first = nodes_[l.first].value[l.second];
+		auto it = dense_cells_.find(key(l.first, l.second));
+		if (it == dense_cells_.end())
+			return first;
+		return first + uint32(it->second++ / max_faces_);
+	}
+
+	inline uint32 nb_nodes() const { return uint32(nodes_.size()); }
+
+	static inline uint32 morton_code(const std::array<uint32, 3>& cell, uint32 nb_bits)
+	{
+		uint32 code = 0u;
+		for (uint32 b = 0u; b < nb_bits; ++b)
+			for (uint32 k = 0u; k < 3u; ++k)
+				code |= ((cell[k] >> b) & 1u) << (3u * b + k);
+		return code;
+	}
+
+private:
+
+	// cells of the grid or of a divided cell: number of faces (then first chunk) and division of each cell
+	struct Node
+	{
+		uint32 size;
+		uint32 nb_bits;
+		uint32 depth;
+		std::vector<uint32> value;
+		std::vector<int32> child;
+	};
+
+	inline uint32 add_node(uint32 size, uint32 depth)
+	{
+		Node node;
+		node.size = size;
+		node.nb_bits = 0u;
+		while ((1u << node.nb_bits) < size)
+			++node.nb_bits;
+		node.depth = depth;
+		node.value.assign(size * size * size, 0u);
+		node.child.assign(size * size * size, -1);
+		nodes_.push_back(std::move(node));
+		return uint32(nodes_.size()) - 1u;
+	}
+
+	static inline uint64 key(uint32 node, uint32 code)
+	{
+		return (uint64(node) << 32u) | uint64(code);
+	}
+
+	// node and Morton code of the (not divided) cell that contains p
+	inline std::pair<uint32, uint32> leaf(const Position& p) const
+	{
+		Position x;
+		for (uint32 k = 0u; k < 3u; ++k)
+			x[k] = (p[k] - origin_[k]) * inv_cell_size_[k];
+		uint32 n = 0u;
+		while (true)
+		{
+			const Node& node = nodes_[n];
+			std::array<uint32, 3> cell;
+			for (uint32 k = 0u; k < 3u; ++k)
+				cell[k] = uint32(std::min(std::max(x[k], 0.0), float64(node.size - 1u)));
+			const uint32 code = morton_code(cell, node.nb_bits);
+			if (node.child[code] < 0)
+				return std::make_pair(n, code);
+			for (uint32 k = 0u; k < 3u; ++k)
+				x[k] = (x[k] - float64(cell[k])) * float64(SUBGRID_SIZE);
+			n = uint32(node.child[code]);
+		}
+	}
+
+	Position origin_;
+	Position inv_cell_size_;
+	std::size_t max_faces_;
+	std::vector<Node> nodes_;
+	std::unordered_map<uint64, std::size_t> dense_cells_;
+};
+
+/**
+ * @brief decimate the surface of the input file in chunks and write the result in the output file
+ * The faces are distributed in chunks of at most memory_budget / STREAMING_DECIMATION_BYTES_PER_FACE faces (see StreamingChunkGrid).
+ * Each chunk is decimated with the QEM, its boundary (the vertices shared with other chunks) being locked,
+ * then written in the output where the locked vertices of the different chunks are merged.
+ * @param target the number of vertices of the decimated surface
+ * @param pass the index of the pass, that shifts the grid
+ */
+template <typename VEC3>
+bool streaming_decimation_pass(const std::string& input, const std::string& output, uint32 target, uint32 pass, bool binary, std::size_t memory_budget)
+{
+	using Scalar = typename geometry::vector_traits<VEC3>::Scalar;
+	using Vertex = CMap2::Vertex;
+	using Face = CMap2::Face;
+	using Position = std::array<float64, 3>;
+
+	std::unique_ptr<io::SurfaceStreamReader> reader = io::SurfaceStreamReader::open(input);
+	if (!reader)
+		return false;
+	const uint32 nb_vertices = reader->nb_vertices();
+	const uint32 nb_faces = reader->nb_faces();
+
+	io::SurfaceStreamWriter writer(output, binary);
+	if (!writer.good())
+	{
+		cgogn_log_error("streaming_decimate") << "Unable to write the file \"" << output << "\".";
+		return false;
+	}
+	if (nb_vertices == 0u || nb_faces == 0u)
+		return writer.close();
+
+	// the positions are copied in a file mapped in memory for the random accesses
+	const std::string positions_filename = output + ".positions.tmp";
+	Position bb_min, bb_max;
+	bb_min.fill(std::numeric_limits<float64>::max());
+	bb_max.fill(std::numeric_limits<float64>::lowest());
+	{
+		std::ofstream positions_file(positions_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		Position p;
+		for (uint32 i = 0u; i < nb_vertices && reader->read_vertex(p); ++i)
+		{
+			positions_file.write(reinterpret_cast<const char*>(p.data()), sizeof(p));
+			for (uint32 k = 0u; k < 3u; ++k)
+			{
+				bb_min[k] = std::min(bb_min[k], p[k]);
+				bb_max[k] = std::max(bb_max[k], p[k]);
+			}
+		}
+		if (!positions_file.good() || std::size_t(positions_file.tellp()) != nb_vertices * sizeof(Position))
+		{
+			cgogn_log_error("streaming_decimate") << "Unable to read the vertices of \"" << input << "\".";
+			positions_file.close();
+			std::remove(positions_filename.c_str());
+			return false;
+		}
+	}
+	std::shared_ptr<MappedFile> positions_file = MappedFile::open(positions_filename);
+	if (!positions_file)
+	{
+		std::remove(positions_filename.c_str());
+		return false;
+	}
+	const Position* positions = reinterpret_cast<const Position*>(positions_file->data());
+
+	// the faces are sorted in the cells of a grid by their centroid,
+	// the grid being shifted by half a chunk at odd passes
+	const std::size_t faces_per_chunk = std::max(std::size_t(1u), memory_budget / STREAMING_DECIMATION_BYTES_PER_FACE);
+	const float64 chunk_extent = 1.0 / std::cbrt(float64((nb_faces + faces_per_chunk - 1u) / faces_per_chunk));
+	Position origin, inv_cell_size;
+	for (uint32 k = 0u; k < 3u; ++k)
+	{
+		const float64 extent = std::max(bb_max[k] - bb_min[k], std::numeric_limits<float64>::min());
+		const float64 shift = pass % 2u == 1u ? 0.5 * chunk_extent * extent : 0.0;
+		origin[k] = bb_min[k] - shift;
+		inv_cell_size[k] = float64(StreamingChunkGrid::GRID_SIZE) / (extent + shift);
+	}
+	auto face_centroid = [&] (const std::vector<uint32>& indices) -> Position
+	{
+		Position c = {{ 0.0, 0.0, 0.0 }};
+		for (uint32 i : indices)
+			for (uint32 k = 0u; k < 3u; ++k)
+				c[k] += positions[i][k];
+		for (uint32 k = 0u; k < 3u; ++k)
+			c[k] /= float64(indices.size());
+		return c;
+	};
+
+	// the faces are counted in the cells, again each time the dense cells are divided
+	StreamingChunkGrid grid(origin, inv_cell_size, faces_per_chunk);
+	std::vector<uint32> face;
+	for (bool first = true; ; first = false)
+	{
+		bool ok = true;
+		if (!first)
+		{
+			reader = io::SurfaceStreamReader::open(input);
+			ok = reader && reader->skip_vertices();
+		}
+		for (uint32 i = 0u; i < nb_faces && ok; ++i)
+		{
+			ok = reader->read_face(face);
+			if (ok)
+				grid.count(face_centroid(face));
+		}
+		if (!ok)
+		{
+			cgogn_log_error("streaming_decimate") << "Unable to read the faces of \"" << input << "\".";
+			positions_file.reset();
+			std::remove(positions_filename.c_str());
+			return false;
+		}
+		if (!grid.refine())
+			break;
+	}
+	const uint32 nb_chunks = grid.assign_chunks();
+
+	// second reading of the faces, written in the file of their chunk:
+	// the faces are buffered by chunk and the buffers are appended to the files when they exceed the memory budget
+	// (that the map of a chunk uses later), so that only one file is open at a time
+	auto chunk_filename = [&] (uint32 c) { return output + ".chunk" + std::to_string(c) + ".tmp"; };
+	{
+		std::vector<std::vector<uint32>> chunk_buffers(nb_chunks);
+		std::vector<bool> chunk_written(nb_chunks, false);
+		const std::size_t max_buffered = std::max(memory_budget, std::size_t(1u) << 20u) / sizeof(uint32);
+		std::size_t nb_buffered = 0u;
+		auto flush = [&] () -> bool
+		{
+			bool good = true;
+			for (uint32 c = 0u; c < nb_chunks; ++c)
+			{
+				std::vector<uint32>& buffer = chunk_buffers[c];
+				if (buffer.empty())
+					continue;
+				std::ofstream chunk_file(chunk_filename(c), std::ios::out | std::ios::binary | (chunk_written[c] ? std::ios::app : std::ios::trunc));
+				chunk_file.write(reinterpret_cast<const char*>(buffer.data()), std::streamsize(buffer.size() * sizeof(uint32)));
+				good = good && chunk_file.good();
+				chunk_written[c] = true;
+				std::vector<uint32>().swap(buffer);
+			}
+			nb_buffered = 0u;
+			return good;
+		};
+
+		reader = io::SurfaceStreamReader::open(input);
+		bool ok = reader && reader->skip_vertices();
+		for (uint32 i = 0u; i < nb_faces && ok; ++i)
+		{
+			ok = reader->read_face(face);
+			if (!ok)
+				break;
+			std::vector<uint32>& buffer = chunk_buffers[grid.chunk(face_centroid(face))];
+			buffer.push_back(uint32(face.size()));
+			buffer.insert(buffer.end(), face.begin(), face.end());
+			nb_buffered += face.size() + 1u;
+			if (nb_buffered >= max_buffered)
+				ok = flush();
+		}
+		ok = flush() && ok;
+		reader.reset();
+		if (!ok)
+		{
+			cgogn_log_error("streaming_decimate") << "Unable to split the faces of \"" << input << "\" in chunks.";
+			for (uint32 c = 0u; c < nb_chunks; ++c)
+				if (chunk_written[c])
+					std::remove(chunk_filename(c).c_str());
+			positions_file.reset();
+			std::remove(positions_filename.c_str());
+			return false;
+		}
+	}
+
+	// decimate the chunks one by one and write them;
+	// the indices of the output vertices are stored for the vertices shared by several chunks
+	const float64 removed_ratio = nb_vertices > target ? float64(nb_vertices - target) / float64(nb_vertices) : 0.0;
+	std::unordered_map<uint32, uint32> shared_vertices;
+	std::vector<uint32> faces_nb_vertices;
+	std::vector<uint32> faces_vertices;
+	std::vector<uint32> corners;
+	std::vector<uint32> link, link_parent, fan_roots, fan_lines;
+	for (uint32 c = 0u; c < nb_chunks; ++c)
+	{
+		faces_nb_vertices.clear();
+		faces_vertices.clear();
+		{
+			std::ifstream chunk_file(chunk_filename(c), std::ios::in | std::ios::binary);
+			uint32 n;
+			while (chunk_file.read(reinterpret_cast<char*>(&n), sizeof(n)))
+			{
+				faces_nb_vertices.push_back(n);
+				faces_vertices.resize(faces_vertices.size() + n);
+				chunk_file.read(reinterpret_cast<char*>(&faces_vertices[faces_vertices.size() - n]), std::streamsize(n * sizeof(uint32)));
+			}
+		}
+		std::remove(chunk_filename(c).c_str());
+		if (faces_nb_vertices.empty())
+			continue;
+
+		// the faces of a chunk may form several fans around a vertex: a vertex of the map is created for each fan
+		// (the fans of a vertex being open, their vertices are on the boundary of the chunk and are merged in the output)
+		const uint32 nb_corners = uint32(faces_vertices.size());
+		std::vector<uint32> corner_prev(nb_corners), corner_next(nb_corners);
+		for (uint32 f = 0u, first = 0u; f < uint32(faces_nb_vertices.size()); first += faces_nb_vertices[f++])
+		{
+			const uint32 n = faces_nb_vertices[f];
+			for (uint32 j = 0u; j < n; ++j)
+			{
+				corner_prev[first + j] = faces_vertices[first + (j + n - 1u) % n];
+				corner_next[first + j] = faces_vertices[first + (j + 1u) % n];
+			}
+		}
+		corners.resize(nb_corners);
+		for (uint32 i = 0u; i < nb_corners; ++i)
+			corners[i] = i;
+		std::sort(corners.begin(), corners.end(), [&] (uint32 i, uint32 j) { return faces_vertices[i] < faces_vertices[j]; });
+
+		CMap2 map;
+		{
+			io::SurfaceImport<CMap2> import(map);
+			MapBaseData::ChunkArray<VEC3>* position = import.template add_vertex_attribute<VEC3>("position");
+			MapBaseData::ChunkArray<uint32>* stream_index = import.template add_vertex_attribute<uint32>("stream_index");
+			std::vector<uint32> corner_line(nb_corners);
+			for (uint32 b = 0u; b < nb_corners; )
+			{
+				const uint32 v = faces_vertices[corners[b]];
+				uint32 e = b;
+				while (e < nb_corners && faces_vertices[corners[e]] == v)
+					++e;
+				// union-find of the vertices of the link of v, joined by the corners of v
+				link.clear();
+				link_parent.clear();
+				auto link_index = [&] (uint32 w) -> uint32
+				{
+					const uint32 i = uint32(std::find(link.begin(), link.end(), w) - link.begin());
+					if (i == link.size())
+					{
+						link.push_back(w);
+						link_parent.push_back(i);
+					}
+					return i;
+				};
+				auto root = [&] (uint32 i) -> uint32
+				{
+					while (link_parent[i] != i)
+						i = link_parent[i] = link_parent[link_parent[i]];
+					return i;
+				};
+				for (uint32 k = b; k < e; ++k)
+				{
+					const uint32 i = root(link_index(corner_prev[corners[k]]));
+					const uint32 j = root(link_index(corner_next[corners[k]]));
+					link_parent[i] = j;
+				}
+				fan_roots.clear();
+				fan_lines.clear();
+				for (uint32 k = b; k < e; ++k)
+				{
+					const uint32 r = root(link_index(corner_prev[corners[k]]));
+					const uint32 fan = uint32(std::find(fan_roots.begin(), fan_roots.end(), r) - fan_roots.begin());
+					if (fan == fan_roots.size())
+					{
+						const Position& p = positions[v];
+						const uint32 line = import.insert_line_vertex_container();
+						(*position)[line] = VEC3{Scalar(p[0]), Scalar(p[1]), Scalar(p[2])};
+						(*stream_index)[line] = v;
+						fan_roots.push_back(r);
+						fan_lines.push_back(line);
+					}
+					corner_line[corners[k]] = fan_lines[fan];
+				}
+				b = e;
+			}
+			import.reserve(uint32(faces_nb_vertices.size()));
+			auto it = corner_line.begin();
+			for (uint32 n : faces_nb_vertices)
+			{
+				face.assign(it, it + n);
+				it += n;
+				import.add_face(face);
+			}
+			import.create_map();
+		}
+
+		CMap2::VertexAttribute<VEC3> position = map.template get_attribute<VEC3, Vertex>("position");
+		CMap2::VertexAttribute<uint32> stream_index = map.template get_attribute<uint32, Vertex>("stream_index");
+
+		// the edges incident to the boundary of the chunk are not collapsed:
+		// the number of collapses is given by the inner vertices, the boundary ones being counted by several chunks
+		uint32 nb_inner_vertices = 0u;
+		map.foreach_cell([&] (Vertex v) { if (!map.is_incident_to_boundary(v)) ++nb_inner_vertices; });
+		const uint32 nb = uint32(removed_ratio * float64(nb_inner_vertices));
+		decimate(map, position, EdgeTraversor_QEM_T, EdgeApproximator_QEM_T, nb);
+
+		CMap2::VertexAttribute<uint32> output_index = map.template add_attribute<uint32, Vertex>("output_index");
+		map.foreach_cell([&] (Vertex v)
+		{
+			const VEC3& p = position[v];
+			const Position q = {{ float64(p[0]), float64(p[1]), float64(p[2]) }};
+			if (map.is_incident_to_boundary(v))
+			{
+				auto it = shared_vertices.find(stream_index[v]);
+				if (it == shared_vertices.end())
+					it = shared_vertices.insert(std::make_pair(stream_index[v], writer.add_vertex(q))).first;
+				output_index[v] = it->second;
+			}
+			else
+				output_index[v] = writer.add_vertex(q);
+		});
+		map.foreach_cell([&] (Face f)
+		{
+			face.clear();
+			map.foreach_incident_vertex(f, [&] (Vertex v) { face.push_back(output_index[v]); });
+			writer.add_face(face.data(), uint32(face.size()));
+		});
+	}
+
+	positions_file.reset();
+	std::remove(positions_filename.c_str());
+	return writer.close();
+}
+
+} // namespace internal
+
+/**
+ * @brief decimate a surface mesh file that does not fit in memory and write the result in another file
+ * The faces are streamed from the input file and distributed in spatial chunks whose maps fit in the memory budget.
+ * Each chunk is decimated with the QEM (as decimate does) while its boundary is locked,
+ * and the decimated chunks are stitched in the output file by their shared vertices.
+ * The locked boundaries are decimated by the next passes, made with shifted chunks.
+ * Besides the map of a chunk, the memory holds the grid of the chunks and the indices of the shared vertices;
+ * the positions and the chunks are stored in temporary files next to the output file.
+ * The cells of the grid denser than a chunk are divided, and the faces of a cell that cannot be divided anymore
+ * are split in several chunks, so that no chunk exceeds the memory budget.
+ * This function reads and writes the files with cgogn_io: the programs that use it must link against cgogn::io.
+ * @param input the surface file (OFF or PLY)
+ * @param output the decimated surface file (OFF or PLY)
+ * @param options the ratio of kept vertices, the memory budget and the number of passes
+ * @return true iff the output file has been written
+ */
+template <typename VEC3>
+bool streaming_decimate(const std::string& input, const std::string& output, const StreamingDecimationOptions& options = StreamingDecimationOptions())
+{
+	uint32 target = 0u;
+	{
+		std::unique_ptr<io::SurfaceStreamReader> reader = io::SurfaceStreamReader::open(input);
+		if (!reader)
+			return false;
+		target = uint32(std::ceil(std::min(std::max(options.ratio_, 0.0f), 1.0f) * float32(reader->nb_vertices())));
+	}
+
+	std::string pass_input = input;
+	const uint32 nb_passes = std::max(options.nb_passes_, 1u);
+	for (uint32 pass = 0u; pass < nb_passes; ++pass)
+	{
+		const bool last = pass + 1u == nb_passes;
+		const std::string pass_output = last ? output : output + ".pass" + std::to_string(pass) + ".off";
+		const bool ok = internal::streaming_decimation_pass<VEC3>(
+			pass_input, pass_output, target, pass, last ? options.binary_ : true, options.memory_budget_
+		);
+		if (pass_input != input)
+			std::remove(pass_input.c_str());
+		if (!ok)
+		{
+			if (!last)
+				std::remove(pass_output.c_str());
+			return false;
+		}
+		pass_input = pass_output;
+	}
+	return true;
+}
+
+} // namespace modeling
+
+} // namespace cgogn
+
+#endif // CGOGN_MODELING_ALGOS_STREAMING_DECIMATION_H_
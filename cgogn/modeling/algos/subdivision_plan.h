@@ -0,0 +1,322 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_MODELING_ALGOS_SUBDIVISION_PLAN_H_
+#define CGOGN_MODELING_ALGOS_SUBDIVISION_PLAN_H_
+
+#include <vector>
+#include <type_traits>
+
+#include <cgogn/core/utils/masks.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/cmap/cmap2_builder.h>
+
+namespace cgogn
+{
+
+namespace modeling
+{
+
+/**
+ * @brief The SubdivisionPlan class numbers the edges and the faces of a CellCache (in the order of the cache)
+ * and stores the number of the edge and of the face of each dart of the map.
+ * The stencils of a subdivision scheme can then be evaluated in parallel in flat arrays before the topology is changed.
+ * The topology of a CMap2 whose embedded orbits are only vertices (see is_batch_refinable) can then be refined
+ * in one batch: all the darts and vertices are allocated at once and their relations are written in parallel,
+ * without calling cut_edge and cut_face for each cell.
+ * After such a refinement, the vertex inserted on the i-th edge has the index edge_vertex(i)
+ * and the vertex inserted in the i-th face has the index face_vertex(i).
+ */
+template <typename MAP>
+class SubdivisionPlan
+{
+public:
+
+	using Self = SubdivisionPlan<MAP>;
+	using Vertex = typename MAP::Vertex;
+	using Edge = typename MAP::Edge;
+	using Face = typename MAP::Face;
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(SubdivisionPlan);
+
+	/**
+	 * @param cache a cache of the edges and faces of map
+	 */
+	SubdivisionPlan(MAP& map, const CellCache<MAP>& cache) :
+		map_(map),
+		edges_(cache.template cells<Edge>()),
+		faces_(cache.template cells<Face>()),
+		first_vertex_(INVALID_INDEX)
+	{
+		const uint32 nb_darts = map.topology_container().end();
+		edge_index_.assign(nb_darts, INVALID_INDEX);
+		face_index_.assign(nb_darts, INVALID_INDEX);
+
+		parallel_for(0u, nb_edges(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				map_.foreach_dart_of_orbit(Edge(edges_[i]), [&] (Dart d) { edge_index_[d.index] = i; });
+		});
+		parallel_for(0u, nb_faces(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				map_.foreach_dart_of_orbit(Face(faces_[i]), [&] (Dart d) { face_index_[d.index] = i; });
+		});
+	}
+
+	inline uint32 nb_edges() const { return uint32(edges_.size()); }
+	inline uint32 nb_faces() const { return uint32(faces_.size()); }
+
+	inline const std::vector<Dart>& edges() const { return edges_; }
+	inline const std::vector<Dart>& faces() const { return faces_; }
+
+	/**
+	 * @return the number of the edge of the (initial) dart d
+	 */
+	inline uint32 edge_index(Dart d) const { return edge_index_[d.index]; }
+
+	/**
+	 * @return the number of the face of the (initial) dart d (INVALID_INDEX for boundary darts)
+	 */
+	inline uint32 face_index(Dart d) const { return face_index_[d.index]; }
+
+	/**
+	 * @return the index of the vertex inserted on the i-th edge by a batch refinement
+	 */
+	inline uint32 edge_vertex(uint32 i) const { return first_vertex_ + i; }
+
+	/**
+	 * @return the index of the vertex inserted in the i-th face by a batch refinement
+	 */
+	inline uint32 face_vertex(uint32 i) const { return first_vertex_ + nb_edges() + i; }
+
+	/**
+	 * @return true if the topology of the map can be refined in one batch:
+	 * a CMap2 with embedded vertices and no other embedded orbit.
+	 */
+	static bool is_batch_refinable(const MAP& map)
+	{
+		return is_batch_refinable(map, std::integral_constant<bool, MAP::DIMENSION == 2u>());
+	}
+
+	/**
+	 * @brief cut all the edges and split each triangle in 4 triangles (Loop)
+	 * @return false (the map is unchanged) if the map is not batch refinable or if a face is not a triangle
+	 */
+	bool refine_loop()
+	{
+		return refine(false, std::integral_constant<bool, MAP::DIMENSION == 2u>());
+	}
+
+	/**
+	 * @brief cut all the edges and split each face of degree n in n quads around a new vertex (Catmull-Clark)
+	 * @return false (the map is unchanged) if the map is not batch refinable
+	 */
+	bool refine_catmull_clark()
+	{
+		return refine(true, std::integral_constant<bool, MAP::DIMENSION == 2u>());
+	}
+
+private:
+
+	static bool is_batch_refinable(const MAP&, std::false_type)
+	{
+		return false;
+	}
+
+	static bool is_batch_refinable(const MAP& map, std::true_type)
+	{
+		return map.template is_embedded<Vertex>() &&
+			!map.template is_embedded<typename MAP::CDart>() &&
+			!map.template is_embedded<Edge>() &&
+			!map.template is_embedded<Face>() &&
+			!map.template is_embedded<typename MAP::Volume>();
+	}
+
+	bool refine(bool, std::false_type)
+	{
+		return false;
+	}
+
+	/**
+	 * The new darts are numbered as follows (from the first allocated dart):
+	 *  - the dart inserted after the dart d (resp. phi2(d)) of the i-th edge in its face: 2i (resp. 2i+1)
+	 *  - for the face f of degree n, from its offset: n pairs of darts (x_k, y_k) inserted inside f.
+	 * When the edges are cut, the face f is made of the darts o_0, o_0', ..., o_n-1, o_n-1' (o_k' = phi1(o_k)).
+	 *  - Loop: x_k goes from o_k' to o_k-1' and closes the corner triangle (o_k-1', o_k, x_k),
+	 *    y_k = phi2(x_k) goes from o_k-1' to o_k' in the central triangle.
+	 *  - Catmull-Clark: x_k goes from o_k' to the center of f and y_k goes from the center to o_k-1',
+	 *    they close the quad (o_k-1', o_k, x_k, y_k) and phi2(x_k) = y_k+1.
+	 */
+	bool refine(bool face_vertices, std::true_type)
+	{
+		if (!is_batch_refinable(map_))
+			return false;
+
+		const uint32 nb_e = nb_edges();
+		const uint32 nb_f = nb_faces();
+
+		// offsets of the new darts of the faces
+		std::vector<uint32> offsets(nb_f + 1u);
+		offsets[0] = 2u * nb_e;
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				offsets[i + 1u] = 2u * map_.codegree(Face(faces_[i]));
+		});
+		for (uint32 i = 0u; i < nb_f; ++i)
+		{
+			if (!face_vertices && offsets[i + 1u] != 6u)
+				return false;
+			offsets[i + 1u] += offsets[i];
+		}
+
+		CMap2Builder_T<MAP> mbuild(map_);
+		const uint32 first_dart = mbuild.add_topology_elements(offsets[nb_f]).index;
+		first_vertex_ = mbuild.template add_attribute_elements<Vertex::ORBIT>(face_vertices ? nb_e + nb_f : nb_e);
+
+		auto& phi1 = mbuild.ca_phi1();
+		auto& phi_1 = mbuild.ca_phi_1();
+		auto& phi2 = mbuild.ca_phi2();
+		auto& vertex_emb = mbuild.template ca_embedding<Vertex::ORBIT>();
+
+		const auto link = [&] (Dart d, Dart e)
+		{
+			phi1[d.index] = e;
+			phi_1[e.index] = d;
+		};
+		const auto sew = [&] (Dart d, Dart e)
+		{
+			phi2[d.index] = e;
+			phi2[e.index] = d;
+		};
+
+		// cut the edges: a thread only changes phi1 and phi2 of the darts of its edges,
+		// and phi_1 of the successors of these darts
+		std::vector<uint8> boundary(2u * nb_e);
+		parallel_for(0u, nb_e, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				const Dart d = edges_[i];
+				const Dart e = phi2[d.index];
+				const Dart d1 = phi1[d.index];
+				const Dart e1 = phi1[e.index];
+				const Dart nd(first_dart + 2u * i);
+				const Dart ne(first_dart + 2u * i + 1u);
+				link(d, nd);
+				link(nd, d1);
+				link(e, ne);
+				link(ne, e1);
+				sew(d, ne);
+				sew(e, nd);
+				vertex_emb[nd.index] = edge_vertex(i);
+				vertex_emb[ne.index] = edge_vertex(i);
+				boundary[2u * i] = map_.is_boundary(d);
+				boundary[2u * i + 1u] = map_.is_boundary(e);
+			}
+		});
+
+		// the new darts of the boundary faces are boundary darts (the ranges are aligned on the chunks of the boundary marker)
+		const uint32 chunk_size = MAP::CHUNK_SIZE;
+		const uint32 last_edge_dart = first_dart + 2u * nb_e;
+		parallel_for(first_dart / chunk_size, (last_edge_dart + chunk_size - 1u) / chunk_size, 1u, [&] (uint32 first_chunk, uint32 last_chunk)
+		{
+			const uint32 end = std::min(last_edge_dart, last_chunk * chunk_size);
+			for (uint32 i = std::max(first_dart, first_chunk * chunk_size); i < end; ++i)
+			{
+				if (boundary[i - first_dart])
+					map_.set_boundary(Dart(i), true);
+			}
+		});
+
+		// split the faces: a thread only changes the darts of its faces
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			std::vector<Dart> o;
+			for (uint32 i = first; i < last; ++i)
+			{
+				o.clear();
+				Dart d = faces_[i];
+				do
+				{
+					o.push_back(d);
+					d = phi1[phi1[d.index].index];
+				} while (d != faces_[i]);
+
+				const uint32 n = uint32(o.size());
+				const uint32 base = first_dart + offsets[i];
+				for (uint32 k = 0u; k < n; ++k)
+				{
+					const Dart ok = o[k];
+					const Dart prev_new = phi_1[ok.index]; // o_k-1'
+					const Dart x(base + 2u * k);
+					const Dart y(base + 2u * k + 1u);
+					link(ok, x);
+					vertex_emb[x.index] = edge_vertex(edge_index_[ok.index]);
+					if (face_vertices)
+					{
+						link(x, y);
+						link(y, prev_new);
+						sew(x, Dart(base + (2u * k + 3u) % (2u * n)));
+						vertex_emb[y.index] = face_vertex(i);
+					}
+					else
+					{
+						link(x, prev_new);
+						link(y, Dart(base + (2u * k + 3u) % (2u * n)));
+						sew(x, y);
+						vertex_emb[y.index] = vertex_emb[prev_new.index];
+					}
+				}
+			}
+		});
+
+		// reference the new vertices by their darts
+		auto& vertex_container = mbuild.template attribute_container<Vertex::ORBIT>();
+		const uint32 nb_v = face_vertices ? nb_e + nb_f : nb_e;
+		parallel_for(0u, nb_v, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				const Dart d = i < nb_e ? Dart(first_dart + 2u * i) : Dart(first_dart + offsets[i - nb_e] + 1u);
+				map_.foreach_dart_of_orbit(Vertex(d), [&] (Dart) { vertex_container.ref_line(edge_vertex(i)); });
+			}
+		});
+
+		return true;
+	}
+
+	MAP& map_;
+	const std::vector<Dart>& edges_;
+	const std::vector<Dart>& faces_;
+	std::vector<uint32> edge_index_;
+	std::vector<uint32> face_index_;
+	uint32 first_vertex_;
+};
+
+} // namespace modeling
+
+} // namespace cgogn
+
+#endif // CGOGN_MODELING_ALGOS_SUBDIVISION_PLAN_H_
@@ -25,6 +25,8 @@
 #define CGOGN_MODELING_DECIMATION_EDGE_TRAVERSOR_QEM_H_
 
 #include <cgogn/core/utils/masks.h>
+#include <cgogn/core/utils/indexed_heap.h>
+#include <cgogn/core/cmap/scatter.h>
 #include <cgogn/geometry/types/quadric.h>
 #include <cgogn/modeling/decimation/edge_approximator.h>
 
@@ -46,17 +48,6 @@ public:
 	using Edge = typename MAP::Edge;
 	using Face = typename MAP::Face;
 
-	struct EdgeInfo
-	{
-		typename std::multimap<Scalar, Edge>::const_iterator it_;
-		bool valid_;
-
-		EdgeInfo() : valid_(false) {}
-
-		friend std::ostream& operator<<(std::ostream& out, const EdgeInfo&) { return out; }
-		friend std::istream& operator>>(std::istream& in, const EdgeInfo&) { return in; }
-	};
-
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(EdgeTraversor_QEM);
 
 	inline EdgeTraversor_QEM(
@@ -68,7 +59,7 @@ public:
 		position_(position),
 		approx_(approx)
 	{
-		einfo_ = map_.template add_attribute<EdgeInfo, Edge>("EdgeTraversor_QEM_EdgeInfo");
+		edge_ = map_.template add_attribute<Edge, Edge>("EdgeTraversor_QEM_Edge");
 		quadric_ = map_.template add_attribute<geometry::Quadric, Vertex>("EdgeTraversor_QEM_Quadric");
 
 		map_.parallel_foreach_cell([&] (Vertex v)
@@ -76,36 +67,61 @@ public:
 			quadric_[v].zero();
 		});
 
-		map_.parallel_foreach_cell([&] (Face f)
+		// several faces share a vertex: their quadrics are scattered without concurrent writes
+		parallel_scatter(map_, quadric_, [&] (Face f, ScatterAccumulator<geometry::Quadric, Vertex::ORBIT>& acc)
 		{
 			Dart d = f.dart;
 			Dart d1 = map_.phi1(d);
 			Dart d_1 = map_.phi_1(d);
 			geometry::Quadric q(position_[Vertex(d)], position_[Vertex(d1)], position_[Vertex(d_1)]);
-			quadric_[d] += q;
-			quadric_[d1] += q;
-			quadric_[d_1] += q;
+			acc(Vertex(d), q);
+			acc(Vertex(d1), q);
+			acc(Vertex(d_1), q);
 		});
 
+		// the costs of the collapsible edges are computed in parallel, each block being evaluated in one batch
+		std::vector<Edge> candidates;
 		map_.foreach_cell([&] (Edge e)
 		{
-			einfo_[e].valid_ = false;
-			update_edge_info(e);
+			if (map_.edge_can_collapse(e))
+				candidates.push_back(e);
 		});
+		std::vector<Scalar> costs(candidates.size());
+		parallel_for(0u, uint32(candidates.size()), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			std::vector<geometry::Quadric> quadrics;
+			std::vector<VEC3> positions;
+			quadrics.reserve(last - first);
+			positions.reserve(last - first);
+			for (uint32 i = first; i < last; ++i)
+			{
+				std::pair<Vertex,Vertex> vertices = map_.vertices(candidates[i]);
+				quadrics.push_back(quadric_[vertices.first] + quadric_[vertices.second]);
+				positions.push_back(approx_(candidates[i]));
+			}
+			geometry::Quadric::evaluate(quadrics.size(), quadrics.data(), positions.data(), &costs[first]);
+		});
+
+		edges_.reserve(map_.template attribute_container<Edge::ORBIT>().end());
+		for (std::size_t i = 0u, end = candidates.size(); i < end; ++i)
+		{
+			const uint32 index = map_.embedding(candidates[i]);
+			edge_[index] = candidates[i];
+			edges_.set(index, costs[i]);
+		}
 
 		this->traversed_cells_ |= orbit_mask<Edge>();
 	}
 
 	~EdgeTraversor_QEM() override
 	{
-		map_.remove_attribute(einfo_);
+		map_.remove_attribute(edge_);
 		map_.remove_attribute(quadric_);
 	}
 
 	void pre_collapse(Edge e)
 	{
-		EdgeInfo& ei = einfo_[e];
-		if (ei.valid_) { edges_.erase(ei.it_); ei.valid_ = false; }
+		edges_.erase(map_.embedding(e));
 
 		e1_ = Edge(map_.phi2(map_.phi_1(e.dart)));
 		e2_ = Edge(map_.phi2(map_.phi_1(map_.phi2(e.dart))));
@@ -113,18 +129,10 @@ public:
 		Dart ed1 = e.dart;
 		Dart ed2 = map_.phi2(ed1);
 
-		EdgeInfo& ei1 = einfo_[Edge(map_.phi1(ed1))];
-		if (ei1.valid_) { edges_.erase(ei1.it_); ei1.valid_ = false; }
-
-		EdgeInfo& ei2 = einfo_[Edge(map_.phi_1(ed1))];
-		if (ei2.valid_) { edges_.erase(ei2.it_); ei2.valid_ = false; }
-
-		EdgeInfo& ei3 = einfo_[Edge(map_.phi1(ed2))];
-		if (ei3.valid_) { edges_.erase(ei3.it_); ei3.valid_ = false; }
-
-		EdgeInfo& ei4 = einfo_[Edge(map_.phi_1(ed2))];
-		if (ei4.valid_) { edges_.erase(ei4.it_); ei4.valid_ = false; }
-
+		edges_.erase(map_.embedding(Edge(map_.phi1(ed1))));
+		edges_.erase(map_.embedding(Edge(map_.phi_1(ed1))));
+		edges_.erase(map_.embedding(Edge(map_.phi1(ed2))));
+		edges_.erase(map_.embedding(Edge(map_.phi_1(ed2))));
 		std::pair<Vertex,Vertex> vertices = map_.vertices(e);
 		q_.zero();
 		q_ += quadric_[vertices.first];
@@ -161,7 +169,7 @@ public:
 
 	void update_edge_info(Edge e)
 	{
-		EdgeInfo& ei = einfo_[e];
+		const uint32 index = map_.embedding(e);
 		if (map_.edge_can_collapse(e))
 		{
 			std::pair<Vertex,Vertex> vertices = map_.vertices(e);
@@ -169,66 +177,62 @@ public:
 			q += quadric_[vertices.first];
 			q += quadric_[vertices.second];
 			Scalar cost = q(approx_(e));
-			if (ei.valid_)
-			{
-				edges_.erase(ei.it_);
-				ei.it_ = edges_.insert(std::make_pair(cost, e));
-			}
-			else
-			{
-				ei.it_ = edges_.insert(std::make_pair(cost, e));
-				ei.valid_ = true;
-			}
+			edge_[index] = e;
+			edges_.set(index, cost);
 		}
 		else
-		{
-			if (ei.valid_)
-			{
-				edges_.erase(ei.it_);
-				ei.valid_ = false;
-			}
-		}
+			edges_.erase(index);
 	}
 
+	/**
+	 * @brief The const_iterator class gives the edge of minimal cost until the heap is empty
+	 * (the traversed edge must be removed from the heap or its cost changed before incrementing the iterator)
+	 */
 	class const_iterator
 	{
 	public:
 
-		const Self* const trav_ptr_;
-		typename std::multimap<Scalar, Edge>::const_iterator edge_it_;
+		const Self* trav_ptr_;
+		bool end_;
 
-		inline const_iterator(const Self* trav, typename std::multimap<Scalar, Edge>::const_iterator it) :
+		inline const_iterator(const Self* trav, bool end) :
 			trav_ptr_(trav),
-			edge_it_(it)
+			end_(end)
 		{}
 
 		inline const_iterator(const const_iterator& it) :
 			trav_ptr_(it.trav_ptr_),
-			edge_it_(it.edge_it_)
+			end_(it.end_)
 		{}
 
 		inline const_iterator& operator=(const const_iterator& it)
 		{
 			trav_ptr_ = it.trav_ptr_;
-			edge_it_ = it.edge_it_;
+			end_ = it.end_;
 			return *this;
 		}
 
 		inline const_iterator& operator++()
 		{
-			edge_it_ = trav_ptr_->edges_.begin();
 			return *this;
 		}
 
 		inline const Edge& operator*() const
 		{
-			return (*edge_it_).second;
+			return trav_ptr_->edge_[trav_ptr_->edges_.top()];
 		}
 
 		inline bool operator!=(const_iterator it) const
 		{
 			cgogn_assert(trav_ptr_ == it.trav_ptr_);
-			return edge_it_ != it.edge_it_;
+			return is_end() != it.is_end();
+		}
+
+	private:
+
+		inline bool is_end() const
+		{
+			return end_ || trav_ptr_->edges_.empty();
 		}
 	};
 
@@ -236,14 +240,14 @@ public:
 			  typename std::enable_if<std::is_same<CellType, typename MAP::Edge>::value>::type* = nullptr>
 	inline const_iterator begin() const
 	{
-		return const_iterator(this, edges_.begin());
+		return const_iterator(this, false);
 	}
 
 	template <typename CellType,
 			  typename std::enable_if<std::is_same<CellType, typename MAP::Edge>::value>::type* = nullptr>
 	inline const_iterator end() const
 	{
-		return const_iterator(this, edges_.end());
+		return const_iterator(this, true);
 	}
 
 private:
@@ -252,9 +256,9 @@ private:
 	const typename MAP::template VertexAttribute<VEC3>& position_;
 	const EdgeApproximator<MAP, VEC3>& approx_;
 
-	typename MAP::template EdgeAttribute<EdgeInfo> einfo_;
+	typename MAP::template EdgeAttribute<Edge> edge_;
 	typename MAP::template VertexAttribute<geometry::Quadric> quadric_;
-	std::multimap<Scalar, Edge> edges_;
+	IndexedHeap<Scalar> edges_;
 	Edge e1_, e2_;
 	geometry::Quadric q_;
 };
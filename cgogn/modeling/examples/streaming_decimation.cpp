@@ -0,0 +1,38 @@
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+#include <cgogn/modeling/algos/streaming_decimation.h>
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+
+int main(int argc, char** argv)
+{
+	if (argc < 4)
+	{
+		cgogn_log_info("streaming_decimation") << "USAGE: " << argv[0] << " [input_filename] [output_filename] [ratio of kept vertices] [memory budget in MB](optional, default 1024) [nb passes](optional, default 2)";
+		return 0;
+	}
+
+	cgogn::modeling::StreamingDecimationOptions options;
+	options.ratio(float32(std::atof(argv[3])));
+	if (argc > 4)
+		options.memory_budget(std::size_t(std::atoi(argv[4])) << 20u);
+	if (argc > 5)
+		options.nb_passes(uint32(std::atoi(argv[5])));
+
+	std::chrono::time_point<std::chrono::system_clock> start, end;
+	start = std::chrono::system_clock::now();
+
+	const bool ok = cgogn::modeling::streaming_decimate<Vec3>(argv[1], argv[2], options);
+
+	end = std::chrono::system_clock::now();
+	std::chrono::duration<float64> elapsed_seconds = end - start;
+
+	if (ok)
+		cgogn_log_info("streaming_decimation") << argv[1] << " decimated in " << elapsed_seconds.count() << "s";
+	return ok ? 0 : 1;
+}
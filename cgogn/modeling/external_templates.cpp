@@ -25,6 +25,7 @@
 #include <cgogn/modeling/algos/loop.h>
 #include <cgogn/modeling/algos/catmull_clark.h>
 #include <cgogn/modeling/algos/doo_sabin.h>
+#include <cgogn/modeling/algos/indexed_subdivision.h>
 #include <cgogn/modeling/algos/decimation.h>
 #include <cgogn/modeling/algos/pliant_remeshing.h>
 #include <cgogn/modeling/algos/refinements.h>
@@ -53,10 +54,15 @@ template CGOGN_MODELING_API void catmull_clark(CMap2&, CMap2::VertexAttribute<Ei
 template CGOGN_MODELING_API void doo_sabin(CMap2&, CMap2::VertexAttribute<Eigen::Vector3f>&);
 template CGOGN_MODELING_API void doo_sabin(CMap2&, CMap2::VertexAttribute<Eigen::Vector3d>&);
 
+template class CGOGN_MODELING_API IndexedSubdivision<Eigen::Vector3f>;
+template class CGOGN_MODELING_API IndexedSubdivision<Eigen::Vector3d>;
+
 
 
 template CGOGN_MODELING_API void decimate(CMap2&, CMap2::VertexAttribute<Eigen::Vector3f>&, EdgeTraversorType, EdgeApproximatorType, uint32);
 template CGOGN_MODELING_API void decimate(CMap2&, CMap2::VertexAttribute<Eigen::Vector3d>&, EdgeTraversorType, EdgeApproximatorType, uint32);
+template CGOGN_MODELING_API void parallel_decimate(CMap2&, CMap2::VertexAttribute<Eigen::Vector3f>&, EdgeTraversorType, EdgeApproximatorType, uint32, float32);
+template CGOGN_MODELING_API void parallel_decimate(CMap2&, CMap2::VertexAttribute<Eigen::Vector3d>&, EdgeTraversorType, EdgeApproximatorType, uint32, float32);
 
 template CGOGN_MODELING_API void pliant_remeshing(CMap2&, CMap2::VertexAttribute<Eigen::Vector3f>&);
 template CGOGN_MODELING_API void pliant_remeshing(CMap2&, CMap2::VertexAttribute<Eigen::Vector3d>&);
@@ -26,6 +26,8 @@
 #include <cgogn/core/cmap/cmap2.h>
 #include <cgogn/io/map_import.h>
 #include <cgogn/modeling/algos/catmull_clark.h>
+#include <cgogn/modeling/tiling/square_grid.h>
+#include <cgogn/modeling/tests/algos/subdivision_test.h>
 
 #include <gtest/gtest.h>
 
@@ -108,3 +110,22 @@ TYPED_TEST(Algos_TEST, QuadCatmullClark)
 
 	EXPECT_EQ(16, nb_f2);
 }
+
+TYPED_TEST(Algos_TEST, GridCatmullClark)
+{
+	cgogn::modeling::check_grid_subdivision<TypeParam, cgogn::modeling::SquareGrid<CMap2>>(
+		[] (CMap2& map, VertexAttribute<TypeParam>& position) { cgogn::modeling::catmull_clark(map, position); },
+		320u
+	);
+}
+
+TYPED_TEST(Algos_TEST, BoundaryCatmullClark)
+{
+	for (bool batch : { true, false })
+	{
+		cgogn::modeling::check_boundary_rules<TypeParam, cgogn::modeling::SquareGrid<CMap2>>(
+			[] (CMap2& map, VertexAttribute<TypeParam>& position) { cgogn::modeling::catmull_clark(map, position); },
+			batch
+		);
+	}
+}
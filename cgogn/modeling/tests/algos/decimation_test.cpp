@@ -0,0 +1,117 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/types/vec.h>
+#include <cgogn/geometry/algos/length.h>
+#include <cgogn/modeling/tiling/triangular_tore.h>
+#include <cgogn/modeling/algos/decimation.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using StdArrayf = cgogn::geometry::Vec_T<std::array<float,3>>;
+using StdArrayd = cgogn::geometry::Vec_T<std::array<double,3>>;
+using EigenVec3f = Eigen::Vector3f;
+using EigenVec3d = Eigen::Vector3d;
+using VecTypes = testing::Types<StdArrayf, EigenVec3f, StdArrayd ,EigenVec3d>;
+
+using CMap2 = cgogn::CMap2;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+
+template <typename Vec_T>
+class Decimation_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+
+	VertexAttribute<Vec_T> add_tore(uint32 n)
+	{
+		VertexAttribute<Vec_T> vertex_position = map2_.template add_attribute<Vec_T, Vertex>("position");
+		cgogn::modeling::TriangularTore<CMap2> tore(map2_, n, n);
+		tore.embed_into_tore(vertex_position, 10.0f, 3.0f);
+		return vertex_position;
+	}
+};
+
+TYPED_TEST_CASE(Decimation_TEST, VecTypes);
+
+TYPED_TEST(Decimation_TEST, EdgeLengthOrder)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+	VertexAttribute<TypeParam> vertex_position = this->add_tore(12);
+
+	// the edges are given by increasing length while none is collapsed
+	cgogn::modeling::EdgeTraversor_EdgeLength<CMap2, TypeParam> trav(this->map2_, vertex_position);
+	Scalar previous(0);
+	uint32 nb_edges = 0;
+	this->map2_.foreach_cell([&] (Edge e)
+	{
+		const Scalar l = cgogn::geometry::length(this->map2_, e, vertex_position);
+		EXPECT_LE(previous, l);
+		previous = l;
+		++nb_edges;
+		trav.pre_collapse(e);
+	},
+	trav);
+	EXPECT_GT(nb_edges, 0u);
+}
+
+TYPED_TEST(Decimation_TEST, Decimate)
+{
+	VertexAttribute<TypeParam> vertex_position = this->add_tore(20);
+	const uint32 nb_vertices = this->map2_.template nb_cells<Vertex::ORBIT>();
+
+	cgogn::modeling::decimate(this->map2_, vertex_position,
+		cgogn::modeling::EdgeTraversor_EdgeLength_T, cgogn::modeling::EdgeApproximator_MidEdge_T, 100u);
+	EXPECT_EQ(this->map2_.template nb_cells<Vertex::ORBIT>(), nb_vertices - 100u);
+	EXPECT_TRUE(this->map2_.check_map_integrity());
+
+	cgogn::modeling::decimate(this->map2_, vertex_position,
+		cgogn::modeling::EdgeTraversor_QEM_T, cgogn::modeling::EdgeApproximator_QEM_T, 100u);
+	EXPECT_EQ(this->map2_.template nb_cells<Vertex::ORBIT>(), nb_vertices - 200u);
+	EXPECT_TRUE(this->map2_.check_map_integrity());
+}
+
+TYPED_TEST(Decimation_TEST, ParallelDecimate)
+{
+	VertexAttribute<TypeParam> vertex_position = this->add_tore(20);
+	const uint32 nb_vertices = this->map2_.template nb_cells<Vertex::ORBIT>();
+
+	cgogn::modeling::parallel_decimate(this->map2_, vertex_position,
+		cgogn::modeling::EdgeTraversor_EdgeLength_T, cgogn::modeling::EdgeApproximator_MidEdge_T, 100u);
+	EXPECT_EQ(this->map2_.template nb_cells<Vertex::ORBIT>(), nb_vertices - 100u);
+	EXPECT_TRUE(this->map2_.check_map_integrity());
+
+	cgogn::modeling::parallel_decimate(this->map2_, vertex_position,
+		cgogn::modeling::EdgeTraversor_QEM_T, cgogn::modeling::EdgeApproximator_QEM_T, 100u, 1.0f);
+	EXPECT_EQ(this->map2_.template nb_cells<Vertex::ORBIT>(), nb_vertices - 200u);
+	EXPECT_TRUE(this->map2_.check_map_integrity());
+	EXPECT_FALSE(this->map2_.has_attribute(Edge::ORBIT, "parallel_decimate_cost"));
+}
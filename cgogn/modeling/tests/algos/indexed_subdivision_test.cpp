@@ -0,0 +1,208 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/io/surface_import.h>
+#include <cgogn/modeling/algos/indexed_subdivision.h>
+#include <cgogn/modeling/algos/loop.h>
+#include <cgogn/modeling/algos/catmull_clark.h>
+#include <cgogn/modeling/algos/doo_sabin.h>
+#include <cgogn/modeling/tiling/square_grid.h>
+#include <cgogn/modeling/tiling/square_tore.h>
+#include <cgogn/modeling/tiling/triangular_grid.h>
+#include <cgogn/modeling/tiling/triangular_tore.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using StdArrayf = cgogn::geometry::Vec_T<std::array<float,3>>;
+using StdArrayd = cgogn::geometry::Vec_T<std::array<double,3>>;
+using EigenVec3f = Eigen::Vector3f;
+using EigenVec3d = Eigen::Vector3d;
+using VecTypes = testing::Types<StdArrayf, EigenVec3f, StdArrayd ,EigenVec3d>;
+
+using CMap2 = cgogn::CMap2;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+
+template <typename Vec_T>
+class IndexedSubdivision_TEST : public testing::Test
+{
+protected:
+
+	using Subdivision = cgogn::modeling::IndexedSubdivision<Vec_T>;
+
+	CMap2 map2_;
+
+	// the indexed surface has the cells of map2_ and each of its vertices is at the position of a vertex of map2_
+	void check_same_surface(const Subdivision& s, const VertexAttribute<Vec_T>& position)
+	{
+		EXPECT_EQ(s.nb_vertices(), map2_.template nb_cells<Vertex::ORBIT>());
+		EXPECT_EQ(s.nb_faces(), map2_.template nb_cells<Face::ORBIT>());
+		EXPECT_EQ(s.nb_corners(), map2_.nb_darts() - nb_boundary_darts());
+
+		uint32 nb_inner_corners = 0u;
+		for (uint32 c = 0u; c < s.nb_corners(); ++c)
+		{
+			if (s.corner_twin(c) != cgogn::INVALID_INDEX)
+			{
+				++nb_inner_corners;
+				EXPECT_EQ(s.corner_twin(s.corner_twin(c)), c);
+			}
+		}
+		EXPECT_EQ(s.nb_corners() - nb_inner_corners, nb_boundary_darts());
+
+		std::vector<Vec_T> map_positions;
+		map2_.foreach_cell([&] (Vertex v) { map_positions.push_back(position[v]); });
+		for (const Vec_T& p : s.positions())
+		{
+			double min_dist = 1e10;
+			for (const Vec_T& q : map_positions)
+			{
+				double dist = 0.0;
+				for (uint32 i = 0u; i < 3u; ++i)
+					dist += (double(p[i]) - double(q[i])) * (double(p[i]) - double(q[i]));
+				min_dist = std::min(min_dist, dist);
+			}
+			EXPECT_LT(min_dist, 1e-8);
+		}
+	}
+
+	uint32 nb_boundary_darts()
+	{
+		uint32 nb = 0u;
+		map2_.foreach_dart([&] (cgogn::Dart d) { if (map2_.is_boundary(d)) ++nb; });
+		return nb;
+	}
+};
+
+TYPED_TEST_CASE(IndexedSubdivision_TEST, VecTypes);
+
+TYPED_TEST(IndexedSubdivision_TEST, Loop)
+{
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, CMap2::Vertex>("position");
+
+	cgogn::modeling::TriangularGrid<CMap2> grid(this->map2_, 5, 4);
+	grid.embed_into_grid(vertex_position, 1.0f, 1.0f, 0.0f);
+
+	typename TestFixture::Subdivision s(this->map2_, vertex_position);
+	this->check_same_surface(s, vertex_position);
+	EXPECT_TRUE(s.loop(2u));
+	cgogn::modeling::loop(this->map2_, vertex_position);
+	cgogn::modeling::loop(this->map2_, vertex_position);
+	this->check_same_surface(s, vertex_position);
+
+	std::vector<uint32> triangles;
+	s.triangles(triangles);
+	EXPECT_EQ(triangles.size(), 3u * 640u);
+}
+
+TYPED_TEST(IndexedSubdivision_TEST, LoopOfQuads)
+{
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, CMap2::Vertex>("position");
+
+	cgogn::modeling::SquareGrid<CMap2> grid(this->map2_, 5, 4);
+	grid.embed_into_grid(vertex_position, 1.0f, 1.0f, 0.0f);
+
+	typename TestFixture::Subdivision s(this->map2_, vertex_position);
+	EXPECT_FALSE(s.loop());
+	this->check_same_surface(s, vertex_position);
+}
+
+TYPED_TEST(IndexedSubdivision_TEST, CatmullClark)
+{
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, CMap2::Vertex>("position");
+
+	cgogn::modeling::SquareGrid<CMap2> grid(this->map2_, 5, 4);
+	grid.embed_into_grid(vertex_position, 1.0f, 1.0f, 0.0f);
+
+	typename TestFixture::Subdivision s(this->map2_, vertex_position);
+	s.catmull_clark(2u);
+	cgogn::modeling::catmull_clark(this->map2_, vertex_position);
+	cgogn::modeling::catmull_clark(this->map2_, vertex_position);
+	this->check_same_surface(s, vertex_position);
+}
+
+TYPED_TEST(IndexedSubdivision_TEST, CatmullClarkOfTriangles)
+{
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, CMap2::Vertex>("position");
+
+	cgogn::modeling::TriangularTore<CMap2> tore(this->map2_, 6, 5);
+	tore.embed_into_tore(vertex_position, 10.0f, 4.0f);
+
+	typename TestFixture::Subdivision s(this->map2_, vertex_position);
+	s.catmull_clark();
+	cgogn::modeling::catmull_clark(this->map2_, vertex_position);
+	this->check_same_surface(s, vertex_position);
+}
+
+TYPED_TEST(IndexedSubdivision_TEST, DooSabin)
+{
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, CMap2::Vertex>("position");
+
+	cgogn::modeling::SquareTore<CMap2> tore(this->map2_, 6, 5);
+	tore.embed_into_tore(vertex_position, 10.0f, 4.0f);
+
+	typename TestFixture::Subdivision s(this->map2_, vertex_position);
+	s.doo_sabin(2u);
+	cgogn::modeling::doo_sabin(this->map2_, vertex_position);
+	cgogn::modeling::doo_sabin(this->map2_, vertex_position);
+	this->check_same_surface(s, vertex_position);
+}
+
+TYPED_TEST(IndexedSubdivision_TEST, ExportSurface)
+{
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, CMap2::Vertex>("position");
+
+	cgogn::modeling::SquareGrid<CMap2> grid(this->map2_, 5, 4);
+	grid.embed_into_grid(vertex_position, 1.0f, 1.0f, 0.0f);
+
+	typename TestFixture::Subdivision s(this->map2_, vertex_position);
+	s.catmull_clark(2u);
+
+	CMap2 map2;
+	cgogn::io::SurfaceImport<CMap2> import(map2);
+	s.export_surface(import);
+	import.create_map();
+
+	cgogn::modeling::catmull_clark(this->map2_, vertex_position);
+	cgogn::modeling::catmull_clark(this->map2_, vertex_position);
+
+	EXPECT_TRUE(map2.check_map_integrity());
+	EXPECT_EQ(map2.template nb_cells<Vertex::ORBIT>(), this->map2_.template nb_cells<Vertex::ORBIT>());
+	EXPECT_EQ(map2.template nb_cells<Edge::ORBIT>(), this->map2_.template nb_cells<Edge::ORBIT>());
+	EXPECT_EQ(map2.template nb_cells<Face::ORBIT>(), this->map2_.template nb_cells<Face::ORBIT>());
+	EXPECT_EQ(map2.nb_boundaries(), this->map2_.nb_boundaries());
+
+	VertexAttribute<TypeParam> position = map2.template get_attribute<TypeParam, CMap2::Vertex>("position");
+	EXPECT_TRUE(position.is_valid());
+	map2.foreach_cell([&] (Vertex v)
+	{
+		for (uint32 i = 0u; i < 3u; ++i)
+			EXPECT_EQ(position[v][i], s.positions()[map2.embedding(v)][i]);
+	});
+}
@@ -0,0 +1,73 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/modeling/algos/loop.h>
+#include <cgogn/modeling/tiling/triangular_grid.h>
+#include <cgogn/modeling/tests/algos/subdivision_test.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using StdArrayf = cgogn::geometry::Vec_T<std::array<float,3>>;
+using StdArrayd = cgogn::geometry::Vec_T<std::array<double,3>>;
+using EigenVec3f = Eigen::Vector3f;
+using EigenVec3d = Eigen::Vector3d;
+using VecTypes = testing::Types<StdArrayf, EigenVec3f, StdArrayd ,EigenVec3d>;
+
+using CMap2 = cgogn::CMap2;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+
+template <typename Vec_T>
+class Loop_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+};
+
+TYPED_TEST_CASE(Loop_TEST, VecTypes);
+
+TYPED_TEST(Loop_TEST, GridLoop)
+{
+	cgogn::modeling::check_grid_subdivision<TypeParam, cgogn::modeling::TriangularGrid<CMap2>>(
+		[] (CMap2& map, VertexAttribute<TypeParam>& position) { cgogn::modeling::loop(map, position); },
+		640u
+	);
+}
+
+TYPED_TEST(Loop_TEST, BoundaryLoop)
+{
+	for (bool batch : { true, false })
+	{
+		cgogn::modeling::check_boundary_rules<TypeParam, cgogn::modeling::TriangularGrid<CMap2>>(
+			[] (CMap2& map, VertexAttribute<TypeParam>& position) { cgogn::modeling::loop(map, position); },
+			batch
+		);
+	}
+}
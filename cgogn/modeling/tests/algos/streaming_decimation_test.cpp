@@ -0,0 +1,200 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string>
+#include <cstdio>
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/modeling/tiling/triangular_tore.h>
+#include <cgogn/modeling/algos/streaming_decimation.h>
+
+using namespace cgogn::numerics;
+using Vec3 = Eigen::Vector3d;
+using Map2 = cgogn::CMap2;
+
+namespace
+{
+
+// write the map in a file through a SurfaceStreamWriter, with a far away triangle if far is not 0
+void write_map(Map2& map, const Map2::VertexAttribute<Vec3>& position, const std::string& filename, bool binary, float64 far = 0.0)
+{
+	cgogn::io::SurfaceStreamWriter writer(filename, binary);
+	Map2::VertexAttribute<uint32> index = map.add_attribute<uint32, Map2::Vertex>("index");
+	map.foreach_cell([&] (Map2::Vertex v)
+	{
+		const Vec3& p = position[v];
+		index[v] = writer.add_vertex({{ p[0], p[1], p[2] }});
+	});
+	std::vector<uint32> face;
+	map.foreach_cell([&] (Map2::Face f)
+	{
+		face.clear();
+		map.foreach_incident_vertex(f, [&] (Map2::Vertex v) { face.push_back(index[v]); });
+		writer.add_face(face.data(), uint32(face.size()));
+	});
+	if (far != 0.0)
+	{
+		const uint32 triangle[3] = {
+			writer.add_vertex({{ far, far, far }}),
+			writer.add_vertex({{ far + 1.0, far, far }}),
+			writer.add_vertex({{ far, far + 1.0, far }})
+		};
+		writer.add_face(triangle, 3u);
+	}
+	map.remove_attribute(index);
+	EXPECT_TRUE(writer.close());
+}
+
+// read a file through a SurfaceStreamReader in the map
+void read_map(Map2& map, const std::string& filename)
+{
+	std::unique_ptr<cgogn::io::SurfaceStreamReader> reader = cgogn::io::SurfaceStreamReader::open(filename);
+	ASSERT_TRUE(reader != nullptr);
+	cgogn::io::SurfaceImport<Map2> import(map);
+	cgogn::MapBaseData::ChunkArray<Vec3>* position = import.add_vertex_attribute<Vec3>("position");
+	std::array<float64, 3> p;
+	while (reader->read_vertex(p))
+		(*position)[import.insert_line_vertex_container()] = Vec3(p[0], p[1], p[2]);
+	std::vector<uint32> face;
+	while (reader->read_face(face))
+		import.add_face(face);
+	EXPECT_EQ(import.nb_faces(), reader->nb_faces());
+	import.create_map();
+}
+
+} // namespace
+
+TEST(StreamingDecimationTest, stream_round_trip)
+{
+	Map2 map;
+	Map2::VertexAttribute<Vec3> position = map.add_attribute<Vec3, Map2::Vertex>("position");
+	cgogn::modeling::TriangularTore<Map2> tore(map, 10u, 10u);
+	tore.embed_into_tore(position, 10.0f, 3.0f);
+
+	for (const std::string filename : { "stream_ascii.off", "stream_binary.off", "stream_ascii.ply", "stream_binary.ply" })
+	{
+		write_map(map, position, filename, filename.find("binary") != std::string::npos);
+		Map2 map2;
+		read_map(map2, filename);
+		EXPECT_EQ(map2.nb_cells<Map2::Vertex::ORBIT>(), 100u);
+		EXPECT_EQ(map2.nb_cells<Map2::Face::ORBIT>(), 200u);
+		EXPECT_TRUE(map2.check_map_integrity());
+		std::remove(filename.c_str());
+	}
+}
+
+TEST(StreamingDecimationTest, decimate_tore)
+{
+	Map2 map;
+	Map2::VertexAttribute<Vec3> position = map.add_attribute<Vec3, Map2::Vertex>("position");
+	cgogn::modeling::TriangularTore<Map2> tore(map, 60u, 60u);
+	tore.embed_into_tore(position, 10.0f, 3.0f);
+	write_map(map, position, "streaming_input.off", false);
+
+	// several chunks of about 1000 faces
+	testing::internal::CaptureStdout();
+	EXPECT_TRUE(cgogn::modeling::streaming_decimate<Vec3>("streaming_input.off", "streaming_output.ply",
+		cgogn::modeling::StreamingDecimationOptions().ratio(0.2f).memory_budget(1000u * 512u).nb_passes(2u)));
+	testing::internal::GetCapturedStdout();
+
+	// the decimated chunks are stitched in a closed surface
+	Map2 result;
+	read_map(result, "streaming_output.ply");
+	const uint32 nbv = result.nb_cells<Map2::Vertex::ORBIT>();
+	EXPECT_LT(nbv, 3600u / 3u);
+	EXPECT_GE(nbv, 3600u / 5u);
+	EXPECT_TRUE(result.check_map_integrity());
+	uint32 nb_boundary_vertices = 0u;
+	result.foreach_cell([&] (Map2::Vertex v) { if (result.is_incident_to_boundary(v)) ++nb_boundary_vertices; });
+	EXPECT_EQ(nb_boundary_vertices, 0u);
+
+	std::remove("streaming_input.off");
+	std::remove("streaming_output.ply");
+}
+
+TEST(StreamingDecimationTest, chunk_grid)
+{
+	using Grid = cgogn::modeling::internal::StreamingChunkGrid;
+	const Grid::Position origin = {{ 0.0, 0.0, 0.0 }};
+	const Grid::Position inv_cell_size = {{ 64.0, 64.0, 64.0 }};
+
+	// a cluster of 1000 faces in a cell, 100 faces at the same position and 5 isolated faces
+	std::vector<Grid::Position> centroids;
+	for (uint32 i = 0u; i < 1000u; ++i)
+		centroids.push_back({{ 0.5 + 1e-6 * float64(i % 10u), 0.5 + 1e-6 * float64((i / 10u) % 10u), 0.5 + 1e-6 * float64(i / 100u) }});
+	for (uint32 i = 0u; i < 100u; ++i)
+		centroids.push_back({{ 0.25, 0.25, 0.25 }});
+	for (uint32 i = 0u; i < 5u; ++i)
+		centroids.push_back({{ 0.1 * float64(i), 0.9, 0.9 }});
+
+	Grid grid(origin, inv_cell_size, 10u);
+	uint32 nb_rounds = 0u;
+	do
+	{
+		for (const Grid::Position& c : centroids)
+			grid.count(c);
+		++nb_rounds;
+	} while (grid.refine());
+	EXPECT_GT(grid.nb_nodes(), 1u);
+	EXPECT_LE(nb_rounds, Grid::MAX_DEPTH + 1u);
+
+	const uint32 nb_chunks = grid.assign_chunks();
+	std::vector<uint32> chunk_sizes(nb_chunks, 0u);
+	for (const Grid::Position& c : centroids)
+	{
+		const uint32 chunk = grid.chunk(c);
+		ASSERT_LT(chunk, nb_chunks);
+		++chunk_sizes[chunk];
+	}
+	for (uint32 size : chunk_sizes)
+		EXPECT_LE(size, 10u);
+	EXPECT_GE(nb_chunks, 1105u / 10u);
+}
+
+TEST(StreamingDecimationTest, decimate_dense_cell)
+{
+	Map2 map;
+	Map2::VertexAttribute<Vec3> position = map.add_attribute<Vec3, Map2::Vertex>("position");
+	cgogn::modeling::TriangularTore<Map2> tore(map, 60u, 60u);
+	tore.embed_into_tore(position, 10.0f, 3.0f);
+	// the far away triangle puts the whole tore in a cell of the grid
+	write_map(map, position, "streaming_dense_input.off", false, 1e6);
+
+	testing::internal::CaptureStdout();
+	EXPECT_TRUE(cgogn::modeling::streaming_decimate<Vec3>("streaming_dense_input.off", "streaming_dense_output.off",
+		cgogn::modeling::StreamingDecimationOptions().ratio(0.2f).memory_budget(1000u * 512u).nb_passes(2u)));
+	testing::internal::GetCapturedStdout();
+
+	Map2 result;
+	read_map(result, "streaming_dense_output.off");
+	const uint32 nbv = result.nb_cells<Map2::Vertex::ORBIT>();
+	EXPECT_LT(nbv, 3603u / 3u);
+	EXPECT_GE(nbv, 3603u / 5u);
+	EXPECT_TRUE(result.check_map_integrity());
+	uint32 nb_boundary_vertices = 0u;
+	result.foreach_cell([&] (Map2::Vertex v) { if (result.is_incident_to_boundary(v)) ++nb_boundary_vertices; });
+	EXPECT_EQ(nb_boundary_vertices, 3u);
+
+	std::remove("streaming_dense_input.off");
+	std::remove("streaming_dense_output.off");
+}
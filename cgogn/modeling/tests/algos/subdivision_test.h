@@ -0,0 +1,235 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_MODELING_TESTS_ALGOS_SUBDIVISION_TEST_H_
+#define CGOGN_MODELING_TESTS_ALGOS_SUBDIVISION_TEST_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/modeling/algos/subdivision_plan.h>
+
+#include <gtest/gtest.h>
+
+namespace cgogn
+{
+
+namespace modeling
+{
+
+/**
+ * Checks shared by the tests of the subdivision schemes (loop, catmull_clark) on grids.
+ * The refinement in one batch (SubdivisionPlan) is compared with the refinement by local operations,
+ * that is used when the edges are embedded.
+ */
+
+/**
+ * @brief the positions of the vertices of a map, sorted after their rounding to 1e-3,
+ * to compare the positions computed on two maps
+ */
+template <typename VEC>
+std::vector<std::array<float64, 3>> sorted_positions(const CMap2& map, const CMap2::VertexAttribute<VEC>& position)
+{
+	std::vector<std::array<float64, 3>> positions;
+	map.foreach_cell([&] (CMap2::Vertex v)
+	{
+		positions.push_back({{ float64(position[v][0]), float64(position[v][1]), float64(position[v][2]) }});
+	});
+	auto key = [] (const std::array<float64, 3>& p)
+	{
+		return std::make_tuple(std::llround(p[0] * 1e3), std::llround(p[1] * 1e3), std::llround(p[2] * 1e3));
+	};
+	std::sort(positions.begin(), positions.end(), [&] (const std::array<float64, 3>& a, const std::array<float64, 3>& b)
+	{
+		return key(a) < key(b);
+	});
+	return positions;
+}
+
+/**
+ * @brief the two neighbours of each boundary vertex along the boundary (by vertex embedding)
+ */
+inline std::map<uint32, std::vector<uint32>> boundary_neighbours(const CMap2& map)
+{
+	std::map<uint32, std::vector<uint32>> neighbours;
+	map.foreach_dart([&] (Dart d)
+	{
+		if (map.is_boundary(d))
+		{
+			const uint32 a = map.embedding(CMap2::Vertex(d));
+			const uint32 b = map.embedding(CMap2::Vertex(map.phi1(d)));
+			neighbours[a].push_back(b);
+			neighbours[b].push_back(a);
+		}
+	});
+	return neighbours;
+}
+
+/**
+ * @brief subdivide twice a 5x4 grid refined in one batch and the same grid refined by local operations,
+ * and compare them: same cells, same positions; both grids stay planar and inside their initial bounding box
+ * @param subdivide the subdivision scheme, called with a map and its position attribute
+ * @param nb_faces the number of faces after the two subdivisions
+ */
+template <typename VEC, typename GRID, typename SUBDIVIDE>
+void check_grid_subdivision(const SUBDIVIDE& subdivide, uint32 nb_faces)
+{
+	using Vertex = CMap2::Vertex;
+	using Edge = CMap2::Edge;
+	using Face = CMap2::Face;
+
+	CMap2 map;
+	CMap2 map2;
+	CMap2::VertexAttribute<VEC> position = map.add_attribute<VEC, Vertex>("position");
+	CMap2::VertexAttribute<VEC> position2 = map2.add_attribute<VEC, Vertex>("position");
+	map2.add_attribute<uint32, Edge>("edges");
+
+	GRID grid(map, 5, 4);
+	grid.embed_into_grid(position, 1.0f, 1.0f, 0.0f);
+	GRID grid2(map2, 5, 4);
+	grid2.embed_into_grid(position2, 1.0f, 1.0f, 0.0f);
+
+	EXPECT_TRUE(SubdivisionPlan<CMap2>::is_batch_refinable(map));
+	EXPECT_FALSE(SubdivisionPlan<CMap2>::is_batch_refinable(map2));
+
+	// bounding box of the initial grid
+	std::array<float64, 2> min = {{ 1e10, 1e10 }};
+	std::array<float64, 2> max = {{ -1e10, -1e10 }};
+	map.foreach_cell([&] (Vertex v)
+	{
+		for (uint32 i = 0u; i < 2u; ++i)
+		{
+			min[i] = std::min(min[i], float64(position[v][i]));
+			max[i] = std::max(max[i], float64(position[v][i]));
+		}
+	});
+
+	subdivide(map, position);
+	subdivide(map, position);
+	subdivide(map2, position2);
+	subdivide(map2, position2);
+
+	EXPECT_TRUE(map.check_map_integrity());
+	EXPECT_EQ(map.nb_cells<Face::ORBIT>(), nb_faces);
+	EXPECT_EQ(map.nb_cells<Edge::ORBIT>(), map2.nb_cells<Edge::ORBIT>());
+	EXPECT_EQ(map.nb_cells<Vertex::ORBIT>(), map2.nb_cells<Vertex::ORBIT>());
+	EXPECT_EQ(map.nb_boundaries(), map2.nb_boundaries());
+
+	// the batched refinement computes the same positions as the refinement by local operations
+	const std::vector<std::array<float64, 3>> positions = sorted_positions(map, position);
+	const std::vector<std::array<float64, 3>> positions2 = sorted_positions(map2, position2);
+	ASSERT_EQ(positions.size(), positions2.size());
+	for (std::size_t i = 0u; i < positions.size(); ++i)
+	{
+		for (uint32 j = 0u; j < 3u; ++j)
+			EXPECT_NEAR(positions[i][j], positions2[i][j], 1e-4);
+	}
+
+	// the grid stays planar and inside its initial bounding box
+	map.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_NEAR(position[v][2], 0.0, 1e-6);
+		for (uint32 i = 0u; i < 2u; ++i)
+		{
+			EXPECT_GE(position[v][i], min[i] - 1e-6);
+			EXPECT_LE(position[v][i], max[i] + 1e-6);
+		}
+	});
+}
+
+/**
+ * @brief subdivide once a perturbed 3x2 grid and check the boundary rules on the positions computed
+ * independently from the initial ones: an initial boundary vertex v goes to 3/4 v + 1/8 of its two
+ * boundary neighbours, and the point of a boundary edge is its midpoint
+ * @param subdivide the subdivision scheme, called with a map and its position attribute
+ * @param batch refine the grid in one batch or by local operations (embedded edges)
+ */
+template <typename VEC, typename GRID, typename SUBDIVIDE>
+void check_boundary_rules(const SUBDIVIDE& subdivide, bool batch)
+{
+	using Scalar = geometry::ScalarOf<VEC>;
+	using Vertex = CMap2::Vertex;
+
+	CMap2 map;
+	CMap2::VertexAttribute<VEC> position = map.add_attribute<VEC, Vertex>("position");
+	if (!batch)
+		map.add_attribute<uint32, CMap2::Edge>("edges");
+
+	GRID grid(map, 3, 2);
+	grid.embed_into_grid(position, 1.0f, 1.0f, 0.0f);
+	EXPECT_EQ(SubdivisionPlan<CMap2>::is_batch_refinable(map), batch);
+
+	// the boundary is not straight, so that the rules move its vertices
+	std::map<uint32, std::array<float64, 3>> initial;
+	map.foreach_cell([&] (Vertex v)
+	{
+		const uint32 i = map.embedding(v);
+		position[v] += VEC(Scalar(0.05 * std::sin(1.7 * i)), Scalar(0.05 * std::cos(2.3 * i)), Scalar(0.1 * std::sin(0.9 * i)));
+		initial[i] = {{ float64(position[v][0]), float64(position[v][1]), float64(position[v][2]) }};
+	});
+	const std::map<uint32, std::vector<uint32>> initial_neighbours = boundary_neighbours(map);
+
+	subdivide(map, position);
+
+	const std::map<uint32, std::vector<uint32>> neighbours = boundary_neighbours(map);
+	// each initial boundary edge has been cut once
+	EXPECT_EQ(neighbours.size(), 2u * initial_neighbours.size());
+
+	for (const auto& vn : neighbours)
+	{
+		ASSERT_EQ(vn.second.size(), 2u);
+		std::array<float64, 3> expected;
+		auto it = initial_neighbours.find(vn.first);
+		if (it != initial_neighbours.end())
+		{
+			ASSERT_EQ(it->second.size(), 2u);
+			const std::array<float64, 3>& p = initial.at(vn.first);
+			const std::array<float64, 3>& a = initial.at(it->second[0]);
+			const std::array<float64, 3>& b = initial.at(it->second[1]);
+			for (uint32 j = 0u; j < 3u; ++j)
+				expected[j] = 0.75 * p[j] + 0.125 * (a[j] + b[j]);
+		}
+		else
+		{
+			// a new vertex of a boundary edge, between two initial vertices
+			ASSERT_EQ(initial.count(vn.second[0]) + initial.count(vn.second[1]), 2u);
+			const std::array<float64, 3>& a = initial.at(vn.second[0]);
+			const std::array<float64, 3>& b = initial.at(vn.second[1]);
+			for (uint32 j = 0u; j < 3u; ++j)
+				expected[j] = 0.5 * (a[j] + b[j]);
+		}
+		for (uint32 j = 0u; j < 3u; ++j)
+			EXPECT_NEAR(position[vn.first][j], expected[j], 1e-5);
+	}
+}
+
+} // namespace modeling
+
+} // namespace cgogn
+
+#endif // CGOGN_MODELING_TESTS_ALGOS_SUBDIVISION_TEST_H_
@@ -28,6 +28,7 @@
 #include <QOGLViewer/qoglviewer.h>
 
 #include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/attribute_snapshot.h>
 //#include <cgogn/core/cmap/cmap2_tri.h>
 //#include <cgogn/core/cmap/cmap2_quad.h>
 
@@ -94,9 +95,10 @@ private:
 
 //	bool flat_rendering_;
 
-	std::mutex mut_update_;
-	std::condition_variable cv_update_;
-	std::atomic_bool need_update_;
+	// positions published by the computation thread and last positions uploaded in the vbo
+	std::unique_ptr<cgogn::AttributeSnapshot<Vec3>> position_snapshot_;
+	std::shared_ptr<const cgogn::AttributeSnapshot<Vec3>::View> uploaded_position_;
+	std::atomic_bool stop_;
 
 	std::future<void> future_;
 
@@ -126,6 +128,8 @@ void Viewer::import(const std::string& surface_mesh)
 		vertex_pos2_[v] = vertex_position_[v];
 	});
 
+	position_snapshot_ = cgogn::make_unique<cgogn::AttributeSnapshot<Vec3>>(vertex_position_);
+	position_snapshot_->publish();
 
 	cgogn::external_thread_pool()->set_nb_workers(1);
 
@@ -142,7 +146,7 @@ Viewer::~Viewer()
 
 void Viewer::closeEvent(QCloseEvent*)
 {
-	cv_update_.notify_all();
+	stop_ = true;
 	if (future_.valid())
 		future_.wait();
 	render_.reset();
@@ -157,7 +161,7 @@ Viewer::Viewer() :
 	bb_(),
 	render_(nullptr),
 	vbo_pos_(nullptr),
-	need_update_(false)
+	stop_(false)
 {
 
 }
@@ -167,18 +171,23 @@ void Viewer::keyPressEvent(QKeyEvent *ev)
 	switch (ev->key())
 	{
 	case Qt::Key_R:
+		// the positions belong to the computation thread while it runs
+		if (future_.valid() && future_.wait_for(std::chrono::seconds(0)) == std::future_status::timeout)
+			break;
 		map_.foreach_cell([&](Map2::Vertex v)
 		{
 			vertex_position_[v] = vertex_pos2_[v];
 		});
-		cgogn::rendering::update_vbo(vertex_position_, vbo_pos_.get());
+		vertex_position_.set_all_dirty();
+		position_snapshot_->publish();
+		update();
 		break;
 
 	case Qt::Key_A:
 	{
 		if (future_.valid())
 		{
-			std::future_status status = future_.wait_for(std::chrono::nanoseconds::min());
+			std::future_status status = future_.wait_for(std::chrono::seconds(0));
 			if (status == std::future_status::timeout)
 				break;
 		}
@@ -195,40 +204,23 @@ void Viewer::keyPressEvent(QKeyEvent *ev)
 			do
 			{
 				cgogn::geometry::compute_normal(map_, vertex_position_, vertex_normal);
-				for (int i = 0; i < 100; ++i)
+				for (int i = 0; i < 200 && !stop_; ++i)
 				{
+					const float64 step = i < 100 ? 0.0002 : -0.0002;
 					map_.foreach_cell([&](Map2::Vertex v)
 					{
 						Vec3& P = vertex_position_[v];
 						Vec3 N = vertex_normal[v];
-						P += 0.0002*N;
+						P += step*N;
 					});
-					// tag vbo need update
-					need_update_ = true;
+					// publish a consistent copy of the positions (the viewer never reads vertex_position_)
+					vertex_position_.set_all_dirty();
+					position_snapshot_->publish();
 					// ask for update
 					update();
-					// wait vbo update finished (we can write in attribute)
-					std::unique_lock<std::mutex> lk(mut_update_);
-					cv_update_.wait(lk);
-				}
-				for (int i = 0; i < 100; ++i)
-				{
-					map_.foreach_cell([&](Map2::Vertex v)
-					{
-						Vec3& P = vertex_position_[v];
-						Vec3 N = vertex_normal[v];
-						P -= 0.0002*N;
-					});
-					// tag vbo need update
-					need_update_ = true;
-					// ask for update
-					update();
-					// lock & wait vbo update finished (we can write in attribute)
-					std::unique_lock<std::mutex> lk(mut_update_);
-					cv_update_.wait(lk);
 				}
 				end = std::chrono::system_clock::now();
-			} while (std::chrono::duration<float>(end - start).count() < 20);
+			} while (!stop_ && std::chrono::duration<float>(end - start).count() < 20);
 			cgogn_log_info("Asyncrone") << "finished";
 		});
 	}
@@ -251,17 +243,12 @@ void Viewer::draw()
 	camera()->getProjectionMatrix(proj);
 	camera()->getModelViewMatrix(view);
 
-	// VBO need to be sync with attribute ?
-	if (need_update_)
+	// VBO need to be sync with the last published positions ?
+	std::shared_ptr<const cgogn::AttributeSnapshot<Vec3>::View> position = position_snapshot_->view();
+	if (position != uploaded_position_)
 	{
-		// lock
-		std::unique_lock<std::mutex> lk(mut_update_);
-		// update
-		cgogn::rendering::update_vbo(vertex_position_, vbo_pos_.get());
-		// tag
-		need_update_ = false;
-		// ask compute thread to continue
-		cv_update_.notify_all();
+		cgogn::rendering::update_vbo_from_snapshot(*position, vbo_pos_.get(), uploaded_position_.get());
+		uploaded_position_ = position;
 	}
 
 	param_flat_->bind(proj, view);
@@ -276,7 +263,8 @@ void Viewer::init()
 
 	// create and fill VBO for positions
 	vbo_pos_ = cgogn::make_unique<cgogn::rendering::VBO>(3);
-	cgogn::rendering::update_vbo(vertex_position_, vbo_pos_.get());
+	uploaded_position_ = position_snapshot_->view();
+	cgogn::rendering::update_vbo_from_snapshot(*uploaded_position_, vbo_pos_.get());
 
 	// create and fill VBO for normals
 // map rendering object (primitive creation & sending to GPU)
@@ -0,0 +1,449 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_RENDERING_INDEX_BUFFER_H_
+#define CGOGN_RENDERING_INDEX_BUFFER_H_
+
+#include <functional>
+#include <vector>
+
+#include <cgogn/core/cmap/map_base.h>
+#include <cgogn/core/utils/masks.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/geometry/algos/ear_triangulation.h>
+
+namespace cgogn
+{
+
+namespace rendering
+{
+
+enum DrawingType : uint8
+{
+	POINTS = 0,
+	LINES,
+	TRIANGLES,
+	BOUNDARY,
+	SIZE_BUFFER
+};
+
+/**
+ * @brief The IndexBufferBuilder class computes the vertex embedding indices drawn by a MapRender
+ * without any GL context. The building is done in two passes:
+ * - init selects (in parallel, with a CellCache, for the filtered cells of an embedded orbit) the cells of the primitive
+ *   and counts (in parallel) the indices of each cell, the offsets of the cells in the buffer are given by a prefix sum of the counts;
+ * - write fills (in parallel) a presized buffer, e.g. a std::vector or a mapped GL buffer.
+ * The indices are given in the order of map.foreach_cell, as the former serial generation did.
+ * As the former generation, a face of degree n < 3 gives n degenerated triangles (none with the ear triangulation).
+ * The builder keeps references to the map and to the position attribute: it must be written
+ * before any change of the topology (or of the positions for an ear triangulation).
+ */
+class IndexBufferBuilder
+{
+public:
+
+	inline IndexBufferBuilder() : stride_(0u), nb_indices_(0u), boundary_dimension_(0u)
+	{}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(IndexBufferBuilder);
+
+	/**
+	 * @brief select the cells of the given primitive (faces are triangulated in fan) and count their indices
+	 */
+	template <typename MAP, typename MASK>
+	inline auto init(const MAP& m, const MASK& mask, DrawingType prim)
+		-> typename std::enable_if<!std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
+	{
+		clear();
+		switch (prim)
+		{
+			case POINTS:
+				init_points(m, mask);
+				break;
+			case LINES:
+				init_lines(m, mask);
+				break;
+			case TRIANGLES:
+				init_triangles(m, mask);
+				break;
+			case BOUNDARY:
+				init_boundaries(m);
+				break;
+			default:
+				break;
+		}
+	}
+
+	/**
+	 * @brief same as init(m, mask, prim) except that the faces are ear triangulated if a position is given
+	 */
+	template <typename MAP, typename MASK, typename VERTEX_ATTR>
+	inline auto init(const MAP& m, const MASK& mask, DrawingType prim, const VERTEX_ATTR* position)
+		-> typename std::enable_if<!std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
+	{
+		static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value, "attribute must be a vertex attribute");
+
+		if (prim == TRIANGLES && position != nullptr)
+		{
+			clear();
+			init_triangles_ear(m, mask, *position);
+		}
+		else
+			init(m, mask, prim);
+	}
+
+	/**
+	 * @brief write the indices in the given buffer that must be able to store nb_indices() values
+	 */
+	inline void write(uint32* indices) const
+	{
+		parallel_for(0u, uint32(cells_.size()), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			std::vector<uint32> buffer;
+			for (uint32 i = first; i < last; ++i)
+				write_cell_(cells_[i], indices + (stride_ > 0u ? stride_ * i : offsets_[i]), buffer);
+		});
+	}
+
+	inline void clear()
+	{
+		std::vector<Dart>().swap(cells_);
+		std::vector<uint32>().swap(offsets_);
+		write_cell_ = nullptr;
+		stride_ = 0u;
+		nb_indices_ = 0u;
+		boundary_dimension_ = 0u;
+	}
+
+	inline uint32 nb_indices() const { return nb_indices_; }
+
+	/**
+	 * @return the dimension of the cells drawn for the BOUNDARY primitive (0: points, 1: lines, 2: triangles)
+	 */
+	inline uint8 boundary_dimension() const { return boundary_dimension_; }
+
+private:
+
+	/**
+	 * @brief store the cells of type CellType given by the mask and count their indices
+	 * @param stride the number of indices of each cell, or 0 if count(c) must be called for each cell c
+	 * @param write_cell the function write_cell(c, indices, buffer) that writes the indices of c
+	 */
+	template <typename CellType, typename MAP, typename MASK, typename COUNT, typename WRITE>
+	void select(const MAP& m, const MASK& mask, uint32 stride, const COUNT& count, const WRITE& write_cell)
+	{
+		select_cells<CellType>(m, mask);
+
+		const uint32 nb_cells = uint32(cells_.size());
+		stride_ = stride;
+		if (stride_ > 0u)
+			nb_indices_ = stride_ * nb_cells;
+		else
+		{
+			offsets_.assign(nb_cells + 1u, 0u);
+			parallel_for(0u, nb_cells, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+			{
+				for (uint32 i = first; i < last; ++i)
+					offsets_[i + 1u] = count(CellType(cells_[i]));
+			});
+			for (uint32 i = 0u; i < nb_cells; ++i)
+				offsets_[i + 1u] += offsets_[i];
+			nb_indices_ = offsets_[nb_cells];
+		}
+
+		write_cell_ = [write_cell] (Dart d, uint32* indices, std::vector<uint32>& buffer)
+		{
+			write_cell(CellType(d), indices, buffer);
+		};
+	}
+
+	/**
+	 * @brief store in cells_ the cells of type CellType given by the mask, in the order of map.foreach_cell
+	 * The filtered cells are gathered in parallel by a CellCache (sequentially if the orbit is not embedded).
+	 */
+	template <typename CellType, typename MAP, typename FilterFunction>
+	inline auto select_cells(const MAP& m, const FilterFunction& filter)
+		-> typename std::enable_if<is_func_return_same<FilterFunction, bool>::value, void>::type
+	{
+		CellCache<MAP> cache(m);
+		cache.template parallel_build<CellType>(filter);
+		cells_ = cache.template cells<CellType>();
+	}
+
+	template <typename CellType, typename MAP>
+	inline void select_cells(const MAP& m, const AllCellsFilter&)
+	{
+		select_cells<CellType>(m, [] (CellType) { return true; });
+	}
+
+	template <typename CellType, typename MAP>
+	inline void select_cells(const MAP& m, const CellFilters& filters)
+	{
+		select_cells<CellType>(m, [&filters] (CellType c) { return filters.filter(c); });
+	}
+
+	template <typename CellType, typename MAP>
+	inline void select_cells(const MAP&, const CellCache<MAP>& cache)
+	{
+		cells_ = cache.template cells<CellType>();
+	}
+
+	template <typename CellType, typename MAP, typename Traversor>
+	inline auto select_cells(const MAP&, const Traversor& t)
+		-> typename std::enable_if<std::is_base_of<CellTraversor, Traversor>::value && !std::is_same<Traversor, CellCache<MAP>>::value, void>::type
+	{
+		for (typename Traversor::const_iterator it = t.template begin<CellType>(), end = t.template end<CellType>(); it != end; ++it)
+			cells_.push_back(CellType(*it).dart);
+	}
+
+	/**
+	 * @return the number of indices of the fan triangulation of f, n - 2 triangles for a face of degree n
+	 * (n degenerated triangles for n < 3, as the former serial generation)
+	 */
+	template <typename MAP>
+	static inline uint32 nb_fan_indices(const MAP& m, typename MAP::Face f)
+	{
+		const uint32 n = m.codegree(f);
+		return n < 3u ? 3u * n : 3u * (n - 2u);
+	}
+
+	/**
+	 * @return the number of indices of the ear triangulation of f (none for a face of degree n < 3)
+	 */
+	template <typename MAP>
+	static inline uint32 nb_ear_indices(const MAP& m, typename MAP::Face f)
+	{
+		const uint32 n = m.codegree(f);
+		return n < 3u ? 0u : 3u * (n - 2u);
+	}
+
+	template <typename MAP>
+	static inline uint32* write_fan(const MAP& m, typename MAP::Face f, uint32* indices)
+	{
+		using Vertex = typename MAP::Vertex;
+
+		const Dart d0 = f.dart;
+		Dart d1 = m.phi1(d0);
+		Dart d2 = m.phi1(d1);
+		do
+		{
+			*indices++ = m.embedding(Vertex(d0));
+			*indices++ = m.embedding(Vertex(d1));
+			*indices++ = m.embedding(Vertex(d2));
+			d1 = d2;
+			d2 = m.phi1(d1);
+		} while (d2 != d0);
+		return indices;
+	}
+
+	template <typename MAP, typename MASK>
+	inline void init_points(const MAP& m, const MASK& mask)
+	{
+		using Vertex = typename MAP::Vertex;
+
+		select<Vertex>(m, mask, 1u, [] (Vertex) { return 1u; },
+			[&m] (Vertex v, uint32* indices, std::vector<uint32>&)
+		{
+			indices[0] = m.embedding(v);
+		});
+	}
+
+	template <typename MAP, typename MASK>
+	inline auto init_lines(const MAP& m, const MASK& mask)
+		-> typename std::enable_if<MAP::DIMENSION >= 1, void>::type
+	{
+		using Vertex = typename MAP::Vertex;
+		using Edge = typename MAP::Edge;
+
+		select<Edge>(m, mask, 2u, [] (Edge) { return 2u; },
+			[&m] (Edge e, uint32* indices, std::vector<uint32>&)
+		{
+			std::pair<Vertex, Vertex> vs = m.vertices(e);
+			indices[0] = m.embedding(vs.first);
+			indices[1] = m.embedding(vs.second);
+		});
+	}
+
+	template <typename MAP, typename MASK>
+	inline auto init_lines(const MAP&, const MASK&)
+		-> typename std::enable_if<MAP::DIMENSION < 1, void>::type
+	{}
+
+	template <typename MAP, typename MASK>
+	inline auto init_triangles(const MAP& m, const MASK& mask)
+		-> typename std::enable_if<MAP::DIMENSION >= 2, void>::type
+	{
+		using Face = typename MAP::Face;
+
+		select<Face>(m, mask, 0u, [&m] (Face f) { return nb_fan_indices(m, f); },
+			[&m] (Face f, uint32* indices, std::vector<uint32>&)
+		{
+			write_fan(m, f, indices);
+		});
+	}
+
+	template <typename MAP, typename MASK>
+	inline auto init_triangles(const MAP&, const MASK&)
+		-> typename std::enable_if<MAP::DIMENSION < 2, void>::type
+	{}
+
+	template <typename MAP, typename MASK, typename VERTEX_ATTR>
+	inline auto init_triangles_ear(const MAP& m, const MASK& mask, const VERTEX_ATTR& position)
+		-> typename std::enable_if<MAP::DIMENSION >= 2, void>::type
+	{
+		using Face = typename MAP::Face;
+
+		// an ear triangulation of a polygon with n vertices has n-2 triangles, like a fan
+		select<Face>(m, mask, 0u, [&m] (Face f) { return nb_ear_indices(m, f); },
+			[&m, &position] (Face f, uint32* indices, std::vector<uint32>& buffer)
+		{
+			if (m.has_codegree(f, 3))
+				write_fan(m, f, indices);
+			else if (m.codegree(f) > 3u)
+			{
+				buffer.clear();
+				cgogn::geometry::append_ear_triangulation(m, f, position, buffer);
+				std::copy(buffer.begin(), buffer.end(), indices);
+			}
+		});
+	}
+
+	template <typename MAP, typename MASK, typename VERTEX_ATTR>
+	inline auto init_triangles_ear(const MAP&, const MASK&, const VERTEX_ATTR&)
+		-> typename std::enable_if<MAP::DIMENSION < 2, void>::type
+	{}
+
+	template <typename MAP>
+	inline auto init_boundaries(const MAP& m)
+		-> typename std::enable_if<MAP::DIMENSION == 1, void>::type
+	{
+		using Vertex = typename MAP::Vertex;
+
+		typename MAP::BoundaryCache bcache(m);
+		select<Vertex>(m, bcache, 1u, [] (Vertex) { return 1u; },
+			[&m] (Vertex v, uint32* indices, std::vector<uint32>&)
+		{
+			indices[0] = m.embedding(v);
+		});
+		boundary_dimension_ = 0u;
+	}
+
+	template <typename MAP>
+	inline auto init_boundaries(const MAP& m)
+		-> typename std::enable_if<MAP::DIMENSION == 2, void>::type
+	{
+		using Vertex = typename MAP::Vertex;
+		using Edge = typename MAP::Edge;
+		using Face = typename MAP::Face;
+
+		typename MAP::BoundaryCache bcache(m);
+		select<Face>(m, bcache, 0u, [&m] (Face f) { return 2u * m.codegree(f); },
+			[&m] (Face f, uint32* indices, std::vector<uint32>&)
+		{
+			m.foreach_incident_edge(f, [&] (Edge e)
+			{
+				*indices++ = m.embedding(Vertex(e.dart));
+				*indices++ = m.embedding(Vertex(m.phi1(e.dart)));
+			});
+		});
+		boundary_dimension_ = 1u;
+	}
+
+	template <typename MAP>
+	inline auto init_boundaries(const MAP& m)
+		-> typename std::enable_if<MAP::DIMENSION == 3, void>::type
+	{
+		using Face = typename MAP::Face;
+		using Volume = typename MAP::Volume;
+
+		typename MAP::BoundaryCache bcache(m);
+		select<Volume>(m, bcache, 0u,
+			[&m] (Volume v)
+		{
+			uint32 count = 0u;
+			m.foreach_incident_face(v, [&] (Face f) { count += nb_fan_indices(m, f); });
+			return count;
+		},
+			[&m] (Volume v, uint32* indices, std::vector<uint32>&)
+		{
+			m.foreach_incident_face(v, [&] (Face f) { indices = write_fan(m, f, indices); });
+		});
+		boundary_dimension_ = 2u;
+	}
+
+	template <typename MAP>
+	inline auto init_boundaries(const MAP&)
+		-> typename std::enable_if<MAP::DIMENSION == 0, void>::type
+	{}
+
+	std::vector<Dart> cells_;
+	std::vector<uint32> offsets_;
+	std::function<void(Dart, uint32*, std::vector<uint32>&)> write_cell_;
+	uint32 stride_;
+	uint32 nb_indices_;
+	uint8 boundary_dimension_;
+};
+
+/**
+ * @brief build the vertex embedding indices of the given primitive in a presized vector, in parallel
+ * @param m the map
+ * @param mask the cells to draw (ignored for the BOUNDARY primitive)
+ * @param prim the primitive
+ * @param position if not null, the faces are ear triangulated with these vertex positions
+ * @param table_indices the resulting indices
+ */
+template <typename MAP, typename MASK, typename VERTEX_ATTR>
+void build_index_buffer(
+	const MAP& m,
+	const MASK& mask,
+	DrawingType prim,
+	const VERTEX_ATTR* position,
+	std::vector<uint32>& table_indices
+)
+{
+	IndexBufferBuilder builder;
+	builder.init(m, mask, prim, position);
+	table_indices.resize(builder.nb_indices());
+	builder.write(table_indices.data());
+}
+
+template <typename MAP, typename MASK>
+void build_index_buffer(
+	const MAP& m,
+	const MASK& mask,
+	DrawingType prim,
+	std::vector<uint32>& table_indices
+)
+{
+	IndexBufferBuilder builder;
+	builder.init(m, mask, prim);
+	table_indices.resize(builder.nb_indices());
+	builder.write(table_indices.data());
+}
+
+} // namespace rendering
+
+} // namespace cgogn
+
+#endif // CGOGN_RENDERING_INDEX_BUFFER_H_
@@ -31,6 +31,7 @@
 
 #include <cgogn/geometry/algos/ear_triangulation.h>
 
+#include <cgogn/rendering/index_buffer.h>
 #include <cgogn/rendering/drawer.h>
 #include <cgogn/rendering/shaders/vbo.h>
 
@@ -43,15 +44,6 @@ namespace cgogn
 namespace rendering
 {
 
-enum DrawingType : uint8
-{
-	POINTS = 0,
-	LINES,
-	TRIANGLES,
-	BOUNDARY,
-	SIZE_BUFFER
-};
-
 class CGOGN_RENDERING_API MapRender
 {
 protected:
@@ -73,177 +65,40 @@ public:
 
 protected:
 
-	template <typename MAP, typename MASK>
-	inline void init_points(const MAP& m, const MASK& mask, std::vector<uint32>& table_indices)
-	{
-//		table_indices.reserve(m.get_nb_darts() / 6);
-		m.foreach_cell([&] (typename MAP::Vertex v)
-		{
-			table_indices.push_back(m.embedding(v));
-		},
-		mask);
-	}
-
-	template <typename MAP, typename MASK>
-	inline void init_lines(const MAP& m, const MASK& mask, std::vector<uint32>& table_indices)
-	{
-		using Vertex = typename MAP::Vertex;
-		using Edge = typename MAP::Edge;
-
-//		table_indices.reserve(m.get_nb_darts() / 2);
-		m.foreach_cell([&] (Edge e)
-		{
-			std::pair<Vertex, Vertex> vs = m.vertices(e);
-			table_indices.push_back(m.embedding(vs.first));
-			table_indices.push_back(m.embedding(vs.second));
-		},
-		mask);
-	}
-
-	template <typename MAP, typename MASK>
-	inline void init_triangles(const MAP& m, const MASK& mask, std::vector<uint32>& table_indices)
-	{
-		using Vertex = typename MAP::Vertex;
-		using Face = typename MAP::Face;
-
-		// reserve more ?
-//		table_indices.reserve(m.get_nb_darts() / 3);
-		m.foreach_cell([&] (Face f)
-		{
-			Dart d0 = f.dart;
-			Dart d1 = m.phi1(d0);
-			Dart d2 = m.phi1(d1);
-			do
-			{
-				table_indices.push_back(m.embedding(Vertex(d0)));
-				table_indices.push_back(m.embedding(Vertex(d1)));
-				table_indices.push_back(m.embedding(Vertex(d2)));
-				d1 = d2;
-				d2 = m.phi1(d1);
-			} while(d2 != d0);
-		},
-		mask);
-	}
-
-	template <typename VEC3, typename MAP, typename MASK>
-	inline void init_triangles_ear(
-		const MAP& m,
-		const MASK& mask,
-		std::vector<uint32>& table_indices,
-		const typename MAP::template VertexAttribute<VEC3>* position
-	)
-	{
-		using Vertex = typename MAP::Vertex;
-		using Face = typename MAP::Face;
-
-		// reserve more ?
-//		table_indices.reserve(m.get_nb_darts() / 3);
-		m.foreach_cell([&] (Face f)
-		{
-			if (m.has_codegree(f, 3))
-			{
-				table_indices.push_back(m.embedding(Vertex(f.dart)));
-				table_indices.push_back(m.embedding(Vertex(m.phi1(f.dart))));
-				table_indices.push_back(m.embedding(Vertex(m.phi1(m.phi1(f.dart)))));
-			}
-			else
-				cgogn::geometry::append_ear_triangulation(m, f, *position, table_indices);
-		},
-		mask);
-	}
-
-	template <typename MAP, typename MASK>
-	inline auto init_boundaries(const MAP& m, const MASK& mask, std::vector<uint32>& table_indices)
-		-> typename std::enable_if<MAP::DIMENSION == 1 && std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
+	/**
+	 * @brief write the indices computed by the builder in the GL buffer of the primitive.
+	 * The buffer is mapped and filled in parallel, or filled from a CPU copy if it cannot be mapped.
+	 */
+	inline void upload_indices(DrawingType prim, const IndexBufferBuilder& builder)
 	{
-		using Vertex = typename MAP::Vertex;
-
-		m.foreach_cell([&] (Vertex v)
-		{
-			table_indices.push_back(m.embedding(v));
-		},
-		mask);
-
-		boundary_dimension_ = 0;
-	}
+		indices_buffers_uptodate_[prim] = true;
+		nb_indices_[prim] = builder.nb_indices();
+		if (prim == BOUNDARY)
+			boundary_dimension_ = builder.boundary_dimension();
 
-	template <typename MAP, typename MASK>
-	inline auto init_boundaries(const MAP& m, const MASK& /*mask*/, std::vector<uint32>& table_indices)
-		-> typename std::enable_if<MAP::DIMENSION == 1 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		// if the given MASK is not a BoundaryCache, build a BoundaryCache and use it
-		typename MAP::BoundaryCache bcache(m);
-		init_boundaries(m, bcache, table_indices);
-	}
+		if (nb_indices_[prim] == 0u)
+			return;
 
-	template <typename MAP, typename MASK>
-	inline auto init_boundaries(const MAP& m, const MASK& mask, std::vector<uint32>& table_indices)
-		-> typename std::enable_if<MAP::DIMENSION == 2 && std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		using Vertex = typename MAP::Vertex;
-		using Edge = typename MAP::Edge;
-		using Face = typename MAP::Face;
+		const int32 nb_bytes = int32(nb_indices_[prim] * sizeof(uint32));
 
-		m.foreach_cell([&] (Face f)
+		if (!indices_buffers_[prim]->isCreated())
+			indices_buffers_[prim]->create();
+		indices_buffers_[prim]->bind();
+		indices_buffers_[prim]->allocate(nb_bytes);
+		uint32* ptr = static_cast<uint32*>(indices_buffers_[prim]->map(QOpenGLBuffer::WriteOnly));
+		bool written = false;
+		if (ptr)
 		{
-			m.foreach_incident_edge(f, [&] (Edge e)
-			{
-				table_indices.push_back(m.embedding(Vertex(e.dart)));
-				table_indices.push_back(m.embedding(Vertex(m.phi1(e.dart))));
-			});
-		},
-		mask);
-
-		boundary_dimension_ = 1;
-	}
-
-	template <typename MAP, typename MASK>
-	inline auto init_boundaries(const MAP& m, const MASK& /*mask*/, std::vector<uint32>& table_indices)
-		-> typename std::enable_if<MAP::DIMENSION == 2 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		// if the given MASK is not a BoundaryCache, build a BoundaryCache and use it
-		typename MAP::BoundaryCache bcache(m);
-		init_boundaries(m, bcache, table_indices);
-	}
-
-	template <typename MAP, typename MASK>
-	inline auto init_boundaries(const MAP& m, const MASK& mask, std::vector<uint32>& table_indices)
-		-> typename std::enable_if<MAP::DIMENSION == 3 && std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		using Vertex = typename MAP::Vertex;
-		using Face = typename MAP::Face;
-		using Volume = typename MAP::Volume;
-
-		m.foreach_cell([&] (Volume v)
+			builder.write(ptr);
+			written = indices_buffers_[prim]->unmap();
+		}
+		if (!written)
 		{
-			m.foreach_incident_face(v, [&] (Face f)
-			{
-				Dart d0 = f.dart;
-				Dart d1 = m.phi1(d0);
-				Dart d2 = m.phi1(d1);
-				do
-				{
-					table_indices.push_back(m.embedding(Vertex(d0)));
-					table_indices.push_back(m.embedding(Vertex(d1)));
-					table_indices.push_back(m.embedding(Vertex(d2)));
-					d1 = d2;
-					d2 = m.phi1(d1);
-				} while(d2 != d0);
-			});
-		},
-		mask);
-
-		boundary_dimension_ = 2;
-	}
-
-	template <typename MAP, typename MASK>
-	inline auto init_boundaries(const MAP& m, const MASK& mask, std::vector<uint32>& table_indices)
-		-> typename std::enable_if<MAP::DIMENSION == 3 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		unused_parameters(mask);
-		// if the given MASK is not a BoundaryCache, build a BoundaryCache and use it
-		typename MAP::BoundaryCache bcache(m);
-		init_boundaries(m, bcache, table_indices);
+			std::vector<uint32> table_indices(nb_indices_[prim]);
+			builder.write(table_indices.data());
+			indices_buffers_[prim]->write(0, table_indices.data(), nb_bytes);
+		}
+		indices_buffers_[prim]->release();
 	}
 
 public:
@@ -260,129 +115,15 @@ public:
 		DrawingType prim,
 		const VERTEX_ATTR* position
 	)
-		-> typename std::enable_if<(MAP::DIMENSION == 2 || MAP::DIMENSION == 3) && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
+		-> typename std::enable_if<!std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
 	{
 		static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"attribute must be a vertex attribute");
 
-		using VEC3 = InsideTypeOf<VERTEX_ATTR>;
-
-		std::vector<uint32> table_indices;
-
-		switch (prim)
-		{
-			case POINTS:
-				init_points(m, mask, table_indices);
-				break;
-			case LINES:
-				init_lines(m, mask, table_indices);
-				break;
-			case TRIANGLES:
-				if (position)
-					init_triangles_ear<VEC3>(m, mask, table_indices, position);
-				else
-					init_triangles(m, mask, table_indices);
-				break;
-			case BOUNDARY:
-				init_boundaries(m, mask, table_indices);
-				break;
-			default:
-				break;
-		}
-
-		indices_buffers_uptodate_[prim] = true;
-		nb_indices_[prim] = uint32(table_indices.size());
-
-		if (table_indices.empty())
-			return;
-
-		if (!indices_buffers_[prim]->isCreated())
-			indices_buffers_[prim]->create();
-		indices_buffers_[prim]->bind();
-		indices_buffers_[prim]->allocate(&(table_indices[0]), nb_indices_[prim] * sizeof(uint32));
-		indices_buffers_[prim]->release();
+		IndexBufferBuilder builder;
+		builder.init(m, mask, prim, position);
+		upload_indices(prim, builder);
 	}
 
-	template <typename MAP, typename MASK, typename VERTEX_ATTR>
-	inline auto init_primitives(
-		const MAP& m,
-		const MASK& mask,
-		DrawingType prim,
-		const VERTEX_ATTR* /*position*/
-	)
-		-> typename std::enable_if<MAP::DIMENSION == 0 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"attribute must be a vertex attribute");
-
-		using VEC3 = InsideTypeOf<VERTEX_ATTR>;
-
-		std::vector<uint32> table_indices;
-
-		switch (prim)
-		{
-			case POINTS:
-				init_points(m, mask, table_indices);
-				break;
-			default:
-				break;
-		}
-
-		indices_buffers_uptodate_[prim] = true;
-		nb_indices_[prim] = uint32(table_indices.size());
-
-		if (table_indices.empty())
-			return;
-
-		if (!indices_buffers_[prim]->isCreated())
-			indices_buffers_[prim]->create();
-		indices_buffers_[prim]->bind();
-		indices_buffers_[prim]->allocate(&(table_indices[0]), nb_indices_[prim] * sizeof(uint32));
-		indices_buffers_[prim]->release();
-	}
-
-	template <typename MAP, typename MASK, typename VERTEX_ATTR>
-	inline auto init_primitives(
-		const MAP& m,
-		const MASK& mask,
-		DrawingType prim,
-		const VERTEX_ATTR* /*position*/
-	)
-		-> typename std::enable_if<MAP::DIMENSION == 1 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"attribute must be a vertex attribute");
-
-		using VEC3 = InsideTypeOf<VERTEX_ATTR>;
-
-		std::vector<uint32> table_indices;
-
-		switch (prim)
-		{
-			case POINTS:
-				init_points(m, mask, table_indices);
-				break;
-			case LINES:
-				init_lines(m, mask, table_indices);
-				break;
-			case BOUNDARY:
-				init_boundaries(m, mask, table_indices);
-				break;
-			default:
-				break;
-		}
-
-		indices_buffers_uptodate_[prim] = true;
-		nb_indices_[prim] = uint32(table_indices.size());
-
-		if (table_indices.empty())
-			return;
-
-		if (!indices_buffers_[prim]->isCreated())
-			indices_buffers_[prim]->create();
-		indices_buffers_[prim]->bind();
-		indices_buffers_[prim]->allocate(&(table_indices[0]), nb_indices_[prim] * sizeof(uint32));
-		indices_buffers_[prim]->release();
-	}
-
-
 	template <typename MAP, typename VERTEX_ATTR>
 	inline void init_primitives(
 		const MAP& m,
@@ -399,109 +140,11 @@ public:
 		const MASK& mask,
 		DrawingType prim
 	)
-		-> typename std::enable_if<(MAP::DIMENSION == 2 || MAP::DIMENSION == 3) && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		std::vector<uint32> table_indices;
-
-		switch (prim)
-		{
-			case POINTS:
-				init_points(m, mask, table_indices);
-				break;
-			case LINES:
-				init_lines(m, mask, table_indices);
-				break;
-			case TRIANGLES:
-				init_triangles(m, mask, table_indices);
-				break;
-			case BOUNDARY:
-				init_boundaries(m, mask, table_indices);
-				break;
-			default:
-				break;
-		}
-
-		indices_buffers_uptodate_[prim] = true;
-		nb_indices_[prim] = uint32(table_indices.size());
-
-		if (table_indices.empty())
-			return;
-
-		if (!indices_buffers_[prim]->isCreated())
-			indices_buffers_[prim]->create();
-		indices_buffers_[prim]->bind();
-		indices_buffers_[prim]->allocate(&(table_indices[0]), nb_indices_[prim] * sizeof(uint32));
-		indices_buffers_[prim]->release();
-	}
-
-	template <typename MAP, typename MASK>
-	inline auto init_primitives(
-		const MAP& m,
-		const MASK& mask,
-		DrawingType prim
-	)
-		-> typename std::enable_if<MAP::DIMENSION == 0 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
+		-> typename std::enable_if<!std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
 	{
-		std::vector<uint32> table_indices;
-
-		switch (prim)
-		{
-			case POINTS:
-				init_points(m, mask, table_indices);
-				break;
-			default:
-				break;
-		}
-
-		indices_buffers_uptodate_[prim] = true;
-		nb_indices_[prim] = uint32(table_indices.size());
-
-		if (table_indices.empty())
-			return;
-
-		if (!indices_buffers_[prim]->isCreated())
-			indices_buffers_[prim]->create();
-		indices_buffers_[prim]->bind();
-		indices_buffers_[prim]->allocate(&(table_indices[0]), nb_indices_[prim] * sizeof(uint32));
-		indices_buffers_[prim]->release();
-	}
-
-	template <typename MAP, typename MASK>
-	inline auto init_primitives(
-		const MAP& m,
-		const MASK& mask,
-		DrawingType prim
-	)
-		-> typename std::enable_if<MAP::DIMENSION == 1 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
-	{
-		std::vector<uint32> table_indices;
-
-		switch (prim)
-		{
-			case POINTS:
-				init_points(m, mask, table_indices);
-				break;
-			case LINES:
-				init_lines(m, mask, table_indices);
-				break;
-			case BOUNDARY:
-				init_boundaries(m, mask, table_indices);
-				break;
-			default:
-				break;
-		}
-
-		indices_buffers_uptodate_[prim] = true;
-		nb_indices_[prim] = uint32(table_indices.size());
-
-		if (table_indices.empty())
-			return;
-
-		if (!indices_buffers_[prim]->isCreated())
-			indices_buffers_[prim]->create();
-		indices_buffers_[prim]->bind();
-		indices_buffers_[prim]->allocate(&(table_indices[0]), nb_indices_[prim] * sizeof(uint32));
-		indices_buffers_[prim]->release();
+		IndexBufferBuilder builder;
+		builder.init(m, mask, prim);
+		upload_indices(prim, builder);
 	}
 
 	template <typename MAP>
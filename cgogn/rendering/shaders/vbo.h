@@ -30,6 +30,7 @@
 #include <cgogn/core/cmap/attribute.h>
 #include <cgogn/core/cmap/map_traits.h>
 #include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/rendering/shaders/vbo_conversion.h>
 
 namespace cgogn
 {
@@ -45,6 +46,7 @@ protected:
 	uint32 vector_dimension_;
 	QOpenGLBuffer buffer_;
 	std::string name_;
+	ChunkVersions uploaded_versions_;
 
 public:
 
@@ -113,6 +115,7 @@ public:
 	 */
 	inline float32* lock_pointer()
 	{
+		uploaded_versions_.clear();
 		buffer_.bind();
 		return reinterpret_cast<float32*>(buffer_.map(QOpenGLBuffer::ReadWrite));
 	}
@@ -154,6 +157,15 @@ public:
 		return buffer_.bufferId();
 	}
 
+	/**
+	 * @brief versions of the chunks of the attribute uploaded by update_vbo or update_vbo_incremental
+	 * (see ChunkArrayGen::modified_chunks), the other updates of the buffer must clear them
+	 */
+	inline ChunkVersions& uploaded_versions()
+	{
+		return uploaded_versions_;
+	}
+
 };
 
 /**
@@ -170,6 +182,7 @@ void update_vbo(const std::vector<VEC>& vector, VBO* vbo)
 	const uint32 vec_dim = geometry::vector_traits<VEC>::SIZE;
 	uint32 vec_sz = uint32(vector.size());
 	vbo->allocate(vec_sz, vec_dim);
+	vbo->uploaded_versions().clear();
 	const uint32 vbo_bytes =  vec_dim * vec_sz * uint32(sizeof(float32));
 
 	// handle the case where we want to use SIMD with Eigen::AlignedVector3
@@ -242,6 +255,9 @@ void update_vbo(const ATTR& attr, VBO* vbo)
 
 	vbo->allocate(nb_chunks * ATTR::CHUNK_SIZE, vec_dim);
 
+	// the whole attribute is uploaded
+	ca->modified_chunks(vbo->uploaded_versions());
+
 	const uint32 vbo_blk_bytes = ATTR::CHUNK_SIZE * vec_dim * sizeof(float32);
 
 	// handle the case where we want to use SIMD with Eigen::AlignedVector3
@@ -296,6 +312,119 @@ void update_vbo(const ATTR& attr, VBO* vbo)
 	}
 }
 
+namespace internal
+{
+
+// maximal number of chunks converted and uploaded at once by upload_chunks
+const uint32 MAX_UPLOAD_RUN = 64u;
+
+/**
+ * @brief upload some chunks of elements of type T (float or vec<float>) in an allocated vbo.
+ * The chunks are converted to float in parallel if needed and the consecutive chunks are uploaded at once,
+ * by runs of at most MAX_UPLOAD_RUN chunks: the conversion buffer is bounded and released after the upload.
+ */
+template <typename T>
+void upload_chunks(const std::vector<const void*>& chunk_addr, uint32 chunk_size, const std::vector<uint32>& chunks, VBO* vbo)
+{
+	using Scalar = geometry::ScalarOf<T>;
+
+	if (chunks.empty())
+		return;
+
+	const uint32 vec_dim = geometry::vector_traits<T>::SIZE;
+	const uint32 vbo_blk_bytes = chunk_size * vec_dim * sizeof(float32);
+
+	// float vectors without padding are uploaded directly from the chunks
+	if (std::is_same<Scalar, float32>::value && sizeof(T) == vec_dim * sizeof(float32))
+	{
+		vbo->bind();
+		for (uint32 c : chunks)
+			vbo->copy_data(c * vbo_blk_bytes, vbo_blk_bytes, chunk_addr[c]);
+		vbo->release();
+		return;
+	}
+
+	std::vector<float32> buffer;
+	std::vector<uint32> run;
+	vbo->bind();
+	for (uint32 k = 0u, nb = uint32(chunks.size()); k < nb;)
+	{
+		uint32 l = k + 1u;
+		while (l < nb && l - k < MAX_UPLOAD_RUN && chunks[l] == chunks[l - 1u] + 1u)
+			++l;
+		run.assign(chunks.begin() + k, chunks.begin() + l);
+		convert_chunks_to_float32<T>(chunk_addr, chunk_size, run, buffer);
+		vbo->copy_data(chunks[k] * vbo_blk_bytes, (l - k) * std::size_t(vbo_blk_bytes), buffer.data());
+		k = l;
+	}
+	vbo->release();
+}
+
+} // namespace internal
+
+/**
+ * @brief update vbo from the chunks of one Attribute modified since its last upload (see ChunkArrayGen::set_dirty).
+ * The whole attribute is uploaded if the size of the vbo does not match the attribute.
+ * The modified chunks are converted to float in parallel and the consecutive chunks are uploaded at once.
+ * @param attr Attribute (must contain float or vec<float>)
+ * @param vbo vbo to update
+ */
+template <typename ATTR>
+void update_vbo_incremental(const ATTR& attr, VBO* vbo)
+{
+	using Scalar = geometry::ScalarOf<InsideTypeOf<ATTR>>;
+	static_assert(std::is_same<Scalar, float32>::value || std::is_same<Scalar, float64>::value, "only float or double allowed for vbo");
+
+	const typename ATTR::TChunkArray* ca = attr.data();
+
+	vbo->set_name(attr.name());
+
+	const uint32 nb_chunks = ca->nb_chunks();
+	const uint32 vec_dim = geometry::vector_traits<InsideTypeOf<ATTR>>::SIZE;
+
+	// the versions are read before the upload: the chunks modified meanwhile will be uploaded again
+	std::vector<uint32> chunks = ca->modified_chunks(vbo->uploaded_versions());
+	if (vbo->size() != nb_chunks * ATTR::CHUNK_SIZE || vbo->vector_dimension() != vec_dim)
+	{
+		vbo->allocate(nb_chunks * ATTR::CHUNK_SIZE, vec_dim);
+		chunks.resize(nb_chunks);
+		for (uint32 i = 0u; i < nb_chunks; ++i)
+			chunks[i] = i;
+	}
+
+	uint32 byte_chunk_size;
+	internal::upload_chunks<InsideTypeOf<ATTR>>(ca->chunks_pointers(byte_chunk_size), ATTR::CHUNK_SIZE, chunks, vbo);
+}
+
+/**
+ * @brief update vbo from a view of an AttributeSnapshot (see core/cmap/attribute_snapshot.h)
+ * @param view the view to upload (must contain float or vec<float>)
+ * @param vbo vbo to update
+ * @param uploaded the view previously uploaded in the vbo, if any: only the chunks changed since are uploaded
+ */
+template <typename VIEW>
+void update_vbo_from_snapshot(const VIEW& view, VBO* vbo, const VIEW* uploaded = nullptr)
+{
+	using T = typename VIEW::value_type;
+
+	const uint32 nb_chunks = view.nb_chunks();
+	const uint32 vec_dim = geometry::vector_traits<T>::SIZE;
+
+	std::vector<uint32> chunks;
+	if (uploaded == nullptr || vbo->size() != nb_chunks * VIEW::CHUNK_SIZE || vbo->vector_dimension() != vec_dim)
+	{
+		vbo->allocate(nb_chunks * VIEW::CHUNK_SIZE, vec_dim);
+		chunks.resize(nb_chunks);
+		for (uint32 i = 0u; i < nb_chunks; ++i)
+			chunks[i] = i;
+	}
+	else
+		chunks = view.changed_chunks(*uploaded);
+	vbo->uploaded_versions().clear();
+
+	internal::upload_chunks<T>(view.chunks_pointers(), VIEW::CHUNK_SIZE, chunks, vbo);
+}
+
 /**
  * @brief update vbo from one Attribute with conversion lambda
  * @param attr Attribute
@@ -0,0 +1,113 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_RENDERING_SHADERS_VBO_CONVERSION_H_
+#define CGOGN_RENDERING_SHADERS_VBO_CONVERSION_H_
+
+#include <vector>
+#include <algorithm>
+
+#include <cgogn/core/cmap/attribute.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/geometry/types/geometry_traits.h>
+
+namespace cgogn
+{
+
+namespace rendering
+{
+
+/**
+ * @brief convert n scalars into float32 (a plain loop, vectorized by the compiler)
+ */
+inline void convert_to_float32(const float64* src, std::size_t n, float32* dst)
+{
+	for (std::size_t i = 0u; i < n; ++i)
+		dst[i] = float32(src[i]);
+}
+
+inline void convert_to_float32(const float32* src, std::size_t n, float32* dst)
+{
+	std::copy(src, src + n, dst);
+}
+
+/**
+ * @brief convert some chunks of float or vec<float> (float32 or float64) elements of type T
+ * into packed float32 vectors (the padding component of the aligned vectors is dropped), in parallel
+ * @param chunk_addr pointers to the chunks (see ChunkArray::chunks_pointers)
+ * @param chunk_size number of elements of a chunk
+ * @param chunks indices of the chunks to convert
+ * @param buffer receives the converted chunk chunks[k] at the offset k * chunk_size * vec_dim,
+ * it is only enlarged, so that it can be reused from one conversion to the other
+ */
+template <typename T>
+void convert_chunks_to_float32(
+	const std::vector<const void*>& chunk_addr,
+	uint32 chunk_size,
+	const std::vector<uint32>& chunks,
+	std::vector<float32>& buffer
+)
+{
+	using Scalar = geometry::ScalarOf<T>;
+	static_assert(std::is_same<Scalar, float32>::value || std::is_same<Scalar, float64>::value, "only float or double allowed for vbo");
+
+	const uint32 vec_dim = uint32(geometry::vector_traits<T>::SIZE);
+	const uint32 src_dim = uint32(sizeof(T) / sizeof(Scalar));
+	const std::size_t chunk_floats = std::size_t(chunk_size) * vec_dim;
+
+	if (buffer.size() < chunks.size() * chunk_floats)
+		buffer.resize(chunks.size() * chunk_floats);
+
+	parallel_for(0u, uint32(chunks.size()), 1u, [&] (uint32 first, uint32 last)
+	{
+		for (uint32 k = first; k < last; ++k)
+		{
+			cgogn_message_assert(chunks[k] < chunk_addr.size(), "convert_chunks_to_float32: chunk out of the array");
+			const Scalar* src = static_cast<const Scalar*>(chunk_addr[chunks[k]]);
+			float32* dst = buffer.data() + k * chunk_floats;
+			if (src_dim == vec_dim)
+				convert_to_float32(src, chunk_floats, dst);
+			else
+			{
+				for (uint32 i = 0u; i < chunk_size; ++i, src += src_dim, dst += vec_dim)
+					convert_to_float32(src, vec_dim, dst);
+			}
+		}
+	});
+}
+
+/**
+ * @brief convert some chunks of an Attribute of float or vec<float> (see above)
+ */
+template <typename ATTR>
+void convert_chunks_to_float32(const ATTR& attr, const std::vector<uint32>& chunks, std::vector<float32>& buffer)
+{
+	uint32 byte_chunk_size;
+	convert_chunks_to_float32<InsideTypeOf<ATTR>>(attr.data()->chunks_pointers(byte_chunk_size), ATTR::CHUNK_SIZE, chunks, buffer);
+}
+
+} // namespace rendering
+
+} // namespace cgogn
+
+#endif // CGOGN_RENDERING_SHADERS_VBO_CONVERSION_H_
@@ -0,0 +1,205 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/utils/masks.h>
+#include <cgogn/geometry/types/vec.h>
+#include <cgogn/modeling/tiling/square_grid.h>
+#include <cgogn/rendering/index_buffer.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The IndexBufferTest class compares the indices built in parallel by the IndexBufferBuilder
+ * with the former serial generation of MapRender (map.foreach_cell and push_back),
+ * on a grid with a pentagon, a digon and a face of degree one.
+ */
+class IndexBufferTest : public testing::Test
+{
+public:
+
+	using Vec3 = geometry::Vec_T<std::array<float64, 3>>;
+	using Vertex = CMap2::Vertex;
+	using Edge = CMap2::Edge;
+	using Face = CMap2::Face;
+	template <typename T>
+	using VertexAttribute = CMap2::VertexAttribute<T>;
+
+protected:
+
+	CMap2 map_;
+	VertexAttribute<Vec3> position_;
+
+	IndexBufferTest()
+	{
+		position_ = map_.add_attribute<Vec3, Vertex>("position");
+		modeling::SquareGrid<CMap2> grid(map_, 30u, 30u);
+		grid.embed_into_grid(position_, 1.0f, 1.0f, 0.0f);
+
+		uint32 k = 0u;
+		for (uint32 n : { 5u, 2u, 1u })
+		{
+			const Face f = map_.add_face(n);
+			map_.foreach_incident_vertex(f, [&] (Vertex v)
+			{
+				const float64 a = 2.0 * float64(k++) / float64(n);
+				position_[v] = Vec3(2.0 + std::cos(a), std::sin(a), 0.0);
+			});
+		}
+	}
+
+	template <typename MASK>
+	std::vector<uint32> serial_points(const MASK& mask)
+	{
+		std::vector<uint32> indices;
+		map_.foreach_cell([&] (Vertex v) { indices.push_back(map_.embedding(v)); }, mask);
+		return indices;
+	}
+
+	template <typename MASK>
+	std::vector<uint32> serial_lines(const MASK& mask)
+	{
+		std::vector<uint32> indices;
+		map_.foreach_cell([&] (Edge e)
+		{
+			indices.push_back(map_.embedding(Vertex(e.dart)));
+			indices.push_back(map_.embedding(Vertex(map_.phi1(e.dart))));
+		},
+		mask);
+		return indices;
+	}
+
+	template <typename MASK>
+	std::vector<uint32> serial_triangles(const MASK& mask)
+	{
+		std::vector<uint32> indices;
+		map_.foreach_cell([&] (Face f)
+		{
+			Dart d0 = f.dart;
+			Dart d1 = map_.phi1(d0);
+			Dart d2 = map_.phi1(d1);
+			do
+			{
+				indices.push_back(map_.embedding(Vertex(d0)));
+				indices.push_back(map_.embedding(Vertex(d1)));
+				indices.push_back(map_.embedding(Vertex(d2)));
+				d1 = d2;
+				d2 = map_.phi1(d1);
+			} while (d2 != d0);
+		},
+		mask);
+		return indices;
+	}
+
+	template <typename MASK>
+	std::vector<uint32> serial_triangles_ear(const MASK& mask)
+	{
+		std::vector<uint32> indices;
+		map_.foreach_cell([&] (Face f)
+		{
+			if (map_.has_codegree(f, 3))
+			{
+				indices.push_back(map_.embedding(Vertex(f.dart)));
+				indices.push_back(map_.embedding(Vertex(map_.phi1(f.dart))));
+				indices.push_back(map_.embedding(Vertex(map_.phi1(map_.phi1(f.dart)))));
+			}
+			else
+				geometry::append_ear_triangulation(map_, f, position_, indices);
+		},
+		mask);
+		return indices;
+	}
+
+	template <typename MASK>
+	void check(const MASK& mask)
+	{
+		std::vector<uint32> indices;
+		rendering::build_index_buffer(map_, mask, rendering::POINTS, indices);
+		EXPECT_EQ(indices, serial_points(mask));
+		rendering::build_index_buffer(map_, mask, rendering::LINES, indices);
+		EXPECT_EQ(indices, serial_lines(mask));
+		rendering::build_index_buffer(map_, mask, rendering::TRIANGLES, indices);
+		EXPECT_EQ(indices, serial_triangles(mask));
+		rendering::build_index_buffer(map_, mask, rendering::TRIANGLES, &position_, indices);
+		EXPECT_EQ(indices, serial_triangles_ear(mask));
+	}
+};
+
+TEST_F(IndexBufferTest, AllCells)
+{
+	check(AllCellsFilter());
+}
+
+TEST_F(IndexBufferTest, EmbeddedCells)
+{
+	// the cells of the embedded orbits are selected in parallel
+	map_.add_attribute<uint32, Edge>("edge");
+	map_.add_attribute<uint32, Face>("face");
+	check(AllCellsFilter());
+}
+
+TEST_F(IndexBufferTest, FilteredCells)
+{
+	map_.add_attribute<uint32, Face>("face");
+	CellFilters filters;
+	filters.set_filter<Vertex>([&] (Vertex v) { return position_[v][0] < 0.5; });
+	filters.set_filter<Edge>([&] (Edge e) { return map_.embedding(Vertex(e.dart)) % 3u != 0u; });
+	filters.set_filter<Face>([&] (Face f) { return map_.embedding(f) % 2u == 0u || map_.codegree(f) != 4u; });
+	check(filters);
+}
+
+TEST_F(IndexBufferTest, CachedCells)
+{
+	CellCache<CMap2> cache(map_);
+	cache.build<Vertex>();
+	cache.build<Edge>();
+	cache.build<Face>();
+	check(cache);
+}
+
+TEST_F(IndexBufferTest, Boundary)
+{
+	CMap2::BoundaryCache bcache(map_);
+	std::vector<uint32> expected;
+	map_.foreach_cell([&] (Face f)
+	{
+		map_.foreach_incident_edge(f, [&] (Edge e)
+		{
+			expected.push_back(map_.embedding(Vertex(e.dart)));
+			expected.push_back(map_.embedding(Vertex(map_.phi1(e.dart))));
+		});
+	},
+	bcache);
+
+	rendering::IndexBufferBuilder builder;
+	builder.init(map_, AllCellsFilter(), rendering::BOUNDARY);
+	EXPECT_EQ(builder.boundary_dimension(), 1u);
+	std::vector<uint32> indices(builder.nb_indices());
+	builder.write(indices.data());
+	EXPECT_EQ(indices, expected);
+}
+
+} // namespace cgogn
@@ -0,0 +1,119 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/types/vec.h>
+#include <cgogn/rendering/shaders/vbo_conversion.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The VboConversionTest class checks the conversion of a subset of chunks into packed float32 vectors
+ * for scalars, packed vectors and padded (aligned) vectors of float32 and float64.
+ */
+template <typename T>
+class VboConversionTest : public testing::Test
+{
+public:
+
+	using Scalar = geometry::ScalarOf<T>;
+
+	static const uint32 CHUNK_SIZE = 16u;
+	static const uint32 NB_CHUNKS = 5u;
+	static const uint32 VEC_DIM = uint32(geometry::vector_traits<T>::SIZE);
+
+protected:
+
+	std::vector<std::vector<T, Eigen::aligned_allocator<T>>> chunks_;
+	std::vector<const void*> chunk_addr_;
+
+	VboConversionTest()
+	{
+		chunks_.resize(NB_CHUNKS);
+		for (uint32 c = 0u; c < NB_CHUNKS; ++c)
+		{
+			chunks_[c].resize(CHUNK_SIZE);
+			for (uint32 i = 0u; i < CHUNK_SIZE; ++i)
+			{
+				Scalar* v = reinterpret_cast<Scalar*>(&chunks_[c][i]);
+				for (uint32 j = 0u; j < VEC_DIM; ++j)
+					v[j] = value(c, i, j);
+			}
+			chunk_addr_.push_back(chunks_[c].data());
+		}
+	}
+
+	/**
+	 * @brief the component j of the element i of the chunk c (exact in float32)
+	 */
+	static Scalar value(uint32 c, uint32 i, uint32 j)
+	{
+		return Scalar(c * 1000u + i * 10u + j) + Scalar(0.25);
+	}
+};
+
+using ConvertedTypes = testing::Types<
+	float32,
+	float64,
+	geometry::Vec_T<std::array<float64, 3>>,
+	Eigen::Vector3f,
+	Eigen::Vector3d,
+	Eigen::AlignedVector3<float32>,
+	Eigen::AlignedVector3<float64>
+>;
+TYPED_TEST_CASE(VboConversionTest, ConvertedTypes);
+
+TYPED_TEST(VboConversionTest, ConvertChunks)
+{
+	const uint32 CHUNK_SIZE = TestFixture::CHUNK_SIZE;
+	const uint32 VEC_DIM = TestFixture::VEC_DIM;
+
+	const std::vector<uint32> chunks = { 3u, 0u, 4u };
+	std::vector<float32> buffer;
+	rendering::convert_chunks_to_float32<TypeParam>(this->chunk_addr_, CHUNK_SIZE, chunks, buffer);
+	ASSERT_EQ(buffer.size(), chunks.size() * CHUNK_SIZE * VEC_DIM);
+
+	// the chunk chunks[k] is packed at the offset k * CHUNK_SIZE * VEC_DIM
+	for (uint32 k = 0u; k < uint32(chunks.size()); ++k)
+		for (uint32 i = 0u; i < CHUNK_SIZE; ++i)
+			for (uint32 j = 0u; j < VEC_DIM; ++j)
+				EXPECT_EQ(buffer[(k * CHUNK_SIZE + i) * VEC_DIM + j], float32(TestFixture::value(chunks[k], i, j)));
+
+	// the buffer is reused: it is not shrunk for a smaller conversion
+	buffer.assign(buffer.size(), -1.0f);
+	rendering::convert_chunks_to_float32<TypeParam>(this->chunk_addr_, CHUNK_SIZE, { 2u }, buffer);
+	EXPECT_EQ(buffer.size(), chunks.size() * CHUNK_SIZE * VEC_DIM);
+	for (uint32 i = 0u; i < CHUNK_SIZE; ++i)
+		for (uint32 j = 0u; j < VEC_DIM; ++j)
+			EXPECT_EQ(buffer[i * VEC_DIM + j], float32(TestFixture::value(2u, i, j)));
+	EXPECT_EQ(buffer[CHUNK_SIZE * VEC_DIM], -1.0f);
+
+	// nothing to convert
+	rendering::convert_chunks_to_float32<TypeParam>(this->chunk_addr_, CHUNK_SIZE, {}, buffer);
+	EXPECT_EQ(buffer[0], float32(TestFixture::value(2u, 0u, 0u)));
+}
+
+} // namespace cgogn
@@ -0,0 +1,470 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_TOPOLOGY_DELTA_STEPPING_H_
+#define CGOGN_TOPOLOGY_DELTA_STEPPING_H_
+
+#include <map>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include <cgogn/topology/dll.h>
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+#include <cgogn/core/cmap/csr_incidence.h>
+
+namespace cgogn
+{
+
+namespace topology
+{
+
+/**
+ * @brief The DeltaStepping class computes shortest path distances in the graph of the vertices and edges of a map
+ * with the Delta-stepping algorithm (Meyer & Sanders): the vertices are processed by buckets of width delta
+ * of their tentative distance, the light edges (weight <= delta) of a bucket are relaxed until the bucket is empty,
+ * then the heavy edges of all the vertices settled in the bucket are relaxed once.
+ *
+ * The graph is a snapshot of the adjacency of a CSRIncidence and of the edge weights, taken at construction,
+ * with the vertices numbered as in the CSRIncidence.
+ * The relaxations of a phase are computed in parallel from a copy of the distances of the processed vertices:
+ * the requests are sorted by owner (a range of target vertices) and each owner applies its requests,
+ * so the distances are never written concurrently and the result does not depend on the number of threads.
+ *
+ * In batch mode, K <= MAX_NB_LANES distance fields (one per source) are computed in the same sweep and stored
+ * in a vertex-major array of K-wide distance vectors (the distance of the i-th vertex to the k-th source is distances[i*K + k]).
+ * The lanes of a vertex are processed in the buckets of their own distances and only the decreased lanes are relaxed
+ * (all the lanes in a plain loop when they are processed together, e.g. for close sources).
+ */
+template <typename Scalar, typename MAP>
+class DeltaStepping
+{
+	using Edge = typename MAP::Edge;
+
+	template <typename T>
+	using EdgeAttribute = typename MAP::template EdgeAttribute<T>;
+
+	/// a relaxation of the distances of the target vertex from the slot-th processed vertex
+	struct Request
+	{
+		uint32 target_;
+		uint32 slot_;
+		Scalar weight_;
+	};
+
+	/// number of processed vertices per request generation task
+	static const uint32 CHUNK_SIZE = 512u;
+	/// number of target vertex ranges (owners) in which the requests are sorted
+	static const uint32 NB_OWNERS = 64u;
+
+public:
+
+	/// maximal number of distance fields computed by compute_batch
+	static const uint32 MAX_NB_LANES = 64u;
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(DeltaStepping);
+
+	/**
+	 * @brief build the snapshot of the graph
+	 * @param incidence a built CSRIncidence of the map
+	 * @param weight the (non negative) weights of the edges
+	 * The bucket width is initialized to the mean edge weight.
+	 */
+	DeltaStepping(const CSRIncidence<MAP>& incidence, const EdgeAttribute<Scalar>& weight) :
+		delta_(Scalar(1))
+	{
+		cgogn_message_assert(incidence.is_valid(), "DeltaStepping: the incidence snapshot is not valid");
+
+		const uint32 nb_vertices = incidence.nb_vertices();
+		offsets_.assign(nb_vertices + 1u, 0u);
+		for (uint32 i = 0u; i < nb_vertices; ++i)
+			offsets_[i + 1u] = offsets_[i] + incidence.adjacent_vertices(i).size();
+
+		targets_.resize(offsets_[nb_vertices]);
+		weights_.resize(offsets_[nb_vertices]);
+		light_end_.resize(nb_vertices);
+		parallel_for(0u, nb_vertices, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				uint32 k = offsets_[i];
+				for (Dart d : incidence.adjacent_vertices(i))
+				{
+					targets_[k] = incidence.vertex_index(d);
+					weights_[k] = weight[Edge(d)];
+					++k;
+				}
+			}
+		});
+
+		float64 sum = 0.0;
+		for (Scalar w : weights_)
+			sum += float64(w);
+		set_delta(weights_.empty() || sum <= 0.0 ? Scalar(1) : Scalar(sum / float64(weights_.size())));
+	}
+
+	inline uint32 nb_vertices() const { return uint32(light_end_.size()); }
+
+	inline Scalar delta() const { return delta_; }
+
+	/**
+	 * @brief set the width of the buckets (the light edges are the edges whose weight is lower than delta)
+	 * A small delta gives an ordering close to Dijkstra's one with few vertices per phase,
+	 * a large delta gives large phases in which the vertices may be relaxed several times.
+	 */
+	void set_delta(Scalar delta)
+	{
+		cgogn_message_assert(delta > Scalar(0), "DeltaStepping: delta must be positive");
+		delta_ = delta;
+		// sort the adjacent vertices of each vertex: light edges first
+		parallel_for(0u, nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				uint32 l = offsets_[i];
+				for (uint32 k = offsets_[i]; k < offsets_[i + 1u]; ++k)
+				{
+					if (weights_[k] <= delta_)
+					{
+						std::swap(targets_[k], targets_[l]);
+						std::swap(weights_[k], weights_[l]);
+						++l;
+					}
+				}
+				light_end_[i] = l;
+			}
+		});
+	}
+
+	/**
+	 * @brief compute the distance of each vertex to the nearest source
+	 * @param[in] sources the indices of the source vertices
+	 * @param[out] distances the distances (std::numeric_limits<Scalar>::max() for the unreachable vertices)
+	 */
+	void compute(const std::vector<uint32>& sources, std::vector<Scalar>& distances)
+	{
+		std::vector<std::pair<uint32, uint32>> lane_sources;
+		lane_sources.reserve(sources.size());
+		for (uint32 s : sources)
+			lane_sources.push_back(std::make_pair(s, 0u));
+		run(1u, lane_sources, distances, nullptr);
+	}
+
+	/**
+	 * @brief compute the distance of each vertex to the nearest source and a shortest path tree
+	 * @param[in] sources the indices of the source vertices
+	 * @param[out] distances the distances (std::numeric_limits<Scalar>::max() for the unreachable vertices)
+	 * @param[out] predecessors the index of the previous vertex on a shortest path to a source
+	 * (the index of the vertex itself for the sources, INVALID_INDEX for the unreachable vertices)
+	 * The predecessor of a vertex is recorded by the relaxations that strictly decrease its distance,
+	 * so that the tree has no cycle, even with edges of weight zero.
+	 */
+	void compute(const std::vector<uint32>& sources, std::vector<Scalar>& distances, std::vector<uint32>& predecessors)
+	{
+		std::vector<std::pair<uint32, uint32>> lane_sources;
+		lane_sources.reserve(sources.size());
+		for (uint32 s : sources)
+			lane_sources.push_back(std::make_pair(s, 0u));
+		run(1u, lane_sources, distances, &predecessors);
+	}
+
+	/**
+	 * @brief compute in one sweep the distances of each vertex to each source
+	 * @param[in] sources the indices of the K <= MAX_NB_LANES source vertices
+	 * @param[out] distances the K-wide distance vectors of the vertices: distances[i*K + k] is the distance
+	 * of the i-th vertex to the k-th source (std::numeric_limits<Scalar>::max() if it is unreachable)
+	 */
+	void compute_batch(const std::vector<uint32>& sources, std::vector<Scalar>& distances)
+	{
+		std::vector<std::pair<uint32, uint32>> lane_sources;
+		lane_sources.reserve(sources.size());
+		for (uint32 k = 0u, end = uint32(sources.size()); k < end; ++k)
+			lane_sources.push_back(std::make_pair(sources[k], k));
+		run(uint32(sources.size()), lane_sources, distances, nullptr);
+	}
+
+private:
+
+	inline uint64 bucket(Scalar d) const
+	{
+		return uint64(d / delta_);
+	}
+
+	/**
+	 * @brief call f(l) for each lane l of the mask (in a plain loop when all the lanes are set)
+	 */
+	template <typename FUNC>
+	static inline void foreach_lane(uint64 mask, uint64 all_lanes, uint32 nb_lanes, const FUNC& f)
+	{
+		if (mask == all_lanes)
+		{
+			for (uint32 l = 0u; l < nb_lanes; ++l)
+				f(l);
+		}
+		else
+		{
+			for (; mask != 0u; mask &= mask - 1u)
+				f(trailing_zeros(mask));
+		}
+	}
+
+	/**
+	 * @brief the Delta-stepping sweep
+	 * @param nb_lanes the number K of distance fields
+	 * @param sources the (vertex, lane) pairs of the sources
+	 * @param distances the K-wide distance vectors
+	 * @param predecessors the K-wide predecessor vectors (if not null)
+	 */
+	void run(uint32 nb_lanes, const std::vector<std::pair<uint32, uint32>>& sources, std::vector<Scalar>& distances, std::vector<uint32>* predecessors)
+	{
+		cgogn_message_assert(nb_lanes <= MAX_NB_LANES, "DeltaStepping: too many distance fields");
+
+		const uint32 nb_v = nb_vertices();
+		const Scalar inf = std::numeric_limits<Scalar>::max();
+
+		distances.assign(std::size_t(nb_v) * nb_lanes, inf);
+		if (predecessors)
+			predecessors->assign(std::size_t(nb_v) * nb_lanes, INVALID_INDEX);
+		if (nb_lanes == 0u)
+			return;
+
+		key_.assign(nb_v, inf);
+		light_lanes_.assign(nb_v, 0u);
+		heavy_lanes_.assign(nb_v, 0u);
+		slot_.assign(nb_v, INVALID_INDEX);
+		owner_size_ = (nb_v + NB_OWNERS - 1u) / NB_OWNERS;
+		buckets_.clear();
+
+		for (const auto& s : sources)
+		{
+			cgogn_message_assert(s.first < nb_v && s.second < nb_lanes, "DeltaStepping: wrong source");
+			distances[std::size_t(s.first) * nb_lanes + s.second] = Scalar(0);
+			if (predecessors)
+				(*predecessors)[std::size_t(s.first) * nb_lanes + s.second] = s.first;
+			light_lanes_[s.first] |= uint64(1u) << s.second;
+			if (key_[s.first] == inf)
+				buckets_[0u].push_back(s.first);
+			key_[s.first] = Scalar(0);
+		}
+
+		std::vector<uint32> frontier;
+		std::vector<uint32> settled;
+
+		while (!buckets_.empty())
+		{
+			const uint64 current = buckets_.begin()->first;
+			settled.clear();
+
+			// relax the light edges of the vertices of the current bucket until it is empty
+			while (!buckets_.empty() && buckets_.begin()->first == current)
+			{
+				std::vector<uint32> candidates;
+				candidates.swap(buckets_.begin()->second);
+				buckets_.erase(buckets_.begin());
+
+				frontier.clear();
+				frontier_lanes_.clear();
+				for (uint32 v : candidates)
+				{
+					// lazy deletion of the vertices that have been moved to a lower bucket or already processed
+					if (key_[v] == inf || bucket(key_[v]) != current || slot_[v] != INVALID_INDEX)
+						continue;
+					// only the lanes of the current bucket are processed, the others are left in their bucket
+					const Scalar* dv = &distances[std::size_t(v) * nb_lanes];
+					uint64 lanes = 0u;
+					Scalar next_key = inf;
+					for (uint64 mask = light_lanes_[v]; mask != 0u; mask &= mask - 1u)
+					{
+						const uint32 l = trailing_zeros(mask);
+						if (bucket(dv[l]) <= current)
+							lanes |= uint64(1u) << l;
+						else
+							next_key = std::min(next_key, dv[l]);
+					}
+					light_lanes_[v] &= ~lanes;
+					key_[v] = next_key;
+					if (next_key < inf)
+						buckets_[bucket(next_key)].push_back(v);
+
+					slot_[v] = uint32(frontier.size());
+					frontier.push_back(v);
+					frontier_lanes_.push_back(lanes);
+					if (heavy_lanes_[v] == 0u)
+						settled.push_back(v);
+					heavy_lanes_[v] |= lanes;
+				}
+				relax(nb_lanes, current, frontier, true, distances, predecessors);
+			}
+
+			// relax the heavy edges of the vertices settled in the bucket
+			frontier.swap(settled);
+			frontier_lanes_.clear();
+			for (uint32 v : frontier)
+			{
+				frontier_lanes_.push_back(heavy_lanes_[v]);
+				heavy_lanes_[v] = 0u;
+			}
+			relax(nb_lanes, current, frontier, false, distances, predecessors);
+		}
+	}
+
+	/**
+	 * @brief relax the light or heavy edges of the vertices of the frontier, for the lanes given by frontier_lanes_,
+	 * and put the vertices whose distances have decreased in their bucket
+	 * (the vertex of the frontier that decreases a distance becomes the predecessor of the target for this lane)
+	 */
+	void relax(uint32 nb_lanes, uint64 current, const std::vector<uint32>& frontier, bool light, std::vector<Scalar>& distances, std::vector<uint32>* predecessors)
+	{
+		const Scalar inf = std::numeric_limits<Scalar>::max();
+		const uint64 all_lanes = nb_lanes == 64u ? ~uint64(0u) : (uint64(1u) << nb_lanes) - 1u;
+		const uint32 nb_f = uint32(frontier.size());
+		const uint32 nb_chunks = (nb_f + CHUNK_SIZE - 1u) / CHUNK_SIZE;
+
+		// copy the processed distances of the frontier (read by the requests while the distances are updated)
+		frontier_distances_.resize(std::size_t(nb_f) * nb_lanes);
+		parallel_for(0u, nb_f, PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				const Scalar* du = &distances[std::size_t(frontier[i]) * nb_lanes];
+				Scalar* fu = &frontier_distances_[std::size_t(i) * nb_lanes];
+				foreach_lane(frontier_lanes_[i], all_lanes, nb_lanes, [&] (uint32 l) { fu[l] = du[l]; });
+			}
+		});
+
+		if (requests_.size() < std::size_t(nb_chunks) * NB_OWNERS)
+			requests_.resize(std::size_t(nb_chunks) * NB_OWNERS);
+
+		// generate the requests that decrease at least one distance of their target
+		parallel_for(0u, nb_chunks, 1u, [&] (uint32 first_chunk, uint32 last_chunk)
+		{
+			for (uint32 c = first_chunk; c < last_chunk; ++c)
+			{
+				std::vector<Request>* chunk_requests = &requests_[std::size_t(c) * NB_OWNERS];
+				for (uint32 o = 0u; o < NB_OWNERS; ++o)
+					chunk_requests[o].clear();
+
+				for (uint32 i = c * CHUNK_SIZE, end = std::min(nb_f, (c + 1u) * CHUNK_SIZE); i < end; ++i)
+				{
+					const uint32 u = frontier[i];
+					const uint64 lanes = frontier_lanes_[i];
+					const Scalar* du = &frontier_distances_[std::size_t(i) * nb_lanes];
+					const uint32 first_edge = light ? offsets_[u] : light_end_[u];
+					const uint32 last_edge = light ? light_end_[u] : offsets_[u + 1u];
+					for (uint32 k = first_edge; k < last_edge; ++k)
+					{
+						const uint32 v = targets_[k];
+						const Scalar w = weights_[k];
+						const Scalar* dv = &distances[std::size_t(v) * nb_lanes];
+						bool decrease = false;
+						foreach_lane(lanes, all_lanes, nb_lanes, [&] (uint32 l) { decrease |= du[l] + w < dv[l]; });
+						if (decrease)
+							chunk_requests[v / owner_size_].push_back(Request{v, i, w});
+					}
+				}
+			}
+		});
+
+		for (uint32 u : frontier)
+			slot_[u] = INVALID_INDEX;
+
+		// apply the requests of each owner
+		if (moved_.size() < NB_OWNERS)
+			moved_.resize(NB_OWNERS);
+		parallel_for(0u, NB_OWNERS, 1u, [&] (uint32 first_owner, uint32 last_owner)
+		{
+			for (uint32 o = first_owner; o < last_owner; ++o)
+			{
+				moved_[o].clear();
+				for (uint32 c = 0u; c < nb_chunks; ++c)
+				{
+					for (const Request& r : requests_[std::size_t(c) * NB_OWNERS + o])
+					{
+						const Scalar* du = &frontier_distances_[std::size_t(r.slot_) * nb_lanes];
+						Scalar* dv = &distances[std::size_t(r.target_) * nb_lanes];
+						uint32* pv = predecessors ? &(*predecessors)[std::size_t(r.target_) * nb_lanes] : nullptr;
+						Scalar decreased = inf;
+						uint64 decreased_lanes = 0u;
+						foreach_lane(frontier_lanes_[r.slot_], all_lanes, nb_lanes, [&] (uint32 l)
+						{
+							const Scalar d = du[l] + r.weight_;
+							if (d < dv[l])
+							{
+								dv[l] = d;
+								if (pv)
+									pv[l] = frontier[r.slot_];
+								decreased = std::min(decreased, d);
+								decreased_lanes |= uint64(1u) << l;
+							}
+						});
+						light_lanes_[r.target_] |= decreased_lanes;
+						Scalar& key = key_[r.target_];
+						if (decreased < key)
+						{
+							if (key == inf || bucket(decreased) < bucket(key))
+								moved_[o].push_back(r.target_);
+							key = decreased;
+						}
+					}
+				}
+			}
+		});
+
+		for (uint32 o = 0u; o < NB_OWNERS; ++o)
+			for (uint32 v : moved_[o])
+				buckets_[std::max(current, bucket(key_[v]))].push_back(v);
+	}
+
+	Scalar delta_;
+
+	std::vector<uint32> offsets_;
+	std::vector<uint32> targets_;
+	std::vector<Scalar> weights_;
+	std::vector<uint32> light_end_;
+
+	// state of the sweep
+	std::map<uint64, std::vector<uint32>> buckets_;
+	std::vector<Scalar> key_;
+	std::vector<uint64> light_lanes_;
+	std::vector<uint64> heavy_lanes_;
+	std::vector<uint32> slot_;
+	std::vector<Scalar> frontier_distances_;
+	std::vector<uint64> frontier_lanes_;
+	std::vector<std::vector<Request>> requests_;
+	std::vector<std::vector<uint32>> moved_;
+	uint32 owner_size_;
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_EXTERNAL_TEMPLATES_CPP_))
+extern template class CGOGN_TOPOLOGY_API DeltaStepping<float32, CMap2>;
+extern template class CGOGN_TOPOLOGY_API DeltaStepping<float64, CMap2>;
+extern template class CGOGN_TOPOLOGY_API DeltaStepping<float32, CMap3>;
+extern template class CGOGN_TOPOLOGY_API DeltaStepping<float64, CMap3>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_EXTERNAL_TEMPLATES_CPP_))
+
+} // namespace topology
+
+} // namespace cgogn
+
+#endif // CGOGN_TOPOLOGY_DELTA_STEPPING_H_
@@ -24,7 +24,10 @@
 #ifndef CGOGN_TOPOLOGY_DISTANCE_FIELD_H_
 #define CGOGN_TOPOLOGY_DISTANCE_FIELD_H_
 
+#include <queue>
+
 #include <cgogn/topology/types/adjacency_cache.h>
+#include <cgogn/topology/algos/delta_stepping.h>
 
 #include <cgogn/geometry/algos/centroid.h>
 
@@ -54,6 +57,9 @@ class DistanceField
 
 public:
 
+	/// number of distance fields computed in the same sweep by the batched queries
+	static const std::size_t DISTANCE_BATCH_SIZE = 8u;
+
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(DistanceField);
 
 	DistanceField(MAP& map,
@@ -93,53 +99,43 @@ public:
 
 private:
 
+	/**
+	 * @return the indices in the adjacency snapshot of the given vertices
+	 */
+	std::vector<uint32> vertex_indices(const std::vector<Vertex>& vertices) const
+	{
+		const CSRIncidence<MAP>& incidence = cache_.incidence();
+		std::vector<uint32> indices;
+		indices.reserve(vertices.size());
+		for (Vertex v : vertices)
+			indices.push_back(incidence.vertex_index(v.dart));
+		return indices;
+	}
+
 	/**
 	 * Compute for each vertex of the map, the shortest path to the sources
 	 * A path is a sequence of adjacent edges whose weights are summed along the paths
 	 * The method returns the lengths of the shortest paths in a VertexAttribute.
 	 * @param[in] sources the vertices from which the shortest paths are computed
 	 * @param[out] distance_to_source : the sums of the edge weights in the shortest paths
+	 * The distances are computed in parallel by a DeltaStepping engine on the adjacency snapshot of the cache.
 	 */
 	void dijkstra_compute_distances(
 			const std::vector<Vertex>& sources,
 			VertexAttribute<Scalar>& distance_to_source)
 	{
-		for (auto& d : distance_to_source)
-			d = std::numeric_limits<Scalar>::max();
+		const CSRIncidence<MAP>& incidence = cache_.incidence();
+		const std::vector<Dart>& vertices = incidence.vertices();
 
-		// A pair contains a scalar (the actual distance) and a vertex (the index of one of its darts)
-		using my_pair = std::pair<Scalar, uint32>;
+		DeltaStepping<Scalar, MAP> engine(incidence, edge_weight_);
+		std::vector<Scalar> distances;
+		engine.compute(vertex_indices(sources), distances);
 
-		// The queue is used to manage the front of the dijkstra flood that consider
-		// the vertices in the order of their estimated distance to a source
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair>, std::greater<my_pair> >;
-		my_queue vertex_queue;
-
-		// Initialize the sources with a zero lenght path
-		for (auto& source : sources)
+		parallel_for(0u, incidence.nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
 		{
-			vertex_queue.push(std::make_pair(Scalar(0), source.dart.index));
-			distance_to_source[source] = Scalar(0);
-		}
-
-		// The dijkstra flood
-		while (!vertex_queue.empty())
-		{
-			Scalar dist = vertex_queue.top().first;
-			Vertex u = Vertex(Dart(vertex_queue.top().second));
-
-			vertex_queue.pop();
-
-			cache_.foreach_adjacent_vertex_through_edge(u, [&](Vertex v)
-			{
-				Scalar distance_through_u = dist + edge_weight_[Edge(v.dart)];
-				if (distance_through_u < distance_to_source[v])
-				{
-					distance_to_source[v] = distance_through_u;
-					vertex_queue.push(std::make_pair(distance_through_u, v.dart.index));
-				}
-			});
-		}
+			for (uint32 i = first; i < last; ++i)
+				distance_to_source[Vertex(vertices[i])] = distances[i];
+		});
 	}
 
 public:
@@ -151,52 +147,67 @@ public:
 	 * @param[in] sources the vertices from which the shortest paths are computed
 	 * @param[out] distance_to_source : the sums of the edge weights in the shortest paths
 	 * @param[out] path_to_source : a reference to the previous vertex in the shortest path
+	 * (the sources reference themselves, the unreachable vertices reference an invalid vertex)
 	 */
 	void dijkstra_compute_paths(
 			const std::vector<Vertex>& sources,
 			VertexAttribute<Scalar>& distance_to_source,
 			VertexAttribute<Vertex>& path_to_source)
 	{
-		for (auto& d : distance_to_source)
-			d = std::numeric_limits<Scalar>::max();
+		const CSRIncidence<MAP>& incidence = cache_.incidence();
+		const std::vector<uint32> source_indices = vertex_indices(sources);
 
-		for (auto& p : path_to_source)
-			p = Vertex();
+		DeltaStepping<Scalar, MAP> engine(incidence, edge_weight_);
+		std::vector<Scalar> distances;
+		std::vector<uint32> predecessors;
+		engine.compute(source_indices, distances, predecessors);
 
-		// A pair contains a scalar (the actual distance) and a vertex (the index of one of its darts)
-		using my_pair = std::pair<Scalar, uint32>;
+		// the paths reference the sources by their given darts
+		std::vector<Dart> darts = incidence.vertices();
+		for (uint32 k = 0u, end = uint32(sources.size()); k < end; ++k)
+			darts[source_indices[k]] = sources[k].dart;
 
-		// The queue is used to manage the front of the dijkstra flood that consider
-		// the vertices in the order of their estimated distance to a source
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair>, std::greater<my_pair> >;
-		my_queue vertex_queue;
-
-		// Initialize the sources with a zero lenght path
-		for (auto& source : sources)
+		parallel_for(0u, incidence.nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
 		{
-			vertex_queue.push(std::make_pair(Scalar(0), source.dart.index));
-			distance_to_source[source] = Scalar(0);
-			path_to_source[source] = source;
-		}
-
-		// The dijkstra flood
-		while (!vertex_queue.empty())
-		{
-			Scalar dist = vertex_queue.top().first;
-			Vertex u = Vertex(Dart(vertex_queue.top().second));
+			for (uint32 i = first; i < last; ++i)
+			{
+				const Vertex v(darts[i]);
+				distance_to_source[v] = distances[i];
+				path_to_source[v] = predecessors[i] == INVALID_INDEX ? Vertex() : Vertex(darts[predecessors[i]]);
+			}
+		});
+	}
 
-			vertex_queue.pop();
+	/**
+	 * Compute in one sweep the distance fields of several sources
+	 * @param[in] sources the vertices from which the distance fields are computed
+	 * @param[out] distances the distance vectors of the vertices, in the order of the adjacency snapshot of the cache:
+	 * distances[i*K + k] is the distance of the i-th vertex to the k-th source (K = sources.size())
+	 */
+	void compute_distance_fields(const std::vector<Vertex>& sources, std::vector<Scalar>& distances)
+	{
+		DeltaStepping<Scalar, MAP> engine(cache_.incidence(), edge_weight_);
+		engine.compute_batch(vertex_indices(sources), distances);
+	}
 
-			cache_.foreach_adjacent_vertex_through_edge(u, [&](Vertex v)
-			{
-				Scalar distance_through_u = dist + edge_weight_[Edge(v.dart)];
-				if (distance_through_u < distance_to_source[v])
-				{
-					distance_to_source[v] = distance_through_u;
-					path_to_source[v] = u;
-					vertex_queue.push(std::make_pair(distance_through_u, v.dart.index));
-				}
-			});
+	/**
+	 * @brief compute the maximal distance of the vertices to each source
+	 * @param[in] sources the vertices from which the distance fields are computed
+	 * @param[out] max_distances the maximum of the distance field of each source
+	 * The distance fields are computed in batches of DISTANCE_BATCH_SIZE sources.
+	 */
+	void maximal_distances(const std::vector<Vertex>& sources, std::vector<Scalar>& max_distances)
+	{
+		max_distances.assign(sources.size(), Scalar(0));
+		std::vector<Scalar> distances;
+		for (std::size_t first = 0u; first < sources.size(); first += DISTANCE_BATCH_SIZE)
+		{
+			const std::vector<Vertex> batch(sources.begin() + first, sources.begin() + std::min(sources.size(), first + DISTANCE_BATCH_SIZE));
+			const std::size_t nb = batch.size();
+			compute_distance_fields(batch, distances);
+			for (std::size_t i = 0u, end = distances.size(); i < end; i += nb)
+				for (std::size_t k = 0u; k < nb; ++k)
+					max_distances[first + k] = std::max(max_distances[first + k], distances[i + k]);
 		}
 	}
 
@@ -346,28 +357,37 @@ public:
 	}
 
 	/**
-		 * Build a scalar field that represent the sum of the distance of each vertex
-		 * to a given set of features (selected vertices) of the Map.
-		 * @param[in] features the vertices from which the shortest paths are computed
-		 * @param[out] scalar_field : the computed distance field
-		 */
+	 * Build a scalar field that represent the sum of the distance of each vertex
+	 * to a given set of features (selected vertices) of the Map.
+	 * @param[in] features the vertices from which the shortest paths are computed
+	 * @param[out] scalar_field : the computed distance field
+	 * The distance fields of the features are computed in batches of DISTANCE_BATCH_SIZE features.
+	 */
 	void sum_of_distance_to_features(const std::vector<Vertex>& features,
 									 VertexAttribute<Scalar>& scalar_field)
 	{
-		VertexAttribute<Scalar> distance_to_feature =
-				map_.template add_attribute<Scalar, Vertex>("__distance_to_feature__");
+		const CSRIncidence<MAP>& incidence = cache_.incidence();
+		const std::vector<Dart>& vertices = incidence.vertices();
 
 		for (auto& s : scalar_field) s = Scalar(0);
 
-		for (Vertex f : features)
+		std::vector<Scalar> distances;
+		for (std::size_t first = 0u; first < features.size(); first += DISTANCE_BATCH_SIZE)
 		{
-			dijkstra_compute_distances({f}, distance_to_feature);
-			map_.foreach_cell([&](Vertex v)
+			const std::vector<Vertex> batch(features.begin() + first, features.begin() + std::min(features.size(), first + DISTANCE_BATCH_SIZE));
+			const uint32 nb = uint32(batch.size());
+			compute_distance_fields(batch, distances);
+			parallel_for(0u, incidence.nb_vertices(), PARALLEL_BUFFER_SIZE, [&] (uint32 first_vertex, uint32 last_vertex)
 			{
-				scalar_field[v] += distance_to_feature[v];
+				for (uint32 i = first_vertex; i < last_vertex; ++i)
+				{
+					Scalar sum = Scalar(0);
+					for (uint32 k = 0u; k < nb; ++k)
+						sum += distances[std::size_t(i) * nb + k];
+					scalar_field[Vertex(vertices[i])] += sum;
+				}
 			});
 		}
-		map_.remove_attribute(distance_to_feature);
 	}
 
 	/**
@@ -192,18 +192,19 @@ public:
 
 		// Search the most central vertices in these maxima,
 		// i.e. whose distance field has a minimal diameter
+		// (the distance fields of the maxima are computed by batches)
+		std::vector<Scalar> diameters;
+		distance_field_.maximal_distances(maxima, diameters);
+
 		Scalar min = std::numeric_limits<Scalar>::max();
 		Vertex min_vertex = maxima.front();
 
-		for (Vertex v : maxima)
+		for (std::size_t i = 0u; i < maxima.size(); ++i)
 		{
-			distance_field_.distance_to_features({v}, distance_to_A_);
-			Vertex max_vertex = distance_field_.find_maximum(distance_to_A_);
-			Scalar max = distance_to_A_[max_vertex];
-			if (min > max)
+			if (min > diameters[i])
 			{
-				min = max;
-				min_vertex = v;
+				min = diameters[i];
+				min_vertex = maxima[i];
 			}
 		}
 		return min_vertex;
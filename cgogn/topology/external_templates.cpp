@@ -22,6 +22,7 @@
 *******************************************************************************/
 #define CGOGN_TOPOLOGY_EXTERNAL_TEMPLATES_CPP_
 
+#include <cgogn/topology/algos/delta_stepping.h>
 #include <cgogn/topology/algos/distance_field.h>
 #include <cgogn/topology/algos/features.h>
 #include <cgogn/topology/algos/scalar_field.h>
@@ -32,6 +33,11 @@ namespace cgogn
 namespace topology
 {
 
+template class CGOGN_TOPOLOGY_API DeltaStepping<float32, CMap2>;
+template class CGOGN_TOPOLOGY_API DeltaStepping<float64, CMap2>;
+template class CGOGN_TOPOLOGY_API DeltaStepping<float32, CMap3>;
+template class CGOGN_TOPOLOGY_API DeltaStepping<float64, CMap3>;
+
 template class CGOGN_TOPOLOGY_API DistanceField<float32, CMap2>;
 template class CGOGN_TOPOLOGY_API DistanceField<float64, CMap2>;
 template class CGOGN_TOPOLOGY_API DistanceField<float32, CMap3>;
@@ -0,0 +1,208 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/csr_incidence.h>
+#include <cgogn/modeling/tiling/square_grid.h>
+#include <cgogn/topology/algos/delta_stepping.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The DeltaSteppingTest class compares the distances of the DeltaStepping engine with a serial Dijkstra
+ * on the graph of a grid and of an isolated triangle (whose vertices are unreachable from the grid).
+ */
+class DeltaSteppingTest : public testing::Test
+{
+public:
+
+	using Vertex = CMap2::Vertex;
+	using Edge = CMap2::Edge;
+	template <typename T>
+	using EdgeAttribute = CMap2::EdgeAttribute<T>;
+	using Engine = topology::DeltaStepping<float64, CMap2>;
+
+protected:
+
+	CMap2 map_;
+	EdgeAttribute<float64> weight_;
+	CSRIncidence<CMap2> incidence_;
+	std::vector<uint32> triangle_;
+
+	DeltaSteppingTest() :
+		incidence_(map_)
+	{
+		modeling::SquareGrid<CMap2> grid(map_, 20u, 20u);
+		const CMap2::Face f = map_.add_face(3u);
+		weight_ = map_.add_attribute<float64, Edge>("weight");
+		incidence_.build();
+		map_.foreach_incident_vertex(f, [&] (Vertex v) { triangle_.push_back(incidence_.vertex_index(v.dart)); });
+	}
+
+	// integer weights, the sums of weights are exact
+	void set_weights(uint32 max_weight, uint32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<uint32> uni(0u, max_weight);
+		map_.foreach_cell([&] (Edge e) { weight_[e] = float64(uni(rng)); });
+	}
+
+	std::vector<float64> dijkstra(const std::vector<uint32>& sources)
+	{
+		using Entry = std::pair<float64, uint32>;
+		std::vector<float64> distances(incidence_.nb_vertices(), std::numeric_limits<float64>::max());
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+		for (uint32 s : sources)
+		{
+			distances[s] = 0.0;
+			queue.push(std::make_pair(0.0, s));
+		}
+		while (!queue.empty())
+		{
+			const Entry e = queue.top();
+			queue.pop();
+			if (e.first > distances[e.second])
+				continue;
+			for (Dart d : incidence_.adjacent_vertices(e.second))
+			{
+				const uint32 v = incidence_.vertex_index(d);
+				const float64 dv = e.first + weight_[Edge(d)];
+				if (dv < distances[v])
+				{
+					distances[v] = dv;
+					queue.push(std::make_pair(dv, v));
+				}
+			}
+		}
+		return distances;
+	}
+
+	// the predecessors form a forest rooted at the sources along which the distances are reached
+	void check_tree(const std::vector<uint32>& sources, const std::vector<float64>& distances, const std::vector<uint32>& predecessors)
+	{
+		const uint32 nb_vertices = incidence_.nb_vertices();
+		ASSERT_EQ(predecessors.size(), nb_vertices);
+		for (uint32 i = 0u; i < nb_vertices; ++i)
+		{
+			const uint32 p = predecessors[i];
+			if (distances[i] == std::numeric_limits<float64>::max())
+			{
+				EXPECT_EQ(p, INVALID_INDEX);
+				continue;
+			}
+			ASSERT_NE(p, INVALID_INDEX);
+			if (p == i)
+			{
+				EXPECT_NE(std::find(sources.begin(), sources.end(), i), sources.end());
+				continue;
+			}
+			bool tight = false;
+			for (Dart d : incidence_.adjacent_vertices(i))
+				tight |= incidence_.vertex_index(d) == p && distances[p] + weight_[Edge(d)] == distances[i];
+			EXPECT_TRUE(tight);
+
+			uint32 v = i;
+			uint32 nb_steps = 0u;
+			while (predecessors[v] != v && nb_steps <= nb_vertices)
+			{
+				v = predecessors[v];
+				++nb_steps;
+			}
+			EXPECT_LE(nb_steps, nb_vertices);
+		}
+	}
+};
+
+TEST_F(DeltaSteppingTest, dijkstra)
+{
+	set_weights(4u, 1u);
+	Engine engine(incidence_, weight_);
+
+	const std::vector<uint32> sources = { 0u, 57u, 211u };
+	std::vector<float64> distances;
+	engine.compute(sources, distances);
+	EXPECT_EQ(distances, dijkstra(sources));
+	for (uint32 v : triangle_)
+		EXPECT_EQ(distances[v], std::numeric_limits<float64>::max());
+
+	std::vector<float64> tree_distances;
+	std::vector<uint32> predecessors;
+	engine.compute(sources, tree_distances, predecessors);
+	EXPECT_EQ(tree_distances, distances);
+	check_tree(sources, tree_distances, predecessors);
+
+	// each distance field of the batch is the distance field of its source
+	std::vector<float64> batch;
+	engine.compute_batch(sources, batch);
+	const uint32 nb_sources = uint32(sources.size());
+	for (uint32 k = 0u; k < nb_sources; ++k)
+	{
+		const std::vector<float64> expected = dijkstra({ sources[k] });
+		for (uint32 i = 0u; i < incidence_.nb_vertices(); ++i)
+			EXPECT_EQ(batch[i * nb_sources + k], expected[i]);
+	}
+}
+
+TEST_F(DeltaSteppingTest, zero_weights)
+{
+	// many ties: the shortest paths through the edges of weight zero have the same lengths
+	for (uint32 max_weight : { 0u, 1u })
+	{
+		set_weights(max_weight, 2u);
+		Engine engine(incidence_, weight_);
+		const std::vector<uint32> sources = { 0u, 120u, triangle_[0] };
+		std::vector<float64> distances;
+		std::vector<uint32> predecessors;
+		engine.compute(sources, distances, predecessors);
+		EXPECT_EQ(distances, dijkstra(sources));
+		check_tree(sources, distances, predecessors);
+	}
+}
+
+TEST_F(DeltaSteppingTest, delta_values)
+{
+	set_weights(8u, 3u);
+	Engine engine(incidence_, weight_);
+	const std::vector<uint32> sources = { 13u, 300u };
+	const std::vector<float64> expected = dijkstra(sources);
+
+	for (float64 delta : { 0.5, 1.0, 3.0, 1000.0 })
+	{
+		engine.set_delta(delta);
+		std::vector<float64> distances;
+		std::vector<uint32> predecessors;
+		engine.compute(sources, distances, predecessors);
+		EXPECT_EQ(distances, expected);
+		check_tree(sources, distances, predecessors);
+	}
+}
+
+} // namespace cgogn
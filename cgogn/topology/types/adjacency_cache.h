@@ -24,9 +24,12 @@
 #ifndef CGOGN_TOPOLOGY_TYPES_ADJACENCY_CACHE_H_
 #define CGOGN_TOPOLOGY_TYPES_ADJACENCY_CACHE_H_
 
+#include <memory>
+
 #include <cgogn/topology/dll.h>
 #include <cgogn/core/cmap/cmap2.h>
 #include <cgogn/core/cmap/cmap3.h>
+#include <cgogn/core/cmap/csr_incidence.h>
 
 namespace cgogn
 {
@@ -34,13 +37,14 @@ namespace cgogn
 namespace topology
 {
 
+/**
+ * @brief The AdjacencyCache class gives the vertices adjacent to each vertex of a map through an edge,
+ * from a CSRIncidence snapshot of the map built by init (and shared by the copies of the cache).
+ */
 template <typename MAP>
 class AdjacencyCache
 {
 	using Vertex = typename MAP::Vertex;
-	using VertexArray = std::vector<Vertex>;
-	template<typename T>
-	using VertexAttribute = typename MAP::template VertexAttribute<T>;
 
 public:
 
@@ -50,12 +54,12 @@ public:
 
 	inline AdjacencyCache(const AdjacencyCache& other) :
 		map_(other.map_),
-		adjacency_(other.adjacency_)
+		incidence_(other.incidence_)
 	{}
 
 	inline AdjacencyCache(AdjacencyCache&& other) :
 		map_(other.map_),
-		adjacency_(std::move(other.adjacency_))
+		incidence_(std::move(other.incidence_))
 	{}
 
 	const AdjacencyCache& operator=(AdjacencyCache&&) = delete;
@@ -66,27 +70,27 @@ public:
 
 	void init()
 	{
-		adjacency_ = map_.template add_attribute<VertexArray, Vertex>("__adjacency__");
-		map_.foreach_cell([&](Vertex v)
-		{
-			map_.foreach_adjacent_vertex_through_edge(v, [&](Vertex u)
-			{
-				adjacency_[v].push_back(u);
-			});
-		});
+		std::shared_ptr<CSRIncidence<MAP>> incidence = std::make_shared<CSRIncidence<MAP>>(map_);
+		incidence->build();
+		incidence_ = incidence;
+	}
+
+	inline const CSRIncidence<MAP>& incidence() const
+	{
+		return *incidence_;
 	}
 
 	template <typename FUNC>
 	inline void foreach_adjacent_vertex_through_edge(Vertex v, const FUNC& f) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Vertex>::value, "Wrong function cell parameter type");
-		for (Vertex u : adjacency_[v]) f(u);
+		incidence_->foreach_adjacent_vertex_through_edge(v, f);
 	}
 
 private:
 
 	MAP& map_;
-	VertexAttribute<VertexArray> adjacency_;
+	std::shared_ptr<const CSRIncidence<MAP>> incidence_;
 };
 
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_EXTERNAL_TEMPLATES_CPP_))